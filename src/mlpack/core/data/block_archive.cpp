@@ -0,0 +1,84 @@
+/**
+ * @file block_archive.cpp
+ * @author agent
+ *
+ * Instantiation of the boost::serialization machinery for BlockOArchive and
+ * BlockIArchive (boost only instantiates it for its own archives), and the
+ * implementation of MappedFile.
+ */
+#include "block_archive.hpp"
+
+#include <boost/archive/detail/archive_serializer_map.hpp>
+#include <boost/archive/impl/archive_serializer_map.ipp>
+#include <boost/archive/impl/basic_binary_oprimitive.ipp>
+#include <boost/archive/impl/basic_binary_oarchive.ipp>
+#include <boost/archive/impl/basic_binary_iprimitive.ipp>
+#include <boost/archive/impl/basic_binary_iarchive.ipp>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace boost {
+namespace archive {
+
+template class detail::archive_serializer_map<mlpack::data::BlockOArchive>;
+template class basic_binary_oprimitive<mlpack::data::BlockOArchive,
+    std::ostream::char_type, std::ostream::traits_type>;
+template class basic_binary_oarchive<mlpack::data::BlockOArchive>;
+template class binary_oarchive_impl<mlpack::data::BlockOArchive,
+    std::ostream::char_type, std::ostream::traits_type>;
+
+template class detail::archive_serializer_map<mlpack::data::BlockIArchive>;
+template class basic_binary_iprimitive<mlpack::data::BlockIArchive,
+    std::istream::char_type, std::istream::traits_type>;
+template class basic_binary_iarchive<mlpack::data::BlockIArchive>;
+template class binary_iarchive_impl<mlpack::data::BlockIArchive,
+    std::istream::char_type, std::istream::traits_type>;
+
+} // namespace archive
+} // namespace boost
+
+using namespace mlpack::data;
+
+MappedFile::MappedFile(const std::string& filename) :
+    data(NULL),
+    size(0)
+{
+#ifndef _WIN32
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+
+  struct stat status;
+  if (::fstat(fd, &status) == 0 && status.st_size > 0)
+  {
+    void* mapping = ::mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd,
+        0);
+    if (mapping != MAP_FAILED)
+    {
+      data = (char*) mapping;
+      size = status.st_size;
+
+      // The file is read front to back, once.
+      ::madvise(mapping, size, MADV_SEQUENTIAL);
+    }
+  }
+
+  // The mapping stays valid after the file is closed.
+  ::close(fd);
+#else
+  (void) filename;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+  if (data != NULL)
+    ::munmap(data, size);
+#endif
+}
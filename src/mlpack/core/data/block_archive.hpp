@@ -0,0 +1,190 @@
+/**
+ * @file block_archive.hpp
+ * @author agent
+ *
+ * Binary boost::serialization archives that store arrays (and so the contents
+ * of Armadillo matrices and std::vectors of primitive types) as raw blocks
+ * aligned in the file, plus a read-only memory mapping of a file that the
+ * input archive can read from.  These are used by data::Save() and
+ * data::Load() for the format::block format.
+ */
+#ifndef __MLPACK_CORE_DATA_BLOCK_ARCHIVE_HPP
+#define __MLPACK_CORE_DATA_BLOCK_ARCHIVE_HPP
+
+#include <boost/version.hpp>
+#include <boost/archive/binary_oarchive_impl.hpp>
+#include <boost/archive/binary_iarchive_impl.hpp>
+#include <boost/archive/detail/register_archive.hpp>
+#include <boost/serialization/array.hpp>
+
+#include <stdint.h>
+#include <streambuf>
+#include <string>
+
+namespace mlpack {
+namespace data {
+
+//! The type boost::serialization uses to wrap arrays.
+#if BOOST_VERSION >= 106100
+  #define MLPACK_ARRAY_WRAPPER boost::serialization::array_wrapper
+#else
+  #define MLPACK_ARRAY_WRAPPER boost::serialization::array
+#endif
+
+/**
+ * Arrays of at least this many bytes start at a file offset that is a multiple
+ * of BlockAlignment; smaller arrays (like the bounds of tree nodes) are stored
+ * without padding.
+ */
+static const size_t BlockThreshold = 4096;
+
+//! The alignment of large arrays in the file.
+static const size_t BlockAlignment = 64;
+
+/**
+ * An output archive with the same layout as boost::archive::binary_oarchive,
+ * except that every array is preceded by one byte giving the number of padding
+ * bytes that follow it, so that the contents of large arrays are aligned in the
+ * file.  The contents are written with a single call to the stream buffer.
+ *
+ * The Serialize() methods of mlpack classes do not need to know about this
+ * archive; any object that can be saved with a binary_oarchive can be saved
+ * with a BlockOArchive.  Alignment is relative to the start of the underlying
+ * stream, so the archive should be created on a freshly opened file.
+ */
+class BlockOArchive : public boost::archive::binary_oarchive_impl<
+    BlockOArchive, std::ostream::char_type, std::ostream::traits_type>
+{
+ public:
+  //! Create the archive on the given stream.
+  BlockOArchive(std::ostream& os, const unsigned int flags = 0) :
+      boost::archive::binary_oarchive_impl<BlockOArchive,
+          std::ostream::char_type, std::ostream::traits_type>(os, flags)
+  {
+#if BOOST_VERSION >= 105800
+    init(flags);
+#endif
+  }
+
+  //! Save an array as a (possibly aligned) block.
+  template<typename ValueType>
+  void save_array(const MLPACK_ARRAY_WRAPPER<ValueType>& a,
+                  const unsigned int /* version */)
+  {
+    const size_t bytes = a.count() * sizeof(ValueType);
+
+    // The position is unknown if the stream cannot seek; then the block is not
+    // aligned, but the file can be read just the same.
+    uint8_t padding = 0;
+    if (bytes >= BlockThreshold)
+    {
+      const std::streamoff position = this->m_sb.pubseekoff(0,
+          std::ios_base::cur, std::ios_base::out);
+      if (position >= 0)
+        padding = (BlockAlignment - (position + 1) % BlockAlignment) %
+            BlockAlignment;
+    }
+
+    const char zeros[BlockAlignment] = { 0 };
+    this->save_binary(&padding, 1);
+    if (padding > 0)
+      this->save_binary(zeros, padding);
+    this->save_binary(a.address(), bytes);
+  }
+};
+
+/**
+ * The input archive that reads files written by BlockOArchive.  Each array is
+ * read with a single call to the stream buffer; if the stream buffer is a
+ * MappedBuffer, that is a single copy out of the page cache.
+ */
+class BlockIArchive : public boost::archive::binary_iarchive_impl<
+    BlockIArchive, std::istream::char_type, std::istream::traits_type>
+{
+ public:
+  //! Create the archive on the given stream.
+  BlockIArchive(std::istream& is, const unsigned int flags = 0) :
+      boost::archive::binary_iarchive_impl<BlockIArchive,
+          std::istream::char_type, std::istream::traits_type>(is, flags)
+  {
+#if BOOST_VERSION >= 105800
+    init(flags);
+#endif
+  }
+
+  //! Load an array that was saved as a block.
+  template<typename ValueType>
+  void load_array(MLPACK_ARRAY_WRAPPER<ValueType>& a,
+                  const unsigned int /* version */)
+  {
+    uint8_t padding;
+    this->load_binary(&padding, 1);
+    if (padding >= BlockAlignment)
+      boost::serialization::throw_exception(boost::archive::archive_exception(
+          boost::archive::archive_exception::input_stream_error));
+
+    char skipped[BlockAlignment];
+    if (padding > 0)
+      this->load_binary(skipped, padding);
+    this->load_binary(a.address(), a.count() * sizeof(ValueType));
+  }
+};
+
+/**
+ * A read-only memory mapping of a file.  If the file cannot be mapped (or the
+ * platform does not support it), IsOpen() returns false, and the file should be
+ * read with a stream instead.
+ */
+class MappedFile
+{
+ public:
+  //! Map the given file.
+  MappedFile(const std::string& filename);
+
+  //! Unmap the file.
+  ~MappedFile();
+
+  //! Return whether the file was mapped.
+  bool IsOpen() const { return data != NULL; }
+  //! Get the contents of the file.
+  const char* Data() const { return data; }
+  //! Get the size of the file.
+  size_t Size() const { return size; }
+
+ private:
+  //! Copying a mapping is not allowed.
+  MappedFile(const MappedFile& other);
+  //! Copying a mapping is not allowed.
+  MappedFile& operator=(const MappedFile& other);
+
+  //! The contents of the file (or NULL).
+  char* data;
+  //! The size of the file.
+  size_t size;
+};
+
+/**
+ * A stream buffer that reads from a region of memory (such as a MappedFile),
+ * without copying it first.
+ */
+class MappedBuffer : public std::streambuf
+{
+ public:
+  //! Read from the given region.
+  MappedBuffer(const char* data, const size_t size)
+  {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Allow exported (polymorphic) types to be used with the block archives.
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(mlpack::data::BlockOArchive)
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(mlpack::data::BlockIArchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(mlpack::data::BlockOArchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(mlpack::data::BlockIArchive)
+
+#endif
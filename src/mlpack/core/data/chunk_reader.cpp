@@ -0,0 +1,180 @@
+/**
+ * @file chunk_reader.cpp
+ * @author agent
+ *
+ * Implementation of the ChunkReader class.
+ */
+#include "chunk_reader.hpp"
+#include "extension.hpp"
+#include "load_arff.hpp"
+
+#include <boost/algorithm/string.hpp>
+#include <cstdlib>
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+ChunkReader::ChunkReader(const std::string& filename,
+                         DatasetInfo& info,
+                         const size_t chunkSize) :
+    filename(filename),
+    info(info),
+    chunkSize(chunkSize),
+    arff(false),
+    headerLines(0),
+    lineNumber(0),
+    pointsRead(0)
+{
+  if (chunkSize == 0)
+    throw std::invalid_argument("ChunkReader::ChunkReader(): chunk size must "
+        "be positive");
+
+  stream.open(filename.c_str(), std::ifstream::in);
+  if (!stream.is_open())
+    throw std::runtime_error("ChunkReader::ChunkReader(): cannot open '" +
+        filename + "'");
+
+  const std::string extension = Extension(filename);
+  if (extension == "arff")
+  {
+    arff = true;
+    headerLines = ReadARFFHeader(stream, info);
+    lineNumber = headerLines;
+  }
+  else if (extension == "csv" || extension == "tsv" || extension == "txt")
+  {
+    // The dimensionality is the number of values on the first line.
+    std::string line;
+    if (!NextLine(line))
+      throw std::runtime_error("ChunkReader::ChunkReader(): '" + filename +
+          "' is empty");
+
+    std::vector<std::string> tokens;
+    boost::split(tokens, line, boost::is_any_of(", \t"),
+        boost::token_compress_on);
+    if (info.Dimensionality() == 0)
+    {
+      info = DatasetInfo(tokens.size());
+    }
+    else if (info.Dimensionality() != tokens.size())
+    {
+      std::ostringstream oss;
+      oss << "ChunkReader::ChunkReader(): given DatasetInfo has dimensionality "
+          << info.Dimensionality() << ", but data has dimensionality "
+          << tokens.size();
+      throw std::invalid_argument(oss.str());
+    }
+
+    stream.clear();
+    stream.seekg(0);
+    lineNumber = 0;
+  }
+  else
+  {
+    throw std::invalid_argument("ChunkReader::ChunkReader(): cannot read '" +
+        filename + "' in blocks; the type must be csv, tsv, txt, or arff");
+  }
+
+  dataStart = stream.tellg();
+}
+
+bool ChunkReader::Next(arma::mat& chunk)
+{
+  chunk.set_size(info.Dimensionality(), chunkSize);
+
+  size_t points = 0;
+  std::string line;
+  while (points < chunkSize && NextLine(line))
+  {
+    if (arff)
+      ParseARFFLine(line, info, chunk.colptr(points), lineNumber);
+    else
+      ParseLine(line, chunk.colptr(points));
+    ++points;
+  }
+
+  if (points == 0)
+    chunk.reset();
+  else if (points < chunkSize)
+    chunk.resize(info.Dimensionality(), points);
+
+  pointsRead += points;
+  return (points > 0);
+}
+
+void ChunkReader::MapCategories()
+{
+  bool categorical = false;
+  for (size_t i = 0; i < info.Dimensionality(); ++i)
+    if (info.Type(i) == Datatype::categorical)
+      categorical = true;
+
+  if (!categorical)
+    return;
+
+  // Parsing a line maps its categorical values; the points themselves are
+  // thrown away.
+  arma::vec point(info.Dimensionality());
+  std::string line;
+  while (NextLine(line))
+    ParseARFFLine(line, info, point.memptr(), lineNumber);
+
+  Rewind();
+}
+
+void ChunkReader::Rewind()
+{
+  stream.clear();
+  stream.seekg(dataStart);
+  lineNumber = headerLines;
+  pointsRead = 0;
+}
+
+bool ChunkReader::NextLine(std::string& line)
+{
+  while (std::getline(stream, line, '\n'))
+  {
+    ++lineNumber;
+    boost::trim(line);
+
+    // Skip empty lines (and comments in ARFF files).
+    if (!line.empty() && !(arff && line[0] == '%'))
+      return true;
+  }
+
+  return false;
+}
+
+void ChunkReader::ParseLine(const std::string& line, double* point) const
+{
+  const char* position = line.c_str();
+  for (size_t i = 0; i < info.Dimensionality(); ++i)
+  {
+    // Skip the separator (and any whitespace around it).
+    while (*position == ' ' || *position == '\t' ||
+        (i > 0 && *position == ','))
+      ++position;
+
+    char* end;
+    point[i] = std::strtod(position, &end);
+    if (end == position)
+    {
+      std::ostringstream oss;
+      oss << "ChunkReader::Next(): parse error at line " << lineNumber
+          << " of '" << filename << "', value " << i << " (only numeric values "
+          << "can be read in blocks from this type of file)";
+      throw std::runtime_error(oss.str());
+    }
+    position = end;
+  }
+
+  while (*position == ' ' || *position == '\t' || *position == ',')
+    ++position;
+  if (*position != '\0')
+  {
+    std::ostringstream oss;
+    oss << "ChunkReader::Next(): too many values at line " << lineNumber
+        << " of '" << filename << "'";
+    throw std::runtime_error(oss.str());
+  }
+}
@@ -0,0 +1,115 @@
+/**
+ * @file chunk_reader.hpp
+ * @author agent
+ *
+ * Read a dataset from disk a fixed number of points at a time, for training
+ * streaming learners on datasets that do not fit in memory.
+ */
+#ifndef __MLPACK_CORE_DATA_CHUNK_READER_HPP
+#define __MLPACK_CORE_DATA_CHUNK_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <fstream>
+
+#include "dataset_info.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The ChunkReader reads a dataset from a text file in blocks of at most
+ * ChunkSize() points, so that only one block has to be in memory at a time.
+ * As with data::Load(), each line of the file is one point, and each block is
+ * returned as a matrix with one point per column.
+ *
+ * CSV, TSV, and text files (.csv, .tsv, .txt) must hold only numeric values.
+ * ARFF files (.arff) may have categorical ('string') attributes, which are
+ * mapped with the given DatasetInfo object; because a learner may need to know
+ * every category before it sees the first point (as the HoeffdingTree does),
+ * MapCategories() can be called first to map all of them in a pass over the
+ * file that keeps nothing but the mappings.
+ *
+ * @code
+ * data::DatasetInfo info;
+ * data::ChunkReader reader("dataset.arff", info, 10000);
+ * reader.MapCategories();
+ *
+ * arma::mat chunk;
+ * while (reader.Next(chunk))
+ * {
+ *   // Use the points in chunk.
+ * }
+ * @endcode
+ */
+class ChunkReader
+{
+ public:
+  /**
+   * Open the given file and read its header (if it is an ARFF file) or its
+   * first line (to find the dimensionality).  If info has dimensionality 0, it
+   * is set to the dimensionality of the data; otherwise, the dimensionality
+   * must match.  Errors are reported with exceptions, as in data::LoadARFF().
+   *
+   * @param filename File to read.
+   * @param info DatasetInfo to map categorical values with.
+   * @param chunkSize Maximum number of points returned by each call to Next().
+   */
+  ChunkReader(const std::string& filename,
+              DatasetInfo& info,
+              const size_t chunkSize);
+
+  /**
+   * Read the next block of at most ChunkSize() points; return false (and set
+   * chunk to an empty matrix) if there are no more points.
+   *
+   * @param chunk Matrix to store the points in (one point per column).
+   */
+  bool Next(arma::mat& chunk);
+
+  /**
+   * Map every categorical value in the rest of the file, then go back to the
+   * first point.  This does nothing if there are no categorical dimensions.
+   */
+  void MapCategories();
+
+  //! Go back to the first point.
+  void Rewind();
+
+  //! Get the dimensionality of the data.
+  size_t Dimensionality() const { return info.Dimensionality(); }
+  //! Get the maximum number of points in a block.
+  size_t ChunkSize() const { return chunkSize; }
+  //! Get the number of points read since the file was opened or rewound.
+  size_t PointsRead() const { return pointsRead; }
+
+ private:
+  //! Read the next non-empty line into line; return false at the end.
+  bool NextLine(std::string& line);
+
+  //! Parse a line of a CSV, TSV, or text file into the given point.
+  void ParseLine(const std::string& line, double* point) const;
+
+  //! Name of the file.
+  std::string filename;
+  //! The file.
+  std::ifstream stream;
+  //! The mappings of categorical dimensions.
+  DatasetInfo& info;
+  //! Maximum number of points in a block.
+  size_t chunkSize;
+  //! Whether the file is an ARFF file.
+  bool arff;
+  //! Position of the first point in the file.
+  std::streampos dataStart;
+  //! Number of the line before the first point.
+  size_t headerLines;
+  //! Number of the line last read.
+  size_t lineNumber;
+  //! Number of points read since the file was opened or rewound.
+  size_t pointsRead;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -17,7 +17,9 @@ enum format
   autodetect,
   text,
   xml,
-  binary
+  binary,
+  //! Binary, with arrays stored as aligned blocks (see block_archive.hpp).
+  block
 };
 
 } // namespace data
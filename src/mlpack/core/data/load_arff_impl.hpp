@@ -15,15 +15,8 @@
 namespace mlpack {
 namespace data {
 
-template<typename eT>
-void LoadARFF(const std::string& filename,
-              arma::Mat<eT>& matrix,
-              DatasetInfo& info)
+inline size_t ReadARFFHeader(std::istream& ifs, DatasetInfo& info)
 {
-  // First, open the file.
-  std::ifstream ifs;
-  ifs.open(filename);
-
   std::string line;
   size_t dimensionality = 0;
   std::vector<bool> types;
@@ -117,7 +110,98 @@ void LoadARFF(const std::string& filename,
       info.Type(i) = Datatype::numeric;
   }
 
+  return headerLines;
+}
+
+template<typename eT>
+void ParseARFFLine(const std::string& line,
+                   DatasetInfo& info,
+                   eT* point,
+                   const size_t lineNumber)
+{
+  // Each line of the @data section must be a CSV (except sparse data, which
+  // we will handle later).  So now we can tokenize the
+  // CSV and parse it.  The '?' representing a missing value is not allowed,
+  // so if that occurs we throw an exception.  We also throw an exception if
+  // any piece of data does not match its type (categorical or numeric).
+
+  // If the first character is {, it is sparse data, and we can just say this
+  // is not handled for now...
+  if (line[0] == '{')
+    throw std::runtime_error("cannot yet parse sparse ARFF data");
+
+  // Tokenize the line.
+  typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
+  boost::escaped_list_separator<char> sep("\\", ",", "\"");
+  Tokenizer tok(line, sep);
+
+  size_t col = 0;
+  std::stringstream token;
+  for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+  {
+    // Check that we are not too many columns in.
+    if (col >= info.Dimensionality())
+    {
+      std::stringstream error;
+      error << "Too many columns in line " << lineNumber << ".";
+      throw std::runtime_error(error.str());
+    }
+
+    // What should this token be?
+    if (info.Type(col) == Datatype::categorical)
+    {
+      point[col] = info.MapString(*it, col);
+    }
+    else if (info.Type(col) == Datatype::numeric)
+    {
+      // Attempt to read as numeric.
+      token.clear();
+      token.str(*it);
+
+      eT val = eT(0);
+      token >> val;
+
+      if (token.fail())
+      {
+        // Check for NaN or inf.
+        if (!arma::diskio::convert_naninf(val, token.str()))
+        {
+          // Okay, it's not NaN or inf.  If it's '?', we issue a specific
+          // error, otherwise we issue a general error.
+          std::stringstream error;
+          std::string tokenStr = token.str();
+          boost::trim(tokenStr);
+          if (tokenStr == "?")
+            error << "Missing values ('?') not supported, ";
+          else
+            error << "Parse error ";
+          error << "at line " << lineNumber << " token " << col
+              << ": \"" << tokenStr << "\".";
+          throw std::runtime_error(error.str());
+        }
+      }
+
+      // If we made it to here, we have a value.
+      point[col] = val;
+    }
+
+    ++col;
+  }
+}
+
+template<typename eT>
+void LoadARFF(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              DatasetInfo& info)
+{
+  // First, open the file.
+  std::ifstream ifs;
+  ifs.open(filename);
+
+  const size_t headerLines = ReadARFFHeader(ifs, info);
+
   // We need to find out how many lines of data are in the file.
+  std::string line;
   std::streampos pos = ifs.tellg();
   size_t row = 0;
   while (!ifs.eof())
@@ -133,82 +217,17 @@ void LoadARFF(const std::string& filename,
   ifs.seekg(pos);
 
   // Now, set the size of the matrix.
-  matrix.set_size(dimensionality, row);
+  matrix.set_size(info.Dimensionality(), row);
 
-  // Now we are looking at the @data section.
+  // Now we are looking at the @data section.  We load transposed, so each line
+  // is a column of the matrix.
   row = 0;
   while (!ifs.eof())
   {
     std::getline(ifs, line, '\n');
     boost::trim(line);
-    // Each line of the @data section must be a CSV (except sparse data, which
-    // we will handle later).  So now we can tokenize the
-    // CSV and parse it.  The '?' representing a missing value is not allowed,
-    // so if that occurs we throw an exception.  We also throw an exception if
-    // any piece of data does not match its type (categorical or numeric).
-
-    // If the first character is {, it is sparse data, and we can just say this
-    // is not handled for now...
-    if (line[0] == '{')
-      throw std::runtime_error("cannot yet parse sparse ARFF data");
-
-    // Tokenize the line.
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep("\\", ",", "\"");
-    Tokenizer tok(line, sep);
-
-    size_t col = 0;
-    std::stringstream token;
-    for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
-    {
-      // Check that we are not too many columns in.
-      if (col >= matrix.n_rows)
-      {
-        std::stringstream error;
-        error << "Too many columns in line " << (headerLines + row) << ".";
-        throw std::runtime_error(error.str());
-      }
-
-      // What should this token be?
-      if (info.Type(col) == Datatype::categorical)
-      {
-        matrix(col, row) = info.MapString(*it, col); // We load transposed.
-      }
-      else if (info.Type(col) == Datatype::numeric)
-      {
-        // Attempt to read as numeric.
-        token.clear();
-        token.str(*it);
 
-        eT val = eT(0);
-        token >> val;
-
-        if (token.fail())
-        {
-          // Check for NaN or inf.
-          if (!arma::diskio::convert_naninf(val, token.str()))
-          {
-            // Okay, it's not NaN or inf.  If it's '?', we issue a specific
-            // error, otherwise we issue a general error.
-            std::stringstream error;
-            std::string tokenStr = token.str();
-            boost::trim(tokenStr);
-            if (tokenStr == "?")
-              error << "Missing values ('?') not supported, ";
-            else
-              error << "Parse error ";
-            error << "at line " << (headerLines + row) << " token " << col
-                << ": \"" << tokenStr << "\".";
-            throw std::runtime_error(error.str());
-          }
-        }
-
-        // If we made it to here, we have a value.
-        matrix(col, row) = val; // We load transposed.
-      }
-
-      ++col;
-    }
+    ParseARFFLine(line, info, matrix.colptr(row), headerLines + row);
     ++row;
   }
 }
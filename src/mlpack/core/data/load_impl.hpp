@@ -19,6 +19,8 @@
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
+
+#include "block_archive.hpp"
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
 
@@ -515,6 +517,8 @@ bool Load(const std::string& filename,
       f = format::xml;
     else if (extension == "bin")
       f = format::binary;
+    else if (extension == "blk")
+      f = format::block;
     else if (extension == "txt")
       f = format::text;
     else
@@ -530,10 +534,38 @@ bool Load(const std::string& filename,
     }
   }
 
+  // The block format is read straight out of a memory mapping of the file, if
+  // the file can be mapped.
+  if (f == format::block)
+  {
+    MappedFile file(filename);
+    if (file.IsOpen())
+    {
+      try
+      {
+        MappedBuffer buffer(file.Data(), file.Size());
+        std::istream stream(&buffer);
+        BlockIArchive ar(stream);
+        ar >> CreateNVP(t, name);
+
+        return true;
+      }
+      catch (boost::archive::archive_exception& e)
+      {
+        if (fatal)
+          Log::Fatal << e.what() << std::endl;
+        else
+          Log::Warn << e.what() << std::endl;
+
+        return false;
+      }
+    }
+  }
+
   // Now load the given format.
   std::ifstream ifs;
 #ifdef _WIN32 // Open non-text in binary mode on Windows.
-  if (f == format::binary)
+  if (f == format::binary || f == format::block)
     ifs.open(filename, std::ifstream::in | std::ifstream::binary);
   else
     ifs.open(filename, std::ifstream::in);
@@ -570,6 +602,11 @@ bool Load(const std::string& filename,
       boost::archive::binary_iarchive ar(ifs);
       ar >> CreateNVP(t, name);
     }
+    else if (f == format::block)
+    {
+      BlockIArchive ar(ifs);
+      ar >> CreateNVP(t, name);
+    }
 
     return true;
   }
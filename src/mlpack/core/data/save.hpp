@@ -64,9 +64,12 @@ bool Save(const std::string& filename,
  *  - text, denoted by .txt
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - block, denoted by .blk (binary, with the contents of matrices stored as
+ *    aligned blocks, which is much faster to load for large models)
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary', and
+ * 'format::block'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
@@ -16,6 +16,8 @@
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 
+#include "block_archive.hpp"
+
 #include "serialization_shim.hpp"
 
 namespace mlpack {
@@ -185,16 +187,18 @@ bool Save(const std::string& filename,
       f = format::xml;
     else if (extension == "bin")
       f = format::binary;
+    else if (extension == "blk")
+      f = format::block;
     else if (extension == "txt")
       f = format::text;
     else
     {
       if (fatal)
         Log::Fatal << "Unable to detect type of '" << filename << "'; incorrect"
-            << " extension? (allowed: xml/bin/txt)" << std::endl;
+            << " extension? (allowed: xml/bin/blk/txt)" << std::endl;
       else
         Log::Warn << "Unable to detect type of '" << filename << "'; save "
-            << "failed.  Incorrect extension? (allowed: xml/bin/txt)"
+            << "failed.  Incorrect extension? (allowed: xml/bin/blk/txt)"
             << std::endl;
 
       return false;
@@ -204,7 +208,8 @@ bool Save(const std::string& filename,
   // Open the file to save to.
   std::ofstream ofs;
 #ifdef _WIN32
-  if (f == format::binary) // Open non-text types in binary mode on Windows.
+  // Open non-text types in binary mode on Windows.
+  if (f == format::binary || f == format::block)
     ofs.open(filename, std::ofstream::out | std::ofstream::binary);
   else
     ofs.open(filename, std::ofstream::out);
@@ -241,6 +246,11 @@ bool Save(const std::string& filename,
       boost::archive::binary_oarchive ar(ofs);
       ar << CreateNVP(t, name);
     }
+    else if (f == format::block)
+    {
+      BlockOArchive ar(ofs);
+      ar << CreateNVP(t, name);
+    }
 
     return true;
   }
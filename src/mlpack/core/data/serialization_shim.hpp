@@ -13,6 +13,7 @@
 
 #include <mlpack/core/util/sfinae_utility.hpp>
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/version.hpp>
 #include <boost/archive/xml_oarchive.hpp>
 
 namespace mlpack {
@@ -499,6 +500,29 @@ inline void serialize(Archive& ar,
   tptr->Serialize(ar, version);
 }
 
+/**
+ * boost::serialization sees the shims, not the objects they wrap, so the
+ * version of a shim is the version of the wrapped type.  A class can then set
+ * its version by specializing boost::serialization::version, and its
+ * Serialize() method will be given the version of the object being loaded.
+ */
+template<typename T>
+struct version<mlpack::data::SecondShim<T>>
+{
+  typedef typename version<T>::type type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+//! The version of a PointerShim is the version of the wrapped type.
+template<typename T>
+struct version<mlpack::data::PointerShim<T>>
+{
+  typedef typename version<T>::type type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
 } // namespace serialization
 } // namespace boost
 
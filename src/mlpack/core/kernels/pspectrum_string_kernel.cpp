@@ -79,5 +79,50 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
     }
   }
 
-  Log::Info << "Substring extraction complete." << std::endl;
+  // Give each distinct substring an ID.  The IDs are assigned in alphabetical
+  // order, which is also the order in which each map is traversed, so the IDs
+  // of the substrings of each string come out sorted.
+  map<string, size_t> ids;
+  for (size_t dataset = 0; dataset < counts.size(); ++dataset)
+  {
+    for (size_t index = 0; index < counts[dataset].size(); ++index)
+    {
+      map<string, int>::const_iterator it = counts[dataset][index].begin();
+      for ( ; it != counts[dataset][index].end(); ++it)
+        ids[it->first] = 0;
+    }
+  }
+
+  size_t id = 0;
+  for (map<string, size_t>::iterator it = ids.begin(); it != ids.end(); ++it)
+    it->second = id++;
+
+  // Now assemble the sparse p-spectrum of each string.
+  spectra.resize(counts.size());
+  for (size_t dataset = 0; dataset < counts.size(); ++dataset)
+  {
+    size_t nonzeros = 0;
+    for (size_t index = 0; index < counts[dataset].size(); ++index)
+      nonzeros += counts[dataset][index].size();
+
+    arma::umat locations(2, nonzeros);
+    arma::vec values(nonzeros);
+    size_t i = 0;
+    for (size_t index = 0; index < counts[dataset].size(); ++index)
+    {
+      map<string, int>::const_iterator it = counts[dataset][index].begin();
+      for ( ; it != counts[dataset][index].end(); ++it, ++i)
+      {
+        locations(0, i) = ids[it->first];
+        locations(1, i) = index;
+        values[i] = it->second;
+      }
+    }
+
+    spectra[dataset] = arma::sp_mat(locations, values, ids.size(),
+        counts[dataset].size());
+  }
+
+  Log::Info << "Substring extraction complete; " << ids.size() << " distinct "
+      << "substrings found." << std::endl;
 }
@@ -55,6 +55,14 @@ namespace kernel {
  * the data according to the fake data matrix -- resulting in a meaningless
  * tree.  This kernel was originally written for the FastMKS method; so, at the
  * very least, it will work with that.
+ *
+ * At construction time, every distinct substring of length p in the datasets
+ * is given an integer ID, and the p-spectrum of each string is stored as a
+ * sparse vector of substring counts, indexed by ID (see Spectra()).  Because
+ * the nonzero elements of a sparse vector are stored in order of their IDs, an
+ * evaluation of the kernel is a single linear merge of two arrays.  To evaluate
+ * the kernel between one string and many others, use the batch overload of
+ * Evaluate(), which is faster still.
  */
 class PSpectrumStringKernel
 {
@@ -83,6 +91,23 @@ class PSpectrumStringKernel
   template<typename VecType>
   double Evaluate(const VecType& a, const VecType& b) const;
 
+  /**
+   * Evaluate the kernel between one string and each of a set of strings, in
+   * parallel.  a is a 2-element vector as in the other overload of Evaluate(),
+   * and each column of b is a 2-element vector representing a string in the
+   * same way.  The counts of the substrings of a are scattered into a dense
+   * vector once, so each evaluation only takes time linear in the number of
+   * distinct substrings of the other string.
+   *
+   * @param a Index of string and dataset for the query string.
+   * @param b Indices of strings and datasets for the other strings (one per
+   *     column).
+   * @param results Vector to store the kernel evaluations in.
+   */
+  template<typename VecType>
+  void Evaluate(const VecType& a, const arma::mat& b, arma::vec& results)
+      const;
+
   //! Access the lists of substrings.
   const std::vector<std::vector<std::map<std::string, int> > >& Counts() const
   { return counts; }
@@ -90,6 +115,18 @@ class PSpectrumStringKernel
   std::vector<std::vector<std::map<std::string, int> > >& Counts()
   { return counts; }
 
+  /**
+   * Access the p-spectra of the strings: column j of Spectra()[i] holds the
+   * counts of the substrings of datasets[i][j], where row k corresponds to the
+   * substring with ID k.  The spectra are built from Counts() at construction
+   * time; modifying Counts() afterwards does not change them.
+   */
+  const std::vector<arma::sp_mat>& Spectra() const { return spectra; }
+
+  //! Get the number of distinct substrings of length p in the datasets.
+  size_t NumSubstrings() const
+  { return spectra.empty() ? 0 : spectra[0].n_rows; }
+
   //! Access the value of p.
   size_t P() const { return p; }
   //! Modify the value of p.
@@ -103,6 +140,9 @@ class PSpectrumStringKernel
   //! is not wonderful...
   std::vector<std::vector<std::map<std::string, int> > > counts;
 
+  //! The p-spectrum of each string in each dataset, indexed by substring ID.
+  std::vector<arma::sp_mat> spectra;
+
   //! The value of p to use in calculation.
   size_t p;
 };
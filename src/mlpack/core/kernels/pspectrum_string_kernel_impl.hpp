@@ -31,44 +31,73 @@ template<typename VecType>
 double PSpectrumStringKernel::Evaluate(const VecType& a,
                                        const VecType& b) const
 {
-  // Get the map of substrings for the two strings we are interested in.
-  const std::map<std::string, int>& aMap = counts[a[0]][a[1]];
-  const std::map<std::string, int>& bMap = counts[b[0]][b[1]];
+  // Get the spectra of the two strings we are interested in.
+  const arma::sp_mat& aSet = spectra[(size_t) a[0]];
+  const arma::sp_mat& bSet = spectra[(size_t) b[0]];
+  const size_t aCol = (size_t) a[1];
+  const size_t bCol = (size_t) b[1];
 
-  double eval = 0;
-
-  // Loop through the two maps (which, when iterated through, are sorted
-  // alphabetically).
-  std::map<std::string, int>::const_iterator aIt = aMap.begin();
-  std::map<std::string, int>::const_iterator bIt = bMap.begin();
+  // The nonzero elements of each column are stored contiguously, in order of
+  // substring ID, so we can merge the two lists.
+  size_t aIndex = aSet.col_ptrs[aCol];
+  size_t bIndex = bSet.col_ptrs[bCol];
+  const size_t aEnd = aSet.col_ptrs[aCol + 1];
+  const size_t bEnd = bSet.col_ptrs[bCol + 1];
 
-  while ((aIt != aMap.end()) && (bIt != bMap.end()))
+  double eval = 0;
+  while ((aIndex < aEnd) && (bIndex < bEnd))
   {
-    // Compare alphabetically (this is how std::map is ordered).
-    int result = (*aIt).first.compare((*bIt).first);
+    const arma::uword aId = aSet.row_indices[aIndex];
+    const arma::uword bId = bSet.row_indices[bIndex];
 
-    if (result == 0) // The same substring.
-    {
-      eval += ((*aIt).second * (*bIt).second);
-
-      // Now increment both.
-      ++aIt;
-      ++bIt;
-    }
-    else if (result > 0)
-    {
-      // aIt is "ahead" of bIt (alphabetically); so increment bIt to "catch up".
-      ++bIt;
-    }
+    if (aId == bId) // The same substring.
+      eval += aSet.values[aIndex++] * bSet.values[bIndex++];
+    else if (aId < bId)
+      ++aIndex; // aIndex is behind, so let it catch up.
     else
-    {
-      // bIt is "ahead" of aIt (alphabetically); so increment aIt to "catch up".
-      ++aIt;
-    }
+      ++bIndex; // bIndex is behind, so let it catch up.
   }
 
   return eval;
 }
+
+/**
+ * Evaluate the kernel between one string and each of a set of strings, in
+ * parallel.
+ *
+ * @param a Index of string and dataset for the query string.
+ * @param b Indices of strings and datasets for the other strings.
+ * @param results Vector to store the kernel evaluations in.
+ */
+template<typename VecType>
+void PSpectrumStringKernel::Evaluate(const VecType& a,
+                                     const arma::mat& b,
+                                     arma::vec& results) const
+{
+  results.set_size(b.n_cols);
+
+  // Scatter the counts of the query string into a dense vector.
+  const arma::sp_mat& aSet = spectra[(size_t) a[0]];
+  const size_t aCol = (size_t) a[1];
+  arma::vec aCounts(NumSubstrings(), arma::fill::zeros);
+  for (size_t i = aSet.col_ptrs[aCol]; i < aSet.col_ptrs[aCol + 1]; ++i)
+    aCounts[aSet.row_indices[i]] = aSet.values[i];
+
+  // Now each evaluation is a gather over the substrings of the other string.
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    const arma::sp_mat& bSet = spectra[(size_t) b(0, j)];
+    const size_t bCol = (size_t) b(1, j);
+
+    double eval = 0;
+    for (size_t i = bSet.col_ptrs[bCol]; i < bSet.col_ptrs[bCol + 1]; ++i)
+      eval += aCounts[bSet.row_indices[i]] * bSet.values[i];
+
+    results[j] = eval;
+  }
+}
+
 } // namespace kernel
 } // namespace mlpack
 
@@ -48,6 +48,13 @@ namespace metric {
  *  - EuclideanDistance
  *  - SquaredEuclideanDistance
  *
+ * For the Manhattan, (squared) Euclidean, and Chebyshev distances, when both
+ * vectors are dense and of the same element type (double or float), Evaluate()
+ * uses explicitly vectorized kernels (AVX2 or AVX-512, chosen at runtime
+ * depending on what the CPU supports; see lmetric_simd.hpp).  Vectors of
+ * different element types (such as a float point and a double centroid) may
+ * also be given.
+ *
  * @tparam Power Power of metric; i.e. Power = 1 gives the L1-norm (Manhattan
  *    distance).
  * @tparam TakeRoot If true, the Power'th root of the result is taken before it
@@ -67,7 +74,7 @@ class LMetric
   /**
    * Computes the distance between two points.
    *
-   * @tparam VecTypeA Type of first vector (generally arma::vec or
+   * @tparam VecTypeA Type of first vector (generally arma::vec, arma::fvec, or
    *      arma::sp_vec).
    * @tparam VecTypeB Type of second vector.
    * @param a First vector.
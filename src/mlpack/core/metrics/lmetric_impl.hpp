@@ -10,6 +10,9 @@
 // In case it hasn't been included.
 #include "lmetric.hpp"
 
+// Vectorized kernels for the common cases.
+#include "lmetric_simd.hpp"
+
 namespace mlpack {
 namespace metric {
 
@@ -29,34 +32,35 @@ double LMetric<Power, TakeRoot>::Evaluate(const VecTypeA& a,
   return pow(sum, (1.0 / Power));
 }
 
-// L1-metric specializations; the root doesn't matter.
+// L1-metric specializations; the root doesn't matter.  When possible, these use
+// vectorized kernels.
 template<>
 template<typename VecTypeA, typename VecTypeB>
 double LMetric<1, true>::Evaluate(const VecTypeA& a, const VecTypeB& b)
 {
-  return accu(abs(a - b));
+  return simd::L1(a, b);
 }
 
 template<>
 template<typename VecTypeA, typename VecTypeB>
 double LMetric<1, false>::Evaluate(const VecTypeA& a, const VecTypeB& b)
 {
-  return accu(abs(a - b));
+  return simd::L1(a, b);
 }
 
-// L2-metric specializations.
+// L2-metric specializations.  When possible, these use vectorized kernels.
 template<>
 template<typename VecTypeA, typename VecTypeB>
 double LMetric<2, true>::Evaluate(const VecTypeA& a, const VecTypeB& b)
 {
-  return sqrt(accu(square(a - b)));
+  return sqrt(simd::SquaredL2(a, b));
 }
 
 template<>
 template<typename VecTypeA, typename VecTypeB>
 double LMetric<2, false>::Evaluate(const VecTypeA& a, const VecTypeB& b)
 {
-  return accu(square(a - b));
+  return simd::SquaredL2(a, b);
 }
 
 // L3-metric specialization (not very likely to be used, but just in case).
@@ -83,7 +87,7 @@ template<>
 template<typename VecTypeA, typename VecTypeB>
 double LMetric<INT_MAX, false>::Evaluate(const VecTypeA& a, const VecTypeB& b)
 {
-  return arma::as_scalar(max(abs(a - b)));
+  return simd::LInf(a, b);
 }
 
 } // namespace metric
@@ -0,0 +1,359 @@
+/**
+ * @file lmetric_simd.cpp
+ * @author agent
+ *
+ * Implementation of the vectorized L-metric kernels and the runtime selection
+ * of the instruction set to use.
+ */
+#include "lmetric_simd.hpp"
+
+// The AVX2 and AVX-512 kernels are compiled with function-level target
+// attributes, so that mlpack itself does not need to be compiled with -mavx2
+// (which would make it unusable on older CPUs).  This is only supported by
+// GCC-like compilers on x86.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define MLPACK_LMETRIC_SIMD_X86
+  #include <immintrin.h>
+#endif
+
+namespace mlpack {
+namespace metric {
+namespace simd {
+
+namespace {
+
+//! The set of kernels in use.
+struct Kernels
+{
+  double (*squaredL2Double)(const double*, const double*, const size_t);
+  double (*squaredL2Float)(const float*, const float*, const size_t);
+  double (*l1Double)(const double*, const double*, const size_t);
+  double (*l1Float)(const float*, const float*, const size_t);
+  double (*lInfDouble)(const double*, const double*, const size_t);
+  double (*lInfFloat)(const float*, const float*, const size_t);
+  const char* name;
+};
+
+#ifdef MLPACK_LMETRIC_SIMD_X86
+
+// Some versions of GCC give spurious warnings about uninitialized variables
+// inside the AVX-512 intrinsics (which use _mm512_undefined_pd() and friends).
+#if !defined(__clang__)
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wuninitialized"
+  #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+//
+// AVX2 kernels.  Each handles four doubles (or eight floats) per step, and the
+// remaining elements with scalar code.
+//
+
+__attribute__((target("avx2,fma")))
+double Avx2SquaredL2(const double* a, const double* b, const size_t n)
+{
+  __m256d sum = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(a + i),
+        _mm256_loadu_pd(b + i));
+    sum = _mm256_fmadd_pd(diff, diff, sum);
+  }
+
+  double lanes[4];
+  _mm256_storeu_pd(lanes, sum);
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) +
+      ScalarSquaredL2(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2,fma")))
+double Avx2SquaredL2(const float* a, const float* b, const size_t n)
+{
+  __m256 sum = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(a + i),
+        _mm256_loadu_ps(b + i));
+    sum = _mm256_fmadd_ps(diff, diff, sum);
+  }
+
+  float lanes[8];
+  _mm256_storeu_ps(lanes, sum);
+  double result = 0;
+  for (size_t j = 0; j < 8; ++j)
+    result += lanes[j];
+  return result + ScalarSquaredL2(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+double Avx2L1(const double* a, const double* b, const size_t n)
+{
+  // Clearing the sign bit gives the absolute value.
+  const __m256d signMask = _mm256_set1_pd(-0.0);
+  __m256d sum = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(a + i),
+        _mm256_loadu_pd(b + i));
+    sum = _mm256_add_pd(sum, _mm256_andnot_pd(signMask, diff));
+  }
+
+  double lanes[4];
+  _mm256_storeu_pd(lanes, sum);
+  return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) +
+      ScalarL1(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+double Avx2L1(const float* a, const float* b, const size_t n)
+{
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+  __m256 sum = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(a + i),
+        _mm256_loadu_ps(b + i));
+    sum = _mm256_add_ps(sum, _mm256_andnot_ps(signMask, diff));
+  }
+
+  float lanes[8];
+  _mm256_storeu_ps(lanes, sum);
+  double result = 0;
+  for (size_t j = 0; j < 8; ++j)
+    result += lanes[j];
+  return result + ScalarL1(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2")))
+double Avx2LInf(const double* a, const double* b, const size_t n)
+{
+  const __m256d signMask = _mm256_set1_pd(-0.0);
+  __m256d result = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    const __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(a + i),
+        _mm256_loadu_pd(b + i));
+    result = _mm256_max_pd(result, _mm256_andnot_pd(signMask, diff));
+  }
+
+  double lanes[4];
+  _mm256_storeu_pd(lanes, result);
+  return std::max(std::max(std::max(lanes[0], lanes[1]),
+      std::max(lanes[2], lanes[3])), ScalarLInf(a + i, b + i, n - i));
+}
+
+__attribute__((target("avx2")))
+double Avx2LInf(const float* a, const float* b, const size_t n)
+{
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+  __m256 result = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(a + i),
+        _mm256_loadu_ps(b + i));
+    result = _mm256_max_ps(result, _mm256_andnot_ps(signMask, diff));
+  }
+
+  float lanes[8];
+  _mm256_storeu_ps(lanes, result);
+  double max = ScalarLInf(a + i, b + i, n - i);
+  for (size_t j = 0; j < 8; ++j)
+    max = std::max(max, (double) lanes[j]);
+  return max;
+}
+
+//
+// AVX-512 kernels.  Each handles eight doubles (or sixteen floats) per step.
+//
+
+__attribute__((target("avx512f")))
+double Avx512SquaredL2(const double* a, const double* b, const size_t n)
+{
+  __m512d sum = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m512d diff = _mm512_sub_pd(_mm512_loadu_pd(a + i),
+        _mm512_loadu_pd(b + i));
+    sum = _mm512_fmadd_pd(diff, diff, sum);
+  }
+
+  return _mm512_reduce_add_pd(sum) + ScalarSquaredL2(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+double Avx512SquaredL2(const float* a, const float* b, const size_t n)
+{
+  __m512 sum = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    const __m512 diff = _mm512_sub_ps(_mm512_loadu_ps(a + i),
+        _mm512_loadu_ps(b + i));
+    sum = _mm512_fmadd_ps(diff, diff, sum);
+  }
+
+  return (double) _mm512_reduce_add_ps(sum) +
+      ScalarSquaredL2(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+double Avx512L1(const double* a, const double* b, const size_t n)
+{
+  __m512d sum = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m512d diff = _mm512_sub_pd(_mm512_loadu_pd(a + i),
+        _mm512_loadu_pd(b + i));
+    sum = _mm512_add_pd(sum, _mm512_abs_pd(diff));
+  }
+
+  return _mm512_reduce_add_pd(sum) + ScalarL1(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+double Avx512L1(const float* a, const float* b, const size_t n)
+{
+  __m512 sum = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    const __m512 diff = _mm512_sub_ps(_mm512_loadu_ps(a + i),
+        _mm512_loadu_ps(b + i));
+    sum = _mm512_add_ps(sum, _mm512_abs_ps(diff));
+  }
+
+  return (double) _mm512_reduce_add_ps(sum) + ScalarL1(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx512f")))
+double Avx512LInf(const double* a, const double* b, const size_t n)
+{
+  __m512d result = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+  {
+    const __m512d diff = _mm512_sub_pd(_mm512_loadu_pd(a + i),
+        _mm512_loadu_pd(b + i));
+    result = _mm512_max_pd(result, _mm512_abs_pd(diff));
+  }
+
+  return std::max(_mm512_reduce_max_pd(result),
+      ScalarLInf(a + i, b + i, n - i));
+}
+
+__attribute__((target("avx512f")))
+double Avx512LInf(const float* a, const float* b, const size_t n)
+{
+  __m512 result = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    const __m512 diff = _mm512_sub_ps(_mm512_loadu_ps(a + i),
+        _mm512_loadu_ps(b + i));
+    result = _mm512_max_ps(result, _mm512_abs_ps(diff));
+  }
+
+  return std::max((double) _mm512_reduce_max_ps(result),
+      ScalarLInf(a + i, b + i, n - i));
+}
+
+#if !defined(__clang__)
+  #pragma GCC diagnostic pop
+#endif
+
+#endif // MLPACK_LMETRIC_SIMD_X86
+
+//! Choose the best set of kernels the CPU supports.
+Kernels SelectKernels()
+{
+  Kernels kernels;
+  kernels.squaredL2Double = &ScalarSquaredL2<double>;
+  kernels.squaredL2Float = &ScalarSquaredL2<float>;
+  kernels.l1Double = &ScalarL1<double>;
+  kernels.l1Float = &ScalarL1<float>;
+  kernels.lInfDouble = &ScalarLInf<double>;
+  kernels.lInfFloat = &ScalarLInf<float>;
+  kernels.name = "scalar";
+
+#ifdef MLPACK_LMETRIC_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+  {
+    kernels.squaredL2Double = &Avx512SquaredL2;
+    kernels.squaredL2Float = &Avx512SquaredL2;
+    kernels.l1Double = &Avx512L1;
+    kernels.l1Float = &Avx512L1;
+    kernels.lInfDouble = &Avx512LInf;
+    kernels.lInfFloat = &Avx512LInf;
+    kernels.name = "avx512";
+  }
+  else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+  {
+    kernels.squaredL2Double = &Avx2SquaredL2;
+    kernels.squaredL2Float = &Avx2SquaredL2;
+    kernels.l1Double = &Avx2L1;
+    kernels.l1Float = &Avx2L1;
+    kernels.lInfDouble = &Avx2LInf;
+    kernels.lInfFloat = &Avx2LInf;
+    kernels.name = "avx2";
+  }
+#endif
+
+  return kernels;
+}
+
+//! Get the kernels to use; they are selected the first time this is called.
+const Kernels& GetKernels()
+{
+  static const Kernels kernels = SelectKernels();
+  return kernels;
+}
+
+} // anonymous namespace
+
+double SquaredL2(const double* a, const double* b, const size_t n)
+{
+  return GetKernels().squaredL2Double(a, b, n);
+}
+
+double SquaredL2(const float* a, const float* b, const size_t n)
+{
+  return GetKernels().squaredL2Float(a, b, n);
+}
+
+double L1(const double* a, const double* b, const size_t n)
+{
+  return GetKernels().l1Double(a, b, n);
+}
+
+double L1(const float* a, const float* b, const size_t n)
+{
+  return GetKernels().l1Float(a, b, n);
+}
+
+double LInf(const double* a, const double* b, const size_t n)
+{
+  return GetKernels().lInfDouble(a, b, n);
+}
+
+double LInf(const float* a, const float* b, const size_t n)
+{
+  return GetKernels().lInfFloat(a, b, n);
+}
+
+const char* InstructionSet()
+{
+  return GetKernels().name;
+}
+
+} // namespace simd
+} // namespace metric
+} // namespace mlpack
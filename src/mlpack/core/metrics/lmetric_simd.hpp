@@ -0,0 +1,285 @@
+/**
+ * @file lmetric_simd.hpp
+ * @author agent
+ *
+ * Explicitly vectorized kernels for the most common L-metrics (squared
+ * Euclidean, Manhattan, and Chebyshev distance), on contiguous double and
+ * float data.  The instruction set (AVX-512, AVX2, or plain scalar code) is
+ * chosen at runtime, the first time a kernel is called, based on what the CPU
+ * supports.
+ *
+ * The LMetric class uses these kernels automatically whenever both vectors are
+ * dense, contiguous, and of the same element type; otherwise it falls back to
+ * Armadillo expressions.
+ */
+#ifndef __MLPACK_CORE_METRICS_LMETRIC_SIMD_HPP
+#define __MLPACK_CORE_METRICS_LMETRIC_SIMD_HPP
+
+#include <mlpack/core.hpp>
+#include <type_traits>
+
+namespace mlpack {
+namespace metric {
+namespace simd /** Vectorized distance kernels. */ {
+
+/**
+ * Vectors with fewer elements than this are handled with inline scalar code,
+ * because for them the cost of calling the dispatched kernel is larger than
+ * the gain from vectorization.
+ */
+static const size_t SmallDimension = 16;
+
+//! Compute the squared Euclidean distance between two arrays of length n.
+double SquaredL2(const double* a, const double* b, const size_t n);
+//! Compute the squared Euclidean distance between two arrays of length n.
+double SquaredL2(const float* a, const float* b, const size_t n);
+
+//! Compute the Manhattan distance between two arrays of length n.
+double L1(const double* a, const double* b, const size_t n);
+//! Compute the Manhattan distance between two arrays of length n.
+double L1(const float* a, const float* b, const size_t n);
+
+//! Compute the Chebyshev distance between two arrays of length n.
+double LInf(const double* a, const double* b, const size_t n);
+//! Compute the Chebyshev distance between two arrays of length n.
+double LInf(const float* a, const float* b, const size_t n);
+
+/**
+ * Return the name of the instruction set the kernels are using ("avx512",
+ * "avx2", or "scalar").
+ */
+const char* InstructionSet();
+
+//! Scalar squared Euclidean distance, used for small vectors and vectors of
+//! different element types.
+template<typename eTA, typename eTB>
+inline double ScalarSquaredL2(const eTA* a, const eTB* b, const size_t n)
+{
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double diff = (double) a[i] - (double) b[i];
+    sum += diff * diff;
+  }
+  return sum;
+}
+
+//! Scalar Manhattan distance, used for small vectors and vectors of different
+//! element types.
+template<typename eTA, typename eTB>
+inline double ScalarL1(const eTA* a, const eTB* b, const size_t n)
+{
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i)
+    sum += std::fabs((double) a[i] - (double) b[i]);
+  return sum;
+}
+
+//! Scalar Chebyshev distance, used for small vectors and vectors of different
+//! element types.
+template<typename eTA, typename eTB>
+inline double ScalarLInf(const eTA* a, const eTB* b, const size_t n)
+{
+  double result = 0;
+  for (size_t i = 0; i < n; ++i)
+    result = std::max(result, std::fabs((double) a[i] - (double) b[i]));
+  return result;
+}
+
+/**
+ * Utility struct where Value is true if and only if the vector type is stored
+ * contiguously in memory; Memptr() then gives the start of the storage.
+ */
+template<typename VecType>
+struct DenseVector
+{
+  static const bool Value = false;
+};
+
+//! Specialization for columns.
+template<typename eT>
+struct DenseVector<arma::Col<eT>>
+{
+  static const bool Value = true;
+  static const eT* Memptr(const arma::Col<eT>& v) { return v.memptr(); }
+};
+
+//! Specialization for rows.
+template<typename eT>
+struct DenseVector<arma::Row<eT>>
+{
+  static const bool Value = true;
+  static const eT* Memptr(const arma::Row<eT>& v) { return v.memptr(); }
+};
+
+//! Specialization for column views (such as matrix.unsafe_col(i) or
+//! matrix.col(i)).
+template<typename eT>
+struct DenseVector<arma::subview_col<eT>>
+{
+  static const bool Value = true;
+  static const eT* Memptr(const arma::subview_col<eT>& v) { return v.colmem; }
+};
+
+/**
+ * Utility struct where Value is true if the vectorized kernels can be used for
+ * the given two vector types: both must be dense, with the same element type,
+ * which must be double or float.
+ */
+template<typename VecTypeA, typename VecTypeB>
+struct UseKernel
+{
+  typedef typename VecTypeA::elem_type ElemType;
+
+  static const bool Value = DenseVector<VecTypeA>::Value &&
+      DenseVector<VecTypeB>::Value &&
+      std::is_same<ElemType, typename VecTypeB::elem_type>::value &&
+      (std::is_same<ElemType, double>::value ||
+       std::is_same<ElemType, float>::value);
+};
+
+/**
+ * Utility struct where Value is true if the two vector types have different
+ * element types (for instance, a float data point and a double centroid).
+ * Armadillo expressions cannot mix element types, so these are handled with
+ * scalar code, after any Armadillo expressions (such as a - b or a subview)
+ * are evaluated.
+ */
+template<typename VecTypeA, typename VecTypeB>
+struct MixedTypes
+{
+  static const bool Value = !std::is_same<typename VecTypeA::elem_type,
+                                          typename VecTypeB::elem_type>::value;
+};
+
+//! Squared Euclidean distance between two dense vectors of the same type.
+template<typename VecTypeA, typename VecTypeB>
+inline typename std::enable_if<UseKernel<VecTypeA, VecTypeB>::Value,
+                               double>::type
+SquaredL2(const VecTypeA& a, const VecTypeB& b)
+{
+#ifdef DEBUG
+  Log::Assert(a.n_elem == b.n_elem);
+#endif
+  if (a.n_elem < SmallDimension)
+    return ScalarSquaredL2(DenseVector<VecTypeA>::Memptr(a),
+        DenseVector<VecTypeB>::Memptr(b), a.n_elem);
+
+  return SquaredL2(DenseVector<VecTypeA>::Memptr(a),
+      DenseVector<VecTypeB>::Memptr(b), a.n_elem);
+}
+
+//! Squared Euclidean distance between any other vectors of the same type.
+template<typename VecTypeA, typename VecTypeB>
+inline typename std::enable_if<!UseKernel<VecTypeA, VecTypeB>::Value &&
+                               !MixedTypes<VecTypeA, VecTypeB>::Value,
+                               double>::type
+SquaredL2(const VecTypeA& a, const VecTypeB& b)
+{
+  return accu(square(a - b));
+}
+
+//! Squared Euclidean distance between vectors of different element types.
+template<typename VecTypeA, typename VecTypeB>
+inline typename std::enable_if<MixedTypes<VecTypeA, VecTypeB>::Value,
+                               double>::type
+SquaredL2(const VecTypeA& a, const VecTypeB& b)
+{
+  // Evaluate any expressions first; this does not copy plain vectors.
+  const arma::unwrap<VecTypeA> ua(a);
+  const arma::unwrap<VecTypeB> ub(b);
+#ifdef DEBUG
+  Log::Assert(ua.M.n_elem == ub.M.n_elem);
+#endif
+  return ScalarSquaredL2(ua.M.memptr(), ub.M.memptr(), ua.M.n_elem);
+}
+
+//! Manhattan distance between two dense vectors of the same type.
+template<typename VecTypeA, typename VecTypeB>
+inline typename std::enable_if<UseKernel<VecTypeA, VecTypeB>::Value,
+                               double>::type
+L1(const VecTypeA& a, const VecTypeB& b)
+{
+#ifdef DEBUG
+  Log::Assert(a.n_elem == b.n_elem);
+#endif
+  if (a.n_elem < SmallDimension)
+    return ScalarL1(DenseVector<VecTypeA>::Memptr(a),
+        DenseVector<VecTypeB>::Memptr(b), a.n_elem);
+
+  return L1(DenseVector<VecTypeA>::Memptr(a),
+      DenseVector<VecTypeB>::Memptr(b), a.n_elem);
+}
+
+//! Manhattan distance between any other vectors of the same type.
+template<typename VecTypeA, typename VecTypeB>
+inline typename std::enable_if<!UseKernel<VecTypeA, VecTypeB>::Value &&
+                               !MixedTypes<VecTypeA, VecTypeB>::Value,
+                               double>::type
+L1(const VecTypeA& a, const VecTypeB& b)
+{
+  return accu(abs(a - b));
+}
+
+//! Manhattan distance between vectors of different element types.
+template<typename VecTypeA, typename VecTypeB>
+inline typename std::enable_if<MixedTypes<VecTypeA, VecTypeB>::Value,
+                               double>::type
+L1(const VecTypeA& a, const VecTypeB& b)
+{
+  // Evaluate any expressions first; this does not copy plain vectors.
+  const arma::unwrap<VecTypeA> ua(a);
+  const arma::unwrap<VecTypeB> ub(b);
+#ifdef DEBUG
+  Log::Assert(ua.M.n_elem == ub.M.n_elem);
+#endif
+  return ScalarL1(ua.M.memptr(), ub.M.memptr(), ua.M.n_elem);
+}
+
+//! Chebyshev distance between two dense vectors of the same type.
+template<typename VecTypeA, typename VecTypeB>
+inline typename std::enable_if<UseKernel<VecTypeA, VecTypeB>::Value,
+                               double>::type
+LInf(const VecTypeA& a, const VecTypeB& b)
+{
+#ifdef DEBUG
+  Log::Assert(a.n_elem == b.n_elem);
+#endif
+  if (a.n_elem < SmallDimension)
+    return ScalarLInf(DenseVector<VecTypeA>::Memptr(a),
+        DenseVector<VecTypeB>::Memptr(b), a.n_elem);
+
+  return LInf(DenseVector<VecTypeA>::Memptr(a),
+      DenseVector<VecTypeB>::Memptr(b), a.n_elem);
+}
+
+//! Chebyshev distance between any other vectors of the same type.
+template<typename VecTypeA, typename VecTypeB>
+inline typename std::enable_if<!UseKernel<VecTypeA, VecTypeB>::Value &&
+                               !MixedTypes<VecTypeA, VecTypeB>::Value,
+                               double>::type
+LInf(const VecTypeA& a, const VecTypeB& b)
+{
+  return arma::as_scalar(max(abs(a - b)));
+}
+
+//! Chebyshev distance between vectors of different element types.
+template<typename VecTypeA, typename VecTypeB>
+inline typename std::enable_if<MixedTypes<VecTypeA, VecTypeB>::Value,
+                               double>::type
+LInf(const VecTypeA& a, const VecTypeB& b)
+{
+  // Evaluate any expressions first; this does not copy plain vectors.
+  const arma::unwrap<VecTypeA> ua(a);
+  const arma::unwrap<VecTypeB> ub(b);
+#ifdef DEBUG
+  Log::Assert(ua.M.n_elem == ub.M.n_elem);
+#endif
+  return ScalarLInf(ua.M.memptr(), ub.M.memptr(), ua.M.n_elem);
+}
+
+} // namespace simd
+} // namespace metric
+} // namespace mlpack
+
+#endif
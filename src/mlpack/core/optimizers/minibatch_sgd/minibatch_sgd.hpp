@@ -62,6 +62,22 @@ namespace optimization {
  * function on the first point in the dataset (presumably, the dataset is held
  * internally in the DecomposableFunctionType).
  *
+ * Optionally, the class may also implement overloads that handle a whole
+ * mini-batch of functions [begin, begin + batchSize) at once:
+ *
+ *   double Evaluate(const arma::mat& coordinates,
+ *                   const size_t begin,
+ *                   const size_t batchSize);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t begin,
+ *                 arma::mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * These should return the sum of the objectives (or store the sum of the
+ * gradients) over the batch.  If they are available, they are used in place of
+ * one call per function; this allows the function to share work (such as
+ * transforming the dataset) across the mini-batch.
+ *
  * @tparam DecomposableFunctionType Decomposable objective function type to be
  *     minimized.
  */
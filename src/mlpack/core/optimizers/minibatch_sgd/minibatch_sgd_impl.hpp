@@ -10,9 +10,115 @@
 // In case it hasn't been included yet.
 #include "minibatch_sgd.hpp"
 
+#include <mlpack/core/util/sfinae_utility.hpp>
+
 namespace mlpack {
 namespace optimization {
 
+// These give us HasBatchGradientCheck<T, U> and HasBatchEvaluateCheck<T, U>
+// types (where U is a function pointer) we can use with SFINAE to catch when a
+// function has Gradient() and Evaluate() overloads for a batch of points.
+HAS_MEM_FUNC(Gradient, HasBatchGradientCheck);
+HAS_MEM_FUNC(Evaluate, HasBatchEvaluateCheck);
+
+//! Utility struct where value is true if and only if the function has a
+//! Gradient(const arma::mat&, const size_t, arma::mat&, const size_t) function
+//! (const or not).
+template<typename FunctionType>
+struct HasBatchGradient
+{
+  static const bool value = HasBatchGradientCheck<FunctionType,
+      void(FunctionType::*)(const arma::mat&, const size_t, arma::mat&,
+                            const size_t)>::value ||
+      HasBatchGradientCheck<FunctionType,
+      void(FunctionType::*)(const arma::mat&, const size_t, arma::mat&,
+                            const size_t) const>::value;
+};
+
+//! Utility struct where value is true if and only if the function has an
+//! Evaluate(const arma::mat&, const size_t, const size_t) function (const or
+//! not).
+template<typename FunctionType>
+struct HasBatchEvaluate
+{
+  static const bool value = HasBatchEvaluateCheck<FunctionType,
+      double(FunctionType::*)(const arma::mat&, const size_t,
+                              const size_t)>::value ||
+      HasBatchEvaluateCheck<FunctionType,
+      double(FunctionType::*)(const arma::mat&, const size_t,
+                              const size_t) const>::value;
+};
+
+//! Compute the sum of the gradients of the functions [begin, begin +
+//! batchSize) with a single call, for functions that support it.
+template<typename FunctionType>
+void BatchGradient(
+    FunctionType& function,
+    const arma::mat& iterate,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize,
+    const typename boost::enable_if_c<
+        HasBatchGradient<FunctionType>::value>::type* = 0)
+{
+  function.Gradient(iterate, begin, gradient, batchSize);
+}
+
+//! Compute the sum of the gradients of the functions [begin, begin +
+//! batchSize) one at a time, for functions that only have single-point
+//! gradients.
+template<typename FunctionType>
+void BatchGradient(
+    FunctionType& function,
+    const arma::mat& iterate,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize,
+    const typename boost::disable_if_c<
+        HasBatchGradient<FunctionType>::value>::type* = 0)
+{
+  function.Gradient(iterate, begin, gradient);
+  arma::mat funcGradient;
+  for (size_t j = 1; j < batchSize; ++j)
+  {
+    function.Gradient(iterate, begin + j, funcGradient);
+    gradient += funcGradient;
+  }
+}
+
+//! Compute the sum of the objectives of the functions [begin, begin +
+//! batchSize) with a single call, for functions that support it.
+template<typename FunctionType>
+double BatchEvaluate(
+    FunctionType& function,
+    const arma::mat& iterate,
+    const size_t begin,
+    const size_t batchSize,
+    const typename boost::enable_if_c<
+        HasBatchEvaluate<FunctionType>::value>::type* = 0)
+{
+  return function.Evaluate(iterate, begin, batchSize);
+}
+
+//! Compute the sum of the objectives of the functions [begin, begin +
+//! batchSize) one at a time, for functions that only have single-point
+//! objectives.
+template<typename FunctionType>
+double BatchEvaluate(
+    FunctionType& function,
+    const arma::mat& iterate,
+    const size_t begin,
+    const size_t batchSize,
+    const typename boost::disable_if_c<
+        HasBatchEvaluate<FunctionType>::value>::type* = 0)
+{
+  double objective = 0;
+  for (size_t j = 0; j < batchSize; ++j)
+    objective += function.Evaluate(iterate, begin + j);
+
+  return objective;
+}
+
 template<typename DecomposableFunctionType>
 MiniBatchSGD<DecomposableFunctionType>::MiniBatchSGD(
     DecomposableFunctionType& function,
@@ -47,12 +153,10 @@ double MiniBatchSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
 
   // To keep track of where we are and how things are going.
   size_t currentBatch = 0;
-  double overallObjective = 0;
   double lastObjective = DBL_MAX;
 
   // Calculate the first objective function.
-  for (size_t i = 0; i < numFunctions; ++i)
-    overallObjective += function.Evaluate(iterate, i);
+  double overallObjective = BatchEvaluate(function, iterate, 0, numFunctions);
 
   // Now iterate!
   arma::mat gradient(iterate.n_rows, iterate.n_cols);
@@ -89,53 +193,25 @@ double MiniBatchSGD<DecomposableFunctionType>::Optimize(arma::mat& iterate)
         visitationOrder = arma::shuffle(visitationOrder);
     }
 
-    // Evaluate the gradient for this mini-batch.
+    // Find the mini-batch; the last one may not be a full-size batch.
     const size_t offset = (shuffle) ? batchSize * visitationOrder[currentBatch]
         : batchSize * currentBatch;
-    function.Gradient(iterate, offset, gradient);
-    if (visitationOrder[currentBatch] != numBatches - 1)
-    {
-      for (size_t j = 1; j < batchSize; ++j)
-      {
-        arma::mat funcGradient;
-        function.Gradient(iterate, offset + j, funcGradient);
-        gradient += funcGradient;
-      }
-
-      // Now update the iterate.
-      iterate -= (stepSize / batchSize) * gradient;
-
-      // Add that to the overall objective function.
-      for (size_t j = 0; j < batchSize; ++j)
-        overallObjective += function.Evaluate(iterate, offset + j);
-    }
-    else
-    {
-      // Handle last batch differently: it's not a full-size batch.
-      const size_t lastBatchSize = numFunctions - offset - 1;
-      for (size_t j = 1; j < lastBatchSize; ++j)
-      {
-        arma::mat funcGradient;
-        function.Gradient(iterate, offset + j, funcGradient);
-        gradient += funcGradient;
-      }
+    const size_t currentBatchSize = std::min(batchSize, numFunctions - offset);
 
-      // Now update the iterate.
-      iterate -= (stepSize / lastBatchSize) * gradient;
+    // Evaluate the gradient for this mini-batch and update the iterate.
+    BatchGradient(function, iterate, offset, gradient, currentBatchSize);
+    iterate -= (stepSize / currentBatchSize) * gradient;
 
-      // Add that to the overall objective function.
-      for (size_t j = 0; j < lastBatchSize; ++j)
-        overallObjective += function.Evaluate(iterate, offset + j);
-    }
+    // Add that to the overall objective function.
+    overallObjective += BatchEvaluate(function, iterate, offset,
+        currentBatchSize);
   }
 
   Log::Info << "Mini-batch SGD: maximum iterations (" << maxIterations << ") "
       << "reached; terminating optimization." << std::endl;
 
   // Calculate final objective.
-  overallObjective = 0;
-  for (size_t i = 0; i < numFunctions; ++i)
-    overallObjective += function.Evaluate(iterate, i);
+  overallObjective = BatchEvaluate(function, iterate, 0, numFunctions);
 
   return overallObjective;
 }
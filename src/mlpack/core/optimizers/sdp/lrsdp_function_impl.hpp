@@ -39,11 +39,24 @@ LRSDPFunction<SDPType>::LRSDPFunction(const size_t numSparseConstraints,
         << "transposed solution." << std::endl;
 }
 
+//! Utility function for calculating Tr(A_i * (R R^T)) for an entry constraint,
+//! given R^T (so that the rows of R are contiguous).
+template <typename SDPType>
+static inline double
+EntryTrace(const SDPType& sdp, const arma::mat& rt, const size_t i)
+{
+  const size_t row = sdp.EntryIndices()(0, i);
+  const size_t col = sdp.EntryIndices()(1, i);
+  const double trace = sdp.EntryValues()[i] *
+      arma::dot(rt.unsafe_col(row), rt.unsafe_col(col));
+  return (row == col) ? trace : 2 * trace;
+}
+
 template <typename SDPType>
 double LRSDPFunction<SDPType>::Evaluate(const arma::mat& coordinates) const
 {
-  const arma::mat rrt = coordinates * trans(coordinates);
-  return accu(SDP().C() % rrt);
+  // Tr(C * (R R^T)) = Tr(R^T * (C R)), which does not need R R^T.
+  return accu(coordinates % (SDP().C() * coordinates));
 }
 
 template <typename SDPType>
@@ -58,11 +71,25 @@ template <typename SDPType>
 double LRSDPFunction<SDPType>::EvaluateConstraint(const size_t index,
                                                   const arma::mat& coordinates) const
 {
-  const arma::mat rrt = coordinates * trans(coordinates);
   if (index < SDP().NumSparseConstraints())
+  {
+    const arma::mat rrt = coordinates * trans(coordinates);
     return accu(SDP().SparseA()[index] % rrt) - SDP().SparseB()[index];
+  }
   const size_t index1 = index - SDP().NumSparseConstraints();
-  return accu(SDP().DenseA()[index1] % rrt) - SDP().DenseB()[index1];
+  if (index1 < SDP().NumDenseConstraints())
+  {
+    const arma::mat rrt = coordinates * trans(coordinates);
+    return accu(SDP().DenseA()[index1] % rrt) - SDP().DenseB()[index1];
+  }
+
+  // An entry constraint only needs two rows of R.
+  const size_t index2 = index1 - SDP().NumDenseConstraints();
+  const size_t row = SDP().EntryIndices()(0, index2);
+  const size_t col = SDP().EntryIndices()(1, index2);
+  const double trace = SDP().EntryValues()[index2] *
+      arma::dot(coordinates.row(row), coordinates.row(col));
+  return ((row == col) ? trace : 2 * trace) - SDP().EntryB()[index2];
 }
 
 template <typename SDPType>
@@ -115,6 +142,72 @@ UpdateGradient(arma::mat& s,
   }
 }
 
+//! Utility function for calculating the part of the objective for the entry
+//! constraints when AugLagrangian is used with an LRSDPFunction.
+template <typename SDPType>
+static inline void
+UpdateEntryObjective(double& objective,
+                     const SDPType& sdp,
+                     const arma::mat& rt,
+                     const arma::vec& lambda,
+                     const size_t lambdaOffset,
+                     const double sigma)
+{
+  double entryObjective = 0.0;
+
+  #pragma omp parallel for reduction(+:entryObjective)
+  for (omp_size_t i = 0; i < (omp_size_t) sdp.NumEntryConstraints(); ++i)
+  {
+    const double constraint = EntryTrace(sdp, rt, i) - sdp.EntryB()[i];
+    entryObjective -= (lambda[lambdaOffset + i] * constraint);
+    entryObjective += (sigma / 2.) * constraint * constraint;
+  }
+
+  objective += entryObjective;
+}
+
+//! Utility function for calculating the part of the gradient for the entry
+//! constraints when AugLagrangian is used with an LRSDPFunction.  Each entry
+//! constraint adds -2 y'_i A_i R to the gradient, so all of them together add
+//! -2 Y R, where Y is the sparse matrix sum_i y'_i A_i.
+template <typename SDPType>
+static inline void
+UpdateEntryGradient(arma::mat& gradient,
+                    const SDPType& sdp,
+                    const arma::mat& coordinates,
+                    const arma::mat& rt,
+                    const arma::vec& lambda,
+                    const size_t lambdaOffset,
+                    const double sigma)
+{
+  const size_t numEntries = sdp.NumEntryConstraints();
+  arma::umat locations(2, 2 * numEntries);
+  arma::vec values(2 * numEntries);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numEntries; ++i)
+  {
+    const size_t row = sdp.EntryIndices()(0, i);
+    const size_t col = sdp.EntryIndices()(1, i);
+    const double constraint = EntryTrace(sdp, rt, i) - sdp.EntryB()[i];
+    const double y = lambda[lambdaOffset + i] - sigma * constraint;
+
+    // A diagonal entry appears twice, so each copy gets half of it.
+    const double value = (row == col) ? y * sdp.EntryValues()[i] / 2 :
+        y * sdp.EntryValues()[i];
+    locations(0, 2 * i) = row;
+    locations(1, 2 * i) = col;
+    locations(0, 2 * i + 1) = col;
+    locations(1, 2 * i + 1) = row;
+    values[2 * i] = value;
+    values[2 * i + 1] = value;
+  }
+
+  // Repeated locations are summed.
+  const arma::sp_mat y(true, locations, values, sdp.N(), sdp.N());
+  gradient -= 2 * y * coordinates;
+}
+
 template <typename SDPType>
 static inline double
 EvaluateImpl(const LRSDPFunction<SDPType>& function,
@@ -127,22 +220,30 @@ EvaluateImpl(const LRSDPFunction<SDPType>& function,
   //     sum_{i = 1}^{m} (y_i (Tr(A_i * (R R^T)) - b_i)) +
   //     (sigma / 2) * sum_{i = 1}^{m} (Tr(A_i * (R R^T)) - b_i)^2
 
-  // Let's start with the objective: Tr(C * (R R^T)).
-  // Simple, possibly slow solution-- see below for optimization opportunity
-  //
-  // TODO: Note that Tr(C^T * (R R^T)) = Tr( (CR)^T * R ), so
-  // multiplying C*R first, and then taking the trace dot should be more memory
-  // efficient
+  // Let's start with the objective: Tr(C * (R R^T)) = Tr((C R)^T * R), so we
+  // don't need to form R R^T.
   //
-  // Similarly for the constraints, taking A*R first should be more efficient
-  const arma::mat rrt = coordinates * trans(coordinates);
-  double objective = accu(function.SDP().C() % rrt);
+  // TODO: for the sparse and dense constraints, taking A*R first should be
+  // more efficient too.
+  double objective = accu(coordinates % (function.SDP().C() * coordinates));
 
   // Now each constraint.
-  UpdateObjective(objective, rrt, function.SDP().SparseA(), function.SDP().SparseB(),
-      lambda, 0, sigma);
-  UpdateObjective(objective, rrt, function.SDP().DenseA(), function.SDP().DenseB(), lambda,
-      function.SDP().NumSparseConstraints(), sigma);
+  const SDPType& sdp = function.SDP();
+  if (sdp.NumSparseConstraints() + sdp.NumDenseConstraints() > 0)
+  {
+    const arma::mat rrt = coordinates * trans(coordinates);
+    UpdateObjective(objective, rrt, sdp.SparseA(), sdp.SparseB(), lambda, 0,
+        sigma);
+    UpdateObjective(objective, rrt, sdp.DenseA(), sdp.DenseB(), lambda,
+        sdp.NumSparseConstraints(), sigma);
+  }
+
+  if (sdp.NumEntryConstraints() > 0)
+  {
+    const arma::mat rt = trans(coordinates);
+    UpdateEntryObjective(objective, sdp, rt, lambda,
+        sdp.NumSparseConstraints() + sdp.NumDenseConstraints(), sigma);
+  }
 
   return objective;
 }
@@ -160,17 +261,29 @@ GradientImpl(const LRSDPFunction<SDPType>& function,
   //   with
   // S' = C - sum_{i = 1}^{m} y'_i A_i
   // y'_i = y_i - sigma * (Trace(A_i * (R R^T)) - b_i)
-  const arma::mat rrt = coordinates * trans(coordinates);
-  arma::mat s(function.SDP().C());
+  //
+  // The C term is 2 * C * R, which keeps C sparse if it is sparse.
+  const SDPType& sdp = function.SDP();
+  gradient = 2 * sdp.C() * coordinates;
+
+  if (sdp.NumSparseConstraints() + sdp.NumDenseConstraints() > 0)
+  {
+    const arma::mat rrt = coordinates * trans(coordinates);
+    arma::mat s(sdp.N(), sdp.N(), arma::fill::zeros);
+
+    UpdateGradient(s, rrt, sdp.SparseA(), sdp.SparseB(), lambda, 0, sigma);
+    UpdateGradient(s, rrt, sdp.DenseA(), sdp.DenseB(), lambda,
+        sdp.NumSparseConstraints(), sigma);
 
-  UpdateGradient(
-      s, rrt, function.SDP().SparseA(), function.SDP().SparseB(),
-      lambda, 0, sigma);
-  UpdateGradient(
-      s, rrt, function.SDP().DenseA(), function.SDP().DenseB(),
-      lambda, function.SDP().NumSparseConstraints(), sigma);
+    gradient += 2 * s * coordinates;
+  }
 
-  gradient = 2 * s * coordinates;
+  if (sdp.NumEntryConstraints() > 0)
+  {
+    const arma::mat rt = trans(coordinates);
+    UpdateEntryGradient(gradient, sdp, coordinates, rt, lambda,
+        sdp.NumSparseConstraints() + sdp.NumDenseConstraints(), sigma);
+  }
 }
 
 // Template specializations for function and gradient evaluation.
@@ -24,6 +24,11 @@ LRSDP<SDPType>::LRSDP(const size_t numSparseConstraints,
 template <typename SDPType>
 double LRSDP<SDPType>::Optimize(arma::mat& coordinates)
 {
+  // Entry constraints are usually set after construction, so the Lagrange
+  // multipliers may not have been sized for them yet.
+  if (augLag.Lambda().n_elem != function.NumConstraints())
+    augLag.Lambda().zeros(function.NumConstraints());
+
   augLag.Sigma() = 10;
   augLag.Optimize(coordinates, 1000);
 
@@ -237,6 +237,10 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
   // TODO(stephentu): We need a method which deals with the case when the Ais
   // are not linearly independent.
 
+  if (sdp.NumEntryConstraints() > 0)
+    Log::Fatal << "PrimalDualSolver::Optimize(): entry constraints are not "
+        << "supported; give them as sparse constraints instead." << std::endl;
+
   const size_t n = sdp.N();
   const size_t n2bar = sdp.N2bar();
 
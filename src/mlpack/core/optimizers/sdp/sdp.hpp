@@ -24,6 +24,15 @@ namespace optimization {
  * that for each matrix you add to either SparseA() or DenseA(), you must add
  * the corresponding b value to the corresponding vector SparseB() or DenseB().
  *
+ * Constraints whose Ai has a single nonzero entry v at (r, c) (and, to keep Ai
+ * symmetric, at (c, r)) can be given as entry constraints instead: the column
+ * (r, c) of EntryIndices(), the value v in EntryValues(), and bi in EntryB().
+ * These take no more memory than the triplet itself, and the LRSDP solver
+ * evaluates them in time proportional to the rank of the solution instead of
+ * the size of X; so they are the right choice when there are very many
+ * constraints of this type, as in matrix completion.  The PrimalDualSolver does
+ * not support entry constraints.
+ *
  * The objective matrix (C) may be stored as either dense or sparse depending on
  * the ObjectiveMatrixType parameter.
  *
@@ -73,8 +82,13 @@ class SDP
   //! SDP.
   size_t NumDenseConstraints() const { return denseB.n_elem; }
 
+  //! Return the number of entry constraints (constraints with a single entry
+  //! in Ai) in the SDP.
+  size_t NumEntryConstraints() const { return entryB.n_elem; }
+
   //! Return the total number of constraints in the SDP.
-  size_t NumConstraints() const { return sparseB.n_elem + denseB.n_elem; }
+  size_t NumConstraints() const
+  { return sparseB.n_elem + denseB.n_elem + entryB.n_elem; }
 
   //! Modify the sparse objective function matrix (sparseC).
   ObjectiveMatrixType& C() { return c; }
@@ -107,6 +121,23 @@ class SDP
   //! Modify the vector of dense B values.
   arma::vec& DenseB() { return denseB; }
 
+  //! Return the (row, column) indices of the entry constraints (one column per
+  //! constraint).
+  const arma::umat& EntryIndices() const { return entryIndices; }
+  //! Modify the (row, column) indices of the entry constraints (one column per
+  //! constraint).
+  arma::umat& EntryIndices() { return entryIndices; }
+
+  //! Return the values of the entries of the entry constraints.
+  const arma::vec& EntryValues() const { return entryValues; }
+  //! Modify the values of the entries of the entry constraints.
+  arma::vec& EntryValues() { return entryValues; }
+
+  //! Return the vector of entry B values.
+  const arma::vec& EntryB() const { return entryB; }
+  //! Modify the vector of entry B values.
+  arma::vec& EntryB() { return entryB; }
+
   /**
    * Check whether or not the constraint matrices are linearly independent.
    *
@@ -127,6 +158,13 @@ class SDP
   std::vector<arma::mat> denseA;
   //! b_i for each dense constraint.
   arma::vec denseB;
+
+  //! (row, column) of the entry of A_i for each entry constraint.
+  arma::umat entryIndices;
+  //! Value of the entry of A_i for each entry constraint.
+  arma::vec entryValues;
+  //! b_i for each entry constraint.
+  arma::vec entryB;
 };
 
 } // namespace optimization
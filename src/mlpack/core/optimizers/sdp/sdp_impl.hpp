@@ -17,7 +17,10 @@ SDP<ObjectiveMatrixType>::SDP() :
     sparseA(),
     sparseB(),
     denseA(),
-    denseB()
+    denseB(),
+    entryIndices(2, 0),
+    entryValues(),
+    entryB()
 {
 
 }
@@ -30,7 +33,10 @@ SDP<ObjectiveMatrixType>::SDP(const size_t n,
     sparseA(numSparseConstraints),
     sparseB(numSparseConstraints),
     denseA(numDenseConstraints),
-    denseB(numDenseConstraints)
+    denseB(numDenseConstraints),
+    entryIndices(2, 0),
+    entryValues(),
+    entryB()
 {
   for (size_t i = 0; i < numSparseConstraints; i++)
     sparseA[i].zeros(n, n);
@@ -60,6 +66,15 @@ bool SDP<ObjectiveMatrixType>::HasLinearlyIndependentConstraints() const
     math::Svec(DenseA()[i], sa);
     A.row(NumSparseConstraints() + i) = sa.t();
   }
+  for (size_t i = 0; i < NumEntryConstraints(); i++)
+  {
+    arma::mat a(N(), N(), arma::fill::zeros);
+    a(entryIndices(0, i), entryIndices(1, i)) = entryValues[i];
+    a(entryIndices(1, i), entryIndices(0, i)) = entryValues[i];
+    arma::vec sa;
+    math::Svec(a, sa);
+    A.row(NumSparseConstraints() + NumDenseConstraints() + i) = sa.t();
+  }
 
   const arma::vec s = arma::svd(A);
   return s(s.n_elem - 1) > 1e-5;
@@ -14,6 +14,21 @@
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+/**
+ * The orders in which the nodes of a flattened BinarySpaceTree can be laid out
+ * in memory; see BinarySpaceTree::Flatten().
+ */
+enum NodeLayout
+{
+  //! Nodes are stored level by level, as they are visited by a breadth-first
+  //! search.
+  BREADTH_FIRST_LAYOUT,
+  //! Nodes are stored in van Emde Boas order: the top half of the levels of
+  //! the tree is stored first, followed by each of the subtrees below it, each
+  //! laid out recursively in the same way.
+  VAN_EMDE_BOAS_LAYOUT
+};
+
 /**
  * A binary space partitioning tree, such as a KD-tree or a ball tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -27,6 +42,22 @@ namespace tree /** Trees and tree-building procedures. */ {
  * This tree does take one runtime parameter in the constructor, which is the
  * max leaf size to be used.
  *
+ * If mlpack is compiled with OpenMP, the tree is built in parallel: once a node
+ * is split, its two children cover disjoint parts of the dataset, so they are
+ * built as independent tasks, and the bounds of the largest nodes (near the
+ * root) are computed in parallel too.  The resulting tree is the same as the
+ * one built by a single thread.  The SplitType and StatisticType classes must
+ * therefore allow nodes in different subtrees to be split and to have their
+ * statistics built at the same time.
+ *
+ * After the tree is built, Flatten() can be called on the root to move every
+ * node into a single contiguous array (in breadth-first or van Emde Boas
+ * order), with the bounds of all nodes in one contiguous block of memory.
+ * This gives better cache behavior during searches, and the flattened tree is
+ * still traversed with the same traversers.  A flattened tree is serialized as
+ * one block of node data instead of node by node.  Only trees whose BoundType
+ * is HRectBound (such as the kd-tree) can be flattened.
+ *
  * @tparam MetricType The metric used for tree-building.  The BoundType may
  *     place restrictions on the metrics that can be used.
  * @tparam StatisticType Extra data contained in the node.  See statistic.hpp
@@ -75,6 +106,21 @@ class BinarySpaceTree
   //! delete it.
   MatType* dataset;
 
+  //! If this is the root of a flattened tree, the array holding every other
+  //! node of the tree; otherwise, NULL.
+  BinarySpaceTree* flatNodes;
+  //! If this is the root of a flattened tree, the number of nodes in the tree
+  //! (including the root); otherwise, 0.
+  size_t numFlatNodes;
+  //! If this is the root of a flattened tree, the memory holding the bounds of
+  //! every node of the tree; otherwise, NULL.
+  math::Range* flatBounds;
+
+  //! Nodes with at least this many points build their children in parallel
+  //! (if OpenMP is available); smaller subtrees are built by a single thread,
+  //! because the overhead of a task would be larger than the work.
+  static const size_t ParallelBuildSize = 10000;
+
  public:
   //! So other classes can use TreeType::Mat.
   typedef MatType Mat;
@@ -452,6 +498,24 @@ class BinarySpaceTree
   //! Store the center of the bounding region in the given vector.
   void Center(arma::vec& center) { bound.Center(center); }
 
+  /**
+   * Move every node of the tree into one contiguous array, in the given order,
+   * and store the bounds of every node in one contiguous block of memory.  This
+   * must be called on the root of the tree, and only compiles for trees whose
+   * BoundType is HRectBound, since the bounds are moved into external memory.
+   * Pointers and references to
+   * any node other than the root are invalidated, and the statistics of every
+   * node are rebuilt.  The tree can still be used as any other tree, but it is
+   * freed all at once when the root is destroyed.  Copying a flattened tree
+   * gives a tree that is not flattened.
+   *
+   * @param layout Order in which to store the nodes.
+   */
+  void Flatten(const NodeLayout layout = VAN_EMDE_BOAS_LAYOUT);
+
+  //! Return whether or not this is the root of a flattened tree.
+  bool IsFlat() const { return (numFlatNodes > 0); }
+
  private:
   /**
    * Splits the current node, assigning its left and right children recursively.
@@ -474,6 +538,65 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Expand the given bound so that it contains all of the points held in this
+   * node.  Bounds other than HRectBound are expanded with one pass over the
+   * points, since combining the bounds of chunks of points would give a looser
+   * bound (or, for a BallBound, is not possible).
+   *
+   * @param boundToUpdate The bound of this node.
+   */
+  template<typename BoundType2>
+  void UpdateBound(BoundType2& boundToUpdate);
+
+  /**
+   * Expand the given hyperrectangle bound so that it contains all of the points
+   * held in this node.  For large nodes, the bounds of chunks of the points are
+   * calculated in parallel and then combined, which gives the same bound.
+   *
+   * @param boundToUpdate The bound of this node.
+   */
+  void UpdateBound(bound::HRectBound<MetricType>& boundToUpdate);
+
+  /**
+   * Append the nodes of the subtree rooted at the given node, which has the
+   * given number of levels, to the given vector in van Emde Boas order.
+   */
+  static void VanEmdeBoasOrder(BinarySpaceTree* node,
+                               const size_t levels,
+                               std::vector<BinarySpaceTree*>& order);
+
+  /**
+   * Append the descendants of the given node which are exactly the given number
+   * of levels below it to the given vector.
+   */
+  static void Descendants(BinarySpaceTree* node,
+                          const size_t levels,
+                          std::vector<BinarySpaceTree*>& descendants);
+
+  //! Return the number of levels in the subtree rooted at the given node.
+  static size_t Levels(const BinarySpaceTree* node);
+
+  /**
+   * Free the node array and the bound memory of a flattened tree.  The bound
+   * of the root is moved back into its own memory, and the root is left with
+   * no children.
+   */
+  void FreeFlatStorage();
+
+  /**
+   * Stop a bound from using the memory of a flattened tree.  Only trees with
+   * HRectBound can be flattened, so this does nothing for any other bound.
+   */
+  template<typename BoundType2>
+  static void ReleaseFlatBound(BoundType2& /* flatBound */) { }
+
+  //! Move the given hyperrectangle bound back into its own memory.
+  static void ReleaseFlatBound(bound::HRectBound<MetricType>& flatBound)
+  {
+    flatBound.UseMemory(NULL);
+  }
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -492,11 +615,48 @@ class BinarySpaceTree
    */
   template<typename Archive>
   void Serialize(Archive& ar, const unsigned int version);
+
+ private:
+  /**
+   * Serialize the root of a flattened tree: the structure, distances, and
+   * bounds of every node are serialized as a few matrices, followed by the
+   * statistics and the dataset.  The bound of the root is passed only to choose
+   * the overload; trees with bounds other than HRectBound are never flattened,
+   * so loading a flattened tree of that type throws an exception.
+   */
+  template<typename Archive, typename BoundType2>
+  void SerializeFlat(Archive& ar, BoundType2& rootBound);
+
+  //! Serialize the root of a flattened tree with hyperrectangle bounds.
+  template<typename Archive>
+  void SerializeFlat(Archive& ar, bound::HRectBound<MetricType>& rootBound);
 };
 
 } // namespace tree
 } // namespace mlpack
 
+namespace boost {
+namespace serialization {
+
+//! Version 1 of the BinarySpaceTree serialization records whether the tree is
+//! flattened; trees saved with version 0 are never flattened.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+struct version<mlpack::tree::BinarySpaceTree<MetricType, StatisticType,
+    MatType, BoundType, SplitType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "binary_space_tree_impl.hpp"
 
@@ -13,6 +13,7 @@
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/string_util.hpp>
 #include <queue>
+#include <unordered_map>
 
 namespace mlpack {
 namespace tree {
@@ -36,11 +37,19 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    flatNodes(NULL),
+    numFlatNodes(0),
+    flatBounds(NULL)
 {
-  // Do the actual splitting of this node.
+  // Do the actual splitting of this node; this is done in parallel if OpenMP
+  // is available, with each child built as a separate task.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  #pragma omp parallel if (count >= ParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -64,16 +73,24 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    flatNodes(NULL),
+    numFlatNodes(0),
+    flatBounds(NULL)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
   for (size_t i = 0; i < data.n_cols; i++)
     oldFromNew[i] = i; // Fill with unharmed indices.
 
-  // Now do the actual splitting.
+  // Now do the actual splitting; this is done in parallel if OpenMP is
+  // available, with each child built as a separate task.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  #pragma omp parallel if (count >= ParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(oldFromNew, maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -98,16 +115,24 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    flatNodes(NULL),
+    numFlatNodes(0),
+    flatBounds(NULL)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
   for (size_t i = 0; i < data.n_cols; i++)
     oldFromNew[i] = i; // Fill with unharmed indices.
 
-  // Now do the actual splitting.
+  // Now do the actual splitting; this is done in parallel if OpenMP is
+  // available, with each child built as a separate task.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  #pragma omp parallel if (count >= ParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(oldFromNew, maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -133,11 +158,19 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    flatNodes(NULL),
+    numFlatNodes(0),
+    flatBounds(NULL)
 {
-  // Do the actual splitting of this node.
+  // Do the actual splitting of this node; this is done in parallel if OpenMP
+  // is available, with each child built as a separate task.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(maxLeafSize, splitter);
+  #pragma omp parallel if (count >= ParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -161,16 +194,24 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    flatNodes(NULL),
+    numFlatNodes(0),
+    flatBounds(NULL)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
   for (size_t i = 0; i < dataset->n_cols; i++)
     oldFromNew[i] = i; // Fill with unharmed indices.
 
-  // Now do the actual splitting.
+  // Now do the actual splitting; this is done in parallel if OpenMP is
+  // available, with each child built as a separate task.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  #pragma omp parallel if (count >= ParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(oldFromNew, maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -195,16 +236,24 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    flatNodes(NULL),
+    numFlatNodes(0),
+    flatBounds(NULL)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
   for (size_t i = 0; i < dataset->n_cols; i++)
     oldFromNew[i] = i; // Fill with unharmed indices.
 
-  // Now do the actual splitting.
+  // Now do the actual splitting; this is done in parallel if OpenMP is
+  // available, with each child built as a separate task.
   SplitType<BoundType<MetricType>, MatType> splitter;
-  SplitNode(oldFromNew, maxLeafSize, splitter);
+  #pragma omp parallel if (count >= ParallelBuildSize)
+  {
+    #pragma omp single
+    SplitNode(oldFromNew, maxLeafSize, splitter);
+  }
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -234,7 +283,10 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    flatNodes(NULL),
+    numFlatNodes(0),
+    flatBounds(NULL)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -263,7 +315,10 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    flatNodes(NULL),
+    numFlatNodes(0),
+    flatBounds(NULL)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -297,7 +352,10 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    flatNodes(NULL),
+    numFlatNodes(0),
+    flatBounds(NULL)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -338,7 +396,10 @@ BinarySpaceTree(
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    flatNodes(NULL),
+    numFlatNodes(0),
+    flatBounds(NULL)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -396,7 +457,10 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    flatNodes(other.flatNodes),
+    numFlatNodes(other.numFlatNodes),
+    flatBounds(other.flatBounds)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -408,6 +472,9 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.flatNodes = NULL;
+  other.numFlatNodes = 0;
+  other.flatBounds = NULL;
 }
 
 /**
@@ -445,8 +512,16 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  // The nodes of a flattened tree are all freed at once.
+  if (numFlatNodes > 0)
+  {
+    FreeFlatStorage();
+  }
+  else
+  {
+    delete left;
+    delete right;
+  }
 
   // If we're the root, delete the matrix.
   if (!parent)
@@ -631,8 +706,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
               SplitType<BoundType<MetricType>, MatType>& splitter)
 {
   // We need to expand the bounds of this node properly.
-  if (count > 0)
-    bound |= dataset->cols(begin, begin + count - 1);
+  UpdateBound(bound);
 
   // Calculate the furthest descendant distance.
   furthestDescendantDistance = 0.5 * bound.Diameter();
@@ -657,11 +731,16 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     return;
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
+  // by calling their constructors (which perform this splitting process).  The
+  // children hold disjoint ranges of the dataset, so for large nodes they are
+  // built as independent tasks.
+  #pragma omp task if (count >= ParallelBuildSize) shared(splitter)
   left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
       maxLeafSize);
+  #pragma omp task if (count >= ParallelBuildSize) shared(splitter)
   right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
       splitter, maxLeafSize);
+  #pragma omp taskwait
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -689,8 +768,7 @@ SplitNode(std::vector<size_t>& oldFromNew,
 {
   // This should be a single function for Bound.
   // We need to expand the bounds of this node properly.
-  if (count > 0)
-    bound |= dataset->cols(begin, begin + count - 1);
+  UpdateBound(bound);
 
   // Calculate the furthest descendant distance.
   furthestDescendantDistance = 0.5 * bound.Diameter();
@@ -715,11 +793,16 @@ SplitNode(std::vector<size_t>& oldFromNew,
     return;
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
+  // by calling their constructors (which perform this splitting process).  The
+  // children hold disjoint ranges of the dataset and of oldFromNew, so for
+  // large nodes they are built as independent tasks.
+  #pragma omp task if (count >= ParallelBuildSize) shared(oldFromNew, splitter)
   left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
       splitter, maxLeafSize);
+  #pragma omp task if (count >= ParallelBuildSize) shared(oldFromNew, splitter)
   right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
       oldFromNew, splitter, maxLeafSize);
+  #pragma omp taskwait
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -734,6 +817,271 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename BoundType2>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+UpdateBound(BoundType2& boundToUpdate)
+{
+  if (count > 0)
+    boundToUpdate |= dataset->cols(begin, begin + count - 1);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+UpdateBound(bound::HRectBound<MetricType>& boundToUpdate)
+{
+  if (count == 0)
+    return;
+
+  // Only split the work if each thread gets a reasonable number of points.
+#ifdef _OPENMP
+  const size_t threads = (size_t) omp_get_num_threads();
+#else
+  const size_t threads = 1;
+#endif
+  const size_t chunks = std::min(threads, count / ParallelBuildSize);
+  if (chunks <= 1)
+  {
+    boundToUpdate |= dataset->cols(begin, begin + count - 1);
+    return;
+  }
+
+  // Calculate the bound of each chunk of points separately, then combine them.
+  const size_t chunkSize = (count + chunks - 1) / chunks;
+  std::vector<bound::HRectBound<MetricType>> chunkBounds(chunks,
+      bound::HRectBound<MetricType>(dataset->n_rows));
+  for (size_t c = 0; c < chunks; ++c)
+  {
+    #pragma omp task shared(chunkBounds)
+    {
+      const size_t chunkBegin = begin + c * chunkSize;
+      const size_t chunkEnd = std::min(chunkBegin + chunkSize, begin + count);
+      chunkBounds[c] |= dataset->cols(chunkBegin, chunkEnd - 1);
+    }
+  }
+  #pragma omp taskwait
+
+  for (size_t c = 0; c < chunks; ++c)
+    boundToUpdate |= chunkBounds[c];
+}
+
+/**
+ * Move every node of the tree into a contiguous array in the given order.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::Flatten(
+    const NodeLayout layout)
+{
+  static_assert(std::is_same<BoundType<MetricType>,
+      bound::HRectBound<MetricType>>::value, "BinarySpaceTree::Flatten() is "
+      "only available for trees with HRectBound bounds");
+  Log::Assert(parent == NULL, "BinarySpaceTree::Flatten() must be called on "
+      "the root of the tree!");
+
+  // Find the order of the nodes.  In both layouts, each node comes before its
+  // children, and the root comes first.
+  std::vector<BinarySpaceTree*> order;
+  if (layout == BREADTH_FIRST_LAYOUT)
+  {
+    std::queue<BinarySpaceTree*> queue;
+    queue.push(this);
+    while (!queue.empty())
+    {
+      BinarySpaceTree* node = queue.front();
+      queue.pop();
+
+      order.push_back(node);
+      if (node->left)
+        queue.push(node->left);
+      if (node->right)
+        queue.push(node->right);
+    }
+  }
+  else
+  {
+    VanEmdeBoasOrder(this, Levels(this), order);
+  }
+
+  // Allocate the new storage.  The root stays where it is.
+  const size_t numNodes = order.size();
+  const size_t dim = bound.Dim();
+  BinarySpaceTree* nodes = (numNodes > 1) ?
+      new BinarySpaceTree[numNodes - 1] : NULL;
+  math::Range* bounds = new math::Range[numNodes * dim];
+
+  std::unordered_map<BinarySpaceTree*, BinarySpaceTree*> newNodes;
+  newNodes[this] = this;
+  for (size_t i = 1; i < numNodes; ++i)
+    newNodes[order[i]] = &nodes[i - 1];
+
+  // Copy each node into its new position, and find the new child links; the
+  // old nodes must be kept until everything is copied.
+  std::vector<BinarySpaceTree*> newLeft(numNodes, NULL);
+  std::vector<BinarySpaceTree*> newRight(numNodes, NULL);
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    BinarySpaceTree* oldNode = order[i];
+    BinarySpaceTree* node = newNodes[oldNode];
+    if (i > 0)
+    {
+      node->parent = newNodes[oldNode->parent];
+      node->begin = oldNode->begin;
+      node->count = oldNode->count;
+      node->bound = oldNode->bound;
+      node->parentDistance = oldNode->parentDistance;
+      node->furthestDescendantDistance = oldNode->furthestDescendantDistance;
+      node->minimumBoundDistance = oldNode->minimumBoundDistance;
+      node->dataset = dataset;
+    }
+
+    node->bound.UseMemory(bounds + i * dim);
+    if (oldNode->left)
+      newLeft[i] = newNodes[oldNode->left];
+    if (oldNode->right)
+      newRight[i] = newNodes[oldNode->right];
+  }
+
+  // Now free the old nodes (and the old storage, if the tree was already
+  // flattened).
+  if (numFlatNodes > 0)
+  {
+    FreeFlatStorage();
+    // The bound of the root was moved out of the new storage; put it back.
+    bound.UseMemory(bounds);
+  }
+  else
+  {
+    delete left;
+    delete right;
+  }
+
+  flatNodes = nodes;
+  numFlatNodes = numNodes;
+  flatBounds = bounds;
+
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    BinarySpaceTree* node = (i == 0) ? this : &nodes[i - 1];
+    node->left = newLeft[i];
+    node->right = newRight[i];
+  }
+
+  // Rebuild the statistics.  Children come after their parents, so iterating
+  // backwards builds the statistics of children first.
+  for (size_t i = numNodes; i > 0; --i)
+  {
+    BinarySpaceTree* node = (i == 1) ? this : &nodes[i - 2];
+    node->stat = StatisticType(*node);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::VanEmdeBoasOrder(
+    BinarySpaceTree* node,
+    const size_t levels,
+    std::vector<BinarySpaceTree*>& order)
+{
+  if (levels <= 1 || node->IsLeaf())
+  {
+    order.push_back(node);
+    return;
+  }
+
+  // Lay out the top half of the levels, then each of the subtrees hanging off
+  // of the bottom of the top half.
+  const size_t topLevels = levels / 2;
+  VanEmdeBoasOrder(node, topLevels, order);
+
+  std::vector<BinarySpaceTree*> subtrees;
+  Descendants(node, topLevels, subtrees);
+  for (size_t i = 0; i < subtrees.size(); ++i)
+    VanEmdeBoasOrder(subtrees[i], levels - topLevels, order);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::Descendants(
+    BinarySpaceTree* node,
+    const size_t levels,
+    std::vector<BinarySpaceTree*>& descendants)
+{
+  if (levels == 0)
+  {
+    descendants.push_back(node);
+    return;
+  }
+
+  if (node->left)
+    Descendants(node->left, levels - 1, descendants);
+  if (node->right)
+    Descendants(node->right, levels - 1, descendants);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+size_t BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::Levels(
+    const BinarySpaceTree* node)
+{
+  if (node->IsLeaf())
+    return 1;
+
+  return 1 + std::max(Levels(node->left), Levels(node->right));
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::FreeFlatStorage()
+{
+  // The nodes in the array must not delete their children themselves.
+  for (size_t i = 0; i + 1 < numFlatNodes; ++i)
+  {
+    flatNodes[i].left = NULL;
+    flatNodes[i].right = NULL;
+  }
+
+  ReleaseFlatBound(bound);
+
+  delete[] flatNodes;
+  delete[] flatBounds;
+  flatNodes = NULL;
+  numFlatNodes = 0;
+  flatBounds = NULL;
+  left = NULL;
+  right = NULL;
+}
+
 // Default constructor (private), for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -751,7 +1099,10 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    flatNodes(NULL),
+    numFlatNodes(0),
+    flatBounds(NULL)
 {
   // Nothing to do.
 }
@@ -767,22 +1118,48 @@ template<typename MetricType,
              class SplitType>
 template<typename Archive>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
-    Serialize(Archive& ar, const unsigned int /* version */)
+    Serialize(Archive& ar, const unsigned int version)
 {
   using data::CreateNVP;
 
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    if (numFlatNodes > 0)
+    {
+      FreeFlatStorage();
+    }
+    else
+    {
+      if (left)
+        delete left;
+      if (right)
+        delete right;
+    }
     if (!parent)
       delete dataset;
+
+    left = NULL;
+    right = NULL;
+    dataset = NULL;
   }
 
   ar & CreateNVP(parent, "parent");
+
+  // The root of the tree records whether the tree is flattened; if so, the
+  // whole tree is serialized at once.  Trees saved before version 1 do not
+  // record this, and are never flattened.
+  if (parent == NULL && version >= 1)
+  {
+    bool flat = (numFlatNodes > 0);
+    ar & CreateNVP(flat, "flat");
+    if (flat)
+    {
+      SerializeFlat(ar, bound);
+      return;
+    }
+  }
+
   ar & CreateNVP(begin, "begin");
   ar & CreateNVP(count, "count");
   ar & CreateNVP(bound, "bound");
@@ -836,6 +1213,128 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   }
 }
 
+/**
+ * Flattened trees always have HRectBound bounds, so this overload is only used
+ * when loading a corrupt or mismatched archive.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename Archive, typename BoundType2>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::SerializeFlat(
+    Archive& /* ar */,
+    BoundType2& /* rootBound */)
+{
+  // Only a tree with HRectBound can be saved as a flattened tree.
+  throw std::invalid_argument("BinarySpaceTree::Serialize(): cannot load a "
+      "flattened tree into a tree type whose bound is not HRectBound");
+}
+
+/**
+ * Serialize a flattened tree with hyperrectangle bounds as one block of node
+ * data.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename Archive>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::SerializeFlat(
+    Archive& ar,
+    bound::HRectBound<MetricType>& /* rootBound */)
+{
+  using data::CreateNVP;
+
+  size_t numNodes = numFlatNodes;
+  size_t dim = bound.Dim();
+  ar & CreateNVP(numNodes, "numNodes");
+  ar & CreateNVP(dim, "dim");
+
+  // The structure of the tree: the begin and count of each node, and the
+  // indices of its children (0 if there is no child, since the root is never a
+  // child).  Then the distances and bounds of each node.
+  arma::Mat<size_t> structure;
+  arma::mat distances;
+  arma::mat bounds;
+  if (Archive::is_saving::value)
+  {
+    structure.set_size(4, numNodes);
+    distances.set_size(4, numNodes);
+    bounds.set_size(2 * dim, numNodes);
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      const BinarySpaceTree* node = (i == 0) ? this : &flatNodes[i - 1];
+      structure(0, i) = node->begin;
+      structure(1, i) = node->count;
+      structure(2, i) = node->left ? (node->left - flatNodes + 1) : 0;
+      structure(3, i) = node->right ? (node->right - flatNodes + 1) : 0;
+      distances(0, i) = node->parentDistance;
+      distances(1, i) = node->furthestDescendantDistance;
+      distances(2, i) = node->minimumBoundDistance;
+      distances(3, i) = node->bound.MinWidth();
+      for (size_t d = 0; d < dim; ++d)
+      {
+        bounds(2 * d, i) = node->bound[d].Lo();
+        bounds(2 * d + 1, i) = node->bound[d].Hi();
+      }
+    }
+  }
+
+  ar & CreateNVP(structure, "structure");
+  ar & CreateNVP(distances, "distances");
+  ar & CreateNVP(bounds, "bounds");
+
+  if (Archive::is_loading::value)
+  {
+    flatNodes = (numNodes > 1) ? new BinarySpaceTree[numNodes - 1] : NULL;
+    numFlatNodes = numNodes;
+    flatBounds = new math::Range[numNodes * dim];
+
+    for (size_t i = 0; i < numNodes; ++i)
+    {
+      BinarySpaceTree* node = (i == 0) ? this : &flatNodes[i - 1];
+      node->begin = structure(0, i);
+      node->count = structure(1, i);
+      node->left = (structure(2, i) > 0) ? &flatNodes[structure(2, i) - 1] :
+          NULL;
+      node->right = (structure(3, i) > 0) ? &flatNodes[structure(3, i) - 1] :
+          NULL;
+      if (node->left)
+        node->left->parent = node;
+      if (node->right)
+        node->right->parent = node;
+
+      node->parentDistance = distances(0, i);
+      node->furthestDescendantDistance = distances(1, i);
+      node->minimumBoundDistance = distances(2, i);
+
+      node->bound = BoundType<MetricType>(dim);
+      for (size_t d = 0; d < dim; ++d)
+        node->bound[d] = math::Range(bounds(2 * d, i), bounds(2 * d + 1, i));
+      node->bound.MinWidth() = distances(3, i);
+      node->bound.UseMemory(flatBounds + i * dim);
+    }
+  }
+
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    BinarySpaceTree* node = (i == 0) ? this : &flatNodes[i - 1];
+    ar & CreateNVP(node->stat, "statistic");
+  }
+
+  ar & CreateNVP(dataset, "dataset");
+  if (Archive::is_loading::value)
+  {
+    for (size_t i = 0; i + 1 < numNodes; ++i)
+      flatNodes[i].dataset = dataset;
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
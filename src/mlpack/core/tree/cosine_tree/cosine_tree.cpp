@@ -16,7 +16,8 @@ CosineTree::CosineTree(const arma::mat& dataset) :
     parent(NULL),
     left(NULL),
     right(NULL),
-    numColumns(dataset.n_cols)
+    numColumns(dataset.n_cols),
+    basisColumn(size_t(-1))
 {
   // Initialize sizes of column indices and l2 norms.
   indices.resize(numColumns);
@@ -45,7 +46,8 @@ CosineTree::CosineTree(CosineTree& parentNode,
     parent(&parentNode),
     left(NULL),
     right(NULL),
-    numColumns(subIndices.size())
+    numColumns(subIndices.size()),
+    basisColumn(size_t(-1))
 {
   // Initialize sizes of column indices and l2 norms.
   indices.resize(numColumns);
@@ -73,16 +75,23 @@ CosineTree::CosineTree(const arma::mat& dataset,
     dataset(dataset),
     delta(delta),
     left(NULL),
-    right(NULL)
+    right(NULL),
+    basisColumn(size_t(-1))
 {
   // Declare the cosine tree priority queue.
   CosineNodeQueue treeQueue;
 
+  // The basis vectors of the nodes in the queue are kept in the first columns
+  // of the basis matrix, which grows by doubling; so orthonormalization and
+  // the Monte Carlo estimates work on one contiguous matrix.
+  basis.set_size(dataset.n_rows, 16);
+
   // Define root node of the tree and add it to the queue.
   CosineTree root(dataset);
   arma::vec tempVector = arma::zeros(dataset.n_rows);
   root.L2Error(0);
   root.BasisVector(tempVector);
+  AddToBasis(&root, tempVector);
   treeQueue.push(&root);
 
   // Initialize Monte Carlo error estimate for comparison.
@@ -94,6 +103,7 @@ CosineTree::CosineTree(const arma::mat& dataset,
     CosineTree* currentNode;
     currentNode = treeQueue.top();
     treeQueue.pop();
+    RemoveFromBasis(currentNode);
 
     // Split the node into left and right children.
     currentNode->CosineNodeSplit();
@@ -103,31 +113,34 @@ CosineTree::CosineTree(const arma::mat& dataset,
     currentLeft = currentNode->Left();
     currentRight = currentNode->Right();
 
-    // Calculate basis vectors of left and right children.
+    // Calculate basis vectors of left and right children; each one is
+    // orthonormalized against the basis, and then added to it.
     arma::vec lBasisVector, rBasisVector;
 
-    ModifiedGramSchmidt(treeQueue, currentLeft->Centroid(), lBasisVector);
-    ModifiedGramSchmidt(treeQueue, currentRight->Centroid(), rBasisVector,
-                        &lBasisVector);
+    ModifiedGramSchmidt(currentLeft->Centroid(), lBasisVector);
+    AddToBasis(currentLeft, lBasisVector);
+    ModifiedGramSchmidt(currentRight->Centroid(), rBasisVector);
+    AddToBasis(currentRight, rBasisVector);
 
     // Add basis vectors to their respective nodes.
     currentLeft->BasisVector(lBasisVector);
     currentRight->BasisVector(rBasisVector);
 
     // Calculate Monte Carlo error estimates for child nodes.
-    MonteCarloError(currentLeft, treeQueue, &lBasisVector, &rBasisVector);
-    MonteCarloError(currentRight, treeQueue, &lBasisVector, &rBasisVector);
+    MonteCarloError(currentLeft);
+    MonteCarloError(currentRight);
 
     // Push child nodes into the priority queue.
     treeQueue.push(currentLeft);
     treeQueue.push(currentRight);
 
     // Calculate Monte Carlo error estimate for the root node.
-    monteCarloError = MonteCarloError(&root, treeQueue);
+    monteCarloError = MonteCarloError(&root);
   }
 
-  // Construct the subspace basis from the current priority queue.
-  ConstructBasis(treeQueue);
+  // The basis of the subspace is the basis vectors of the nodes in the queue.
+  basis.resize(dataset.n_rows, basisNodes.size());
+  basisNodes.clear();
 }
 
 CosineTree::~CosineTree()
@@ -185,8 +198,8 @@ double CosineTree::MonteCarloError(CosineTree* node,
   size_t numSamples = log(node->NumColumns()) + 1;
   node->ColumnSamplesLS(sampledIndices, probabilities, numSamples);
 
-  // Get pointer to the original dataset.
-  arma::mat dataset = node->GetDataset();
+  // Get the original dataset.
+  const arma::mat& dataset = node->GetDataset();
 
   // Initialize weighted projection magnitudes as zeros.
   arma::vec weightedMagnitudes;
@@ -236,6 +249,67 @@ double CosineTree::MonteCarloError(CosineTree* node,
     weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
   }
 
+  return MonteCarloBound(node, weightedMagnitudes);
+}
+
+void CosineTree::ModifiedGramSchmidt(const arma::vec& centroid,
+                                     arma::vec& newBasisVector)
+{
+  newBasisVector = centroid;
+
+  // Remove the projection onto the current basis.  A second pass removes what
+  // rounding errors left of it, so the basis stays orthonormal as it grows.
+  const size_t basisSize = basisNodes.size();
+  if(basisSize > 0)
+  {
+    const arma::mat currentBasis(basis.memptr(), basis.n_rows, basisSize,
+        false, true);
+    for(size_t pass = 0; pass < 2; pass++)
+      newBasisVector -= currentBasis * (currentBasis.t() * newBasisVector);
+  }
+
+  // Normalize the modified centroid vector.
+  const double norm = arma::norm(newBasisVector, 2);
+  if(norm)
+    newBasisVector /= norm;
+}
+
+double CosineTree::MonteCarloError(CosineTree* node)
+{
+  std::vector<size_t> sampledIndices;
+  arma::vec probabilities;
+
+  // Sample O(log m) points from the input node's distribution.
+  // 'm' is the number of columns present in the node.
+  size_t numSamples = log(node->NumColumns()) + 1;
+  node->ColumnSamplesLS(sampledIndices, probabilities, numSamples);
+
+  // Gather the sampled columns, so that all their projections onto the basis
+  // are computed with one matrix multiplication.
+  arma::mat samples(dataset.n_rows, numSamples);
+  #pragma omp parallel for
+  for(omp_size_t i = 0; i < (omp_size_t) numSamples; i++)
+    samples.col(i) = dataset.col(sampledIndices[i]);
+
+  const arma::mat currentBasis(basis.memptr(), basis.n_rows,
+      basisNodes.size(), false, true);
+  const arma::mat projections = currentBasis.t() * samples;
+
+  // Calculate the weighted projection magnitude of each sample.
+  arma::vec weightedMagnitudes(numSamples);
+  #pragma omp parallel for
+  for(omp_size_t i = 0; i < (omp_size_t) numSamples; i++)
+  {
+    weightedMagnitudes(i) = arma::dot(projections.col(i),
+        projections.col(i)) / probabilities(i);
+  }
+
+  return MonteCarloBound(node, weightedMagnitudes);
+}
+
+double CosineTree::MonteCarloBound(CosineTree* node,
+                                   const arma::vec& weightedMagnitudes)
+{
   // Compute mean and standard deviation of the weighted samples.
   double mu = arma::mean(weightedMagnitudes);
   double sigma = arma::stddev(weightedMagnitudes);
@@ -257,6 +331,34 @@ double CosineTree::MonteCarloError(CosineTree* node,
   return (node->FrobNormSquared() - lowerBound);
 }
 
+void CosineTree::AddToBasis(CosineTree* node, const arma::vec& basisVector)
+{
+  if(basisNodes.size() == basis.n_cols)
+    basis.resize(basis.n_rows, std::max(2 * basis.n_cols, (arma::uword) 1));
+
+  node->basisColumn = basisNodes.size();
+  basis.col(node->basisColumn) = basisVector;
+  basisNodes.push_back(node);
+}
+
+void CosineTree::RemoveFromBasis(CosineTree* node)
+{
+  if(node->basisColumn == size_t(-1))
+    return;
+
+  // Move the last basis vector into the freed column.
+  const size_t last = basisNodes.size() - 1;
+  if(node->basisColumn != last)
+  {
+    basis.col(node->basisColumn) = basis.col(last);
+    basisNodes[node->basisColumn] = basisNodes[last];
+    basisNodes[node->basisColumn]->basisColumn = node->basisColumn;
+  }
+
+  basisNodes.pop_back();
+  node->basisColumn = size_t(-1);
+}
+
 void CosineTree::ConstructBasis(CosineNodeQueue& treeQueue)
 {
   // Initialize basis as matrix of zeros.
@@ -315,15 +417,9 @@ void CosineTree::ColumnSamplesLS(std::vector<size_t>& sampledIndices,
                                  arma::vec& probabilities,
                                  size_t numSamples)
 {
-  // Initialize the cumulative distribution vector size.
-  arma::vec cDistribution;
-  cDistribution.zeros(numColumns + 1);
-
-  // Calculate cumulative length-squared distribution for the node.
-  for(size_t i = 0; i < numColumns; i++)
-  {
-    cDistribution(i+1) = cDistribution(i) + l2NormsSquared(i) / frobNormSquared;
-  }
+  // Calculate cumulative length-squared distribution for the node, if it
+  // hasn't been calculated yet.
+  CalculateDistribution();
 
   // Initialize sizes of the 'sampledIndices' and 'probabilities' vectors.
   sampledIndices.resize(numSamples);
@@ -350,15 +446,9 @@ size_t CosineTree::ColumnSampleLS()
     return 0;
   }
 
-  // Initialize the cumulative distribution vector size.
-  arma::vec cDistribution;
-  cDistribution.zeros(numColumns + 1);
-
-  // Calculate cumulative length-squared distribution for the node.
-  for(size_t i = 0; i < numColumns; i++)
-  {
-    cDistribution(i+1) = cDistribution(i) + l2NormsSquared(i) / frobNormSquared;
-  }
+  // Calculate cumulative length-squared distribution for the node, if it
+  // hasn't been calculated yet.
+  CalculateDistribution();
 
   // Generate a random value for sampling.
   double randValue = arma::randu();
@@ -417,6 +507,18 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   }
 }
 
+void CosineTree::CalculateDistribution()
+{
+  if(cDistribution.n_elem == numColumns + 1)
+    return;
+
+  cDistribution.zeros(numColumns + 1);
+  for(size_t i = 0; i < numColumns; i++)
+  {
+    cDistribution(i+1) = cDistribution(i) + l2NormsSquared(i) / frobNormSquared;
+  }
+}
+
 void CosineTree::CalculateCentroid()
 {
   // Initialize centroid as vector of zeros.
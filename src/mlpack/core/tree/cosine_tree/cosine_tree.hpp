@@ -99,6 +99,27 @@ class CosineTree
                          arma::vec* addBasisVector1 = NULL,
                          arma::vec* addBasisVector2 = NULL);
 
+  /**
+   * Calculates the orthonormalization of the passed centroid, with respect to
+   * the basis vectors of the nodes in the queue of the tree being built (which
+   * are kept in one matrix, so that this is done with matrix-vector products).
+   *
+   * @param centroid Centroid of the node being added to the basis.
+   * @param newBasisVector Orthonormalized centroid of the node.
+   */
+  void ModifiedGramSchmidt(const arma::vec& centroid,
+                           arma::vec& newBasisVector);
+
+  /**
+   * Estimates the squared error of the projection of the input node's matrix
+   * onto the basis of the tree being built, as the other overload of
+   * MonteCarloError() does.  The projections of all the samples are computed
+   * at once, in parallel.
+   *
+   * @param node Node for which Monte Carlo estimate is calculated.
+   */
+  double MonteCarloError(CosineTree* node);
+
   /**
    * Constructs the final basis matrix, after the cosine tree construction.
    *
@@ -208,6 +229,24 @@ class CosineTree
   size_t SplitPointIndex() const { return indices[splitPointIndex]; }
 
  private:
+  /**
+   * Fit a normal distribution to the weighted projection magnitudes of the
+   * samples of the given node, and store and return the resulting upper bound
+   * on the squared projection error of the node.
+   */
+  double MonteCarloBound(CosineTree* node,
+                         const arma::vec& weightedMagnitudes);
+
+  //! Add the given basis vector of the given node to the basis being built.
+  void AddToBasis(CosineTree* node, const arma::vec& basisVector);
+
+  //! Remove the basis vector of the given node from the basis being built.
+  void RemoveFromBasis(CosineTree* node);
+
+  //! Calculate the cumulative Length-Squared distribution of the columns in
+  //! the node, if it hasn't been calculated yet.
+  void CalculateDistribution();
+
   //! Matrix for which cosine tree is constructed.
   const arma::mat& dataset;
   //! Cumulative probability for Monte Carlo error lower bound.
@@ -236,6 +275,12 @@ class CosineTree
   double l2Error;
   //! Frobenius norm squared of columns in the node.
   double frobNormSquared;
+  //! Cumulative Length-Squared distribution of columns in the node.
+  arma::vec cDistribution;
+  //! Nodes whose basis vectors are in the columns of the basis being built.
+  std::vector<CosineTree*> basisNodes;
+  //! Column of the basis being built that holds this node's basis vector.
+  size_t basisColumn;
 };
 
 class CompareCosineNode
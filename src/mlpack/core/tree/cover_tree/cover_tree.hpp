@@ -71,6 +71,17 @@ namespace tree {
  * }
  * @endcode
  *
+ * Points can be added to and removed from an existing tree with InsertPoint()
+ * and DeletePoint().  Insertion descends greedily from the root, as in the
+ * simplified cover trees of Izbicki and Shelton (ICML 2015): the point is
+ * passed down to a child that covers it, or if there is none, becomes a new
+ * leaf (or shares a new node with the nearest child, if it is too close to that
+ * child).  This keeps the covering and nesting invariants, separates the point
+ * from its siblings, and keeps the self-child and explicit node structure
+ * that the traversers depend on.  Deletion removes the subtree headed by the
+ * point's highest node and reinserts the other points of that subtree, which
+ * is cheap for the most common case, where the point is a leaf.
+ *
  * The CoverTree class offers three template parameters; a custom metric type
  * can be used with MetricType (this class defaults to the L2-squared metric).
  * The root node's point can be chosen with the RootPointPolicy; by default, the
@@ -232,6 +243,43 @@ class CoverTree
    */
   ~CoverTree();
 
+  /**
+   * Insert the point with the given index in the dataset into the tree.  The
+   * point must already be a column of Dataset() and must not already be held
+   * in the tree (for instance, it may be a point that was removed with
+   * DeletePoint(), or the user may have added a column to the dataset the tree
+   * was built on).  This must be called on the root of the tree.
+   *
+   * @param index Index of the point to insert.
+   */
+  void InsertPoint(const size_t index);
+
+  /**
+   * Add the given point to the dataset, and insert it into the tree.  If the
+   * tree does not own its dataset, a copy of the dataset is made first, so the
+   * dataset that was passed to the constructor is not modified (but any
+   * reference obtained from Dataset() must be refreshed).  This must be called
+   * on the root of the tree.
+   *
+   * @param point Point to add.
+   * @return Index of the new point in Dataset().
+   */
+  template<typename VecType>
+  size_t InsertPoint(const VecType& point,
+                     typename boost::enable_if<IsVector<VecType> >::type* = 0);
+
+  /**
+   * Remove the point with the given index from the tree.  The point stays in
+   * Dataset() (so the indices of other points do not change), but it will not
+   * be held in any node.  This must be called on the root of the tree.  If
+   * the last point of the tree is removed, the tree is empty, and must not be
+   * used for search until a point is inserted again.
+   *
+   * @param index Index of the point to remove.
+   * @return false if the point was not found in the tree.
+   */
+  bool DeletePoint(const size_t index);
+
   //! A single-tree cover tree traverser; see single_tree_traverser.hpp for
   //! implementation.
   template<typename RuleType>
@@ -299,11 +347,18 @@ class CoverTree
   double MinDistance(const CoverTree* other, const double distance) const;
 
   //! Return the minimum distance to another point.
-  double MinDistance(const arma::vec& other) const;
+  template<typename VecType>
+  double MinDistance(const VecType& other,
+                     typename boost::enable_if<IsVector<VecType> >::type* = 0)
+      const;
 
   //! Return the minimum distance to another point given that the distance from
   //! the center to the point has already been calculated.
-  double MinDistance(const arma::vec& other, const double distance) const;
+  template<typename VecType>
+  double MinDistance(const VecType& other,
+                     const double distance,
+                     typename boost::enable_if<IsVector<VecType> >::type* = 0)
+      const;
 
   //! Return the maximum distance to another node.
   double MaxDistance(const CoverTree* other) const;
@@ -313,11 +368,18 @@ class CoverTree
   double MaxDistance(const CoverTree* other, const double distance) const;
 
   //! Return the maximum distance to another point.
-  double MaxDistance(const arma::vec& other) const;
+  template<typename VecType>
+  double MaxDistance(const VecType& other,
+                     typename boost::enable_if<IsVector<VecType> >::type* = 0)
+      const;
 
   //! Return the maximum distance to another point given that the distance from
   //! the center to the point has already been calculated.
-  double MaxDistance(const arma::vec& other, const double distance) const;
+  template<typename VecType>
+  double MaxDistance(const VecType& other,
+                     const double distance,
+                     typename boost::enable_if<IsVector<VecType> >::type* = 0)
+      const;
 
   //! Return the minimum and maximum distance to another node.
   math::Range RangeDistance(const CoverTree* other) const;
@@ -328,12 +390,16 @@ class CoverTree
       const;
 
   //! Return the minimum and maximum distance to another point.
-  math::Range RangeDistance(const arma::vec& other) const;
+  template<typename VecType>
+  math::Range RangeDistance(const VecType& other,
+      typename boost::enable_if<IsVector<VecType> >::type* = 0) const;
 
   //! Return the minimum and maximum distance to another point given that the
   //! point-to-point distance has already been calculated.
-  math::Range RangeDistance(const arma::vec& other, const double distance)
-      const;
+  template<typename VecType>
+  math::Range RangeDistance(const VecType& other,
+      const double distance,
+      typename boost::enable_if<IsVector<VecType> >::type* = 0) const;
 
   //! Returns true: this tree does have self-children.
   static bool HasSelfChildren() { return true; }
@@ -365,7 +431,7 @@ class CoverTree
   //! Get the center of the node and store it in the given vector.
   void Center(arma::vec& center) const
   {
-    center = arma::vec(dataset->col(point));
+    center = arma::conv_to<arma::vec>::from(dataset->col(point));
   }
 
   //! Get the instantiated metric.
@@ -487,6 +553,52 @@ class CoverTree
    */
   void RemoveNewImplicitNodes();
 
+  /**
+   * Insert the given point below this (non-leaf) node, which must cover it.
+   * numDescendants and furthestDescendantDistance are updated on the way down,
+   * and statistics are rebuilt on the way back up.
+   *
+   * @param index Index of the point to insert.
+   * @param distance Distance between this node's point and the new point.
+   */
+  void InsertBelow(const size_t index, const double distance);
+
+  /**
+   * Find the highest node holding the given point, below (and including) this
+   * node.
+   *
+   * @param index Index of the point to find.
+   * @param distance Distance between this node's point and the point.
+   * @return The node, or NULL if the point is not a descendant.
+   */
+  CoverTree* FindPoint(const size_t index, const double distance);
+
+  /**
+   * Collect the points of this subtree, ordered so that points held in higher
+   * nodes come first (which makes reinsertion of the points give a better
+   * tree).
+   *
+   * @param points Vector to append the points to.
+   */
+  void CollectPoints(std::vector<size_t>& points) const;
+
+  /**
+   * If this node has only its self-child left, replace it with that child in
+   * the tree (if this is the root, the root takes the child's place instead).
+   * This node may be deleted, so it must not be used afterwards.
+   *
+   * @return The node that takes this node's place.
+   */
+  CoverTree* RemoveImplicitNode();
+
+  /**
+   * Rebuild the statistics of this node and all of its ancestors.
+   */
+  void RebuildStatistics();
+
+  //! Return the smallest scale i such that base^i is at least the distance.
+  int ScaleOf(const double distance) const;
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -12,6 +12,8 @@
 
 #include <mlpack/core/util/string_util.hpp>
 #include <string>
+#include <stack>
+#include <queue>
 
 namespace mlpack {
 namespace tree {
@@ -47,7 +49,11 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CoverTree(
   // If there is only one point or zero points in the dataset... uh, we're done.
   // Technically, if the dataset has zero points, our node is not correct...
   if (dataset.n_cols <= 1)
+  {
+    numDescendants = dataset.n_cols;
+    stat = StatisticType(*this);
     return;
+  }
 
   // Kick off the building.  Create the indices array and the distances array.
   arma::Col<size_t> indices = arma::linspace<arma::Col<size_t> >(1,
@@ -132,7 +138,11 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CoverTree(
   // If there is only one point or zero points in the dataset... uh, we're done.
   // Technically, if the dataset has zero points, our node is not correct...
   if (dataset.n_cols <= 1)
+  {
+    numDescendants = dataset.n_cols;
+    stat = StatisticType(*this);
     return;
+  }
 
   // Kick off the building.  Create the indices array and the distances array.
   arma::Col<size_t> indices = arma::linspace<arma::Col<size_t> >(1,
@@ -219,7 +229,11 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CoverTree(
   // If there is only one point or zero points in the dataset... uh, we're done.
   // Technically, if the dataset has zero points, our node is not correct...
   if (dataset->n_cols <= 1)
+  {
+    numDescendants = dataset->n_cols;
+    stat = StatisticType(*this);
     return;
+  }
 
   // Kick off the building.  Create the indices array and the distances array.
   arma::Col<size_t> indices = arma::linspace<arma::Col<size_t> >(1,
@@ -304,7 +318,11 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CoverTree(
   // If there is only one point or zero points in the dataset... uh, we're done.
   // Technically, if the dataset has zero points, our node is not correct...
   if (dataset->n_cols <= 1)
+  {
+    numDescendants = dataset->n_cols;
+    stat = StatisticType(*this);
     return;
+  }
 
   // Kick off the building.  Create the indices array and the distances array.
   arma::Col<size_t> indices = arma::linspace<arma::Col<size_t> >(1,
@@ -599,8 +617,10 @@ template<
     typename MatType,
     typename RootPointPolicy
 >
+template<typename VecType>
 double CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MinDistance(const arma::vec& other) const
+    MinDistance(const VecType& other,
+                typename boost::enable_if<IsVector<VecType> >::type*) const
 {
   return std::max(metric->Evaluate(dataset->col(point), other) -
       furthestDescendantDistance, 0.0);
@@ -612,8 +632,11 @@ template<
     typename MatType,
     typename RootPointPolicy
 >
+template<typename VecType>
 double CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MinDistance(const arma::vec& /* other */, const double distance) const
+    MinDistance(const VecType& /* other */,
+                const double distance,
+                typename boost::enable_if<IsVector<VecType> >::type*) const
 {
   return std::max(distance - furthestDescendantDistance, 0.0);
 }
@@ -652,8 +675,10 @@ template<
     typename MatType,
     typename RootPointPolicy
 >
+template<typename VecType>
 double CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MaxDistance(const arma::vec& other) const
+    MaxDistance(const VecType& other,
+                typename boost::enable_if<IsVector<VecType> >::type*) const
 {
   return metric->Evaluate(dataset->col(point), other) +
       furthestDescendantDistance;
@@ -665,8 +690,11 @@ template<
     typename MatType,
     typename RootPointPolicy
 >
+template<typename VecType>
 double CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    MaxDistance(const arma::vec& /* other */, const double distance) const
+    MaxDistance(const VecType& /* other */,
+                const double distance,
+                typename boost::enable_if<IsVector<VecType> >::type*) const
 {
   return distance + furthestDescendantDistance;
 }
@@ -721,8 +749,10 @@ template<
     typename MatType,
     typename RootPointPolicy
 >
+template<typename VecType>
 math::Range CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    RangeDistance(const arma::vec& other) const
+    RangeDistance(const VecType& other,
+                  typename boost::enable_if<IsVector<VecType> >::type*) const
 {
   const double distance = metric->Evaluate(dataset->col(point), other);
 
@@ -738,9 +768,11 @@ template<
     typename MatType,
     typename RootPointPolicy
 >
+template<typename VecType>
 math::Range CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
-    RangeDistance(const arma::vec& /* other */,
-                  const double distance) const
+    RangeDistance(const VecType& /* other */,
+                  const double distance,
+                  typename boost::enable_if<IsVector<VecType> >::type*) const
 {
   return math::Range(distance - furthestDescendantDistance,
                      distance + furthestDescendantDistance);
@@ -1312,6 +1344,445 @@ inline void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
   }
 }
 
+/**
+ * Insert a point that is already in the dataset into the tree.
+ */
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    InsertPoint(const size_t index)
+{
+  Log::Assert(parent == NULL);
+
+  // If the tree is empty, the point becomes the root.
+  if (numDescendants == 0)
+  {
+    point = index;
+    scale = INT_MAX;
+    furthestDescendantDistance = 0;
+    numDescendants = 1;
+    stat = StatisticType(*this);
+    return;
+  }
+
+  const double distance = metric->Evaluate(dataset->col(point),
+      dataset->col(index));
+
+  // If the root is the only point, the root gets a self-child and a child for
+  // the new point.
+  if (children.size() == 0)
+  {
+    scale = ScaleOf(distance);
+    children.push_back(new CoverTree(*dataset, base, point, INT_MIN, this, 0, 0,
+        metric));
+    children.push_back(new CoverTree(*dataset, base, index, INT_MIN, this,
+        distance, 0, metric));
+    children[0]->numDescendants = 1;
+    children[1]->numDescendants = 1;
+
+    furthestDescendantDistance = distance;
+    numDescendants = 2;
+    stat = StatisticType(*this);
+    return;
+  }
+
+  // If the root does not cover the new point, raise the scale of the root; its
+  // old children are moved to a new self-child at the old scale.
+  if (distance > pow(base, scale))
+  {
+    CoverTree* selfChild = new CoverTree(*dataset, base, point, scale, this, 0,
+        furthestDescendantDistance, metric);
+    selfChild->children.swap(children);
+    selfChild->numDescendants = numDescendants;
+    for (size_t i = 0; i < selfChild->children.size(); ++i)
+      selfChild->children[i]->parent = selfChild;
+    selfChild->stat = StatisticType(*selfChild);
+
+    CoverTree* leaf = new CoverTree(*dataset, base, index, INT_MIN, this,
+        distance, 0, metric);
+    leaf->numDescendants = 1;
+
+    children.push_back(selfChild);
+    children.push_back(leaf);
+    scale = ScaleOf(distance);
+    furthestDescendantDistance = std::max(furthestDescendantDistance,
+        distance);
+    ++numDescendants;
+    stat = StatisticType(*this);
+    return;
+  }
+
+  InsertBelow(index, distance);
+}
+
+/**
+ * Add a point to the dataset and insert it into the tree.
+ */
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+template<typename VecType>
+size_t CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    InsertPoint(const VecType& newPoint,
+                typename boost::enable_if<IsVector<VecType> >::type*)
+{
+  Log::Assert(parent == NULL);
+
+  // We can only modify the dataset if we own it.
+  if (!localDataset)
+  {
+    const MatType* newDataset = new MatType(*dataset);
+    std::stack<CoverTree*> nodes;
+    nodes.push(this);
+    while (!nodes.empty())
+    {
+      CoverTree* node = nodes.top();
+      nodes.pop();
+
+      node->dataset = newDataset;
+      for (size_t i = 0; i < node->children.size(); ++i)
+        nodes.push(node->children[i]);
+    }
+
+    localDataset = true;
+  }
+
+  MatType& data = const_cast<MatType&>(*dataset);
+  data.resize(data.n_rows, data.n_cols + 1);
+  data.col(data.n_cols - 1) = newPoint;
+
+  InsertPoint(data.n_cols - 1);
+  return data.n_cols - 1;
+}
+
+/**
+ * Remove a point from the tree.
+ */
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+bool CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    DeletePoint(const size_t index)
+{
+  Log::Assert(parent == NULL);
+
+  if (numDescendants == 0)
+    return false;
+
+  CoverTree* node = FindPoint(index, metric->Evaluate(dataset->col(point),
+      dataset->col(index)));
+  if (node == NULL)
+    return false;
+
+  // The other points held in the subtree of the node will need to be
+  // reinserted.
+  std::vector<size_t> orphans;
+  node->CollectPoints(orphans);
+  orphans.erase(orphans.begin()); // This is the point being removed.
+
+  if (node == this)
+  {
+    // We are removing the root point, so the whole tree must be rebuilt.
+    for (size_t i = 0; i < children.size(); ++i)
+      delete children[i];
+    children.clear();
+    numDescendants = 0;
+
+    for (size_t i = 0; i < orphans.size(); ++i)
+      InsertPoint(orphans[i]);
+
+    if (numDescendants == 0)
+    {
+      scale = INT_MAX;
+      furthestDescendantDistance = 0;
+      stat = StatisticType(*this);
+    }
+
+    return true;
+  }
+
+  // Detach the node from its parent; it is never the self-child, because it
+  // is the highest node holding the point.
+  CoverTree* nodeParent = node->parent;
+  for (size_t i = 1; i < nodeParent->children.size(); ++i)
+  {
+    if (nodeParent->children[i] == node)
+    {
+      nodeParent->children.erase(nodeParent->children.begin() + i);
+      break;
+    }
+  }
+
+  for (CoverTree* ancestor = nodeParent; ancestor != NULL;
+       ancestor = ancestor->parent)
+    ancestor->numDescendants -= node->numDescendants;
+
+  delete node;
+
+  // The parent may now be an implicit node.  (Its furthest descendant
+  // distance, and those of its ancestors, are still valid upper bounds.)
+  nodeParent->RemoveImplicitNode()->RebuildStatistics();
+
+  for (size_t i = 0; i < orphans.size(); ++i)
+    InsertPoint(orphans[i]);
+
+  return true;
+}
+
+//! Insert a point below a node that covers it.
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    InsertBelow(const size_t index, const double distance)
+{
+  ++numDescendants;
+  furthestDescendantDistance = std::max(furthestDescendantDistance, distance);
+
+  // Find the closest child which covers the point at its own scale, and the
+  // closest child overall.
+  size_t coveringChild = children.size();
+  double coveringDistance = DBL_MAX;
+  size_t closestChild = 0;
+  double closestDistance = DBL_MAX;
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    // The self-child has the same point as this node.
+    double childDistance = distance;
+    if (i > 0)
+    {
+      childDistance = metric->Evaluate(dataset->col(children[i]->point),
+          dataset->col(index));
+      ++distanceComps;
+    }
+
+    if (childDistance < closestDistance)
+    {
+      closestDistance = childDistance;
+      closestChild = i;
+    }
+
+    if (children[i]->NumChildren() > 0 && childDistance < coveringDistance &&
+        childDistance <= pow(base, children[i]->scale))
+    {
+      coveringDistance = childDistance;
+      coveringChild = i;
+    }
+  }
+
+  if (coveringChild < children.size())
+  {
+    // Descend into the child.
+    children[coveringChild]->InsertBelow(index, coveringDistance);
+  }
+  else if (scale > INT_MIN + 1 && closestDistance <= pow(base, scale - 1))
+  {
+    // The point is too close to the closest child to be its sibling, so the
+    // child and the point become the children of a new node, which takes the
+    // place of the child at the scale just large enough to cover the point.
+    CoverTree* child = children[closestChild];
+    const int newScale = std::max(ScaleOf(closestDistance), child->scale + 1);
+
+    CoverTree* newNode = new CoverTree(*dataset, base, child->point, newScale,
+        this, child->parentDistance, std::max(
+        child->furthestDescendantDistance, closestDistance), metric);
+    CoverTree* leaf = new CoverTree(*dataset, base, index, INT_MIN, newNode,
+        closestDistance, 0, metric);
+    leaf->numDescendants = 1;
+
+    child->parent = newNode;
+    child->parentDistance = 0;
+    newNode->children.push_back(child);
+    newNode->children.push_back(leaf);
+    newNode->numDescendants = child->numDescendants + 1;
+    newNode->stat = StatisticType(*newNode);
+
+    children[closestChild] = newNode;
+  }
+  else
+  {
+    // The point is far enough from every child to be a new leaf.  (If this
+    // node is at the lowest non-leaf scale, its children and the point are all
+    // duplicates of its point, so the point is simply added as a leaf too.)
+    CoverTree* leaf = new CoverTree(*dataset, base, index, INT_MIN, this,
+        distance, 0, metric);
+    leaf->numDescendants = 1;
+    children.push_back(leaf);
+  }
+
+  stat = StatisticType(*this);
+}
+
+//! Find the highest node holding a point.
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>*
+CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    FindPoint(const size_t index, const double distance)
+{
+  if (point == index)
+    return this;
+
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    const double childDistance = (i == 0) ? distance :
+        metric->Evaluate(dataset->col(children[i]->point),
+                         dataset->col(index));
+
+    // The point can only be below the child if the child's bound contains it.
+    if (childDistance > children[i]->furthestDescendantDistance)
+      continue;
+
+    CoverTree* node = children[i]->FindPoint(index, childDistance);
+    if (node != NULL)
+      return node;
+  }
+
+  return NULL;
+}
+
+//! Collect the points held in a subtree.
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    CollectPoints(std::vector<size_t>& points) const
+{
+  // A breadth-first traversal, taking each point at its highest node.
+  std::queue<const CoverTree*> nodes;
+  nodes.push(this);
+  points.push_back(point);
+  while (!nodes.empty())
+  {
+    const CoverTree* node = nodes.front();
+    nodes.pop();
+
+    for (size_t i = 0; i < node->children.size(); ++i)
+    {
+      // The self-child holds the same point as its parent.
+      if (i > 0)
+        points.push_back(node->children[i]->point);
+      nodes.push(node->children[i]);
+    }
+  }
+}
+
+//! Remove this node if it has only its self-child.
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>*
+CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    RemoveImplicitNode()
+{
+  if (children.size() != 1)
+    return this;
+
+  CoverTree* selfChild = children[0];
+  if (parent == NULL)
+  {
+    // The root must stay where it is, so it takes the place of its self-child
+    // instead.
+    children.clear();
+    if (selfChild->NumChildren() == 0)
+    {
+      scale = INT_MAX;
+      furthestDescendantDistance = 0;
+    }
+    else
+    {
+      children.swap(selfChild->children);
+      for (size_t i = 0; i < children.size(); ++i)
+        children[i]->parent = this;
+      scale = selfChild->scale;
+      furthestDescendantDistance = selfChild->furthestDescendantDistance;
+    }
+
+    delete selfChild;
+    return this;
+  }
+
+  // Put the self-child where this node was.
+  for (size_t i = 0; i < parent->children.size(); ++i)
+  {
+    if (parent->children[i] == this)
+    {
+      parent->children[i] = selfChild;
+      break;
+    }
+  }
+
+  selfChild->parent = parent;
+  selfChild->parentDistance = parentDistance;
+  selfChild->stat = StatisticType(*selfChild);
+
+  children.clear();
+  delete this;
+  return selfChild;
+}
+
+//! Rebuild the statistics of a node and its ancestors.
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+void CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    RebuildStatistics()
+{
+  for (CoverTree* node = this; node != NULL; node = node->parent)
+    node->stat = StatisticType(*node);
+}
+
+//! Find the scale needed to cover a distance.
+template<
+    typename MetricType,
+    typename StatisticType,
+    typename MatType,
+    typename RootPointPolicy
+>
+int CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
+    ScaleOf(const double distance) const
+{
+  // Identical points can be covered only by the lowest non-leaf scale.
+  if (distance == 0)
+    return INT_MIN + 1;
+
+  // Correct for any roundoff in the logarithm, so base^scale is certainly at
+  // least the distance, and base^(scale - 1) is less than it.
+  int result = (int) ceil(log(distance) / log(base));
+  while (pow(base, result) < distance)
+    ++result;
+  while (pow(base, result - 1) >= distance)
+    --result;
+
+  return result;
+}
+
 /**
  * Default constructor, only for use with boost::serialization.
  */
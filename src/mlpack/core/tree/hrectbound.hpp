@@ -95,6 +95,21 @@ class HRectBound
   //! Modify the minimum width of the bound.
   double& MinWidth() { return minWidth; }
 
+  /**
+   * Store the ranges of this bound in the given externally-owned memory, which
+   * must hold at least Dim() ranges and must outlive the bound (or until
+   * another call to UseMemory()).  The current ranges are copied into the
+   * memory.  This is used to place the bounds of many tree nodes in one
+   * contiguous block.  If memory is NULL, the bound allocates (and owns) its
+   * own memory again.
+   *
+   * @param memory Memory to store the ranges in.
+   */
+  void UseMemory(math::Range* memory);
+
+  //! Return whether or not the ranges are owned by this bound.
+  bool OwnsMemory() const { return ownsBounds; }
+
   /**
    * Calculates the center of the range, placing it into the given vector.
    *
@@ -199,6 +214,8 @@ class HRectBound
   math::Range* bounds;
   //! Cached minimum width of bound.
   double minWidth;
+  //! If true, the bounds array is freed when the bound is destroyed.
+  bool ownsBounds;
 };
 
 // A specialization of BoundTraits for this class.
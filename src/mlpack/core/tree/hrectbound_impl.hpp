@@ -24,7 +24,8 @@ template<typename MetricType>
 inline HRectBound<MetricType>::HRectBound() :
     dim(0),
     bounds(NULL),
-    minWidth(0)
+    minWidth(0),
+    ownsBounds(true)
 { /* Nothing to do. */ }
 
 /**
@@ -35,7 +36,8 @@ template<typename MetricType>
 inline HRectBound<MetricType>::HRectBound(const size_t dimension) :
     dim(dimension),
     bounds(new math::Range[dim]),
-    minWidth(0)
+    minWidth(0),
+    ownsBounds(true)
 { /* Nothing to do. */ }
 
 /**
@@ -45,7 +47,8 @@ template<typename MetricType>
 inline HRectBound<MetricType>::HRectBound(const HRectBound& other) :
     dim(other.Dim()),
     bounds(new math::Range[dim]),
-    minWidth(other.MinWidth())
+    minWidth(other.MinWidth()),
+    ownsBounds(true)
 {
   // Copy other bounds over.
   for (size_t i = 0; i < dim; i++)
@@ -62,11 +65,12 @@ inline HRectBound<MetricType>& HRectBound<MetricType>::operator=(
   if (dim != other.Dim())
   {
     // Reallocation is necessary.
-    if (bounds)
+    if (bounds && ownsBounds)
       delete[] bounds;
 
     dim = other.Dim();
     bounds = new math::Range[dim];
+    ownsBounds = true;
   }
 
   // Now copy each of the bound values.
@@ -85,12 +89,14 @@ template<typename MetricType>
 inline HRectBound<MetricType>::HRectBound(HRectBound&& other) :
     dim(other.dim),
     bounds(other.bounds),
-    minWidth(other.minWidth)
+    minWidth(other.minWidth),
+    ownsBounds(other.ownsBounds)
 {
   // Fix the other bound.
   other.dim = 0;
   other.bounds = NULL;
   other.minWidth = 0.0;
+  other.ownsBounds = true;
 }
 
 /**
@@ -99,10 +105,30 @@ inline HRectBound<MetricType>::HRectBound(HRectBound&& other) :
 template<typename MetricType>
 inline HRectBound<MetricType>::~HRectBound()
 {
-  if (bounds)
+  if (bounds && ownsBounds)
     delete[] bounds;
 }
 
+/**
+ * Move the ranges into the given memory (or into newly allocated memory).
+ */
+template<typename MetricType>
+inline void HRectBound<MetricType>::UseMemory(math::Range* memory)
+{
+  const bool owned = (memory == NULL);
+  if (owned)
+    memory = new math::Range[dim];
+
+  for (size_t i = 0; i < dim; i++)
+    memory[i] = bounds[i];
+
+  if (bounds && ownsBounds)
+    delete[] bounds;
+
+  bounds = memory;
+  ownsBounds = owned;
+}
+
 /**
  * Resets all dimensions to the empty set.
  */
@@ -369,8 +395,9 @@ inline HRectBound<MetricType>& HRectBound<MetricType>::operator|=(
 {
   Log::Assert(data.n_rows == dim);
 
-  arma::vec mins(min(data, 1));
-  arma::vec maxs(max(data, 1));
+  // Keep the element type of the data, so that this works for float data too.
+  arma::Col<typename MatType::elem_type> mins(min(data, 1));
+  arma::Col<typename MatType::elem_type> maxs(max(data, 1));
 
   minWidth = DBL_MAX;
   for (size_t i = 0; i < dim; i++)
@@ -449,9 +476,10 @@ void HRectBound<MetricType>::Serialize(Archive& ar,
   // Allocate memory for the bounds, if necessary.
   if (Archive::is_loading::value)
   {
-    if (bounds)
+    if (bounds && ownsBounds)
       delete[] bounds;
     bounds = new math::Range[dim];
+    ownsBounds = true;
   }
 
   ar & data::CreateArrayNVP(bounds, dim, "bounds");
@@ -18,6 +18,17 @@
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+/**
+ * The ways a RectangleTree can be built from a whole dataset.
+ */
+enum RectangleTreeBuildType
+{
+  //! Insert the points one at a time, splitting nodes as necessary.
+  INSERTION_BUILD,
+  //! Pack the points into full leaves with the Sort-Tile-Recursive algorithm.
+  STR_BULK_LOAD
+};
+
 /**
  * A rectangle type tree tree, such as an R-tree or X-tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -26,6 +37,14 @@ namespace tree /** Trees and tree-building procedures. */ {
  *
  * This tree does allow growth, so you can add and delete nodes from it.
  *
+ * If the whole dataset is available up front, the tree can instead be
+ * bulk-loaded with the Sort-Tile-Recursive (STR) algorithm by passing
+ * STR_BULK_LOAD to the constructor.  This takes O(n log n) time, and gives a
+ * balanced tree whose leaves and nodes are (nearly) full and whose bounds
+ * overlap very little, which is usually both much faster to build and faster
+ * to search than a tree built by inserting points one at a time.  Points can
+ * still be inserted into or deleted from a bulk-loaded tree.
+ *
  * @tparam MetricType This *must* be EuclideanDistance, but the template
  *     parameter is required to satisfy the TreeType API.
  * @tparam StatisticType Extra data contained in the node.  See statistic.hpp
@@ -165,6 +184,52 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree using the given
+   * dataset, with the given build algorithm.  With INSERTION_BUILD this is the
+   * same as the constructor above; with STR_BULK_LOAD, the tree is bulk-loaded
+   * with the Sort-Tile-Recursive algorithm, so that every leaf holds
+   * maxLeafSize points and every non-leaf node holds maxNumChildren children
+   * (except for at most the last two nodes of each level, which are balanced
+   * so that they still satisfy the minimum fills).
+   *
+   * @param data Dataset from which to create the tree.
+   * @param buildType Algorithm to use to build the tree.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(const MatType& data,
+                const RectangleTreeBuildType buildType,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
+  /**
+   * Construct this as the root node of a rectangle type tree using the given
+   * dataset and the given build algorithm, taking ownership of the given
+   * dataset.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param buildType Algorithm to use to build the tree.
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(MatType&& data,
+                const RectangleTreeBuildType buildType,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -547,6 +612,50 @@ class RectangleTree
    */
   void SplitNode(std::vector<bool>& relevels);
 
+  /**
+   * Build the tree below this (empty) root node with the Sort-Tile-Recursive
+   * algorithm: the points are tiled into full leaves, then the leaves (by
+   * their centers) are tiled into full nodes, and so on, until at most
+   * maxNumChildren nodes remain, which become the children of this node.
+   */
+  void BulkLoad();
+
+  /**
+   * Reorder the indices order[begin, end) so that consecutive groups of
+   * capacity indices are spatially close, using the Sort-Tile-Recursive
+   * tiling: sort by dimension dim, cut into slabs, and recurse into each slab
+   * with the next dimension.
+   *
+   * @param coordinates Matrix whose columns are the items being tiled.
+   * @param order Indices of the columns to tile.
+   * @param begin First index of order to tile.
+   * @param end One past the last index of order to tile.
+   * @param dim Dimension to sort by.
+   * @param capacity Number of items in each group.
+   */
+  template<typename CoordinatesType>
+  static void TileSTR(const CoordinatesType& coordinates,
+                      std::vector<size_t>& order,
+                      const size_t begin,
+                      const size_t end,
+                      const size_t dim,
+                      const size_t capacity);
+
+  /**
+   * Split count tiled items into consecutive groups of capacity items, moving
+   * items from the second-to-last group to the last group if the last group
+   * would otherwise have fewer than minimum items.
+   *
+   * @param count Number of items.
+   * @param capacity Maximum number of items in each group.
+   * @param minimum Minimum number of items in each group.
+   * @param groupEnds Will be set to the end index of each group.
+   */
+  static void PackGroups(const size_t count,
+                         const size_t capacity,
+                         const size_t minimum,
+                         std::vector<size_t>& groupEnds);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -95,6 +95,92 @@ RectangleTree(MatType&& data,
     root->InsertPoint(i);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
+RectangleTree(const MatType& data,
+              const RectangleTreeBuildType buildType,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    splitHistory(bound.Dim()),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    localDataset(new MatType(arma::zeros<MatType>(data.n_rows,
+                                                  maxLeafSize + 1)))
+{
+  stat = StatisticType(*this);
+
+  if (buildType == STR_BULK_LOAD)
+  {
+    BulkLoad();
+  }
+  else
+  {
+    for (size_t i = 0; i < dataset->n_cols; i++)
+      InsertPoint(i);
+  }
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
+RectangleTree(MatType&& data,
+              const RectangleTreeBuildType buildType,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    splitHistory(bound.Dim()),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    localDataset(new MatType(arma::zeros<MatType>(dataset->n_rows,
+                                                  maxLeafSize + 1)))
+{
+  stat = StatisticType(*this);
+
+  if (buildType == STR_BULK_LOAD)
+  {
+    BulkLoad();
+  }
+  else
+  {
+    for (size_t i = 0; i < dataset->n_cols; i++)
+      InsertPoint(i);
+  }
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -284,7 +370,7 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
   // If it is not a leaf node, we use the DescentHeuristic to choose a child
   // to which we recurse.
   const size_t descentNode = DescentType::ChooseDescentNode(this,
-      dataset->col(point));
+      arma::conv_to<arma::vec>::from(dataset->col(point)));
   children[descentNode]->InsertPoint(point, lvls);
 }
 
@@ -317,7 +403,7 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
   // If it is not a leaf node, we use the DescentHeuristic to choose a child
   // to which we recurse.
   const size_t descentNode = DescentType::ChooseDescentNode(this,
-      dataset->col(point));
+      arma::conv_to<arma::vec>::from(dataset->col(point)));
   children[descentNode]->InsertPoint(point, relevels);
 }
 
@@ -385,7 +471,8 @@ bool RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
         localDataset->col(i) = localDataset->col(--count); // Decrement count.
         points[i] = points[count];
         // This function wil ensure that minFill is satisfied.
-        CondenseTree(dataset->col(point), lvls, true);
+        CondenseTree(arma::conv_to<arma::vec>::from(dataset->col(point)),
+            lvls, true);
         return true;
       }
     }
@@ -420,7 +507,8 @@ bool RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
         localDataset->col(i) = localDataset->col(--count);
         points[i] = points[count];
         // This function will ensure that minFill is satisfied.
-        CondenseTree(dataset->col(point), relevels, true);
+        CondenseTree(arma::conv_to<arma::vec>::from(dataset->col(point)),
+            relevels, true);
         return true;
       }
     }
@@ -673,6 +761,183 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
   }
 }
 
+/**
+ * Bulk-load the tree with the Sort-Tile-Recursive algorithm.  This node must be
+ * an empty root.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
+    BulkLoad()
+{
+  const size_t n = dataset->n_cols;
+
+  // If everything fits in one leaf, the root is that leaf.
+  if (n <= maxLeafSize)
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      bound |= dataset->col(i);
+      localDataset->col(count) = dataset->col(i);
+      points[count++] = i;
+    }
+
+    stat = StatisticType(*this);
+    return;
+  }
+
+  // Tile the points and pack them into leaves.
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; i++)
+    order[i] = i;
+  TileSTR(*dataset, order, 0, n, 0, maxLeafSize);
+
+  std::vector<size_t> groupEnds;
+  PackGroups(n, maxLeafSize, minLeafSize, groupEnds);
+
+  std::vector<RectangleTree*> nodes;
+  nodes.reserve(groupEnds.size());
+  size_t groupBegin = 0;
+  for (size_t g = 0; g < groupEnds.size(); g++)
+  {
+    RectangleTree* leaf = new RectangleTree(this);
+    for (size_t i = groupBegin; i < groupEnds[g]; i++)
+    {
+      leaf->bound |= dataset->col(order[i]);
+      leaf->localDataset->col(leaf->count) = dataset->col(order[i]);
+      leaf->points[leaf->count++] = order[i];
+    }
+
+    leaf->stat = StatisticType(*leaf);
+    nodes.push_back(leaf);
+    groupBegin = groupEnds[g];
+  }
+
+  // Now tile the nodes of each level, by their centers, and pack them into
+  // the nodes of the level above, until they fit in the root.
+  while (nodes.size() > maxNumChildren)
+  {
+    arma::mat centers(bound.Dim(), nodes.size());
+    arma::vec center;
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+      nodes[i]->Center(center);
+      centers.col(i) = center;
+    }
+
+    order.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++)
+      order[i] = i;
+    TileSTR(centers, order, 0, nodes.size(), 0, maxNumChildren);
+    PackGroups(nodes.size(), maxNumChildren, minNumChildren, groupEnds);
+
+    std::vector<RectangleTree*> parents;
+    parents.reserve(groupEnds.size());
+    groupBegin = 0;
+    for (size_t g = 0; g < groupEnds.size(); g++)
+    {
+      RectangleTree* node = new RectangleTree(this);
+      for (size_t i = groupBegin; i < groupEnds[g]; i++)
+      {
+        RectangleTree* child = nodes[order[i]];
+        child->parent = node;
+        node->bound |= child->bound;
+        node->children[node->numChildren++] = child;
+      }
+
+      node->stat = StatisticType(*node);
+      parents.push_back(node);
+      groupBegin = groupEnds[g];
+    }
+
+    nodes.swap(parents);
+  }
+
+  // The remaining nodes are the children of the root.
+  for (size_t i = 0; i < nodes.size(); i++)
+  {
+    bound |= nodes[i]->bound;
+    children[numChildren++] = nodes[i];
+  }
+
+  stat = StatisticType(*this);
+}
+
+/**
+ * Sort-Tile-Recursive tiling of a set of columns.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType>
+template<typename CoordinatesType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
+    TileSTR(const CoordinatesType& coordinates,
+            std::vector<size_t>& order,
+            const size_t begin,
+            const size_t end,
+            const size_t dim,
+            const size_t capacity)
+{
+  const size_t itemCount = end - begin;
+  if (itemCount <= capacity)
+    return; // This is already a single group.
+
+  std::sort(order.begin() + begin, order.begin() + end,
+      [&coordinates, dim](const size_t a, const size_t b)
+      { return coordinates(dim, a) < coordinates(dim, b); });
+
+  // If this is the last dimension, the sorted order is cut into groups.
+  if (dim + 1 >= (size_t) coordinates.n_rows)
+    return;
+
+  // Cut the groups into S slabs along this dimension, where S is the
+  // (d - dim)'th root of the number of groups, so that every remaining
+  // dimension is cut into the same number of slabs.
+  const size_t groups = (itemCount + capacity - 1) / capacity;
+  const size_t slabs = (size_t) std::ceil(std::pow((double) groups,
+      1.0 / (coordinates.n_rows - dim)));
+  const size_t slabSize = ((groups + slabs - 1) / slabs) * capacity;
+
+  for (size_t slabBegin = begin; slabBegin < end; slabBegin += slabSize)
+    TileSTR(coordinates, order, slabBegin, std::min(slabBegin + slabSize, end),
+        dim + 1, capacity);
+}
+
+/**
+ * Cut tiled items into groups that satisfy the fill constraints.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType>::
+    PackGroups(const size_t count,
+               const size_t capacity,
+               const size_t minimum,
+               std::vector<size_t>& groupEnds)
+{
+  groupEnds.clear();
+  for (size_t end = capacity; end < count; end += capacity)
+    groupEnds.push_back(end);
+  groupEnds.push_back(count);
+
+  // Balance the last two groups if the last one is too small.
+  const size_t numGroups = groupEnds.size();
+  if (numGroups > 1 &&
+      groupEnds[numGroups - 1] - groupEnds[numGroups - 2] < minimum)
+  {
+    const size_t lastTwo = count - (numGroups > 2 ? groupEnds[numGroups - 3] :
+        0);
+    groupEnds[numGroups - 2] = count - lastTwo / 2;
+  }
+}
+
 //! Default constructor for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -193,28 +193,45 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::Row<size_t> tempPredictedLabels(test.n_cols);
-  arma::mat cMatrix(classes, test.n_cols);
-
-  cMatrix.zeros();
   predictedLabels.set_size(test.n_cols);
 
-  for (size_t i = 0; i < wl.size(); i++)
+  // Collect the votes of the weak learners in blocks of points, so that only
+  // the votes of one block are held at once.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (test.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel
   {
-    wl[i].Classify(test, tempPredictedLabels);
+    // Scratch space for one block, reused for each block.
+    MatType block;
+    arma::Row<size_t> tempPredictedLabels;
+    arma::mat votes(classes, blockSize);
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
-      cMatrix(tempPredictedLabels(j), j) += alpha[i];
-  }
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t count = std::min(blockSize, (size_t) test.n_cols - begin);
 
-  arma::colvec cMRow;
-  arma::uword maxIndex;
+      block = test.cols(begin, begin + count - 1);
+      arma::mat blockVotes(votes.memptr(), classes, count, false, true);
+      blockVotes.zeros();
 
-  for (size_t i = 0; i < predictedLabels.n_cols; i++)
-  {
-    cMRow = cMatrix.unsafe_col(i);
-    cMRow.max(maxIndex);
-    predictedLabels(i) = maxIndex;
+      for (size_t i = 0; i < wl.size(); ++i)
+      {
+        wl[i].Classify(block, tempPredictedLabels);
+
+        for (size_t j = 0; j < count; ++j)
+          blockVotes(tempPredictedLabels[j], j) += alpha[i];
+      }
+
+      arma::uword maxIndex;
+      for (size_t j = 0; j < count; ++j)
+      {
+        blockVotes.unsafe_col(j).max(maxIndex);
+        predictedLabels[begin + j] = maxIndex;
+      }
+    }
   }
 }
 
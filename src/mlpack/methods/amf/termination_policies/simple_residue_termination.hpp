@@ -21,6 +21,12 @@ namespace amf {
  * IsConverged() will return true.  This class is meant for use with the AMF
  * (alternating matrix factorization) class.
  *
+ * The norm of WH is calculated from the r x r matrix W^T W, so W * H is never
+ * formed and checking the residue costs much less than an update step.  To make
+ * it cheaper still, the residue can be checked only every few iterations (see
+ * the checkInterval parameter); the residue is then the relative change of the
+ * norm since the last check.
+ *
  * @see AMF
  */
 class SimpleResidueTermination
@@ -29,14 +35,19 @@ class SimpleResidueTermination
   /**
    * Construct the SimpleResidueTermination object with the given minimum
    * residue (or the default) and the given maximum number of iterations (or the
-   * default).  0 indicates no iteration limit.
+   * default).  0 indicates no iteration limit.  Optionally, the residue can be
+   * checked only once every checkInterval iterations.
    *
    * @param minResidue Minimum residue for termination.
    * @param maxIterations Maximum number of iterations.
+   * @param checkInterval Number of iterations between residue checks.
    */
   SimpleResidueTermination(const double minResidue = 1e-5,
-                           const size_t maxIterations = 10000)
-      : minResidue(minResidue), maxIterations(maxIterations) { }
+                           const size_t maxIterations = 10000,
+                           const size_t checkInterval = 1)
+      : minResidue(minResidue),
+        maxIterations(maxIterations),
+        checkInterval(checkInterval) { }
 
   /**
    * Initializes the termination policy before stating the factorization.
@@ -62,11 +73,23 @@ class SimpleResidueTermination
    */
   bool IsConverged(arma::mat& W, arma::mat& H)
   {
-    // Calculate the norm and compute the residue, but do it by hand, so as to
-    // avoid calculating (W*H), which may be very large.
+    // Between checks, we only need to count the iteration.  The last iteration
+    // is always checked.
+    if ((checkInterval > 1) && ((iteration - 1) % checkInterval != 0) &&
+        (iteration < maxIterations))
+    {
+      iteration++;
+      return false;
+    }
+
+    // Calculate the norm and compute the residue, but avoid calculating (W*H),
+    // which may be very large: ||W h_j||^2 = h_j^T (W^T W) h_j, so only the
+    // r x r matrix W^T W is needed.
+    const arma::mat gram = W.t() * W;
+    const arma::rowvec squaredNorms = arma::sum(H % (gram * H), 0);
     double norm = 0.0;
-    for (size_t j = 0; j < H.n_cols; ++j)
-      norm += arma::norm(W * H.col(j), "fro");
+    for (size_t j = 0; j < squaredNorms.n_elem; ++j)
+      norm += std::sqrt(std::max(squaredNorms[j], 0.0));
     residue = fabs(normOld - norm) / normOld;
 
     // Store the norm.
@@ -94,11 +117,17 @@ class SimpleResidueTermination
   const double& MinResidue() const { return minResidue; }
   double& MinResidue() { return minResidue; }
 
+  //! Access the number of iterations between residue checks
+  const size_t& CheckInterval() const { return checkInterval; }
+  size_t& CheckInterval() { return checkInterval; }
+
 public:
   //! residue threshold
   double minResidue;
   //! iteration threshold
   size_t maxIterations;
+  //! number of iterations between residue checks
+  size_t checkInterval;
 
   //! current value of residue
   double residue;
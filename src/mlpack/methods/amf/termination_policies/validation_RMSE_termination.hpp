@@ -24,6 +24,11 @@ namespace amf
  * with reverseStepCount. Secondary termination criterion terminates algorithm
  * when iteration count goes above the threshold.
  *
+ * The prediction for each validation entry is computed directly from a row of
+ * W and a column of H (in parallel, if OpenMP is available), so W * H is never
+ * formed.  The RMSE can also be checked only every few iterations (see the
+ * checkInterval parameter).
+ *
  * @note The input matrix is modified by this termination policy.
  *
  * @see AMF
@@ -40,16 +45,19 @@ class ValidationRMSETermination
    * @param num_test_points number of validation test points
    * @param maxIterations max iteration count before termination
    * @param reverseStepTolerance max successive RMSE drops allowed
+   * @param checkInterval number of iterations between RMSE checks
    */
   ValidationRMSETermination(MatType& V,
                             size_t num_test_points,
                             double tolerance = 1e-5,
                             size_t maxIterations = 10000,
-                            size_t reverseStepTolerance = 3)
+                            size_t reverseStepTolerance = 3,
+                            size_t checkInterval = 1)
         : tolerance(tolerance),
           maxIterations(maxIterations),
           num_test_points(num_test_points),
-          reverseStepTolerance(reverseStepTolerance)
+          reverseStepTolerance(reverseStepTolerance),
+          checkInterval(checkInterval)
   {
     size_t n = V.n_rows;
     size_t m = V.n_cols;
@@ -108,26 +116,30 @@ class ValidationRMSETermination
    */
   bool IsConverged(arma::mat& W, arma::mat& H)
   {
-    arma::mat WH;
-
-    WH = W * H;
+    // between checks only count the iteration; the last iteration is always
+    // checked
+    if ((checkInterval > 1) && ((iteration - 1) % checkInterval != 0) &&
+        (iteration < maxIterations))
+    {
+      iteration++;
+      return false;
+    }
 
-    // compute validation RMSE
+    // compute validation RMSE, predicting each entry without forming W * H
     if (iteration != 0)
     {
       rmseOld = rmse;
-      rmse = 0;
-      for(size_t i = 0; i < num_test_points; i++)
+      double sum = 0;
+      #pragma omp parallel for reduction(+:sum)
+      for (omp_size_t i = 0; i < (omp_size_t) num_test_points; i++)
       {
-        size_t t_row = test_points(i, 0);
-        size_t t_col = test_points(i, 1);
-        double t_val = test_points(i, 2);
-        double temp = (t_val - WH(t_row, t_col));
-        temp *= temp;
-        rmse += temp;
+        const size_t t_row = test_points(i, 0);
+        const size_t t_col = test_points(i, 1);
+        const double t_val = test_points(i, 2);
+        const double temp = t_val - arma::dot(W.row(t_row), H.col(t_col));
+        sum += temp * temp;
       }
-      rmse /= num_test_points;
-      rmse = sqrt(rmse);
+      rmse = sqrt(sum / num_test_points);
     }
 
     // increment iteration count
@@ -195,6 +207,10 @@ class ValidationRMSETermination
   const double& Tolerance() const { return tolerance; }
   double& Tolerance() { return tolerance; }
 
+  //! Access number of iterations between RMSE checks
+  const size_t& CheckInterval() const { return checkInterval; }
+  size_t& CheckInterval() { return checkInterval; }
+
  private:
   //! tolerance
   double tolerance;
@@ -217,6 +233,8 @@ class ValidationRMSETermination
   size_t reverseStepTolerance;
   //! successive residue drops
   size_t reverseStepCount;
+  //! number of iterations between RMSE checks
+  size_t checkInterval;
 
   //! indicates whether a copy of information is available which corresponds to
   //! minimum residue point
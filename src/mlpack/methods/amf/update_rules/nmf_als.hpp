@@ -32,16 +32,30 @@ namespace amf {
  * It uses the least squares projection formula to reduce the error value of
  * \f$ \sqrt{\sum_i \sum_j(V-WH)^2} \f$ by alternately calculating W and H
  * respectively while holding the other matrix constant.
+ *
+ * Each half-step solves a least squares problem whose matrix is the r x r Gram
+ * matrix of the fixed factor (H H^T or W^T W).  This matrix is factored once
+ * per half-step with a Cholesky decomposition, and the factor is used to solve
+ * for all rows of W (or columns of H) at once.  (If the Gram matrix is
+ * singular, the pseudoinverse is used instead.)
+ *
+ * For sparse matrices (arma::sp_mat), the products of V with the fixed factor
+ * only visit the nonzero elements of V, and are computed in parallel over the
+ * columns of V (if OpenMP is available); no dense intermediate the size of V is
+ * ever created.  To allow this for W, a transposed copy of V is made in
+ * Initialize().
  */
 class NMFALSUpdate
 {
  public:
   //! Empty constructor required for the UpdateRule template.
-  NMFALSUpdate() { }
+  NMFALSUpdate() : transposedSource(NULL) { }
 
   /**
-   * Set initial values for the factorization.  In this case, we don't need to
-   * set anything.
+   * Set initial values for the factorization.  For dense matrices, we don't
+   * need to set anything; for sparse matrices, the transpose of the dataset is
+   * stored, so that the products for WUpdate() can be computed column by
+   * column.
    */
   template<typename MatType>
   void Initialize(const MatType& /* dataset */, const size_t /* rank */)
@@ -64,22 +78,16 @@ class NMFALSUpdate
    * @param H Encoding matrix.
    */
   template<typename MatType>
-  inline static void WUpdate(const MatType& V,
-                             arma::mat& W,
-                             const arma::mat& H)
+  inline void WUpdate(const MatType& V,
+                      arma::mat& W,
+                      const arma::mat& H)
   {
-    // The call to inv() sometimes fails; so we are using the psuedoinverse.
-    // W = (inv(H * H.t()) * H * V.t()).t();
-    W = V * H.t() * pinv(H * H.t());
+    arma::mat wt = H * V.t();
+    Solve(H * H.t(), wt);
+    W = wt.t();
 
-    // Set all negative numbers to machine epsilon.
-    for (size_t i = 0; i < W.n_elem; i++)
-    {
-      if (W(i) < 0.0)
-      {
-        W(i) = 0.0;
-      }
-    }
+    // Set all negative numbers to 0.
+    ClampNegative(W);
   }
 
   /**
@@ -97,27 +105,134 @@ class NMFALSUpdate
    * @param H Encoding matrix to be updated.
    */
   template<typename MatType>
-  inline static void HUpdate(const MatType& V,
-                             const arma::mat& W,
-                             arma::mat& H)
+  inline void HUpdate(const MatType& V,
+                      const arma::mat& W,
+                      arma::mat& H)
   {
-    H = pinv(W.t() * W) * W.t() * V;
+    H = W.t() * V;
+    Solve(W.t() * W, H);
 
     // Set all negative numbers to 0.
-    for (size_t i = 0; i < H.n_elem; i++)
-    {
-      if (H(i) < 0.0)
-      {
-        H(i) = 0.0;
-      }
-    }
+    ClampNegative(H);
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
   template<typename Archive>
   void Serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  //! Transpose of the sparse dataset (only used for arma::sp_mat).
+  arma::sp_mat transposedDataset;
+  //! The dataset that transposedDataset was computed from.
+  const arma::sp_mat* transposedSource;
+
+  /**
+   * Overwrite x with the solution of (gram * result = x), using a Cholesky
+   * decomposition of the symmetric r x r matrix gram.  If gram is not positive
+   * definite, its pseudoinverse is used instead.
+   */
+  static void Solve(const arma::mat& gram, arma::mat& x)
+  {
+    arma::mat upper;
+    if (!arma::chol(upper, gram))
+    {
+      // The call to chol() fails when the matrix is singular (for instance,
+      // when a row of H is all zeros); so we use the pseudoinverse.
+      x = pinv(gram) * x;
+      return;
+    }
+
+    // gram = upper^T * upper, so solve two triangular systems.
+    x = arma::solve(arma::trimatu(upper),
+        arma::solve(arma::trimatl(upper.t()), x));
+  }
+
+  /**
+   * Compute result = F * S, where S is sparse, only visiting the nonzero
+   * elements of S.  Each column of the result is computed independently, in
+   * parallel if OpenMP is available.
+   */
+  static void SparseProduct(const arma::mat& f,
+                            const arma::sp_mat& s,
+                            arma::mat& result)
+  {
+    result.zeros(f.n_rows, s.n_cols);
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (omp_size_t j = 0; j < (omp_size_t) s.n_cols; ++j)
+    {
+      for (arma::sp_mat::const_iterator it = s.begin_col(j);
+           it != s.end_col(j); ++it)
+        result.col(j) += (*it) * f.col(it.row());
+    }
+  }
+
+  //! Set all negative elements of the matrix to 0.
+  static void ClampNegative(arma::mat& m)
+  {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) m.n_elem; ++i)
+    {
+      if (m[i] < 0.0)
+        m[i] = 0.0;
+    }
+  }
 }; // class NMFALSUpdate
 
+/**
+ * Initialize specialization for sparse matrices: store the transpose of the
+ * dataset, so that the rows of V can be iterated over quickly.
+ */
+template<>
+inline void NMFALSUpdate::Initialize<arma::sp_mat>(const arma::sp_mat& dataset,
+                                                   const size_t /* rank */)
+{
+  transposedDataset = dataset.t();
+  transposedSource = &dataset;
+}
+
+/**
+ * WUpdate specialization for sparse matrices.  Column i of H V^T only depends
+ * on row i of V, which is column i of the stored transpose.
+ */
+template<>
+inline void NMFALSUpdate::WUpdate<arma::sp_mat>(const arma::sp_mat& V,
+                                                arma::mat& W,
+                                                const arma::mat& H)
+{
+  // In case Initialize() was not called with this dataset.  A different dataset
+  // can have the same shape and number of nonzeros, so only the identity of
+  // the dataset tells us whether the stored transpose is still valid.
+  if (transposedSource != &V)
+  {
+    transposedDataset = V.t();
+    transposedSource = &V;
+  }
+
+  arma::mat wt;
+  SparseProduct(H, transposedDataset, wt);
+  Solve(H * H.t(), wt);
+  W = wt.t();
+
+  // Set all negative numbers to 0.
+  ClampNegative(W);
+}
+
+/**
+ * HUpdate specialization for sparse matrices.
+ */
+template<>
+inline void NMFALSUpdate::HUpdate<arma::sp_mat>(const arma::sp_mat& V,
+                                                const arma::mat& W,
+                                                arma::mat& H)
+{
+  SparseProduct(W.t(), V, H);
+  Solve(W.t() * W, H);
+
+  // Set all negative numbers to 0.
+  ClampNegative(H);
+}
+
 } // namespace amf
 } // namespace mlpack
 
@@ -46,6 +46,7 @@ PROGRAM_INFO("Collaborating Filtering", "This program performs collaborative "
     "algorithms can be specified via the --algorithm (-a) parameter: "
     "\n"
     "'RegSVD' -- Regularized SVD using a SGD optimizer\n"
+    "'ParallelRegSVD' -- Regularized SVD using a parallel (DSGD) optimizer\n"
     "'NMF' -- Non-negative matrix factorization with alternating least squares "
     "update rules\n"
     "'BatchSVD' -- SVD batch learning\n"
@@ -212,10 +213,10 @@ void AssembleFactorizerType(const std::string& algorithm,
           SVDCompleteIncrementalLearning<arma::sp_mat>> FactorizerType;
       PerformAction(FactorizerType(mit), dataset, rank);
     }
-    else if (algorithm == "RegSVD")
+    else if (algorithm == "RegSVD" || algorithm == "ParallelRegSVD")
     {
-      Log::Fatal << "--iteration_only_termination not supported with 'RegSVD' "
-          << "algorithm!" << endl;
+      Log::Fatal << "--iteration_only_termination not supported with '"
+          << algorithm << "' algorithm!" << endl;
     }
   }
   else
@@ -235,6 +236,8 @@ void AssembleFactorizerType(const std::string& algorithm,
       PerformAction(SparseSVDCompleteIncrementalFactorizer(srt), dataset, rank);
     else if (algorithm == "RegSVD")
       PerformAction(RegularizedSVD<>(maxIterations), dataset, rank);
+    else if (algorithm == "ParallelRegSVD")
+      PerformAction(RegularizedSVD<DSGD>(maxIterations), dataset, rank);
   }
 }
 
@@ -286,10 +289,11 @@ int main(int argc, char** argv)
         algo != "SVDBatch" &&
         algo != "SVDIncompleteIncremental" &&
         algo != "SVDCompleteIncremental" &&
-        algo != "RegSVD")
+        algo != "RegSVD" &&
+        algo != "ParallelRegSVD")
       Log::Fatal << "Invalid decomposition algorithm.  Choices are 'NMF', "
           << "'SVDBatch', 'SVDIncompleteIncremental', 'SVDCompleteIncremental',"
-          << " and 'RegSVD'." << endl;
+          << " 'RegSVD', and 'ParallelRegSVD'." << endl;
 
     // Issue a warning if the user provided a minimum residue but it will be
     // ignored.
@@ -63,6 +63,15 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * If OpenMP is available, each Boruvka round is run in parallel.  The query
+ * side of the tree is split into a number of independent subtrees, and each
+ * thread traverses its subtrees against the whole tree, collecting the best
+ * candidate edge of every component in its own arrays; these are then merged.
+ * Between rounds, the union-find structure is flattened so that components can
+ * be looked up by many threads at once, and the tree statistics are reset in
+ * parallel.  The resulting spanning tree is the same as with a single thread
+ * (up to the choice between edges of equal length).
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -113,6 +122,12 @@ class DualTreeBoruvka
   //! The instantiated metric.
   MetricType metric;
 
+  //! Subtrees with at least this many descendants have their statistics reset
+  //! in parallel (if OpenMP is available); smaller subtrees are handled by a
+  //! single thread, because the overhead of a task would be larger than the
+  //! work.
+  static const size_t ParallelCleanupSize = 10000;
+
   //! For sorting the edge list after the computation.
   struct SortEdgesHelper
   {
@@ -172,6 +187,30 @@ class DualTreeBoruvka
   void ComputeMST(arma::mat& results);
 
  private:
+  /**
+   * Split the query side of the tree into independent subtrees, so that they
+   * can be traversed by different threads.  Together the subtrees hold every
+   * point of the dataset.  If OpenMP is not available, only the root is
+   * returned.
+   *
+   * @param queryNodes Vector to store the subtrees in.
+   */
+  void SplitQueryTree(std::vector<Tree*>& queryNodes);
+
+  /**
+   * Run one Boruvka round: find the nearest neighbor outside of each component,
+   * and store it in neighborsDistances, neighborsInComponent, and
+   * neighborsOutComponent.  This is done in parallel if OpenMP is available.
+   *
+   * @param queryNodes Query subtrees given by SplitQueryTree().
+   * @param baseCases Number of base cases; incremented by this round.
+   * @param scores Number of node combinations scored; incremented by this
+   *      round.
+   */
+  void FindNeighbors(const std::vector<Tree*>& queryNodes,
+                     size_t& baseCases,
+                     size_t& scores);
+
   /**
    * Adds a single edge to the edge list
    */
@@ -121,23 +121,15 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
 
   totalDist = 0; // Reset distance.
 
-  typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+  std::vector<Tree*> queryNodes;
+  if (!naive)
+    SplitQueryTree(queryNodes);
+
+  size_t baseCases = 0;
+  size_t scores = 0;
   while (edges.size() < (data.n_cols - 1))
   {
-    if (naive)
-    {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
-    }
-    else
-    {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
-    }
+    FindNeighbors(queryNodes, baseCases, scores);
 
     AddAllEdges();
 
@@ -146,8 +138,8 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      Log::Info << baseCases << " cumulative base cases." << std::endl;
+      Log::Info << scores << " cumulative node combinations scored."
           << std::endl;
     }
   }
@@ -159,6 +151,127 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
   Log::Info << "Total spanning tree length: " << totalDist << std::endl;
 }
 
+/**
+ * Split the query side of the tree into subtrees for the threads.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::SplitQueryTree(
+    std::vector<Tree*>& queryNodes)
+{
+  queryNodes.clear();
+  queryNodes.push_back(tree);
+
+  // Aim for several subtrees per thread, so that the work can be balanced even
+  // though the subtrees take different amounts of time to traverse.
+#ifdef _OPENMP
+  const size_t minNodes = 8 * omp_get_max_threads();
+#else
+  const size_t minNodes = 1;
+#endif
+
+  // Replace each internal node by its children, one level at a time.  Points
+  // held by an internal node are always also held by one of its descendants
+  // (in the cover tree, by the self-child), so no point is lost.
+  bool split = true;
+  while (split && queryNodes.size() < minNodes)
+  {
+    split = false;
+    std::vector<Tree*> children;
+    for (size_t i = 0; i < queryNodes.size(); ++i)
+    {
+      if (queryNodes[i]->NumChildren() == 0)
+      {
+        children.push_back(queryNodes[i]);
+        continue;
+      }
+
+      for (size_t j = 0; j < queryNodes[i]->NumChildren(); ++j)
+        children.push_back(&queryNodes[i]->Child(j));
+      split = true;
+    }
+
+    queryNodes.swap(children);
+  }
+}
+
+/**
+ * Find the nearest neighbor outside of each component, in parallel.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::FindNeighbors(
+    const std::vector<Tree*>& queryNodes,
+    size_t& baseCases,
+    size_t& scores)
+{
+  typedef DTBRules<MetricType, Tree> RuleType;
+
+  size_t roundBaseCases = 0;
+  size_t roundScores = 0;
+  #pragma omp parallel reduction(+:roundBaseCases, roundScores)
+  {
+    // Each thread keeps its own candidate edges, so the traversals do not need
+    // to synchronize.  A thread's candidates are only ever as good as or worse
+    // than the merged candidates, so pruning with them is still correct.
+    arma::vec distances(data.n_cols);
+    arma::Col<size_t> inComponent(data.n_cols);
+    arma::Col<size_t> outComponent(data.n_cols);
+    distances.fill(DBL_MAX);
+
+    MetricType threadMetric(metric);
+    RuleType rules(data, connections, distances, inComponent, outComponent,
+                   threadMetric);
+
+    if (naive)
+    {
+      // Full O(N^2) traversal.
+      #pragma omp for schedule(dynamic, 16)
+      for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+        for (size_t j = 0; j < data.n_cols; ++j)
+          rules.BaseCase((size_t) i, j);
+    }
+    else
+    {
+      // The query subtrees are disjoint, so each query node's statistic is
+      // only modified by the thread traversing it.
+      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) queryNodes.size(); ++i)
+        traverser.Traverse(*queryNodes[i], *tree);
+    }
+
+    roundBaseCases += rules.BaseCases();
+    roundScores += rules.Scores();
+
+    // Keep the best candidate edge for each component.
+    #pragma omp critical
+    {
+      for (size_t c = 0; c < data.n_cols; ++c)
+      {
+        if (distances[c] < neighborsDistances[c])
+        {
+          neighborsDistances[c] = distances[c];
+          neighborsInComponent[c] = inComponent[c];
+          neighborsOutComponent[c] = outComponent[c];
+        }
+      }
+    }
+  }
+
+  baseCases += roundBaseCases;
+  scores += roundScores;
+}
+
 /**
  * Adds a single edge to the edge list
  */
@@ -281,15 +394,19 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
   tree->Stat().MinNeighborDistance() = DBL_MAX;
   tree->Stat().Bound() = DBL_MAX;
 
-  // Recurse into all children.
+  // Recurse into all children; large subtrees are handled as separate tasks.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
+  {
+    #pragma omp task if (tree->NumDescendants() >= ParallelCleanupSize)
     CleanupHelper(&tree->Child(i));
+  }
+  #pragma omp taskwait
 
   // Get the component of the first child or point.  Then we will check to see
   // if all other components of children and points are the same.
   const int component = (tree->NumChildren() != 0) ?
       tree->Child(0).Stat().ComponentMembership() :
-      connections.Find(tree->Point(0));
+      connections.Root(tree->Point(0));
 
   // Check components of children.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
@@ -298,7 +415,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
 
   // Check components of points.
   for (size_t i = 0; i < tree->NumPoints(); ++i)
-    if (connections.Find(tree->Point(i)) != size_t(component))
+    if (connections.Root(tree->Point(i)) != size_t(component))
       return;
 
   // If we made it this far, all components are the same.
@@ -316,11 +433,20 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
 {
-  for (size_t i = 0; i < data.n_cols; i++)
-    neighborsDistances[i] = DBL_MAX;
+  neighborsDistances.fill(DBL_MAX);
+
+  // Point every element directly at the root of its component, so that the
+  // components can be looked up by many threads at once with Root().
+  connections.Flatten();
 
   if (!naive)
-    CleanupHelper(tree);
+  {
+    #pragma omp parallel if (tree->NumDescendants() >= ParallelCleanupSize)
+    {
+      #pragma omp single
+      CleanupHelper(tree);
+    }
+  }
 }
 
 } // namespace emst
@@ -62,6 +62,38 @@ class UnionFind
     }
   }
 
+  /**
+   * Returns the component containing an element, without compressing the path
+   * to the root.  Because nothing is modified, this may be called by many
+   * threads at once, as long as no thread is calling Find() or Union().  After
+   * Flatten(), this takes constant time.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Root(size_t x) const
+  {
+    while (parent[x] != x)
+      x = parent[x];
+    return x;
+  }
+
+  /**
+   * Compress the path of every element, so that each element points directly
+   * at the root of its component.  The roots are found in parallel (if OpenMP
+   * is available), and afterwards Root() takes constant time.
+   */
+  void Flatten()
+  {
+    arma::Col<size_t> roots(parent.n_elem);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) parent.n_elem; ++i)
+      roots[i] = Root((size_t) i);
+
+    parent = std::move(roots);
+  }
+
   /**
    * Union the components containing x and y.
    *
@@ -212,6 +212,33 @@ class FastMKS
               arma::Mat<size_t>& indices,
               arma::mat& products);
 
+  /**
+   * Add a point to the reference set, inserting it into the reference tree
+   * instead of rebuilding the tree.  This cannot be used in naive mode.  A tree
+   * built on a dataset it does not own (as is the case when FastMKS is trained
+   * on a dataset) will copy the dataset first, which is only done once.
+   *
+   * @param point Point to add.
+   * @return Index of the new point in the reference set.
+   */
+  template<typename VecType>
+  size_t InsertReferencePoint(const VecType& point);
+
+  /**
+   * Remove a point from the reference tree instead of rebuilding the tree.  The
+   * point stays in the reference set (so the indices of the other points stay
+   * the same), but will not be returned by later searches.  If the reference
+   * set is searched against itself, the results for the removed point should be
+   * ignored.  This cannot be used in naive mode.
+   *
+   * @param index Index of the point to remove.
+   * @return false if the point was not in the reference tree.
+   */
+  bool DeleteReferencePoint(const size_t index);
+
+  //! Get the reference dataset.
+  const MatType& ReferenceSet() const { return *referenceSet; }
+
   //! Get the inner-product metric induced by the given kernel.
   const metric::IPMetric<KernelType>& Metric() const { return metric; }
   //! Modify the inner-product metric induced by the given kernel.
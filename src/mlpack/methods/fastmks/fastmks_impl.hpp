@@ -443,6 +443,50 @@ void FastMKS<KernelType, MatType, TreeType>::InsertNeighbor(
   indices(pos, queryIndex) = neighbor;
 }
 
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename VecType>
+size_t FastMKS<KernelType, MatType, TreeType>::
+    InsertReferencePoint(const VecType& point)
+{
+  static_assert(!tree::TreeTraits<Tree>::RearrangesDataset,
+      "FastMKS::InsertReferencePoint() requires a tree type that does "
+      "not rearrange its dataset");
+
+  if (naive)
+    throw std::invalid_argument("cannot call FastMKS::"
+        "InsertReferencePoint() when in naive search mode");
+
+  const size_t index = referenceTree->InsertPoint(point);
+
+  // The tree may have copied its dataset.
+  referenceSet = &referenceTree->Dataset();
+
+  return index;
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+bool FastMKS<KernelType, MatType, TreeType>::
+    DeleteReferencePoint(const size_t index)
+{
+  static_assert(!tree::TreeTraits<Tree>::RearrangesDataset,
+      "FastMKS::DeleteReferencePoint() requires a tree type that does "
+      "not rearrange its dataset");
+
+  if (naive)
+    throw std::invalid_argument("cannot call FastMKS::"
+        "DeleteReferencePoint() when in naive search mode");
+
+  return referenceTree->DeletePoint(index);
+}
+
 //! Serialize the model.
 template<typename KernelType,
          typename MatType,
@@ -133,6 +133,29 @@ bool& FastMKSModel::SingleMode()
   throw std::runtime_error("invalid model type");
 }
 
+const arma::mat& FastMKSModel::ReferenceSet() const
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->ReferenceSet();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->ReferenceSet();
+    case COSINE_DISTANCE:
+      return cosine->ReferenceSet();
+    case GAUSSIAN_KERNEL:
+      return gaussian->ReferenceSet();
+    case EPANECHNIKOV_KERNEL:
+      return epan->ReferenceSet();
+    case TRIANGULAR_KERNEL:
+      return triangular->ReferenceSet();
+    case HYPTAN_KERNEL:
+      return hyptan->ReferenceSet();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
 void FastMKSModel::Search(const arma::mat& querySet,
                           const size_t k,
                           arma::Mat<size_t>& indices,
@@ -199,5 +222,51 @@ void FastMKSModel::Search(const size_t k,
   }
 }
 
+size_t FastMKSModel::Insert(const arma::vec& point)
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->InsertReferencePoint(point);
+    case POLYNOMIAL_KERNEL:
+      return polynomial->InsertReferencePoint(point);
+    case COSINE_DISTANCE:
+      return cosine->InsertReferencePoint(point);
+    case GAUSSIAN_KERNEL:
+      return gaussian->InsertReferencePoint(point);
+    case EPANECHNIKOV_KERNEL:
+      return epan->InsertReferencePoint(point);
+    case TRIANGULAR_KERNEL:
+      return triangular->InsertReferencePoint(point);
+    case HYPTAN_KERNEL:
+      return hyptan->InsertReferencePoint(point);
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
+bool FastMKSModel::Delete(const size_t index)
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->DeleteReferencePoint(index);
+    case POLYNOMIAL_KERNEL:
+      return polynomial->DeleteReferencePoint(index);
+    case COSINE_DISTANCE:
+      return cosine->DeleteReferencePoint(index);
+    case GAUSSIAN_KERNEL:
+      return gaussian->DeleteReferencePoint(index);
+    case EPANECHNIKOV_KERNEL:
+      return epan->DeleteReferencePoint(index);
+    case TRIANGULAR_KERNEL:
+      return triangular->DeleteReferencePoint(index);
+    case HYPTAN_KERNEL:
+      return hyptan->DeleteReferencePoint(index);
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
 } // namespace fastmks
 } // namespace mlpack
@@ -61,6 +61,9 @@ class FastMKSModel
   //! Set whether or not single-tree search is used.
   bool& SingleMode();
 
+  //! Get the reference dataset.
+  const arma::mat& ReferenceSet() const;
+
   //! Get the kernel type.
   int KernelType() const { return kernelType; }
   //! Modify the kernel type.
@@ -97,6 +100,24 @@ class FastMKSModel
               arma::Mat<size_t>& indices,
               arma::mat& kernels);
 
+  /**
+   * Add a point to the reference set without rebuilding the tree (see
+   * FastMKS<>::InsertReferencePoint()).
+   *
+   * @param point Point to add.
+   * @return Index of the new point in the reference set.
+   */
+  size_t Insert(const arma::vec& point);
+
+  /**
+   * Remove a point from the reference tree without rebuilding it (see
+   * FastMKS<>::DeleteReferencePoint()).
+   *
+   * @param index Index of the point to remove.
+   * @return false if the point was not in the reference tree.
+   */
+  bool Delete(const size_t index);
+
   /**
    * Serialize the model.
    */
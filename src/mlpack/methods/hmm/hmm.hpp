@@ -152,6 +152,10 @@ class HMM
    * log-likelihood of the model between iterations is less than the tolerance,
    * the Baum-Welch algorithm terminates.
    *
+   * In each iteration, the emission probabilities of each sequence are
+   * computed only once (in a batch, if the distribution supports it), and the
+   * sequences are processed in parallel if OpenMP is available.
+   *
    * @note
    * Train() can be called multiple times with different sequences; each time it
    * is called, it uses the current parameters of the HMM as a starting point
@@ -217,6 +221,11 @@ class HMM
    * observations, and rows equal to the number of hidden states in the model.
    * The log-likelihood of the most probable sequence is returned.
    *
+   * Because the forward and backward probabilities are not returned, this
+   * overload only keeps O(sqrt(T)) columns of them in memory at once (where T
+   * is the length of the sequence), at the cost of evaluating the emission
+   * probabilities twice.
+   *
    * @param dataSeq Sequence of observations.
    * @param stateProb Probabilities of each state at each time interval.
    * @return Log-likelihood of most likely state sequence.
@@ -243,7 +252,9 @@ class HMM
   /**
    * Compute the most probable hidden state sequence for the given data
    * sequence, using the Viterbi algorithm, returning the log-likelihood of the
-   * most likely state sequence.
+   * most likely state sequence.  The recursion is done in log space, and only
+   * O(sqrt(T)) columns of intermediate results are kept in memory at once
+   * (where T is the length of the sequence).
    *
    * @param dataSeq Sequence of observations.
    * @param stateSeq Vector in which the most probable state sequence will be
@@ -254,7 +265,10 @@ class HMM
                  arma::Row<size_t>& stateSeq) const;
 
   /**
-   * Compute the log-likelihood of the given data sequence.
+   * Compute the log-likelihood of the given data sequence.  Only the forward
+   * probabilities of the current step are kept in memory.  To compute the
+   * log-likelihood of a stream of observations incrementally, see
+   * OnlineFilter.
    *
    * @param dataSeq Data sequence to evaluate the likelihood of.
    * @return Log-likelihood of the given sequence.
@@ -353,6 +367,110 @@ class HMM
                 const arma::vec& scales,
                 arma::mat& backwardProb) const;
 
+  /**
+   * Compute the log-probability of each observation in the given data sequence
+   * under the emission distribution of each state.  If the distribution has a
+   * LogProbability() overload that takes a whole matrix of observations, it is
+   * used; otherwise each observation is evaluated separately.  The returned
+   * matrix has rows equal to the number of hidden states and columns equal to
+   * the number of observations.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logEmissionProb Matrix in which the log-probabilities will be saved.
+   */
+  void LogEmissionProbability(const arma::mat& dataSeq,
+                              arma::mat& logEmissionProb) const;
+
+  /**
+   * The Forward algorithm, given the emission probabilities of each state for
+   * each observation (as computed by LogEmissionProbability(), but not in log
+   * space).
+   *
+   * @param emissionProb Emission probabilities of each state for each
+   *     observation.
+   * @param scales Vector in which scaling factors will be saved.
+   * @param forwardProb Matrix in which forward probabilities will be saved.
+   */
+  void ScaledForward(const arma::mat& emissionProb,
+                     arma::vec& scales,
+                     arma::mat& forwardProb) const;
+
+  /**
+   * The Backward algorithm, given the emission probabilities of each state for
+   * each observation and the scaling factors found by ScaledForward().
+   *
+   * @param emissionProb Emission probabilities of each state for each
+   *     observation.
+   * @param scales Vector of scaling factors.
+   * @param backwardProb Matrix in which backward probabilities will be saved.
+   */
+  void ScaledBackward(const arma::mat& emissionProb,
+                      const arma::vec& scales,
+                      arma::mat& backwardProb) const;
+
+  /**
+   * Compute the emission probabilities of each state for each observation,
+   * like LogEmissionProbability(), but not in log space.  To avoid underflow,
+   * the column for each observation is first shifted in log space so that its
+   * largest element is 1; the shift of each observation is stored in
+   * logShifts.  The forward and backward probabilities computed from the
+   * shifted emission probabilities are unchanged; only the scaling factors are
+   * divided by exp(logShifts).
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionProb Matrix in which the shifted probabilities will be
+   *     saved.
+   * @param logShifts Vector in which the log-space shift of each observation
+   *     will be saved.
+   */
+  void ShiftedEmissionProbability(const arma::mat& dataSeq,
+                                  arma::mat& emissionProb,
+                                  arma::vec& logShifts) const;
+
+  /**
+   * Run the Forward algorithm over the observations [begin, end) of the given
+   * data sequence.  On input, forward holds the forward probabilities of the
+   * step before begin (it is ignored if begin is 0); on output, it holds the
+   * forward probabilities of the step end - 1.  The (shifted) scaling factors
+   * of the segment are stored in scales[begin, end), and if segmentForward or
+   * segmentEmission are given, the forward probabilities and the shifted
+   * emission probabilities of the segment are stored there.
+   *
+   * @return Log-likelihood of the observations in the segment, given the
+   *     observations before it.
+   */
+  double ForwardSegment(const arma::mat& dataSeq,
+                        const size_t begin,
+                        const size_t end,
+                        arma::vec& forward,
+                        arma::vec& scales,
+                        arma::mat* segmentForward = NULL,
+                        arma::mat* segmentEmission = NULL) const;
+
+  /**
+   * Run the Viterbi recursion over the observations [begin, end) of the given
+   * data sequence.  On input, logStateProb holds the log-probabilities of the
+   * most probable paths ending in each state at the step before begin (it is
+   * ignored if begin is 0); on output, it holds them for the step end - 1.  If
+   * stateSeqBack is given, the most probable previous state of each state at
+   * each step of the segment is stored there.
+   *
+   * @param logTrans Log of the transposed transition matrix.
+   */
+  void ViterbiSegment(const arma::mat& dataSeq,
+                      const size_t begin,
+                      const size_t end,
+                      const arma::mat& logTrans,
+                      arma::vec& logStateProb,
+                      arma::Mat<size_t>* stateSeqBack = NULL) const;
+
+  /**
+   * Return the length of the segments that the checkpointed algorithms
+   * (Predict(), LogLikelihood(), and the two-argument Estimate()) split a
+   * sequence of the given length into; this is about sqrt(length).
+   */
+  static size_t SegmentLength(const size_t length);
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
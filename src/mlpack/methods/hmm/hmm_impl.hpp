@@ -12,9 +12,54 @@
 // Just in case...
 #include "hmm.hpp"
 
+#include <mlpack/core/util/sfinae_utility.hpp>
+
 namespace mlpack {
 namespace hmm {
 
+// This gives us a HasBatchLogProbabilityCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a distribution has a
+// LogProbability() function that evaluates a whole matrix of observations.
+HAS_MEM_FUNC(LogProbability, HasBatchLogProbabilityCheck);
+
+//! Utility struct where value is true if and only if the distribution has a
+//! LogProbability(const arma::mat&, arma::vec&) const function.
+template<typename Distribution>
+struct HasBatchLogProbability
+{
+  static const bool value = HasBatchLogProbabilityCheck<Distribution,
+      void(Distribution::*)(const arma::mat&, arma::vec&) const>::value;
+};
+
+//! Compute the log-probabilities of all observations at once, for
+//! distributions that support it.
+template<typename Distribution>
+void BatchLogProbability(
+    const Distribution& distribution,
+    const arma::mat& observations,
+    arma::vec& logProbabilities,
+    const typename boost::enable_if_c<
+        HasBatchLogProbability<Distribution>::value>::type* = 0)
+{
+  distribution.LogProbability(observations, logProbabilities);
+}
+
+//! Compute the log-probabilities of all observations one at a time, for
+//! distributions that only evaluate single observations.
+template<typename Distribution>
+void BatchLogProbability(
+    const Distribution& distribution,
+    const arma::mat& observations,
+    arma::vec& logProbabilities,
+    const typename boost::disable_if_c<
+        HasBatchLogProbability<Distribution>::value>::type* = 0)
+{
+  logProbabilities.set_size(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    logProbabilities[i] = log(distribution.Probability(
+        observations.unsafe_col(i)));
+}
+
 /**
  * Create the Hidden Markov Model with the given number of hidden states and the
  * given number of emission states.
@@ -93,11 +138,22 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
           << dimensionality << " dimensions)." << std::endl;
   }
 
-  // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // These are used later for training of each distribution.  The observations
+  // do not change between iterations, so we can collect them now.  Each
+  // sequence is stored starting at its offset.
+  std::vector<size_t> offsets(dataSeq.size());
   std::vector<arma::vec> emissionProb(transition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = sumTime;
+    if (dataSeq[seq].n_cols > 0)
+      emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    sumTime += dataSeq[seq].n_cols;
+  }
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -113,48 +169,71 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // Loop over each sequence.  The sequences are independent, so each thread
+    // accumulates its own estimates, which are summed at the end.
+    #pragma omp parallel
     {
-      arma::mat stateProb;
-      arma::mat forward;
-      arma::mat backward;
-      arma::vec scales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += Estimate(dataSeq[seq], stateProb, forward, backward, scales);
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; t++)
+      arma::vec threadInitial(transition.n_rows);
+      threadInitial.zeros();
+      arma::mat threadTransition(transition.n_rows, transition.n_cols);
+      threadTransition.zeros();
+
+      #pragma omp for schedule(dynamic) reduction(+:loglik)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
-        for (size_t j = 0; j < transition.n_cols; j++)
+        const size_t length = dataSeq[seq].n_cols;
+        if (length == 0)
+          continue;
+
+        // Evaluate every emission distribution on every observation only once.
+        arma::mat emissions;
+        arma::vec logShifts;
+        ShiftedEmissionProbability(dataSeq[seq], emissions, logShifts);
+
+        arma::mat stateProb;
+        arma::mat forward;
+        arma::mat backward;
+        arma::vec scales;
+
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        ScaledForward(emissions, scales, forward);
+        ScaledBackward(emissions, scales, backward);
+        stateProb = forward % backward;
+        loglik += accu(log(scales)) + accu(logShifts);
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
+        threadInitial += stateProb.col(0);
+
+        if (length > 1)
         {
-          // Add to estimate of initial probability for state j.
-          newInitial[j] = stateProb(j, 0);
-
-          if (t < dataSeq[seq].n_cols - 1)
-          {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
-              newTransition(i, j) += forward(j, t) * backward(i, t + 1) *
-                  emission[i].Probability(dataSeq[seq].unsafe_col(t + 1)) /
-                  scales[t + 1];
-          }
-
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = stateProb(j, t);
+          // Estimate of T_ij (probability of transition from state j to state
+          // i), as a single matrix product over all time steps.  We postpone
+          // multiplication of the old T_ij until later.
+          arma::mat weights = backward.cols(1, length - 1) %
+              emissions.cols(1, length - 1);
+          for (size_t t = 1; t < length; t++)
+            weights.col(t - 1) /= scales[t];
+
+          threadTransition += weights * trans(forward.cols(0, length - 2));
         }
-        sumTime++;
+
+        // Add to list of emission probabilities, for Distribution::Train().
+        // Each sequence has its own range, so no synchronization is needed.
+        for (size_t j = 0; j < transition.n_cols; j++)
+          emissionProb[j].subvec(offsets[seq], offsets[seq] + length - 1) =
+              trans(stateProb.row(j));
+      }
+
+      #pragma omp critical
+      {
+        newInitial += threadInitial;
+        newTransition += threadTransition;
       }
     }
 
@@ -295,31 +374,92 @@ double HMM<Distribution>::Estimate(const arma::mat& dataSeq,
                                    arma::mat& backwardProb,
                                    arma::vec& scales) const
 {
-  // First run the forward-backward algorithm.
-  Forward(dataSeq, scales, forwardProb);
-  Backward(dataSeq, scales, backwardProb);
+  // First run the forward-backward algorithm.  The emission probabilities are
+  // only computed once, for both passes.
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  ShiftedEmissionProbability(dataSeq, emissionProb, logShifts);
+
+  ScaledForward(emissionProb, scales, forwardProb);
+  ScaledBackward(emissionProb, scales, backwardProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
   stateProb = forwardProb % backwardProb;
 
-  // Finally assemble the log-likelihood and return it.
-  return accu(log(scales));
+  // Assemble the log-likelihood before the scales are shifted back, so that it
+  // is finite even if the scales themselves underflow.
+  const double logLikelihood = accu(log(scales)) + accu(logShifts);
+  scales %= exp(logShifts);
+
+  return logLikelihood;
 }
 
 /**
  * Estimate the probabilities of each hidden state at each time step for each
- * given data observation.
+ * given data observation.  Only O(sqrt(T)) columns of forward probabilities
+ * are held in memory at once.
  */
 template<typename Distribution>
 double HMM<Distribution>::Estimate(const arma::mat& dataSeq,
                                    arma::mat& stateProb) const
 {
-  // We don't need to save these.
-  arma::mat forwardProb, backwardProb;
-  arma::vec scales;
+  const size_t length = dataSeq.n_cols;
+  stateProb.set_size(transition.n_rows, length);
+  if (length == 0)
+    return 0.0;
+
+  const size_t segmentLength = SegmentLength(length);
+  const size_t segments = (length + segmentLength - 1) / segmentLength;
+
+  // The forward pass only keeps the forward probabilities at the step before
+  // each segment starts (checkpoints.col(0) is unused).
+  arma::mat checkpoints(transition.n_rows, segments);
+  arma::vec scales(length);
+  arma::vec forward;
+  double logLikelihood = 0.0;
+  for (size_t s = 0; s < segments; ++s)
+  {
+    const size_t begin = s * segmentLength;
+    const size_t end = std::min(begin + segmentLength, length);
+    if (s > 0)
+      checkpoints.col(s) = forward;
+
+    logLikelihood += ForwardSegment(dataSeq, begin, end, forward, scales);
+  }
 
-  return Estimate(dataSeq, stateProb, forwardProb, backwardProb, scales);
+  // Now walk the segments in reverse.  The forward probabilities of each
+  // segment are recomputed from its checkpoint, and the backward recursion
+  //   b(t) = T^T (b(t + 1) % e(t + 1)) / c(t + 1)
+  // is carried across segment boundaries in weightedNext.
+  arma::mat segmentForward;
+  arma::mat segmentEmission;
+  arma::vec backward;
+  arma::vec weightedNext;
+  for (size_t s = segments; s > 0; --s)
+  {
+    const size_t begin = (s - 1) * segmentLength;
+    const size_t end = std::min(begin + segmentLength, length);
+    if (s > 1)
+      forward = checkpoints.col(s - 1);
+
+    ForwardSegment(dataSeq, begin, end, forward, scales, &segmentForward,
+        &segmentEmission);
+
+    for (size_t t = end; t > begin; --t)
+    {
+      const size_t col = t - 1 - begin;
+      if (t == length)
+        backward.ones(transition.n_rows);
+      else
+        backward = trans(transition) * weightedNext / scales[t];
+
+      stateProb.col(t - 1) = segmentForward.col(col) % backward;
+      weightedNext = backward % segmentEmission.col(col);
+    }
+  }
+
+  return logLikelihood;
 }
 
 /**
@@ -381,52 +521,61 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
 {
   // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
-  stateSeq.set_size(dataSeq.n_cols);
-  arma::mat logStateProb(transition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(transition.n_rows, dataSeq.n_cols);
+  // probable sequence of states to produce the observed data sequence, in log
+  // space.  Each time step is a single max-plus product of the log transition
+  // matrix with the previous log state probabilities.  To keep memory usage
+  // low on long sequences, the sequence is split into O(sqrt(T)) segments;
+  // the first pass only keeps the log state probabilities at the start of
+  // each segment, and the back pointers are recomputed one segment at a time
+  // during the backtracking pass.
+  const size_t length = dataSeq.n_cols;
+  stateSeq.set_size(length);
+  if (length == 0)
+    return 0.0;
 
   // Store the logs of the transposed transition matrix.  This is because we
   // will be using the rows of the transition matrix.
-  arma::mat logTrans(log(trans(transition)));
+  const arma::mat logTrans(log(trans(transition)));
 
-  // The calculation of the first state is slightly different; the probability
-  // of the first state being state j is the maximum probability that the state
-  // came to be j from another state.
-  logStateProb.col(0).zeros();
-  for (size_t state = 0; state < transition.n_rows; state++)
+  const size_t segmentLength = SegmentLength(length);
+  const size_t segments = (length + segmentLength - 1) / segmentLength;
+
+  arma::mat checkpoints(transition.n_rows, segments);
+  arma::vec logStateProb;
+  for (size_t s = 0; s < segments; ++s)
   {
-    logStateProb(state, 0) = log(initial[state] *
-        emission[state].Probability(dataSeq.unsafe_col(0)));
-    stateSeqBack(state, 0) = state;
+    const size_t begin = s * segmentLength;
+    const size_t end = std::min(begin + segmentLength, length);
+    if (s > 0)
+      checkpoints.col(s) = logStateProb;
+
+    ViterbiSegment(dataSeq, begin, end, logTrans, logStateProb);
   }
 
-  // Store the best first state.
+  // Find the most probable final state.
   arma::uword index;
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
-  {
-    // Assemble the state probability for this element.
-    // Given that we are in state j, we use state with the highest probability
-    // of being the previous state.
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
-      logStateProb(j, t) = prob.max(index) +
-          log(emission[j].Probability(dataSeq.unsafe_col(t)));
-        stateSeqBack(j, t) = index;
-    }
-  }
+  const double logLikelihood = logStateProb.max(index);
+  stateSeq[length - 1] = index;
 
   // Backtrack to find the most probable state sequence.
-  logStateProb.unsafe_col(dataSeq.n_cols - 1).max(index);
-  stateSeq[dataSeq.n_cols - 1] = index;
-  for (size_t t = 2; t <= dataSeq.n_cols; t++)
-    stateSeq[dataSeq.n_cols - t] =
-        stateSeqBack(stateSeq[dataSeq.n_cols - t + 1], dataSeq.n_cols - t + 1);
+  arma::Mat<size_t> stateSeqBack;
+  for (size_t s = segments; s > 0; --s)
+  {
+    const size_t begin = (s - 1) * segmentLength;
+    const size_t end = std::min(begin + segmentLength, length);
+    if (s > 1)
+      logStateProb = checkpoints.col(s - 1);
+
+    ViterbiSegment(dataSeq, begin, end, logTrans, logStateProb,
+        &stateSeqBack);
+
+    for (size_t t = end - 1; t > begin; --t)
+      stateSeq[t - 1] = stateSeqBack(stateSeq[t], t - begin);
+    if (begin > 0)
+      stateSeq[begin - 1] = stateSeqBack(stateSeq[begin], 0);
+  }
 
-  return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
+  return logLikelihood;
 }
 
 /**
@@ -435,13 +584,21 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 template<typename Distribution>
 double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
 {
-  arma::mat forward;
-  arma::vec scales;
-
-  Forward(dataSeq, scales, forward);
+  // Only the forward pass is needed, so it is run one segment at a time, and
+  // only the last column of forward probabilities is kept.
+  const size_t length = dataSeq.n_cols;
+  const size_t segmentLength = SegmentLength(length);
+
+  arma::vec forward;
+  arma::vec scales(length);
+  double logLikelihood = 0.0;
+  for (size_t begin = 0; begin < length; begin += segmentLength)
+  {
+    const size_t end = std::min(begin + segmentLength, length);
+    logLikelihood += ForwardSegment(dataSeq, begin, end, forward, scales);
+  }
 
-  // The log-likelihood is the log of the scales for each time step.
-  return accu(log(scales));
+  return logLikelihood;
 }
 
 /**
@@ -493,11 +650,56 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& scales,
                                 arma::mat& forwardProb) const
+{
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  ShiftedEmissionProbability(dataSeq, emissionProb, logShifts);
+  ScaledForward(emissionProb, scales, forwardProb);
+
+  // Undo the shift, so that the scales can be used by Backward().
+  scales %= exp(logShifts);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& scales,
+                                 arma::mat& backwardProb) const
+{
+  arma::mat logEmissionProb;
+  LogEmissionProbability(dataSeq, logEmissionProb);
+  ScaledBackward(exp(logEmissionProb), scales, backwardProb);
+}
+
+/**
+ * Evaluate each emission distribution on each observation.
+ */
+template<typename Distribution>
+void HMM<Distribution>::LogEmissionProbability(
+    const arma::mat& dataSeq,
+    arma::mat& logEmissionProb) const
+{
+  logEmissionProb.set_size(transition.n_rows, dataSeq.n_cols);
+
+  arma::vec logProbabilities;
+  for (size_t state = 0; state < transition.n_rows; state++)
+  {
+    BatchLogProbability(emission[state], dataSeq, logProbabilities);
+    logEmissionProb.row(state) = trans(logProbabilities);
+  }
+}
+
+/**
+ * The Forward procedure, given the emission probabilities.
+ */
+template<typename Distribution>
+void HMM<Distribution>::ScaledForward(const arma::mat& emissionProb,
+                                      arma::vec& scales,
+                                      arma::mat& forwardProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardProb.zeros(transition.n_rows, dataSeq.n_cols);
-  scales.zeros(dataSeq.n_cols);
+  forwardProb.zeros(transition.n_rows, emissionProb.n_cols);
+  scales.zeros(emissionProb.n_cols);
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
@@ -505,25 +707,21 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
   for (size_t state = 0; state < transition.n_rows; state++)
-    forwardProb(state, 0) = initial(state) *
-        emission[state].Probability(dataSeq.unsafe_col(0));
+    forwardProb(state, 0) = initial(state) * emissionProb(state, 0);
 
   // Then normalize the column.
   scales[0] = accu(forwardProb.col(0));
   forwardProb.col(0) /= scales[0];
 
-  // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  // Now compute the probabilities for each successive observation.  The
+  // forward probability of state j at time t is the sum over all states of the
+  // probability of the previous state transitioning to state j, times the
+  // probability of state j emitting the observation; for all states at once,
+  // that is one matrix-vector product.
+  for (size_t t = 1; t < emissionProb.n_cols; t++)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      forwardProb(j, t) = accu(forwardProb.col(t - 1) %
-          trans(transition.row(j))) *
-          emission[j].Probability(dataSeq.unsafe_col(t));
-    }
+    forwardProb.col(t) = (transition * forwardProb.col(t - 1)) %
+        emissionProb.col(t);
 
     // Normalize probability.
     scales[t] = accu(forwardProb.col(t));
@@ -531,37 +729,161 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   }
 }
 
+/**
+ * The Backward procedure, given the emission probabilities.
+ */
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& scales,
-                                 arma::mat& backwardProb) const
+void HMM<Distribution>::ScaledBackward(const arma::mat& emissionProb,
+                                       const arma::vec& scales,
+                                       arma::mat& backwardProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardProb.zeros(transition.n_rows, dataSeq.n_cols);
+  backwardProb.zeros(transition.n_rows, emissionProb.n_cols);
 
   // The last element probability is 1.
-  backwardProb.col(dataSeq.n_cols - 1).fill(1);
+  backwardProb.col(emissionProb.n_cols - 1).fill(1);
+
+  // Now step backwards through all other observations.  The backward
+  // probability of state j at time t is the sum over all states of the
+  // probability of the next state having been a transition from state j,
+  // multiplied by the probability of that state emitting the next observation
+  // and by its backward probability.  We normalize by the weights from the
+  // forward algorithm.
+  for (size_t t = emissionProb.n_cols - 2; t + 1 > 0; t--)
+  {
+    backwardProb.col(t) = trans(transition) * (backwardProb.col(t + 1) %
+        emissionProb.col(t + 1)) / scales[t + 1];
+  }
+}
 
-  // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+/**
+ * Compute the emission probabilities, shifted in log space so that the largest
+ * emission probability of each observation is 1.
+ */
+template<typename Distribution>
+void HMM<Distribution>::ShiftedEmissionProbability(
+    const arma::mat& dataSeq,
+    arma::mat& emissionProb,
+    arma::vec& logShifts) const
+{
+  LogEmissionProbability(dataSeq, emissionProb);
+
+  // Scaling every emission probability of one observation by the same factor
+  // does not change the forward or backward probabilities (it is absorbed by
+  // the scaling factor), but it keeps observations far from every state from
+  // underflowing to zero.
+  logShifts.set_size(dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; ++t)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
+    const double shift = emissionProb.col(t).max();
+    logShifts[t] = std::isfinite(shift) ? shift : 0.0;
+    emissionProb.col(t) = exp(emissionProb.col(t) - logShifts[t]);
+  }
+}
+
+/**
+ * Run the forward algorithm on the observations in [begin, end).
+ */
+template<typename Distribution>
+double HMM<Distribution>::ForwardSegment(const arma::mat& dataSeq,
+                                         const size_t begin,
+                                         const size_t end,
+                                         arma::vec& forward,
+                                         arma::vec& scales,
+                                         arma::mat* segmentForward,
+                                         arma::mat* segmentEmission) const
+{
+  arma::mat emissionProb;
+  arma::vec logShifts;
+  ShiftedEmissionProbability(dataSeq.cols(begin, end - 1), emissionProb,
+      logShifts);
+
+  if (segmentForward != NULL)
+    segmentForward->set_size(transition.n_rows, end - begin);
+
+  double logLikelihood = 0.0;
+  for (size_t t = begin; t < end; ++t)
+  {
+    const size_t col = t - begin;
+    if (t == 0)
+      forward = initial % emissionProb.col(col);
+    else
+      forward = (transition * forward) % emissionProb.col(col);
+
+    scales[t] = accu(forward);
+    forward /= scales[t];
+    logLikelihood += std::log(scales[t]) + logShifts[col];
+
+    if (segmentForward != NULL)
+      segmentForward->col(col) = forward;
+  }
+
+  if (segmentEmission != NULL)
+    *segmentEmission = emissionProb;
+
+  return logLikelihood;
+}
+
+/**
+ * Run the Viterbi recursion on the observations in [begin, end).
+ */
+template<typename Distribution>
+void HMM<Distribution>::ViterbiSegment(const arma::mat& dataSeq,
+                                       const size_t begin,
+                                       const size_t end,
+                                       const arma::mat& logTrans,
+                                       arma::vec& logStateProb,
+                                       arma::Mat<size_t>* stateSeqBack) const
+{
+  arma::mat logEmissionProb;
+  LogEmissionProbability(dataSeq.cols(begin, end - 1), logEmissionProb);
+
+  if (stateSeqBack != NULL)
+    stateSeqBack->set_size(transition.n_rows, end - begin);
+
+  // scores(i, j) is the log-probability of the best path that is in state i
+  // at time t - 1 and transitions to state j.
+  arma::mat scores;
+  arma::vec next(transition.n_rows);
+  arma::uword index;
+  for (size_t t = begin; t < end; ++t)
+  {
+    const size_t col = t - begin;
+    if (t == 0)
+    {
+      // The first state does not have a predecessor.
+      logStateProb = log(initial) + logEmissionProb.col(0);
+      if (stateSeqBack != NULL)
+        for (size_t j = 0; j < transition.n_rows; ++j)
+          (*stateSeqBack)(j, 0) = j;
+
+      continue;
+    }
+
+    scores = logTrans;
+    scores.each_col() += logStateProb;
+    for (size_t j = 0; j < transition.n_rows; ++j)
     {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
-        backwardProb(j, t) += transition(state, j) * backwardProb(state, t + 1)
-            * emission[state].Probability(dataSeq.unsafe_col(t + 1));
-
-      // Normalize by the weights from the forward algorithm.
-      backwardProb(j, t) /= scales[t + 1];
+      next[j] = scores.col(j).max(index) + logEmissionProb(j, col);
+      if (stateSeqBack != NULL)
+        (*stateSeqBack)(j, col) = index;
     }
+
+    logStateProb = next;
   }
 }
 
+/**
+ * Get the length of the segments used by the checkpointed algorithms.
+ */
+template<typename Distribution>
+size_t HMM<Distribution>::SegmentLength(const size_t length)
+{
+  return std::max((size_t) std::ceil(std::sqrt((double) length)),
+      (size_t) 1);
+}
+
 //! Serialize the HMM.
 template<typename Distribution>
 template<typename Archive>
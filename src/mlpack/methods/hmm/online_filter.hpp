@@ -0,0 +1,125 @@
+/**
+ * @file online_filter.hpp
+ * @author agent
+ *
+ * Definition of the OnlineFilter class, which runs the forward algorithm of an
+ * HMM on a stream of observations.
+ */
+#ifndef __MLPACK_METHODS_HMM_ONLINE_FILTER_HPP
+#define __MLPACK_METHODS_HMM_ONLINE_FILTER_HPP
+
+#include <mlpack/core.hpp>
+#include "hmm.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * A streaming filter for a Hidden Markov Model.  HMM::Filter() and
+ * HMM::LogLikelihood() need the whole observation sequence up front; the
+ * OnlineFilter instead consumes observations incrementally (one at a time, or
+ * a block at a time) and after each Update() holds the filtered state
+ * probabilities P(X_t | o_{1:t}) and the log-likelihood of all observations
+ * seen so far.  Only O(N) memory is used between updates, where N is the
+ * number of hidden states, so it is suitable for unbounded streams.
+ *
+ * Feeding the observations of a sequence to Update() gives the same state
+ * probabilities as the last column of the forward probabilities computed by
+ * HMM::Estimate(), and the same log-likelihood as HMM::LogLikelihood(),
+ * regardless of how the sequence is split into blocks.  Updating with a block
+ * of observations is faster than updating with each observation separately,
+ * because the emission distributions are evaluated on the whole block at once
+ * (if they support it).
+ *
+ * @code
+ * extern HMM<GaussianDistribution> hmm;
+ * OnlineFilter<GaussianDistribution> filter(hmm);
+ *
+ * arma::mat block;
+ * while (ReadNextBlock(block))
+ * {
+ *   filter.Update(block);
+ *   const arma::vec& stateProb = filter.StateProbabilities();
+ *   ...
+ * }
+ * @endcode
+ *
+ * The HMM must not be modified (or destroyed) while the filter is in use.
+ *
+ * @tparam Distribution Type of emission distribution of the HMM.
+ */
+template<typename Distribution = distribution::DiscreteDistribution>
+class OnlineFilter
+{
+ public:
+  /**
+   * Create the filter for the given HMM.  No observations have been seen.
+   *
+   * @param hmm HMM to filter observations with.
+   */
+  OnlineFilter(const HMM<Distribution>& hmm);
+
+  /**
+   * Forget all of the observations seen so far, so that the next observation
+   * is treated as the first one of a new sequence.
+   */
+  void Reset();
+
+  /**
+   * Consume the given block of observations (one per column), updating the
+   * state probabilities and the log-likelihood.
+   *
+   * @param observations Observations to consume, in order.
+   * @return Log-likelihood of the given observations, given all of the
+   *     observations seen before them.
+   */
+  double Update(const arma::mat& observations);
+
+  /**
+   * Compute the distribution of the hidden state the given number of steps
+   * after the last observation, given all observations so far.  With
+   * ahead = 0, this is just StateProbabilities().
+   *
+   * @param ahead Number of steps ahead.
+   * @param predictedProb Vector to store the state probabilities in.
+   */
+  void Predict(const size_t ahead, arma::vec& predictedProb) const;
+
+  /**
+   * Compute the expected emission the given number of steps after the last
+   * observation, given all observations so far; that is,
+   * E{ Y[t + k] | Y[0], ..., Y[t] }.  With ahead = 0, this matches the column
+   * computed by HMM::Filter() for the last observation.  Like HMM::Filter(),
+   * this will not work for distributions without a Mean() function.
+   *
+   * @param ahead Number of steps ahead (k).
+   * @param expectedEmission Vector to store the expected emission in.
+   */
+  void ExpectedEmission(const size_t ahead, arma::vec& expectedEmission) const;
+
+  //! Get the filtered state probabilities after the last observation.
+  const arma::vec& StateProbabilities() const { return stateProb; }
+  //! Get the log-likelihood of all observations seen so far.
+  double LogLikelihood() const { return logLikelihood; }
+  //! Get the number of observations seen so far.
+  size_t Steps() const { return steps; }
+
+ private:
+  //! The HMM being filtered with.
+  const HMM<Distribution>& hmm;
+
+  //! Filtered state probabilities after the last observation.
+  arma::vec stateProb;
+  //! Log-likelihood of all observations seen so far.
+  double logLikelihood;
+  //! Number of observations seen so far.
+  size_t steps;
+};
+
+} // namespace hmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_filter_impl.hpp"
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file online_filter_impl.hpp
+ * @author agent
+ *
+ * Implementation of the OnlineFilter class.
+ */
+#ifndef __MLPACK_METHODS_HMM_ONLINE_FILTER_IMPL_HPP
+#define __MLPACK_METHODS_HMM_ONLINE_FILTER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_filter.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+template<typename Distribution>
+OnlineFilter<Distribution>::OnlineFilter(const HMM<Distribution>& hmm) :
+    hmm(hmm),
+    logLikelihood(0.0),
+    steps(0)
+{ /* nothing to do */ }
+
+template<typename Distribution>
+void OnlineFilter<Distribution>::Reset()
+{
+  stateProb.reset();
+  logLikelihood = 0.0;
+  steps = 0;
+}
+
+template<typename Distribution>
+double OnlineFilter<Distribution>::Update(const arma::mat& observations)
+{
+  if (observations.n_rows != hmm.Dimensionality())
+  {
+    Log::Fatal << "OnlineFilter::Update(): observations have dimensionality "
+        << observations.n_rows << " (expected " << hmm.Dimensionality()
+        << " dimensions)." << std::endl;
+  }
+
+  const arma::mat& transition = hmm.Transition();
+  const size_t states = transition.n_rows;
+
+  // Evaluate all the emission distributions on the whole block.
+  arma::mat emissionProb(states, observations.n_cols);
+  arma::vec logProbabilities;
+  for (size_t state = 0; state < states; ++state)
+  {
+    BatchLogProbability(hmm.Emission()[state], observations, logProbabilities);
+    emissionProb.row(state) = trans(logProbabilities);
+  }
+
+  // Now take one step of the forward algorithm for each observation.  Each
+  // column of emission probabilities is shifted in log space so that its
+  // largest element is 1; this does not change the filtered probabilities,
+  // but keeps unlikely observations from underflowing.
+  double blockLogLikelihood = 0.0;
+  for (size_t t = 0; t < observations.n_cols; ++t)
+  {
+    double logShift = emissionProb.col(t).max();
+    if (!std::isfinite(logShift))
+      logShift = 0.0;
+
+    const arma::vec emissions = exp(emissionProb.col(t) - logShift);
+    if (steps == 0)
+      stateProb = hmm.Initial() % emissions;
+    else
+      stateProb = (transition * stateProb) % emissions;
+
+    const double scale = accu(stateProb);
+    stateProb /= scale;
+    blockLogLikelihood += std::log(scale) + logShift;
+    ++steps;
+  }
+
+  logLikelihood += blockLogLikelihood;
+  return blockLogLikelihood;
+}
+
+template<typename Distribution>
+void OnlineFilter<Distribution>::Predict(const size_t ahead,
+                                         arma::vec& predictedProb) const
+{
+  // Before any observations, the state distribution is the initial one.
+  predictedProb = (steps == 0) ? hmm.Initial() : stateProb;
+
+  // Propagate the state ahead.  Repeated matrix-vector products are cheaper
+  // than a matrix power when ahead is small relative to the number of states.
+  for (size_t i = 0; i < ahead; ++i)
+    predictedProb = hmm.Transition() * predictedProb;
+}
+
+template<typename Distribution>
+void OnlineFilter<Distribution>::ExpectedEmission(
+    const size_t ahead,
+    arma::vec& expectedEmission) const
+{
+  arma::vec aheadProb;
+  Predict(ahead, aheadProb);
+
+  // Will not work for distributions without a Mean() function.
+  expectedEmission.zeros(hmm.Dimensionality());
+  for (size_t i = 0; i < hmm.Emission().size(); ++i)
+    expectedEmission += aheadProb[i] * hmm.Emission()[i].Mean();
+}
+
+} // namespace hmm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,261 @@
+/**
+ * @file hoeffding_forest.hpp
+ * @author agent
+ *
+ * An ensemble of Hoeffding trees trained with online bagging, for streaming
+ * classification.
+ */
+#ifndef __MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_HPP
+#define __MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_HPP
+
+#include <mlpack/core.hpp>
+#include "hoeffding_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HoeffdingForest is an ensemble of HoeffdingTrees trained with online
+ * bagging, as described in the following paper:
+ *
+ * @code
+ * @inproceedings{oza2001online,
+ *     title={{Online Bagging and Boosting}},
+ *     author={Oza, N.C. and Russell, S.},
+ *     year={2001},
+ *     booktitle={Proceedings of the Eighth International Workshop on
+ *         Artificial Intelligence and Statistics (AISTATS '01)},
+ *     pages={105--112}
+ * }
+ * @endcode
+ *
+ * Each tree sees each training point k times, where k is drawn from a Poisson
+ * distribution with mean Lambda() (1 by default); this is the streaming
+ * equivalent of training each tree on a bootstrap sample.  A point is
+ * classified by letting each tree vote for its prediction with weight equal to
+ * the probability the tree gives for that prediction.
+ *
+ * When training on a batch of points, the trees are split into contiguous
+ * groups, one per OpenMP thread, and each thread streams the whole batch
+ * through its group of trees.  The trees do not share any state, and each tree
+ * draws its Poisson weights from its own random number generator, so the
+ * result does not depend on the number of threads.
+ *
+ * The template parameters are the same as for the HoeffdingTree class.
+ *
+ * @tparam FitnessFunction Fitness function to use.
+ * @tparam NumericSplitType Technique for splitting numeric features.
+ * @tparam CategoricalSplitType Technique for splitting categorical features.
+ */
+template<typename FitnessFunction = GiniImpurity,
+         template<typename> class NumericSplitType =
+             HoeffdingDoubleNumericSplit,
+         template<typename> class CategoricalSplitType =
+             HoeffdingCategoricalSplit
+>
+class HoeffdingForest
+{
+ public:
+  //! The type of tree in the ensemble.
+  typedef HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>
+      TreeType;
+  //! Allow access to the numeric split type.
+  typedef typename TreeType::NumericSplit NumericSplit;
+  //! Allow access to the categorical split type.
+  typedef typename TreeType::CategoricalSplit CategoricalSplit;
+
+  /**
+   * Construct the ensemble and train it on the given data in streaming mode.
+   * The parameters of each tree are the same as for the HoeffdingTree
+   * constructor.
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Information on the dataset (types of each feature).
+   * @param labels Labels of each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of trees in the ensemble.
+   * @param lambda Mean of the Poisson distribution that each point's weight is
+   *      drawn from.
+   * @param successProbability Probability of success required in Hoeffding
+   *      bounds before a split can happen.
+   * @param maxSamples Maximum number of samples before a split is forced (0
+   *      never forces a split).
+   * @param checkInterval Number of samples required before each split.
+   * @param minSamples If the node has seen this many points or fewer, no split
+   *      will be allowed.
+   */
+  template<typename MatType>
+  HoeffdingForest(const MatType& data,
+                  const data::DatasetInfo& datasetInfo,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  const size_t numTrees = 10,
+                  const double lambda = 1.0,
+                  const double successProbability = 0.95,
+                  const size_t maxSamples = 0,
+                  const size_t checkInterval = 100,
+                  const size_t minSamples = 100,
+                  const CategoricalSplit& categoricalSplitIn =
+                      CategoricalSplit(0, 0),
+                  const NumericSplit& numericSplitIn = NumericSplit(0));
+
+  /**
+   * Construct the ensemble without training it.
+   *
+   * @param datasetInfo Information on the dataset (types of each feature).
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of trees in the ensemble.
+   * @param lambda Mean of the Poisson distribution that each point's weight is
+   *      drawn from.
+   * @param successProbability Probability of success required in Hoeffding
+   *      bounds before a split can happen.
+   * @param maxSamples Maximum number of samples before a split is forced (0
+   *      never forces a split).
+   * @param checkInterval Number of samples required before each split.
+   * @param minSamples If the node has seen this many points or fewer, no split
+   *      will be allowed.
+   */
+  HoeffdingForest(const data::DatasetInfo& datasetInfo,
+                  const size_t numClasses,
+                  const size_t numTrees = 10,
+                  const double lambda = 1.0,
+                  const double successProbability = 0.95,
+                  const size_t maxSamples = 0,
+                  const size_t checkInterval = 100,
+                  const size_t minSamples = 100,
+                  const CategoricalSplit& categoricalSplitIn =
+                      CategoricalSplit(0, 0),
+                  const NumericSplit& numericSplitIn = NumericSplit(0));
+
+  /**
+   * Copy another ensemble (this copies every tree).
+   *
+   * @param other Ensemble to copy.
+   */
+  HoeffdingForest(const HoeffdingForest& other);
+
+  /**
+   * Take ownership of the trees of another ensemble, which is left empty.
+   *
+   * @param other Ensemble to move.
+   */
+  HoeffdingForest(HoeffdingForest&& other);
+
+  /**
+   * Copy or move another ensemble into this one.  The other ensemble is taken
+   * by value (so it is copied or moved by the constructors above) and then
+   * swapped with this one, so the old trees are freed when it is destroyed.
+   *
+   * @param other Ensemble to copy or move.
+   */
+  HoeffdingForest& operator=(HoeffdingForest other);
+
+  /**
+   * Clean up memory.
+   */
+  ~HoeffdingForest();
+
+  /**
+   * Train every tree on the given points, in order, in streaming mode.  The
+   * trees are trained in parallel.
+   *
+   * @param data Data points to train on.
+   * @param labels Labels of data points.
+   */
+  template<typename MatType>
+  void Train(const MatType& data, const arma::Row<size_t>& labels);
+
+  /**
+   * Train every tree on a single point.  This is not parallelized; to use many
+   * cores, train on batches of points with the other overload.
+   *
+   * @param point Point to train on.
+   * @param label Label of point to train on.
+   */
+  template<typename VecType>
+  void Train(const VecType& point, const size_t label);
+
+  /**
+   * Classify the given point with a vote of the trees.
+   *
+   * @param point Point to classify.
+   * @return Predicted label of point.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point with a vote of the trees, and also return an
+   * estimate of the probability that the prediction is correct (the weight of
+   * the votes for the prediction divided by the number of trees).
+   *
+   * @param point Point to classify.
+   * @param prediction Predicted label of point.
+   * @param probability An estimate of the probability that the prediction is
+   *      correct.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point, size_t& prediction, double& probability)
+      const;
+
+  /**
+   * Classify the given points in parallel.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted labels for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points in parallel, and also return an estimate of the
+   * probability that each prediction is correct.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted labels for each point.
+   * @param probabilities Probability estimates for each predicted label.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::rowvec& probabilities) const;
+
+  //! Get the number of trees in the ensemble.
+  size_t NumTrees() const { return trees.size(); }
+  //! Get a tree.
+  const TreeType& Tree(const size_t i) const { return *trees[i]; }
+  //! Modify a tree.
+  TreeType& Tree(const size_t i) { return *trees[i]; }
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the mean of the Poisson distribution for the weights of points.
+  double Lambda() const { return lambda; }
+  //! Modify the mean of the Poisson distribution for the weights of points.
+  double& Lambda() { return lambda; }
+
+  //! Serialize the ensemble.
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Seed the random number generator of each tree from math::randGen.
+  void SeedGenerators();
+
+  //! The trees.
+  std::vector<TreeType*> trees;
+  //! The random number generator for the weights of each tree.
+  std::vector<std::mt19937> generators;
+  //! The number of classes.
+  size_t numClasses;
+  //! The mean of the Poisson distribution for the weights of points.
+  double lambda;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#include "hoeffding_forest_impl.hpp"
+
+#endif
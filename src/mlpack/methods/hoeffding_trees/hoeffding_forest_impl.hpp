@@ -0,0 +1,327 @@
+/**
+ * @file hoeffding_forest_impl.hpp
+ * @author agent
+ *
+ * Implementation of the HoeffdingForest class.
+ */
+#ifndef __MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_IMPL_HPP
+#define __MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hoeffding_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::HoeffdingForest(const MatType& data,
+                   const data::DatasetInfo& datasetInfo,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const size_t numTrees,
+                   const double lambda,
+                   const double successProbability,
+                   const size_t maxSamples,
+                   const size_t checkInterval,
+                   const size_t minSamples,
+                   const CategoricalSplit& categoricalSplitIn,
+                   const NumericSplit& numericSplitIn) :
+    HoeffdingForest(datasetInfo, numClasses, numTrees, lambda,
+        successProbability, maxSamples, checkInterval, minSamples,
+        categoricalSplitIn, numericSplitIn)
+{
+  Train(data, labels);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::HoeffdingForest(const data::DatasetInfo& datasetInfo,
+                   const size_t numClasses,
+                   const size_t numTrees,
+                   const double lambda,
+                   const double successProbability,
+                   const size_t maxSamples,
+                   const size_t checkInterval,
+                   const size_t minSamples,
+                   const CategoricalSplit& categoricalSplitIn,
+                   const NumericSplit& numericSplitIn) :
+    numClasses(numClasses),
+    lambda(lambda)
+{
+  if (numTrees == 0)
+    throw std::invalid_argument("HoeffdingForest::HoeffdingForest(): number "
+        "of trees must be positive");
+
+  trees.resize(numTrees, NULL);
+  for (size_t i = 0; i < numTrees; ++i)
+    trees[i] = new TreeType(datasetInfo, numClasses, successProbability,
+        maxSamples, checkInterval, minSamples, categoricalSplitIn,
+        numericSplitIn);
+
+  SeedGenerators();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::HoeffdingForest(const HoeffdingForest& other) :
+    trees(other.trees.size(), NULL),
+    generators(other.generators),
+    numClasses(other.numClasses),
+    lambda(other.lambda)
+{
+  for (size_t i = 0; i < other.trees.size(); ++i)
+    trees[i] = new TreeType(*other.trees[i]);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::HoeffdingForest(HoeffdingForest&& other) :
+    trees(std::move(other.trees)),
+    generators(std::move(other.generators)),
+    numClasses(other.numClasses),
+    lambda(other.lambda)
+{
+  // Make sure the other ensemble does not free the trees we now own.
+  other.trees.clear();
+  other.generators.clear();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>& HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::operator=(HoeffdingForest other)
+{
+  trees.swap(other.trees);
+  generators.swap(other.generators);
+  std::swap(numClasses, other.numClasses);
+  std::swap(lambda, other.lambda);
+
+  return *this;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::~HoeffdingForest()
+{
+  for (size_t i = 0; i < trees.size(); ++i)
+    delete trees[i];
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Train(const MatType& data, const arma::Row<size_t>& labels)
+{
+  // With a static schedule, each thread gets a contiguous group of trees, and
+  // streams every point through each tree of its group.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t t = 0; t < (omp_size_t) trees.size(); ++t)
+  {
+    std::poisson_distribution<size_t> weight(lambda);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const size_t k = weight(generators[t]);
+      for (size_t j = 0; j < k; ++j)
+        trees[t]->Train(data.col(i), labels[i]);
+    }
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename VecType>
+void HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Train(const VecType& point, const size_t label)
+{
+  std::poisson_distribution<size_t> weight(lambda);
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    const size_t k = weight(generators[t]);
+    for (size_t j = 0; j < k; ++j)
+      trees[t]->Train(point, label);
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename VecType>
+size_t HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Classify(const VecType& point) const
+{
+  size_t prediction;
+  double probability;
+  Classify(point, prediction, probability);
+  return prediction;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename VecType>
+void HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Classify(const VecType& point,
+            size_t& prediction,
+            double& probability) const
+{
+  arma::vec votes(numClasses, arma::fill::zeros);
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    size_t treePrediction;
+    double treeProbability;
+    trees[t]->Classify(point, treePrediction, treeProbability);
+    votes[treePrediction] += treeProbability;
+  }
+
+  arma::uword maxIndex;
+  probability = votes.max(maxIndex) / trees.size();
+  prediction = (size_t) maxIndex;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Classify(const MatType& data, arma::Row<size_t>& predictions) const
+{
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    predictions[i] = Classify(data.col(i));
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Classify(const MatType& data,
+            arma::Row<size_t>& predictions,
+            arma::rowvec& probabilities) const
+{
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    Classify(data.col(i), predictions[i], probabilities[i]);
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename Archive>
+void HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Serialize(Archive& ar, const unsigned int /* version */)
+{
+  using data::CreateNVP;
+
+  ar & CreateNVP(numClasses, "numClasses");
+  ar & CreateNVP(lambda, "lambda");
+
+  size_t numTrees;
+  if (Archive::is_saving::value)
+    numTrees = trees.size();
+  ar & CreateNVP(numTrees, "numTrees");
+  if (Archive::is_loading::value)
+  {
+    for (size_t i = 0; i < trees.size(); ++i)
+      delete trees[i];
+
+    trees.clear();
+    trees.resize(numTrees, NULL);
+    for (size_t i = 0; i < numTrees; ++i)
+      trees[i] = new TreeType(data::DatasetInfo(0), 0);
+  }
+
+  for (size_t i = 0; i < numTrees; ++i)
+  {
+    std::ostringstream name;
+    name << "tree" << i;
+    ar & CreateNVP(*trees[i], name.str());
+  }
+
+  // The state of the random number generators is not saved.
+  if (Archive::is_loading::value)
+    SeedGenerators();
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingForest<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::SeedGenerators()
+{
+  generators.resize(trees.size());
+  for (size_t i = 0; i < generators.size(); ++i)
+    generators[i].seed(math::randGen());
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
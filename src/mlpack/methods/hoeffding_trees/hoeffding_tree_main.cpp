@@ -8,6 +8,7 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/information_gain.hpp>
+#include <mlpack/core/data/chunk_reader.hpp>
 #include <queue>
 
 using namespace std;
@@ -39,7 +40,15 @@ PROGRAM_INFO("Hoeffding trees",
     " with the --test_labels_file (-L) option.  Predictions for each test point"
     " will be stored in the file specified by --predictions_file (-p) and "
     "probabilities for each predictions will be stored in the file specified by"
-    " the --probabilities_file (-P) option.");
+    " the --probabilities_file (-P) option."
+    "\n\n"
+    "For datasets that do not fit in memory, the --chunk_size (-C) option "
+    "makes the program read the training file (which must then be a CSV, TSV, "
+    "or text file with only numeric values, or an ARFF file) and the labels "
+    "file from disk in blocks of the given number of points; the next block is "
+    "read while the tree trains on the current one.  If the ARFF file has "
+    "categorical attributes, the file is read once more beforehand to map "
+    "them.");
 
 PARAM_STRING("training_file", "Training dataset file.", "t", "");
 PARAM_STRING("labels_file", "Labels for training dataset.", "l", "");
@@ -69,6 +78,8 @@ PARAM_FLAG("batch_mode", "If true, samples will be considered in batch instead "
 PARAM_FLAG("info_gain", "If set, information gain is used instead of Gini "
     "impurity for calculating Hoeffding bounds.", "i");
 PARAM_INT("passes", "Number of passes to take over the dataset.", "s", 1);
+PARAM_INT("chunk_size", "If nonzero, read the training data from disk in "
+    "blocks of this many points instead of loading it into memory.", "C", 0);
 
 PARAM_INT("bins", "If the 'domingos' split strategy is used, this specifies "
     "the number of bins for each numeric split.", "B", 10);
@@ -81,6 +92,17 @@ template<typename TreeType>
 void PerformActions(const typename TreeType::NumericSplit& numericSplit =
     typename TreeType::NumericSplit(0));
 
+// Helper function to train the tree on blocks of the training file.
+template<typename TreeType>
+void TrainInBlocks(TreeType*& tree,
+                   DatasetInfo& datasetInfo,
+                   const typename TreeType::NumericSplit& numericSplit);
+
+// Helper function to compute the training accuracy on blocks of the training
+// file.
+template<typename TreeType>
+void TrainingAccuracyInBlocks(const TreeType& tree, DatasetInfo& datasetInfo);
+
 int main(int argc, char** argv)
 {
   CLI::ParseCommandLine(argc, argv);
@@ -115,6 +137,14 @@ int main(int argc, char** argv)
     Log::Warn << "--batch_mode (-b) ignored because --passes was specified."
         << endl;
 
+  if (CLI::GetParam<int>("chunk_size") < 0)
+    Log::Fatal << "Invalid --chunk_size (" << CLI::GetParam<int>("chunk_size")
+        << "); must be nonnegative." << endl;
+
+  if (CLI::HasParam("chunk_size") && CLI::HasParam("batch_mode"))
+    Log::Warn << "--batch_mode (-b) ignored because --chunk_size was "
+        << "specified." << endl;
+
   if (CLI::HasParam("info_gain"))
   {
     if (numericSplitStrategy == "domingos")
@@ -183,10 +213,15 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
   const size_t passes = (size_t) CLI::GetParam<int>("passes");
   if (passes > 1)
     batchTraining = false; // We already warned about this earlier.
+  const size_t chunkSize = (size_t) CLI::GetParam<int>("chunk_size");
 
   TreeType* tree = NULL;
   DatasetInfo datasetInfo;
-  if (inputModelFile.empty())
+  if (inputModelFile.empty() && chunkSize > 0)
+  {
+    TrainInBlocks(tree, datasetInfo, numericSplit);
+  }
+  else if (inputModelFile.empty())
   {
     arma::mat trainingSet;
     data::Load(trainingFile, trainingSet, datasetInfo, true);
@@ -216,7 +251,11 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
     tree = new TreeType(datasetInfo, 1, 1);
     data::Load(inputModelFile, "streamingDecisionTree", *tree, true);
 
-    if (!trainingFile.empty())
+    if (!trainingFile.empty() && chunkSize > 0)
+    {
+      TrainInBlocks(tree, datasetInfo, numericSplit);
+    }
+    else if (!trainingFile.empty())
     {
       arma::mat trainingSet;
       data::Load(trainingFile, trainingSet, datasetInfo, true);
@@ -244,7 +283,11 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
     }
   }
 
-  if (!trainingFile.empty())
+  if (!trainingFile.empty() && chunkSize > 0)
+  {
+    TrainingAccuracyInBlocks(*tree, datasetInfo);
+  }
+  else if (!trainingFile.empty())
   {
     // Get training error.
     arma::mat trainingSet;
@@ -326,3 +369,168 @@ void PerformActions(const typename TreeType::NumericSplit& numericSplit)
   // Clean up memory.
   delete tree;
 }
+
+// Read the next block of points and labels; return false at the end.
+bool ReadBlock(ChunkReader& reader,
+               ChunkReader& labelReader,
+               arma::mat& points,
+               arma::Row<size_t>& labels)
+{
+  arma::mat labelsIn;
+  const bool more = reader.Next(points);
+  labelReader.Next(labelsIn);
+  if (labelsIn.n_cols != points.n_cols)
+    throw std::runtime_error("the labels file does not have one label for "
+        "each point of the training file");
+
+  labels = arma::conv_to<arma::Row<size_t>>::from(labelsIn);
+  return more;
+}
+
+template<typename TreeType>
+void TrainInBlocks(TreeType*& tree,
+                   DatasetInfo& datasetInfo,
+                   const typename TreeType::NumericSplit& numericSplit)
+{
+  const string trainingFile = CLI::GetParam<string>("training_file");
+  const string labelsFile = CLI::GetParam<string>("labels_file");
+  const double confidence = CLI::GetParam<double>("confidence");
+  const size_t maxSamples = (size_t) CLI::GetParam<int>("max_samples");
+  const size_t minSamples = (size_t) CLI::GetParam<int>("min_samples");
+  const size_t passes = (size_t) CLI::GetParam<int>("passes");
+  const size_t chunkSize = (size_t) CLI::GetParam<int>("chunk_size");
+
+  try
+  {
+    ChunkReader reader(trainingFile, datasetInfo, chunkSize);
+    DatasetInfo labelInfo;
+    ChunkReader labelReader(labelsFile, labelInfo, chunkSize);
+    if (labelReader.Dimensionality() != 1)
+      Log::Fatal << "The labels file '" << labelsFile << "' must have one "
+          << "label per line." << endl;
+
+    // Every category must be mapped before the tree is built.
+    reader.MapCategories();
+    for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+      Log::Info << datasetInfo.NumMappings(i) << " mappings in dimension "
+          << i << "." << endl;
+
+    if (tree == NULL)
+    {
+      // We need the number of classes; this costs a pass over the labels.
+      size_t numClasses = 0;
+      arma::mat labelsIn;
+      while (labelReader.Next(labelsIn))
+        numClasses = std::max(numClasses, (size_t) labelsIn.max() + 1);
+      labelReader.Rewind();
+
+      tree = new TreeType(datasetInfo, numClasses, confidence, maxSamples,
+          100, minSamples, typename TreeType::CategoricalSplit(0, 0),
+          numericSplit);
+    }
+
+    // The tree reads datasetInfo while it trains, so the blocks that are read
+    // at the same time are parsed with a private copy of the mappings.  Every
+    // category was mapped above, so the copy maps each string to the same
+    // value.
+    DatasetInfo blockInfo(datasetInfo);
+    ChunkReader blockReader(trainingFile, blockInfo, chunkSize);
+
+    Timer::Start("tree_training");
+    if (passes > 1)
+      Log::Info << "Taking " << passes << " passes over the dataset." << endl;
+
+    for (size_t pass = 0; pass < passes; ++pass)
+    {
+      blockReader.Rewind();
+      labelReader.Rewind();
+
+      // Train on one block while the next one is read, so at most two blocks
+      // are in memory.
+      arma::mat points, nextPoints;
+      arma::Row<size_t> labels, nextLabels;
+      bool more = ReadBlock(blockReader, labelReader, points, labels);
+      while (more)
+      {
+        bool nextMore = false;
+        string error;
+        #pragma omp parallel sections num_threads(2)
+        {
+          #pragma omp section
+          {
+            try
+            {
+              nextMore = ReadBlock(blockReader, labelReader, nextPoints,
+                  nextLabels);
+            }
+            catch (std::exception& e)
+            {
+              error = e.what();
+            }
+          }
+
+          #pragma omp section
+          {
+            tree->Train(points, labels, false);
+          }
+        }
+
+        if (!error.empty())
+          throw std::runtime_error(error);
+
+        // If parsing the block found a category that was not mapped before
+        // (because the file changed), its value would mean nothing to the tree.
+        for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+          if (blockInfo.NumMappings(i) != datasetInfo.NumMappings(i))
+            throw std::runtime_error("the training file has a category that "
+                "was not mapped before training");
+
+        points.swap(nextPoints);
+        labels.swap(nextLabels);
+        more = nextMore;
+      }
+
+      Log::Info << "Trained on " << blockReader.PointsRead() << " points in "
+          << "blocks of " << chunkSize << "." << endl;
+    }
+    Timer::Stop("tree_training");
+  }
+  catch (std::exception& e)
+  {
+    Log::Fatal << "Error while training on '" << trainingFile << "': "
+        << e.what() << endl;
+  }
+}
+
+template<typename TreeType>
+void TrainingAccuracyInBlocks(const TreeType& tree, DatasetInfo& datasetInfo)
+{
+  const string trainingFile = CLI::GetParam<string>("training_file");
+  const string labelsFile = CLI::GetParam<string>("labels_file");
+  const size_t chunkSize = (size_t) CLI::GetParam<int>("chunk_size");
+
+  try
+  {
+    ChunkReader reader(trainingFile, datasetInfo, chunkSize);
+    DatasetInfo labelInfo;
+    ChunkReader labelReader(labelsFile, labelInfo, chunkSize);
+
+    size_t correct = 0;
+    arma::mat points;
+    arma::Row<size_t> labels, predictions;
+    while (ReadBlock(reader, labelReader, points, labels))
+    {
+      tree.Classify(points, predictions);
+      correct += arma::accu(labels == predictions);
+    }
+
+    Log::Info << correct << " out of " << reader.PointsRead() << " correct "
+        << "on training set (" << double(correct) /
+        double(reader.PointsRead()) * 100.0 << ")." << endl;
+  }
+  catch (std::exception& e)
+  {
+    Log::Fatal << "Error while classifying '" << trainingFile << "': "
+        << e.what() << endl;
+  }
+}
@@ -0,0 +1,268 @@
+/**
+ * @file kde.hpp
+ * @author agent
+ *
+ * Defines the KDE class, which performs kernel density estimation with trees.
+ */
+#ifndef __MLPACK_METHODS_KDE_KDE_HPP
+#define __MLPACK_METHODS_KDE_KDE_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+
+namespace mlpack {
+namespace kde /** Kernel density estimation. */ {
+
+/**
+ * The KDE class performs kernel density estimation: given a set of reference
+ * points, the density at a query point q is estimated as
+ *
+ * @f[
+ * f(q) = \frac{1}{N C} \sum_{r} K(\| q - r \|)
+ * @f]
+ *
+ * where N is the number of reference points, K is the kernel, and C is the
+ * normalization constant of the kernel.  Naively, this takes O(N) time per
+ * query point.  With single-tree or dual-tree traversal (the default), a
+ * reference node is approximated as a whole when the kernel values between the
+ * query point (or query node) and every point in the node all lie within the
+ * error tolerance of one value.  The result is then guaranteed to satisfy
+ *
+ * @f[
+ * | \hat{f}(q) - f(q) | \le \epsilon_{rel} f(q) + \epsilon_{abs}
+ * @f]
+ *
+ * for every query point q, where @f$\epsilon_{rel}@f$ is RelativeError() and
+ * @f$\epsilon_{abs}@f$ is AbsoluteError().  With reasonable tolerances, this
+ * makes the dual-tree algorithm close to linear in the number of points.  For
+ * more information on dual-tree kernel density estimation, see the following
+ * paper:
+ *
+ * @code
+ * @inproceedings{gray2003nonparametric,
+ *   title={Nonparametric Density Estimation: Toward Computational
+ *       Tractability},
+ *   author={Gray, A.G. and Moore, A.W.},
+ *   booktitle={Proceedings of the 2003 SIAM International Conference on Data
+ *       Mining (SDM '03)},
+ *   pages={203--211},
+ *   year={2003}
+ * }
+ * @endcode
+ *
+ * Optionally, a reference node that cannot be approximated in this way may be
+ * approximated by the mean kernel value of a random sample of its points
+ * instead (see MonteCarlo()).  Then the error bound only holds for each node
+ * approximation with probability MCProbability().
+ *
+ * @tparam KernelType Kernel to use; it must be a decreasing function of the
+ *     distance between points, and provide Evaluate(distance) and
+ *     Normalizer(dimensionality).  GaussianKernel and EpanechnikovKernel are
+ *     suitable.
+ * @tparam MetricType Metric to use; it should be the metric the kernel is
+ *     defined with.
+ * @tparam MatType Type of data matrix.
+ * @tparam TreeType Type of tree to use; the first point of a node must not be
+ *     its centroid (so, for instance, cover trees cannot be used).
+ */
+template<typename KernelType = kernel::GaussianKernel,
+         typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class KDE
+{
+ public:
+  //! Convenience typedef.
+  typedef TreeType<MetricType, tree::EmptyStatistic, MatType> Tree;
+
+  /**
+   * Initialize the KDE object without any reference data.  Call Train() before
+   * Evaluate().
+   *
+   * @param relError Relative error tolerance for each density estimate.
+   * @param absError Absolute error tolerance for each density estimate.
+   * @param kernel Instantiated kernel.
+   * @param naive If true, the O(N) per query naive computation is used.
+   * @param singleMode If true, single-tree traversal is used (as opposed to
+   *     dual-tree traversal).
+   * @param metric Instantiated metric.
+   */
+  KDE(const double relError = 0.05,
+      const double absError = 0.0,
+      const KernelType kernel = KernelType(),
+      const bool naive = false,
+      const bool singleMode = false,
+      const MetricType metric = MetricType());
+
+  /**
+   * Destroy the KDE object, and the reference tree and set if this object owns
+   * them.
+   */
+  ~KDE();
+
+  /**
+   * Set the reference set, building a tree on it if necessary.  The dataset is
+   * copied if a tree is built; to avoid that, use the other overload.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(const MatType& referenceSet);
+
+  /**
+   * Set the reference set, taking ownership of it and building a tree on it if
+   * necessary.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType&& referenceSet);
+
+  /**
+   * Set the reference tree.  This object will not take ownership of the tree,
+   * and, because the tree may have rearranged its points, the estimates for a
+   * monochromatic Evaluate() will be in the order of the points in the tree.
+   *
+   * @param referenceTree Pre-built tree on the reference points.
+   */
+  void Train(Tree* referenceTree);
+
+  /**
+   * Estimate the density at each of the given query points.
+   *
+   * @param querySet Set of query points.
+   * @param estimations Vector to store the density estimate of each query point
+   *     in.
+   */
+  void Evaluate(const MatType& querySet, arma::vec& estimations);
+
+  /**
+   * Estimate the density at each of the reference points.
+   *
+   * @param estimations Vector to store the density estimate of each reference
+   *     point in.
+   */
+  void Evaluate(arma::vec& estimations);
+
+  //! Get the relative error tolerance.
+  double RelativeError() const { return relError; }
+  //! Modify the relative error tolerance.
+  double& RelativeError() { return relError; }
+
+  //! Get the absolute error tolerance.
+  double AbsoluteError() const { return absError; }
+  //! Modify the absolute error tolerance.
+  double& AbsoluteError() { return absError; }
+
+  //! Get the kernel.
+  const KernelType& Kernel() const { return kernel; }
+  //! Modify the kernel.
+  KernelType& Kernel() { return kernel; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get whether naive computation is used.
+  bool Naive() const { return naive; }
+  //! Get whether single-tree traversal is used.
+  bool SingleMode() const { return singleMode; }
+  //! Modify whether single-tree traversal is used.
+  bool& SingleMode() { return singleMode; }
+
+  //! Get whether Monte Carlo approximations are used.
+  bool MonteCarlo() const { return monteCarlo; }
+  //! Modify whether Monte Carlo approximations are used.
+  bool& MonteCarlo() { return monteCarlo; }
+
+  //! Get the probability that each Monte Carlo approximation is within the
+  //! error tolerance.
+  double MCProbability() const { return mcProbability; }
+  //! Modify the probability that each Monte Carlo approximation is within the
+  //! error tolerance.
+  double& MCProbability() { return mcProbability; }
+
+  //! Get the number of points sampled in each round of a Monte Carlo
+  //! approximation.
+  size_t MCInitialSampleSize() const { return mcInitialSampleSize; }
+  //! Modify the number of points sampled in each round of a Monte Carlo
+  //! approximation.
+  size_t& MCInitialSampleSize() { return mcInitialSampleSize; }
+
+  //! Get the fraction of the points of a node after which a Monte Carlo
+  //! approximation of the node is abandoned.
+  double MCBreakCoefficient() const { return mcBreakCoefficient; }
+  //! Modify the fraction of the points of a node after which a Monte Carlo
+  //! approximation of the node is abandoned.
+  double& MCBreakCoefficient() { return mcBreakCoefficient; }
+
+  //! Get the number of base cases during the last evaluation.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores during the last evaluation.
+  size_t Scores() const { return scores; }
+
+  //! Return the reference set.
+  const MatType& ReferenceSet() const { return *referenceSet; }
+  //! Return the reference tree (or NULL if in naive mode).
+  Tree* ReferenceTree() { return referenceTree; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void Serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Check the parameters before an evaluation.
+  void CheckParameters(const size_t dimensionality) const;
+
+  //! Mappings to old reference indices (used when this object builds trees).
+  std::vector<size_t> oldFromNewReferences;
+  //! Reference tree.
+  Tree* referenceTree;
+  //! Reference set.  In some situations we may own this.
+  const MatType* referenceSet;
+
+  //! If true, this object is responsible for deleting the tree.
+  bool treeOwner;
+  //! If true, we own the reference set.
+  bool setOwner;
+
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+
+  //! Instantiated kernel.
+  KernelType kernel;
+  //! Instantiated distance metric.
+  MetricType metric;
+
+  //! If true, naive computation is used.
+  bool naive;
+  //! If true, single-tree traversal is used.
+  bool singleMode;
+
+  //! If true, Monte Carlo approximations are used.
+  bool monteCarlo;
+  //! The probability that each Monte Carlo approximation is within tolerance.
+  double mcProbability;
+  //! The number of points sampled in each round of Monte Carlo approximation.
+  size_t mcInitialSampleSize;
+  //! The fraction of a node after which Monte Carlo approximation stops.
+  double mcBreakCoefficient;
+
+  //! The total number of base cases during the last evaluation.
+  size_t baseCases;
+  //! The total number of scores during the last evaluation.
+  size_t scores;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_impl.hpp"
+
+#endif
@@ -0,0 +1,503 @@
+/**
+ * @file kde_impl.hpp
+ * @author agent
+ *
+ * Implementation of the KDE class.
+ */
+#ifndef __MLPACK_METHODS_KDE_KDE_IMPL_HPP
+#define __MLPACK_METHODS_KDE_KDE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde.hpp"
+
+// The rules for traversal.
+#include "kde_rules.hpp"
+
+namespace mlpack {
+namespace kde {
+
+//! Call the tree constructor that does mapping.
+template<typename TreeType>
+TreeType* BuildTree(
+    typename TreeType::Mat& dataset,
+    std::vector<size_t>& oldFromNew,
+    typename boost::enable_if_c<
+        tree::TreeTraits<TreeType>::RearrangesDataset == true, TreeType*
+    >::type = 0)
+{
+  return new TreeType(dataset, oldFromNew);
+}
+
+//! Call the tree constructor that does not do mapping.
+template<typename TreeType>
+TreeType* BuildTree(
+    const typename TreeType::Mat& dataset,
+    const std::vector<size_t>& /* oldFromNew */,
+    const typename boost::enable_if_c<
+        tree::TreeTraits<TreeType>::RearrangesDataset == false, TreeType*
+    >::type = 0)
+{
+  return new TreeType(dataset);
+}
+
+//! Call the tree constructor that does mapping, taking ownership of the data.
+template<typename TreeType>
+TreeType* BuildTree(
+    typename TreeType::Mat&& dataset,
+    std::vector<size_t>& oldFromNew,
+    const typename boost::enable_if_c<
+        tree::TreeTraits<TreeType>::RearrangesDataset == true, TreeType*
+    >::type = 0)
+{
+  return new TreeType(std::move(dataset), oldFromNew);
+}
+
+//! Call the tree constructor that does not do mapping, taking ownership of the
+//! data.
+template<typename TreeType>
+TreeType* BuildTree(
+    typename TreeType::Mat&& dataset,
+    const std::vector<size_t>& /* oldFromNew */,
+    const typename boost::enable_if_c<
+        tree::TreeTraits<TreeType>::RearrangesDataset == false, TreeType*
+    >::type = 0)
+{
+  return new TreeType(std::move(dataset));
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::KDE(
+    const double relError,
+    const double absError,
+    const KernelType kernel,
+    const bool naive,
+    const bool singleMode,
+    const MetricType metric) :
+    referenceTree(NULL),
+    referenceSet(new MatType()), // Empty matrix.
+    treeOwner(false),
+    setOwner(true),
+    relError(relError),
+    absError(absError),
+    kernel(kernel),
+    metric(metric),
+    naive(naive),
+    singleMode(!naive && singleMode), // Naive overrides single mode.
+    monteCarlo(false),
+    mcProbability(0.95),
+    mcInitialSampleSize(100),
+    mcBreakCoefficient(0.4),
+    baseCases(0),
+    scores(0)
+{
+  // The pruning rules use RangeDistance(), which gives no information about the
+  // descendants of a node whose first point is its centroid.
+  static_assert(!tree::TreeTraits<Tree>::FirstPointIsCentroid,
+      "KDE cannot be used with trees whose first point is the centroid");
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+KDE<KernelType, MetricType, MatType, TreeType>::~KDE()
+{
+  if (treeOwner && referenceTree)
+    delete referenceTree;
+  if (setOwner && referenceSet)
+    delete referenceSet;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Train(
+    const MatType& referenceSet)
+{
+  // Clean up the old tree, if we built one.
+  if (treeOwner && referenceTree)
+    delete referenceTree;
+
+  // Rebuild the tree, if necessary.
+  if (!naive)
+  {
+    referenceTree = BuildTree<Tree>(const_cast<MatType&>(referenceSet),
+        oldFromNewReferences);
+    treeOwner = true;
+  }
+  else
+  {
+    referenceTree = NULL;
+    treeOwner = false;
+  }
+
+  // Delete the old reference set, if we owned it.
+  if (setOwner && this->referenceSet)
+    delete this->referenceSet;
+
+  if (!naive)
+    this->referenceSet = &referenceTree->Dataset();
+  else
+    this->referenceSet = &referenceSet;
+  setOwner = false;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Train(
+    MatType&& referenceSet)
+{
+  // Clean up the old tree, if we built one.
+  if (treeOwner && referenceTree)
+    delete referenceTree;
+
+  // We may need to rebuild the tree.
+  if (!naive)
+  {
+    referenceTree = BuildTree<Tree>(std::move(referenceSet),
+        oldFromNewReferences);
+    treeOwner = true;
+  }
+  else
+  {
+    referenceTree = NULL;
+    treeOwner = false;
+  }
+
+  // Delete the old reference set, if we owned it.
+  if (setOwner && this->referenceSet)
+    delete this->referenceSet;
+
+  if (!naive)
+  {
+    this->referenceSet = &referenceTree->Dataset();
+    setOwner = false;
+  }
+  else
+  {
+    this->referenceSet = new MatType(std::move(referenceSet));
+    setOwner = true;
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Train(
+    Tree* referenceTree)
+{
+  if (naive)
+    throw std::invalid_argument("cannot train on given reference tree when "
+        "naive computation (without trees) is desired");
+
+  if (treeOwner && this->referenceTree)
+    delete this->referenceTree;
+  if (setOwner && referenceSet)
+    delete referenceSet;
+
+  this->referenceTree = referenceTree;
+  this->referenceSet = &referenceTree->Dataset();
+  oldFromNewReferences.clear();
+  treeOwner = false;
+  setOwner = false;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Evaluate(
+    const MatType& querySet,
+    arma::vec& estimations)
+{
+  CheckParameters(querySet.n_rows);
+
+  Timer::Start("kde/computing_densities");
+
+  // The rules work with unnormalized sums of kernel values, so the absolute
+  // error tolerance must be scaled by the normalization constant.
+  const double normalizer = kernel.Normalizer(querySet.n_rows);
+  const double kernelAbsError = absError * normalizer;
+
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  baseCases = 0;
+  scores = 0;
+  estimations.zeros(querySet.n_cols);
+
+  if (naive)
+  {
+    RuleType rules(*referenceSet, querySet, estimations, relError,
+        kernelAbsError, metric, kernel);
+
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+
+    baseCases += rules.BaseCases();
+  }
+  else if (singleMode)
+  {
+    RuleType rules(*referenceSet, querySet, estimations, relError,
+        kernelAbsError, metric, kernel, monteCarlo, mcProbability,
+        mcInitialSampleSize, mcBreakCoefficient);
+
+    // Create the traverser and have it traverse for each point.
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+  }
+  else
+  {
+    // Build the query tree.
+    Timer::Stop("kde/computing_densities");
+    Timer::Start("kde/tree_building");
+    std::vector<size_t> oldFromNewQueries;
+    Tree* queryTree = BuildTree<Tree>(const_cast<MatType&>(querySet),
+        oldFromNewQueries);
+    Timer::Stop("kde/tree_building");
+    Timer::Start("kde/computing_densities");
+
+    arma::vec treeEstimations(querySet.n_cols, arma::fill::zeros);
+    RuleType rules(*referenceSet, queryTree->Dataset(), treeEstimations,
+        relError, kernelAbsError, metric, kernel, monteCarlo, mcProbability,
+        mcInitialSampleSize, mcBreakCoefficient);
+
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+
+    // Map the estimations back to the original order of the query points.
+    if (tree::TreeTraits<Tree>::RearrangesDataset)
+    {
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+        estimations[oldFromNewQueries[i]] = treeEstimations[i];
+    }
+    else
+    {
+      estimations = std::move(treeEstimations);
+    }
+
+    delete queryTree;
+  }
+
+  estimations /= (referenceSet->n_cols * normalizer);
+
+  Timer::Stop("kde/computing_densities");
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::Evaluate(
+    arma::vec& estimations)
+{
+  CheckParameters(referenceSet->n_rows);
+
+  Timer::Start("kde/computing_densities");
+
+  const double normalizer = kernel.Normalizer(referenceSet->n_rows);
+  const double kernelAbsError = absError * normalizer;
+
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  baseCases = 0;
+  scores = 0;
+
+  // The estimations are computed in the order of the points in the tree.
+  arma::vec treeEstimations(referenceSet->n_cols, arma::fill::zeros);
+  RuleType rules(*referenceSet, *referenceSet, treeEstimations, relError,
+      kernelAbsError, metric, kernel, monteCarlo, mcProbability,
+      mcInitialSampleSize, mcBreakCoefficient);
+
+  if (naive)
+  {
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+  }
+  else if (singleMode)
+  {
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+  }
+  else
+  {
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(*referenceTree, *referenceTree);
+  }
+
+  baseCases += rules.BaseCases();
+  scores += rules.Scores();
+
+  // Map the estimations back to the original order of the points, if we built
+  // the tree.
+  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    estimations.set_size(referenceSet->n_cols);
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      estimations[oldFromNewReferences[i]] = treeEstimations[i];
+  }
+  else
+  {
+    estimations = std::move(treeEstimations);
+  }
+
+  estimations /= (referenceSet->n_cols * normalizer);
+
+  Timer::Stop("kde/computing_densities");
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename Archive>
+void KDE<KernelType, MetricType, MatType, TreeType>::Serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  using data::CreateNVP;
+
+  // Serialize preferences for evaluation.
+  ar & CreateNVP(relError, "relError");
+  ar & CreateNVP(absError, "absError");
+  ar & CreateNVP(kernel, "kernel");
+  ar & CreateNVP(naive, "naive");
+  ar & CreateNVP(singleMode, "singleMode");
+  ar & CreateNVP(monteCarlo, "monteCarlo");
+  ar & CreateNVP(mcProbability, "mcProbability");
+  ar & CreateNVP(mcInitialSampleSize, "mcInitialSampleSize");
+  ar & CreateNVP(mcBreakCoefficient, "mcBreakCoefficient");
+
+  // Reset base cases and scores if we are loading.
+  if (Archive::is_loading::value)
+  {
+    baseCases = 0;
+    scores = 0;
+  }
+
+  // If we are doing naive computation, we serialize the dataset.  Otherwise we
+  // serialize the tree.
+  if (naive)
+  {
+    if (Archive::is_loading::value)
+    {
+      if (setOwner && referenceSet)
+        delete referenceSet;
+
+      setOwner = true;
+    }
+
+    ar & CreateNVP(referenceSet, "referenceSet");
+    ar & CreateNVP(metric, "metric");
+
+    // If we are loading, set the tree to NULL and clean up memory if necessary.
+    if (Archive::is_loading::value)
+    {
+      if (treeOwner && referenceTree)
+        delete referenceTree;
+
+      referenceTree = NULL;
+      oldFromNewReferences.clear();
+      treeOwner = false;
+    }
+  }
+  else
+  {
+    // Delete the current reference tree, if necessary and if we are loading.
+    if (Archive::is_loading::value)
+    {
+      if (treeOwner && referenceTree)
+        delete referenceTree;
+
+      // After we load the tree, we will own it.
+      treeOwner = true;
+    }
+
+    ar & CreateNVP(referenceTree, "referenceTree");
+    ar & CreateNVP(oldFromNewReferences, "oldFromNewReferences");
+
+    // If we are loading, set the dataset accordingly and clean up memory if
+    // necessary.
+    if (Archive::is_loading::value)
+    {
+      if (setOwner && referenceSet)
+        delete referenceSet;
+
+      referenceSet = &referenceTree->Dataset();
+      metric = referenceTree->Metric(); // Get the metric from the tree.
+      setOwner = false;
+    }
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void KDE<KernelType, MetricType, MatType, TreeType>::CheckParameters(
+    const size_t dimensionality) const
+{
+  if (referenceSet->n_cols == 0)
+    throw std::invalid_argument("KDE::Evaluate(): no reference points; call "
+        "Train() first");
+
+  if (dimensionality != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KDE::Evaluate(): dimensionalities of query set ("
+        << dimensionality << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (relError < 0.0 || absError < 0.0)
+    throw std::invalid_argument("KDE::Evaluate(): error tolerances must be "
+        "nonnegative");
+
+  if (monteCarlo && (mcProbability <= 0.0 || mcProbability >= 1.0))
+    throw std::invalid_argument("KDE::Evaluate(): Monte Carlo probability "
+        "must be in (0, 1)");
+
+  if (monteCarlo && mcInitialSampleSize < 2)
+    throw std::invalid_argument("KDE::Evaluate(): Monte Carlo initial sample "
+        "size must be at least 2");
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,178 @@
+/**
+ * @file kde_main.cpp
+ * @author agent
+ *
+ * Executable for kernel density estimation with trees.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+
+#include "kde.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::kde;
+using namespace mlpack::kernel;
+
+// Information about the program itself.
+PROGRAM_INFO("Kernel Density Estimation",
+    "This program performs kernel density estimation: given a set of reference "
+    "points, it estimates the probability density at each query point as the "
+    "normalized sum of the kernel values between the query point and every "
+    "reference point.  If no query file is given, the density is estimated at "
+    "each reference point."
+    "\n\n"
+    "By default, a dual-tree algorithm with kd-trees is used, which returns "
+    "estimates within a relative error of --rel_error (-e) plus an absolute "
+    "error of --abs_error (-E) of the true densities.  Single-tree traversal "
+    "or naive computation may be used instead with --single_mode (-S) and "
+    "--naive (-N)."
+    "\n\n"
+    "If --monte_carlo (-M) is given, a reference node that cannot otherwise be "
+    "approximated within the error tolerance may be approximated by the mean "
+    "kernel value of a random sample of its points instead; then the error "
+    "bound holds for each approximation only with probability "
+    "--mc_probability (-P)."
+    "\n\n"
+    "For example, the following will estimate the density at each point in "
+    "'query.csv' with a Gaussian kernel of bandwidth 0.2, using the points in "
+    "'reference.csv', and store the estimates in 'densities.csv':"
+    "\n\n"
+    "$ mlpack_kde -r reference.csv -q query.csv -b 0.2 -o densities.csv");
+
+PARAM_STRING_REQ("reference_file", "File containing the reference dataset.",
+    "r");
+PARAM_STRING("query_file", "File containing query points (optional).", "q", "");
+PARAM_STRING("output_file", "File to save density estimates to.", "o", "");
+
+PARAM_STRING("kernel", "Kernel to use: 'gaussian' or 'epanechnikov'.", "k",
+    "gaussian");
+PARAM_DOUBLE("bandwidth", "Bandwidth of the kernel.", "b", 1.0);
+
+PARAM_DOUBLE("rel_error", "Relative error tolerance for each estimate.", "e",
+    0.05);
+PARAM_DOUBLE("abs_error", "Absolute error tolerance for each estimate.", "E",
+    0.0);
+
+PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
+PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
+    "dual-tree search).", "S");
+
+PARAM_FLAG("monte_carlo", "If true, nodes may be approximated by random "
+    "sampling.", "M");
+PARAM_DOUBLE("mc_probability", "Probability that each Monte Carlo "
+    "approximation is within the error tolerance.", "P", 0.95);
+PARAM_INT("initial_sample_size", "Number of points sampled in each round of a "
+    "Monte Carlo approximation.", "n", 100);
+PARAM_DOUBLE("mc_break_coef", "Fraction of the points of a node after which a "
+    "Monte Carlo approximation of the node is abandoned.", "c", 0.4);
+
+PARAM_INT("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
+
+// Run kernel density estimation with the given kernel.
+template<typename KernelType>
+void RunKDE(const KernelType& kernel,
+            arma::mat&& referenceSet,
+            const arma::mat& querySet,
+            arma::vec& estimations)
+{
+  KDE<KernelType> kde(CLI::GetParam<double>("rel_error"),
+      CLI::GetParam<double>("abs_error"), kernel, CLI::HasParam("naive"),
+      CLI::HasParam("single_mode"));
+
+  kde.MonteCarlo() = CLI::HasParam("monte_carlo");
+  kde.MCProbability() = CLI::GetParam<double>("mc_probability");
+  kde.MCInitialSampleSize() =
+      (size_t) CLI::GetParam<int>("initial_sample_size");
+  kde.MCBreakCoefficient() = CLI::GetParam<double>("mc_break_coef");
+
+  Timer::Start("tree_building");
+  kde.Train(std::move(referenceSet));
+  Timer::Stop("tree_building");
+
+  if (CLI::HasParam("query_file"))
+    kde.Evaluate(querySet, estimations);
+  else
+    kde.Evaluate(estimations);
+
+  Log::Info << kde.BaseCases() << " base cases and " << kde.Scores()
+      << " scores." << endl;
+}
+
+int main(int argc, char *argv[])
+{
+  // Give CLI the command line parameters the user passed in.
+  CLI::ParseCommandLine(argc, argv);
+
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) std::time(NULL));
+
+  // Sanity checks on the parameters.
+  const string kernelType = CLI::GetParam<string>("kernel");
+  if (kernelType != "gaussian" && kernelType != "epanechnikov")
+    Log::Fatal << "Unknown kernel type '" << kernelType << "'; valid choices "
+        << "are 'gaussian' and 'epanechnikov'." << endl;
+
+  const double bandwidth = CLI::GetParam<double>("bandwidth");
+  if (bandwidth <= 0.0)
+    Log::Fatal << "Invalid bandwidth: " << bandwidth << ".  Must be greater "
+        << "than 0." << endl;
+
+  if (CLI::GetParam<double>("rel_error") < 0.0 ||
+      CLI::GetParam<double>("abs_error") < 0.0)
+    Log::Fatal << "Error tolerances (--rel_error and --abs_error) must be "
+        << "nonnegative." << endl;
+
+  if (CLI::HasParam("monte_carlo"))
+  {
+    const double probability = CLI::GetParam<double>("mc_probability");
+    if (probability <= 0.0 || probability >= 1.0)
+      Log::Fatal << "Invalid --mc_probability: " << probability << ".  Must "
+          << "be between 0 and 1." << endl;
+    if (CLI::GetParam<int>("initial_sample_size") < 2)
+      Log::Fatal << "Invalid --initial_sample_size: "
+          << CLI::GetParam<int>("initial_sample_size") << ".  Must be at "
+          << "least 2." << endl;
+    if (CLI::HasParam("naive"))
+      Log::Warn << "--monte_carlo (-M) will be ignored because --naive (-N) is"
+          << " specified." << endl;
+  }
+
+  if (!CLI::HasParam("output_file"))
+    Log::Warn << "--output_file is not specified, so no results will be "
+        << "saved!" << endl;
+
+  arma::mat referenceSet;
+  const string referenceFile = CLI::GetParam<string>("reference_file");
+  data::Load(referenceFile, referenceSet, true);
+  Log::Info << "Loaded reference data from '" << referenceFile << "' ("
+      << referenceSet.n_rows << " x " << referenceSet.n_cols << ")." << endl;
+
+  arma::mat querySet;
+  if (CLI::HasParam("query_file"))
+  {
+    const string queryFile = CLI::GetParam<string>("query_file");
+    data::Load(queryFile, querySet, true);
+    Log::Info << "Loaded query data from '" << queryFile << "' ("
+        << querySet.n_rows << " x " << querySet.n_cols << ")." << endl;
+
+    if (querySet.n_rows != referenceSet.n_rows)
+      Log::Fatal << "Query data dimensionality (" << querySet.n_rows << ") "
+          << "does not match reference data dimensionality ("
+          << referenceSet.n_rows << ")!" << endl;
+  }
+
+  arma::vec estimations;
+  if (kernelType == "gaussian")
+    RunKDE(GaussianKernel(bandwidth), std::move(referenceSet), querySet,
+        estimations);
+  else
+    RunKDE(EpanechnikovKernel(bandwidth), std::move(referenceSet), querySet,
+        estimations);
+
+  if (CLI::HasParam("output_file"))
+    data::Save(CLI::GetParam<string>("output_file"), estimations);
+}
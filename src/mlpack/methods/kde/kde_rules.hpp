@@ -0,0 +1,195 @@
+/**
+ * @file kde_rules.hpp
+ * @author agent
+ *
+ * Rules for kernel density estimation, so that it can be done with arbitrary
+ * tree types.
+ */
+#ifndef __MLPACK_METHODS_KDE_KDE_RULES_HPP
+#define __MLPACK_METHODS_KDE_KDE_RULES_HPP
+
+#include <mlpack/core.hpp>
+#include "../neighbor_search/ns_traversal_info.hpp"
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * The KDERules class computes, for each query point, the sum of the kernel
+ * values between the query point and every reference point.  A reference node
+ * is pruned when the kernel values between the query point (or every point in
+ * the query node) and every point in the reference node lie within the error
+ * tolerance of a single value; then the node's contribution is approximated
+ * with that value.  If Monte Carlo approximation is enabled, a reference node
+ * that cannot be pruned that way may instead be approximated by the mean of a
+ * random sample of its points, if the sample is large enough that the mean is
+ * within the error tolerance with the desired probability.
+ *
+ * The sums are not normalized; that is left to the KDE class.
+ *
+ * @tparam MetricType Metric to use for distance evaluations.
+ * @tparam KernelType Kernel, which must be a decreasing function of the
+ *     distance between points.
+ * @tparam TreeType Type of tree to use.
+ */
+template<typename MetricType, typename KernelType, typename TreeType>
+class KDERules
+{
+ public:
+  /**
+   * Construct the KDERules object.  This is usually done from within the KDE
+   * class at evaluation time.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param densities Vector to add the kernel sums of each query point to.
+   * @param relError Relative error tolerance for each kernel value.
+   * @param absError Absolute error tolerance for each kernel value.
+   * @param metric Instantiated metric.
+   * @param kernel Instantiated kernel.
+   * @param monteCarlo Whether or not to use Monte Carlo approximations.
+   * @param mcProbability Probability that each Monte Carlo approximation is
+   *     within the error tolerance.
+   * @param mcInitialSampleSize Number of points sampled in each round of a
+   *     Monte Carlo approximation.
+   * @param mcBreakCoefficient Fraction of the points in a reference node after
+   *     which a Monte Carlo approximation of the node is abandoned.
+   */
+  KDERules(const typename TreeType::Mat& referenceSet,
+           const typename TreeType::Mat& querySet,
+           arma::vec& densities,
+           const double relError,
+           const double absError,
+           MetricType& metric,
+           KernelType& kernel,
+           const bool monteCarlo = false,
+           const double mcProbability = 0.95,
+           const size_t mcInitialSampleSize = 100,
+           const double mcBreakCoefficient = 0.4);
+
+  /**
+   * Compute the base case between the given query point and reference point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndex Index of reference point.
+   */
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the node should not be recursed
+   * into at all (it should be pruned); in that case, the contribution of the
+   * node has already been approximated.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  Pruning in kernel density
+   * estimation does not depend on the results found so far, so this returns
+   * the old score.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  /**
+   * Get the score for recursion order.  A low score indicates priority for
+   * recursion, while DBL_MAX indicates that the node should not be recursed
+   * into at all (it should be pruned); in that case, the contribution of the
+   * reference node has already been approximated for every query point.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   */
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order.  Pruning in kernel density
+   * estimation does not depend on the results found so far, so this returns
+   * the old score.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  typedef neighbor::NeighborSearchTraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases (including Monte Carlo samples).
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores.
+  size_t Scores() const { return scores; }
+
+ private:
+  /**
+   * Try to approximate the sum of the kernel values between the given query
+   * point and the points of the given reference node by random sampling.
+   * Samples are taken (with replacement) in rounds of mcInitialSampleSize
+   * until the confidence interval of the mean is within the error tolerance, or
+   * until mcBreakCoefficient times the number of points in the node have been
+   * sampled.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Node to approximate.
+   * @param estimate Approximated sum of the kernel values, if successful.
+   * @return Whether or not the approximation was successful.
+   */
+  bool MonteCarloEstimate(const size_t queryIndex,
+                          TreeType& referenceNode,
+                          double& estimate);
+
+  //! The reference set.
+  const typename TreeType::Mat& referenceSet;
+  //! The query set.
+  const typename TreeType::Mat& querySet;
+  //! The kernel sums for each query point.
+  arma::vec& densities;
+
+  //! The relative error tolerance.
+  double relError;
+  //! The absolute error tolerance.
+  double absError;
+
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The instantiated kernel.
+  KernelType& kernel;
+
+  //! Whether or not Monte Carlo approximations are used.
+  bool monteCarlo;
+  //! The quantile of the normal distribution for Monte Carlo confidence
+  //! intervals.
+  double mcQuantile;
+  //! The number of points sampled in each round of Monte Carlo approximation.
+  size_t mcInitialSampleSize;
+  //! The fraction of a node after which Monte Carlo approximation stops.
+  double mcBreakCoefficient;
+
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_rules_impl.hpp"
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file kde_rules_impl.hpp
+ * @author agent
+ *
+ * Implementation of rules for kernel density estimation with generic trees.
+ */
+#ifndef __MLPACK_METHODS_KDE_KDE_RULES_IMPL_HPP
+#define __MLPACK_METHODS_KDE_KDE_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_rules.hpp"
+
+#include <boost/math/distributions/normal.hpp>
+
+namespace mlpack {
+namespace kde {
+
+template<typename MetricType, typename KernelType, typename TreeType>
+KDERules<MetricType, KernelType, TreeType>::KDERules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    arma::vec& densities,
+    const double relError,
+    const double absError,
+    MetricType& metric,
+    KernelType& kernel,
+    const bool monteCarlo,
+    const double mcProbability,
+    const size_t mcInitialSampleSize,
+    const double mcBreakCoefficient) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    densities(densities),
+    relError(relError),
+    absError(absError),
+    metric(metric),
+    kernel(kernel),
+    monteCarlo(monteCarlo),
+    mcQuantile(0.0),
+    mcInitialSampleSize(mcInitialSampleSize),
+    mcBreakCoefficient(mcBreakCoefficient),
+    baseCases(0),
+    scores(0)
+{
+  // The confidence interval is two-sided.
+  if (monteCarlo)
+    mcQuantile = boost::math::quantile(boost::math::normal(),
+        1.0 - (1.0 - mcProbability) / 2.0);
+}
+
+//! The base case.  Evaluate the kernel between the two points and add it to the
+//! sum for the query point.
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline
+double KDERules<MetricType, KernelType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
+      referenceSet.unsafe_col(referenceIndex));
+  ++baseCases;
+
+  densities[queryIndex] += kernel.Evaluate(distance);
+
+  return distance;
+}
+
+//! Single-tree scoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  const math::Range distances = referenceNode.RangeDistance(
+      querySet.unsafe_col(queryIndex));
+  ++scores;
+
+  // The kernel decreases with distance, so these bound the kernel values
+  // between the query point and every point in the node.
+  const double maxKernel = kernel.Evaluate(distances.Lo());
+  const double minKernel = kernel.Evaluate(distances.Hi());
+  const size_t numReferences = referenceNode.NumDescendants();
+
+  // If the midpoint is close enough to every kernel value, use it for all of
+  // them.
+  if (maxKernel - minKernel <= 2.0 * (relError * minKernel + absError))
+  {
+    densities[queryIndex] += numReferences * (maxKernel + minKernel) / 2.0;
+    return DBL_MAX;
+  }
+
+  double estimate;
+  if (monteCarlo && MonteCarloEstimate(queryIndex, referenceNode, estimate))
+  {
+    densities[queryIndex] += estimate;
+    return DBL_MAX;
+  }
+
+  // Otherwise, visit closer nodes first.
+  return distances.Lo();
+}
+
+//! Single-tree rescoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Rescore(
+    const size_t /* queryIndex */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  // If it wasn't pruned before, it isn't pruned now.
+  return oldScore;
+}
+
+//! Dual-tree scoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  const math::Range distances = queryNode.RangeDistance(&referenceNode);
+  ++scores;
+
+  const double maxKernel = kernel.Evaluate(distances.Lo());
+  const double minKernel = kernel.Evaluate(distances.Hi());
+  const size_t numReferences = referenceNode.NumDescendants();
+
+  // If the midpoint is close enough to every kernel value between the two
+  // nodes, use it for every pair of points.
+  if (maxKernel - minKernel <= 2.0 * (relError * minKernel + absError))
+  {
+    const double contribution = numReferences * (maxKernel + minKernel) / 2.0;
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+      densities[queryNode.Descendant(i)] += contribution;
+
+    return DBL_MAX;
+  }
+
+  // The reference node can only be approximated by sampling if the sampling
+  // succeeds for every query point, so hold the estimates until then.
+  if (monteCarlo)
+  {
+    arma::vec estimates(queryNode.NumDescendants());
+    bool success = true;
+    for (size_t i = 0; i < queryNode.NumDescendants() && success; ++i)
+      success = MonteCarloEstimate(queryNode.Descendant(i), referenceNode,
+          estimates[i]);
+
+    if (success)
+    {
+      for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+        densities[queryNode.Descendant(i)] += estimates[i];
+
+      return DBL_MAX;
+    }
+  }
+
+  return distances.Lo();
+}
+
+//! Dual-tree rescoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Rescore(
+    TreeType& /* queryNode */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  // If it wasn't pruned before, it isn't pruned now.
+  return oldScore;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::MonteCarloEstimate(
+    const size_t queryIndex,
+    TreeType& referenceNode,
+    double& estimate)
+{
+  // If we would have to give up before the first round is done, it is cheaper
+  // to just recurse.
+  const size_t numReferences = referenceNode.NumDescendants();
+  const size_t maxSamples = (size_t) (mcBreakCoefficient * numReferences);
+  if (maxSamples < mcInitialSampleSize)
+    return false;
+
+  double sum = 0.0;
+  double sumSquares = 0.0;
+  size_t samples = 0;
+  while (samples + mcInitialSampleSize <= maxSamples)
+  {
+    for (size_t i = 0; i < mcInitialSampleSize; ++i)
+    {
+      const size_t referenceIndex = referenceNode.Descendant(
+          (size_t) math::RandInt(numReferences));
+      const double value = kernel.Evaluate(metric.Evaluate(
+          querySet.unsafe_col(queryIndex),
+          referenceSet.unsafe_col(referenceIndex)));
+
+      sum += value;
+      sumSquares += value * value;
+    }
+
+    samples += mcInitialSampleSize;
+    baseCases += mcInitialSampleSize;
+
+    // Check whether the confidence interval of the mean kernel value is within
+    // the error tolerance.
+    const double mean = sum / samples;
+    const double variance = std::max(0.0,
+        (sumSquares - samples * mean * mean) / (samples - 1));
+    if (mcQuantile * std::sqrt(variance / samples) <=
+        relError * mean + absError)
+    {
+      estimate = numReferences * mean;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
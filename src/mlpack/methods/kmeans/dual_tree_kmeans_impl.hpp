@@ -21,7 +21,7 @@ namespace kmeans {
 //! Call the tree constructor that does mapping.
 template<typename TreeType>
 TreeType* BuildTree(
-    typename TreeType::Mat& dataset,
+    typename TreeType::Mat&& dataset,
     std::vector<size_t>& oldFromNew,
     typename boost::enable_if_c<
         tree::TreeTraits<TreeType>::RearrangesDataset == true, TreeType*
@@ -29,19 +29,19 @@ TreeType* BuildTree(
 {
   // This is a hack.  I know this will be BinarySpaceTree, so force a leaf size
   // of two.
-  return new TreeType(dataset, oldFromNew, 1);
+  return new TreeType(std::move(dataset), oldFromNew, 1);
 }
 
 //! Call the tree constructor that does not do mapping.
 template<typename TreeType>
 TreeType* BuildTree(
-    const typename TreeType::Mat& dataset,
+    typename TreeType::Mat&& dataset,
     const std::vector<size_t>& /* oldFromNew */,
     const typename boost::enable_if_c<
         tree::TreeTraits<TreeType>::RearrangesDataset == false, TreeType*
     >::type = 0)
 {
-  return new TreeType(dataset);
+  return new TreeType(std::move(dataset));
 }
 
 template<typename MetricType,
@@ -96,10 +96,13 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     arma::mat& newCentroids,
     arma::Col<size_t>& counts)
 {
-  // Build a tree on the centroids.
+  // Build a tree on the centroids.  The tree must hold the same type of data
+  // as the dataset tree, so the centroids may need to be converted (for
+  // instance, when the data is float).
   arma::mat oldCentroids(centroids); // Slow. :(
   std::vector<size_t> oldFromNewCentroids;
-  Tree* centroidTree = BuildTree<Tree>(const_cast<MatType&>(centroids),
+  MatType centroidData = arma::conv_to<MatType>::from(centroids);
+  Tree* centroidTree = BuildTree<Tree>(std::move(centroidData),
       oldFromNewCentroids);
 
   // Reset information in the tree, if we need to.
@@ -527,7 +530,8 @@ node.Stat().UpperBound() << " and owner " << node.Stat().Owner() << ".\n";
       for (size_t i = 0; i < node.NumPoints(); ++i)
       {
         const size_t owner = assignments[node.Point(i)];
-        newCentroids.col(owner) += dataset.col(node.Point(i));
+        newCentroids.col(owner) +=
+            AsDoubleVector(dataset.col(node.Point(i)));
         ++newCounts[owner];
 
 /*
@@ -18,8 +18,8 @@ template<typename MetricType, typename TreeType>
 class DualTreeKMeansRules
 {
  public:
-  DualTreeKMeansRules(const arma::mat& centroids,
-                      const arma::mat& dataset,
+  DualTreeKMeansRules(const typename TreeType::Mat& centroids,
+                      const typename TreeType::Mat& dataset,
                       arma::Row<size_t>& assignments,
                       arma::vec& upperBounds,
                       arma::vec& lowerBounds,
@@ -51,8 +51,8 @@ class DualTreeKMeansRules
   size_t& Scores() { return scores; }
 
  private:
-  const arma::mat& centroids;
-  const arma::mat& dataset;
+  const typename TreeType::Mat& centroids;
+  const typename TreeType::Mat& dataset;
   arma::Row<size_t>& assignments;
   arma::vec& upperBounds;
   arma::vec& lowerBounds;
@@ -14,8 +14,8 @@ namespace kmeans {
 
 template<typename MetricType, typename TreeType>
 DualTreeKMeansRules<MetricType, TreeType>::DualTreeKMeansRules(
-    const arma::mat& centroids,
-    const arma::mat& dataset,
+    const typename TreeType::Mat& centroids,
+    const typename TreeType::Mat& dataset,
     arma::Row<size_t>& assignments,
     arma::vec& upperBounds,
     arma::vec& lowerBounds,
@@ -8,6 +8,7 @@
 #define __MLPACK_METHODS_KMEANS_DTNN_STATISTIC_HPP
 
 #include <mlpack/methods/neighbor_search/neighbor_search_stat.hpp>
+#include "vector_conversion.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -52,7 +53,7 @@ class DualTreeKMeansStatistic : public
       if (tree::TreeTraits<TreeType>::HasSelfChildren && i == 0 &&
           node.NumChildren() > 0)
         continue;
-      centroid += node.Dataset().col(node.Point(i));
+      centroid += AsDoubleVector(node.Dataset().col(node.Point(i)));
     }
 
     for (size_t i = 0; i < node.NumChildren(); ++i)
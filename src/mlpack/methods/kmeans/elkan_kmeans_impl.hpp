@@ -82,7 +82,7 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     {
       // No change needed.  This point must still belong to that cluster.
       counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      newCentroids.col(assignments[i]) += AsDoubleVector(dataset.col(i));
       continue;
     }
     else
@@ -144,7 +144,7 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     // At this point, we know the new cluster assignment.
     // Step 4: for each center c, let m(c) be the mean of the points assigned to
     // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+    newCentroids.col(assignments[i]) += AsDoubleVector(dataset.col(i));
     counts[assignments[i]]++;
   }
 
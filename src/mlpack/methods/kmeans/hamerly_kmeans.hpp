@@ -7,6 +7,8 @@
 #ifndef __MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 #define __MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 
+#include "vector_conversion.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
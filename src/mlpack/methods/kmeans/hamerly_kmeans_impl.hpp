@@ -71,7 +71,7 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     if (upperBounds(i) <= m)
     {
       ++hamerlyPruned;
-      newCentroids.col(assignments[i]) += dataset.col(i);
+      newCentroids.col(assignments[i]) += AsDoubleVector(dataset.col(i));
       ++counts(assignments[i]);
       continue;
     }
@@ -84,7 +84,7 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     // Second bound test.
     if (upperBounds(i) <= m)
     {
-      newCentroids.col(assignments[i]) += dataset.col(i);
+      newCentroids.col(assignments[i]) += AsDoubleVector(dataset.col(i));
       ++counts(assignments[i]);
       continue;
     }
@@ -117,7 +117,7 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     distanceCalculations += centroids.n_cols - 1;
 
     // Update new centroids.
-    newCentroids.col(assignments[i]) += dataset.col(i);
+    newCentroids.col(assignments[i]) += AsDoubleVector(dataset.col(i));
     ++counts(assignments[i]);
   }
 
@@ -13,6 +13,7 @@
 #include "random_partition.hpp"
 #include "max_variance_new_cluster.hpp"
 #include "naive_kmeans.hpp"
+#include "vector_conversion.hpp"
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
 
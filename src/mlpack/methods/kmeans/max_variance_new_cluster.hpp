@@ -10,6 +10,7 @@
 #define __MLPACK_METHODS_KMEANS_MAX_VARIANCE_NEW_CLUSTER_HPP
 
 #include <mlpack/core.hpp>
+#include "vector_conversion.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -9,6 +9,8 @@
 #ifndef __MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #define __MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 
+#include "vector_conversion.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -53,7 +53,7 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     Log::Assert(closestCluster != centroids.n_cols);
 
     // We now have the minimum distance centroid index.  Update that centroid.
-    newCentroids.col(closestCluster) += arma::vec(dataset.col(i));
+    newCentroids.col(closestCluster) += AsDoubleVector(dataset.col(i));
     counts(closestCluster)++;
   }
 
@@ -10,6 +10,7 @@
 #define __MLPACK_METHODS_KMEANS_PELLEG_MOORE_KMEANS_RULES_HPP
 
 #include <mlpack/methods/neighbor_search/ns_traversal_info.hpp>
+#include "vector_conversion.hpp"
 
 namespace mlpack {
 namespace kmeans {
@@ -152,7 +152,8 @@ double PellegMooreKMeansRules<MetricType, TreeType>::Score(
     }
 
     // Add to resulting centroid.
-    newCentroids.col(bestCluster) += dataset.col(referenceNode.Point(i));
+    newCentroids.col(bestCluster) +=
+        AsDoubleVector(dataset.col(referenceNode.Point(i)));
     ++counts(bestCluster);
   }
 
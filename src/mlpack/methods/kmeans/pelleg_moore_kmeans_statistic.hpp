@@ -8,6 +8,8 @@
 #ifndef __MLPACK_METHODS_KMEANS_PELLEG_MOORE_KMEANS_STATISTIC_HPP
 #define __MLPACK_METHODS_KMEANS_PELLEG_MOORE_KMEANS_STATISTIC_HPP
 
+#include "vector_conversion.hpp"
+
 namespace mlpack {
 namespace kmeans {
 
@@ -39,7 +41,7 @@ class PellegMooreKMeansStatistic
 
     for (size_t i = 0; i < node.NumPoints(); ++i)
     {
-      centroid += node.Dataset().col(node.Point(i));
+      centroid += AsDoubleVector(node.Dataset().col(node.Point(i)));
     }
 
     if (node.NumDescendants() > 0)
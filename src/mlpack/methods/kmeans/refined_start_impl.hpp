@@ -56,7 +56,8 @@ void RefinedStart::Cluster(const MatType& data,
     // cluster, we re-initialize that cluster as the point furthest away from
     // the cluster with maximum variance.  This is not *exactly* what the paper
     // implements, but it is quite similar, and we'll call it "good enough".
-    KMeans<> kmeans;
+    KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        NaiveKMeans, MatType> kmeans;
     kmeans.Cluster(sampledData, clusters, sampledAssignments, centroids);
 
     // Store the sampled centroids.
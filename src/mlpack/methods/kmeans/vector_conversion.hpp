@@ -0,0 +1,59 @@
+/**
+ * @file vector_conversion.hpp
+ * @author agent
+ *
+ * A utility function that gives a point of a dataset in a form that can be
+ * added to or assigned to a column of a (double-precision) centroid matrix.
+ * This allows the k-means code to work with float data (arma::fmat), while
+ * still keeping the centroids in double precision.
+ */
+#ifndef __MLPACK_METHODS_KMEANS_VECTOR_CONVERSION_HPP
+#define __MLPACK_METHODS_KMEANS_VECTOR_CONVERSION_HPP
+
+#include <mlpack/core.hpp>
+#include <type_traits>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * Dense double-precision vectors can be used directly, so no copy is made.
+ */
+template<typename VecType>
+inline typename std::enable_if<
+    std::is_same<typename VecType::elem_type, double>::value &&
+    !arma::is_arma_sparse_type<VecType>::value, const VecType&>::type
+AsDoubleVector(const VecType& v)
+{
+  return v;
+}
+
+/**
+ * Sparse double-precision vectors are converted to a dense vector.
+ */
+template<typename VecType>
+inline typename std::enable_if<
+    std::is_same<typename VecType::elem_type, double>::value &&
+    arma::is_arma_sparse_type<VecType>::value, arma::vec>::type
+AsDoubleVector(const VecType& v)
+{
+  return arma::vec(v);
+}
+
+/**
+ * Vectors of any other element type (such as float) are converted to a dense
+ * double-precision vector.
+ */
+template<typename VecType>
+inline typename std::enable_if<
+    !std::is_same<typename VecType::elem_type, double>::value,
+    arma::vec>::type
+AsDoubleVector(const VecType& v)
+{
+  return arma::conv_to<arma::vec>::from(v);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
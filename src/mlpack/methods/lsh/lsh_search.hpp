@@ -190,21 +190,48 @@ class LSHSearch
    */
   void BuildHash();
 
+  //! Get the number of tables to search, given the user's request (0 means
+  //! all of them).
+  size_t TablesToSearch(const size_t numTablesToSearch) const
+  {
+    return (numTablesToSearch == 0 || numTablesToSearch > numTables) ?
+        numTables : numTablesToSearch;
+  }
+
+  /**
+   * This function hashes every query into each of the first
+   * 'numTablesToSearch' hash tables to get keys for the query, and then hashes
+   * each key to a bucket of the second hash table.  The projections for each
+   * table are computed for all queries at once.
+   *
+   * @param querySet The queries to hash.
+   * @param numTablesToSearch The number of tables to hash into.
+   * @param hashes Matrix to store the bucket of each query (one per column) in
+   *    each table (one per row).
+   */
+  void HashQueries(const arma::mat& querySet,
+                   const size_t numTablesToSearch,
+                   arma::Mat<size_t>& hashes) const;
+
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
-   * the potential neighbor candidates.
+   * This function collects all the points (if any) in the buckets that a query
+   * was hashed into as the potential neighbor candidates.  Each candidate is
+   * returned once; to find duplicates without touching the whole reference
+   * set, lastQuery holds (one plus) the index of the last query that
+   * considered each reference point, so it must hold no value larger than
+   * queryIndex when this is called.
    *
-   * @param queryPoint The query point currently being processed.
+   * @param hashes The buckets of the queries, as given by HashQueries().
+   * @param queryIndex The index of the query currently being processed.
+   * @param lastQuery The last query that considered each reference point.
    * @param referenceIndices The list of neighbor candidates obtained from
    *    hashing the query into all the hash tables and eventually into
-   *    multiple buckets of the second hash table.
+   *    multiple buckets of the second hash table, in increasing order.
    */
-  template<typename VecType>
-  void ReturnIndicesFromTable(const VecType& queryPoint,
-                              arma::uvec& referenceIndices,
-                              size_t numTablesToSearch) const;
+  void ReturnIndicesFromTable(const arma::Mat<size_t>& hashes,
+                              const size_t queryIndex,
+                              arma::Col<size_t>& lastQuery,
+                              std::vector<size_t>& referenceIndices) const;
 
   /**
    * This is a helper function that computes the distance of the query to the
@@ -182,64 +182,69 @@ void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
 }
 
 template<typename SortPolicy>
-template<typename VecType>
-void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
-    const VecType& queryPoint,
-    arma::uvec& referenceIndices,
-    size_t numTablesToSearch) const
+void LSHSearch<SortPolicy>::HashQueries(const arma::mat& querySet,
+                                        const size_t numTablesToSearch,
+                                        arma::Mat<size_t>& hashes) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
-
-  // Hash the query in each of the 'numTablesToSearch' hash tables using the
-  // 'numProj' projections for each table. This gives us 'numTablesToSearch'
-  // keys for the query where each key is a 'numProj' dimensional integer
-  // vector.
-
-  // Compute the projection of the query in each table.
-  arma::mat allProjInTables(numProj, numTablesToSearch);
+  // Hash every query in each of the 'numTablesToSearch' hash tables using the
+  // 'numProj' projections for each table.  This gives us 'numTablesToSearch'
+  // keys for each query where each key is a 'numProj' dimensional integer
+  // vector.  The projections of all the queries into one table are computed
+  // with a single matrix product.
+  hashes.set_size(numTablesToSearch, querySet.n_cols);
   for (size_t i = 0; i < numTablesToSearch; i++)
-    allProjInTables.unsafe_col(i) = projections[i].t() * queryPoint;
-  allProjInTables += offsets.cols(0, numTablesToSearch - 1);
-  allProjInTables /= hashWidth;
-
-  // Compute the hash value of each key of the query into a bucket of the
-  // 'secondHashTable' using the 'secondHashWeights'.
-  arma::rowvec hashVec = secondHashWeights.t() * arma::floor(allProjInTables);
-
-  for (size_t i = 0; i < hashVec.n_elem; i++)
-    hashVec[i] = (double) ((size_t) hashVec[i] % secondHashSize);
-
-  Log::Assert(hashVec.n_elem == numTablesToSearch);
-
-  // For all the buckets that the query is hashed into, sequentially
-  // collect the indices in those buckets.
-  arma::Col<size_t> refPointsConsidered;
-  refPointsConsidered.zeros(referenceSet->n_cols);
+  {
+    arma::mat allProj = projections[i].t() * querySet;
+    allProj.each_col() += offsets.unsafe_col(i);
+    allProj /= hashWidth;
+
+    // Compute the hash value of each key of the queries into a bucket of the
+    // 'secondHashTable' using the 'secondHashWeights'.
+    const arma::rowvec hashVec = secondHashWeights.t() * arma::floor(allProj);
+    for (size_t j = 0; j < hashVec.n_elem; j++)
+      hashes(i, j) = (size_t) hashVec[j] % secondHashSize;
+  }
+}
 
-  for (size_t i = 0; i < hashVec.n_elem; i++) // For all tables.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
+    const arma::Mat<size_t>& hashes,
+    const size_t queryIndex,
+    arma::Col<size_t>& lastQuery,
+    std::vector<size_t>& referenceIndices) const
+{
+  // For all the buckets that the query is hashed into, sequentially collect
+  // the indices in those buckets.  A point is a new candidate if the last
+  // query that considered it is not this one, so we only touch the points in
+  // the buckets and not the whole reference set.  (lastQuery holds
+  // queryIndex + 1, so that it can start as zeros.)
+  referenceIndices.clear();
+  for (size_t i = 0; i < hashes.n_rows; i++) // For all tables.
   {
-    size_t hashInd = (size_t) hashVec[i];
+    const size_t hashInd = hashes(i, queryIndex);
 
     if (bucketContentSize[hashInd] > 0)
     {
       // Pick the indices in the bucket corresponding to 'hashInd'.
-      size_t tableRow = bucketRowInHashTable[hashInd];
+      const size_t tableRow = bucketRowInHashTable[hashInd];
       assert(tableRow < secondHashSize);
       assert(tableRow < secondHashTable.n_rows);
 
       for (size_t j = 0; j < bucketContentSize[hashInd]; j++)
-        refPointsConsidered[secondHashTable(tableRow, j)]++;
+      {
+        const size_t index = secondHashTable(tableRow, j);
+        if (lastQuery[index] != queryIndex + 1)
+        {
+          lastQuery[index] = queryIndex + 1;
+          referenceIndices.push_back(index);
+        }
+      }
     }
   }
 
-  referenceIndices = arma::find(refPointsConsidered > 0);
+  // Visit the candidates in order of index, so ties are broken the same way
+  // regardless of the order of the tables.
+  std::sort(referenceIndices.begin(), referenceIndices.end());
 }
 
 // Search for nearest neighbors in a given query set.
@@ -283,23 +288,30 @@ void LSHSearch<SortPolicy>::Search(const arma::mat& querySet,
 
   Timer::Start("computing_neighbors");
 
+  // Hash every query into every hash table and eventually into the
+  // 'secondHashTable'.
+  arma::Mat<size_t> hashes;
+  HashQueries(querySet, TablesToSearch(numTablesToSearch), hashes);
+
+  // The last query that considered each reference point; this is allocated
+  // once for all of the queries.
+  arma::Col<size_t> lastQuery(referenceSet->n_cols, arma::fill::zeros);
+  std::vector<size_t> refIndices;
+
   // Go through every query point sequentially.
   for (size_t i = 0; i < querySet.n_cols; i++)
   {
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch);
+    // Obtain the neighbor candidates from the buckets of the query.
+    ReturnIndicesFromTable(hashes, i, lastQuery, refIndices);
 
     // An informative book-keeping for the number of neighbor candidates
     // returned on average.
-    avgIndicesReturned += refIndices.n_elem;
+    avgIndicesReturned += refIndices.size();
 
     // Sequentially go through all the candidates and save the best 'k'
     // candidates.
-    for (size_t j = 0; j < refIndices.n_elem; j++)
-      BaseCase(i, (size_t) refIndices[j], querySet, resultingNeighbors,
-          distances);
+    for (size_t j = 0; j < refIndices.size(); j++)
+      BaseCase(i, refIndices[j], querySet, resultingNeighbors, distances);
   }
 
   Timer::Stop("computing_neighbors");
@@ -328,22 +340,29 @@ Search(const size_t k,
 
   Timer::Start("computing_neighbors");
 
+  // Hash every point into every hash table and eventually into the
+  // 'secondHashTable'.
+  arma::Mat<size_t> hashes;
+  HashQueries(*referenceSet, TablesToSearch(numTablesToSearch), hashes);
+
+  // The last query that considered each reference point.
+  arma::Col<size_t> lastQuery(referenceSet->n_cols, arma::fill::zeros);
+  std::vector<size_t> refIndices;
+
   // Go through every query point sequentially.
   for (size_t i = 0; i < referenceSet->n_cols; i++)
   {
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet->col(i), refIndices, numTablesToSearch);
+    // Obtain the neighbor candidates from the buckets of the query.
+    ReturnIndicesFromTable(hashes, i, lastQuery, refIndices);
 
     // An informative book-keeping for the number of neighbor candidates
     // returned on average.
-    avgIndicesReturned += refIndices.n_elem;
+    avgIndicesReturned += refIndices.size();
 
     // Sequentially go through all the candidates and save the best 'k'
     // candidates.
-    for (size_t j = 0; j < refIndices.n_elem; j++)
-      BaseCase(i, (size_t) refIndices[j], resultingNeighbors, distances);
+    for (size_t j = 0; j < refIndices.size(); j++)
+      BaseCase(i, refIndices[j], resultingNeighbors, distances);
   }
 
   Timer::Stop("computing_neighbors");
@@ -16,7 +16,7 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::vec& values,
                                    const size_t r) :
     m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, arma::randu<arma::mat>(m + n, r))
+    sdp(0, 0, arma::randu<arma::mat>(m + n, r))
 {
   CheckValues();
   InitSDP();
@@ -28,7 +28,7 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::vec& values,
                                    const arma::mat& initialPoint) :
     m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, initialPoint)
+    sdp(0, 0, initialPoint)
 {
   CheckValues();
   InitSDP();
@@ -39,7 +39,7 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const arma::umat& indices,
                                    const arma::vec& values) :
     m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0,
+    sdp(0, 0,
         arma::randu<arma::mat>(m + n, DefaultRank(m, n, indices.n_cols)))
 {
   CheckValues();
@@ -69,14 +69,15 @@ void MatrixCompletion::CheckValues()
 void MatrixCompletion::InitSDP()
 {
   sdp.SDP().C().eye(m + n, m + n);
-  sdp.SDP().SparseB() = 2. * values;
+
+  // Each known value gives an entry constraint: A_i is 1 at (i, m + j) and
+  // (m + j, i), so Tr(A_i * X) = 2 X(i, m + j).
   const size_t p = indices.n_cols;
-  for (size_t i = 0; i < p; i++)
-  {
-    sdp.SDP().SparseA()[i].zeros(m + n, m + n);
-    sdp.SDP().SparseA()[i](indices(0, i), m + indices(1, i)) = 1.;
-    sdp.SDP().SparseA()[i](m + indices(1, i), indices(0, i)) = 1.;
-  }
+  sdp.SDP().EntryIndices().set_size(2, p);
+  sdp.SDP().EntryIndices().row(0) = indices.row(0);
+  sdp.SDP().EntryIndices().row(1) = m + indices.row(1);
+  sdp.SDP().EntryValues().ones(p);
+  sdp.SDP().EntryB() = 2. * values;
 }
 
 void MatrixCompletion::Recover(arma::mat& recovered)
@@ -164,48 +164,62 @@ void NaiveBayesClassifier<MatType>::Classify(const MatType& data,
   // training data.
   Log::Assert(data.n_rows == means.n_rows);
 
-  arma::vec probs = arma::log(probabilities);
-  arma::mat invVar = 1.0 / variances;
-
-  arma::mat testProbs = arma::repmat(probs.t(), data.n_cols, 1);
-
   results.set_size(data.n_cols); // No need to fill with anything yet.
 
   Log::Info << "Running Naive Bayes classifier on " << data.n_cols
       << " data points with " << data.n_rows << " features each." << std::endl;
 
-  // Calculate the joint probability for each of the data points for each of the
-  // means.n_cols.
-
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; i++)
+  // The log-likelihood of a point x for class i is
+  //   log(p_i) - 0.5 * (d log(2 pi) + sum(log(v_i)) + sum((x - m_i)^2 / v_i)),
+  // which is an adaptation of gmm::phi() for the case where the covariance is
+  // a diagonal matrix.  Everything but the last term is the same for every
+  // point, so precompute it.
+  const arma::mat invVar = 1.0 / variances;
+  arma::vec logConstants(means.n_cols);
+  for (size_t i = 0; i < means.n_cols; ++i)
+    logConstants[i] = std::log(probabilities[i]) - 0.5 * (data.n_rows *
+        std::log(2 * M_PI) + arma::accu(arma::log(variances.col(i))));
+
+  // Calculate the log-likelihoods in blocks of points, so that the block's
+  // differences from each mean stay in cache.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel
   {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    arma::mat diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    arma::mat rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::vec exponents(diffs.n_cols);
-    for (size_t j = 0; j < diffs.n_cols; ++j) // log(exp(value)) == value
-      exponents(j) = arma::accu(diffs.col(j) % rhs.unsafe_col(j));
-
-    // Calculate probability as sum of logarithm to decrease floating point
-    // errors.
-    testProbs.col(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        log(arma::det(arma::diagmat(variances.col(i)))) + exponents);
-  }
+    // Scratch space for one block, reused for each block.
+    arma::mat diffs(data.n_rows, blockSize);
+    arma::mat logLikelihoods(means.n_cols, blockSize);
 
-  // Now calculate the label.
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Find the index of the class with maximum probability for this point.
-    arma::uword maxIndex = 0;
-    arma::vec pointProbs = testProbs.row(i).t();
-    pointProbs.max(maxIndex);
-
-    results[i] = maxIndex;
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t count = std::min(blockSize, (size_t) data.n_cols - begin);
+
+      arma::mat blockDiffs(diffs.memptr(), data.n_rows, count, false, true);
+      arma::mat blockLogLikelihoods(logLikelihoods.memptr(), means.n_cols,
+          count, false, true);
+
+      for (size_t i = 0; i < means.n_cols; ++i)
+      {
+        blockDiffs = data.cols(begin, begin + count - 1);
+        blockDiffs.each_col() -= means.col(i);
+        blockDiffs = arma::square(blockDiffs);
+
+        blockLogLikelihoods.row(i) = logConstants[i] - 0.5 *
+            (invVar.col(i).t() * blockDiffs);
+      }
+
+      // Find the index of the class with maximum probability for each point.
+      arma::uword maxIndex;
+      for (size_t j = 0; j < count; ++j)
+      {
+        blockLogLikelihoods.unsafe_col(j).max(maxIndex);
+        results[begin + j] = maxIndex;
+      }
+    }
   }
-
-  return;
 }
 
 template<typename MatType>
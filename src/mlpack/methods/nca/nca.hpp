@@ -12,6 +12,7 @@
 #include <mlpack/core/optimizers/sgd/sgd.hpp>
 
 #include "nca_softmax_error_function.hpp"
+#include "nca_approx_softmax_error_function.hpp"
 
 namespace mlpack {
 namespace nca /** Neighborhood Components Analysis. */ {
@@ -38,9 +39,19 @@ namespace nca /** Neighborhood Components Analysis. */ {
  *   year = {2004}
  * }
  * @endcode
+ *
+ * The objective function to be optimized can be chosen with the
+ * ErrorFunctionType template parameter; by default the exact
+ * SoftmaxErrorFunction is used, but for large datasets
+ * ApproxSoftmaxErrorFunction may be much faster.
+ *
+ * @tparam MetricType Metric to use for distance calculations.
+ * @tparam OptimizerType Optimizer to use.
+ * @tparam ErrorFunctionType Softmax error function to optimize.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance,
-         template<typename> class OptimizerType = optimization::SGD>
+         template<typename> class OptimizerType = optimization::SGD,
+         template<typename> class ErrorFunctionType = SoftmaxErrorFunction>
 class NCA
 {
  public:
@@ -77,10 +88,16 @@ class NCA
   //! Get the labels reference.
   const arma::Row<size_t>& Labels() const { return labels; }
 
+  //! Get the error function.
+  const ErrorFunctionType<MetricType>& ErrorFunction() const
+  { return errorFunction; }
+  //! Modify the error function.
+  ErrorFunctionType<MetricType>& ErrorFunction() { return errorFunction; }
+
   //! Get the optimizer.
-  const OptimizerType<SoftmaxErrorFunction<MetricType> >& Optimizer() const
+  const OptimizerType<ErrorFunctionType<MetricType> >& Optimizer() const
   { return optimizer; }
-  OptimizerType<SoftmaxErrorFunction<MetricType> >& Optimizer()
+  OptimizerType<ErrorFunctionType<MetricType> >& Optimizer()
   { return optimizer; }
 
  private:
@@ -93,10 +110,10 @@ class NCA
   MetricType metric;
 
   //! The function to optimize.
-  SoftmaxErrorFunction<MetricType> errorFunction;
+  ErrorFunctionType<MetricType> errorFunction;
 
   //! The optimizer to use.
-  OptimizerType<SoftmaxErrorFunction<MetricType> > optimizer;
+  OptimizerType<ErrorFunctionType<MetricType> > optimizer;
 };
 
 } // namespace nca
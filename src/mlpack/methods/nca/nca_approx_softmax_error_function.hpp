@@ -0,0 +1,230 @@
+/**
+ * @file nca_approx_softmax_error_function.hpp
+ * @author agent
+ *
+ * An approximate version of the stochastic neighbor assignment probability
+ * error function (the "softmax error"), which uses trees to avoid computing
+ * negligible terms.
+ */
+#ifndef __MLPACK_METHODS_NCA_NCA_APPROX_SOFTMAX_ERROR_FUNCTION_HPP
+#define __MLPACK_METHODS_NCA_NCA_APPROX_SOFTMAX_ERROR_FUNCTION_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
+
+namespace mlpack {
+namespace nca {
+
+/**
+ * An approximate version of the "softmax" stochastic neighbor assignment
+ * probability function.  The function being computed is the same as in
+ * SoftmaxErrorFunction,
+ *
+ * p_ij = (exp(-|| A x_i - A x_j || ^ 2)) /
+ *     (sum_{k != i} (exp(-|| A x_i - A x_k || ^ 2)))
+ *
+ * but every term exp(-d(A x_i, A x_k)) that is smaller than a user-specified
+ * tolerance is treated as zero.  Because for most datasets nearly all of the
+ * O(n^2) terms are numerically zero, this allows the non-separable Evaluate()
+ * and Gradient() to be computed with a dual-tree range search on the stretched
+ * dataset (see mlpack::range::RangeSearch) instead of with an exhaustive scan
+ * over all pairs.  The per-point sums are then calculated in parallel (if
+ * OpenMP is available).
+ *
+ * Because the tree-based search is used, MetricType must be an LMetric (or any
+ * other metric that the kd-tree's HRectBound supports).
+ *
+ * The separable overloads of Evaluate() and Gradient() also ignore negligible
+ * terms, and the stretched dataset is cached between calls with the same
+ * coordinates, so optimizers such as MiniBatchSGD which evaluate many points
+ * at one iterate only need to stretch the dataset once.  Overloads that handle
+ * an entire batch of points at once are also given.
+ *
+ * @tparam MetricType Metric to use; must be usable with a kd-tree.
+ */
+template<typename MetricType = metric::SquaredEuclideanDistance>
+class ApproxSoftmaxErrorFunction
+{
+ public:
+  /**
+   * Initialize the error function with the given dataset, labels, metric, and
+   * tolerance.  Any term exp(-d(A x_i, A x_k)) smaller than the tolerance will
+   * be ignored.
+   *
+   * @param dataset Matrix containing the dataset.
+   * @param labels Vector of class labels for each point in the dataset.
+   * @param metric Instantiated metric (optional).
+   * @param tolerance Smallest term that will be taken into account.
+   */
+  ApproxSoftmaxErrorFunction(const arma::mat& dataset,
+                             const arma::Row<size_t>& labels,
+                             MetricType metric = MetricType(),
+                             const double tolerance = 1e-10);
+
+  /**
+   * Evaluate the softmax function for the given covariance matrix.  This is the
+   * non-separable implementation, where the objective function is not
+   * decomposed into the sum of several objective functions.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   */
+  double Evaluate(const arma::mat& covariance);
+
+  /**
+   * Evaluate the softmax objective function for the given covariance matrix on
+   * only one point of the dataset.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param i Index of point to use for objective function.
+   */
+  double Evaluate(const arma::mat& covariance, const size_t i);
+
+  /**
+   * Evaluate the softmax objective function for the given covariance matrix on
+   * the batch of points [begin, begin + batchSize).  The points of the batch
+   * are handled in parallel.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param begin Index of first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& covariance,
+                  const size_t begin,
+                  const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the softmax function for the given covariance
+   * matrix.  This is the non-separable implementation.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param gradient Matrix to store the calculated gradient in.
+   */
+  void Gradient(const arma::mat& covariance, arma::mat& gradient);
+
+  /**
+   * Evaluate the gradient of the softmax function for the given covariance
+   * matrix on only one point of the dataset.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param i Index of point to use for objective function.
+   * @param gradient Matrix to store the calculated gradient in.
+   */
+  void Gradient(const arma::mat& covariance,
+                const size_t i,
+                arma::mat& gradient);
+
+  /**
+   * Evaluate the gradient of the softmax function for the given covariance
+   * matrix on the batch of points [begin, begin + batchSize).  The result is
+   * the sum of the gradients of each point in the batch.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param begin Index of first point of the batch.
+   * @param gradient Matrix to store the calculated gradient in.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& covariance,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
+  /**
+   * Get the initial point.
+   */
+  const arma::mat GetInitialPoint() const;
+
+  /**
+   * Get the number of functions the objective function can be decomposed into.
+   * This is just the number of points in the dataset.
+   */
+  size_t NumFunctions() const { return dataset.n_cols; }
+
+  //! Get the tolerance below which terms are ignored.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance below which terms are ignored.
+  double& Tolerance() { return tolerance; }
+
+ private:
+  //! The dataset.
+  const arma::mat& dataset;
+  //! Labels for each point in the dataset.
+  const arma::Row<size_t>& labels;
+
+  //! The instantiated metric.
+  MetricType metric;
+  //! Terms smaller than this are ignored.
+  double tolerance;
+
+  //! Last coordinates the dataset was stretched with.
+  arma::mat lastCoordinates;
+  //! Stretched dataset.  Kept internal to avoid memory reallocations.
+  arma::mat stretchedDataset;
+  //! Holds calculated p_i, for the non-separable Evaluate() and Gradient().
+  arma::vec p;
+  //! Holds denominators for calculation of p_ij, for the non-separable
+  //! Evaluate() and Gradient().
+  arma::vec denominators;
+  //! For each point, the points whose terms are not negligible.
+  std::vector<std::vector<size_t>> neighbors;
+  //! For each point, the distances to the points in neighbors.
+  std::vector<std::vector<double>> distances;
+
+  //! False if the dataset has never been stretched.
+  bool stretched;
+  //! False if the tree-based precalculation has not been done for the current
+  //! coordinates.
+  bool precalculated;
+
+  /**
+   * Stretch the dataset with the given coordinates, but only if the
+   * coordinates differ from the last coordinates the dataset was stretched
+   * with.  Whenever the dataset is re-stretched, the precalculated p_i and
+   * denominators are invalidated.
+   *
+   * @param coordinates Coordinates matrix to stretch the dataset with.
+   */
+  void Stretch(const arma::mat& coordinates);
+
+  /**
+   * Prepare to calculate the terms of a batch of the given size: if the batch
+   * is large enough that the range search is cheaper than scanning all points
+   * for each point in the batch, Precalculate() is called; otherwise, the
+   * dataset is only stretched.
+   *
+   * @param coordinates Coordinates matrix to stretch the dataset with.
+   * @param batchSize Number of points in the batch.
+   */
+  void StretchBatch(const arma::mat& coordinates, const size_t batchSize);
+
+  /**
+   * Find, with a dual-tree range search on the stretched dataset, all pairs of
+   * points whose term exp(-d(A x_i, A x_k)) is not negligible, then calculate
+   * the denominators and p_i.  Nothing is done if this was already calculated
+   * for the given coordinates.
+   *
+   * @param coordinates Coordinates matrix to use for precalculation.
+   */
+  void Precalculate(const arma::mat& coordinates);
+
+  /**
+   * Calculate the numerator and denominator of p_i, ignoring negligible terms.
+   * If Precalculate() was done for the current coordinates, only the points it
+   * found are visited; otherwise, all points are scanned.  If firstTerm and secondTerm are given, the
+   * (unnormalized) gradient terms sum_k (p_ik x_ik x_ik^T) and
+   * sum_{k in class of i} (p_ik x_ik x_ik^T) are also accumulated into them.
+   * The dataset must already be stretched.
+   */
+  void PointTerms(const size_t i,
+                  double& numerator,
+                  double& denominator,
+                  arma::mat* firstTerm = NULL,
+                  arma::mat* secondTerm = NULL) const;
+};
+
+} // namespace nca
+} // namespace mlpack
+
+// Include implementation.
+#include "nca_approx_softmax_error_function_impl.hpp"
+
+#endif
@@ -0,0 +1,389 @@
+/**
+ * @file nca_approx_softmax_error_function_impl.hpp
+ * @author agent
+ *
+ * Implementation of the approximate softmax error function.
+ */
+#ifndef __MLPACK_METHODS_NCA_NCA_APPROX_SOFTMAX_ERROR_FUNCTION_IMPL_HPP
+#define __MLPACK_METHODS_NCA_NCA_APPROX_SOFTMAX_ERROR_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included already.
+#include "nca_approx_softmax_error_function.hpp"
+
+namespace mlpack {
+namespace nca {
+
+template<typename MetricType>
+ApproxSoftmaxErrorFunction<MetricType>::ApproxSoftmaxErrorFunction(
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    MetricType metric,
+    const double tolerance) :
+    dataset(dataset),
+    labels(labels),
+    metric(metric),
+    tolerance(tolerance),
+    stretched(false),
+    precalculated(false)
+{ /* nothing to do */ }
+
+//! The non-separable implementation, which uses Precalculate() to save time.
+template<typename MetricType>
+double ApproxSoftmaxErrorFunction<MetricType>::Evaluate(
+    const arma::mat& coordinates)
+{
+  // Calculate the denominators and numerators, if necessary.
+  Precalculate(coordinates);
+
+  return -accu(p); // Sum of p_i for all i.  We negate because our solver
+                   // minimizes, not maximizes.
+}
+
+//! The separable objective function for a single point.
+template<typename MetricType>
+double ApproxSoftmaxErrorFunction<MetricType>::Evaluate(
+    const arma::mat& coordinates,
+    const size_t i)
+{
+  Stretch(coordinates);
+
+  double numerator = 0;
+  double denominator = 0;
+  PointTerms(i, numerator, denominator);
+
+  if (denominator == 0.0)
+  {
+    Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
+    return 0;
+  }
+
+  return -(numerator / denominator); // Negate because the optimizer is a
+                                     // minimizer.
+}
+
+//! The separable objective function for a batch of points.
+template<typename MetricType>
+double ApproxSoftmaxErrorFunction<MetricType>::Evaluate(
+    const arma::mat& coordinates,
+    const size_t begin,
+    const size_t batchSize)
+{
+  StretchBatch(coordinates, batchSize);
+
+  double objective = 0;
+  size_t zeroDenominators = 0;
+  #pragma omp parallel for reduction(+:objective, zeroDenominators)
+  for (omp_size_t i = begin; i < (omp_size_t) (begin + batchSize); ++i)
+  {
+    double numerator = 0;
+    double denominator = 0;
+    PointTerms((size_t) i, numerator, denominator);
+
+    if (denominator == 0.0)
+      ++zeroDenominators;
+    else
+      objective += numerator / denominator;
+  }
+
+  if (zeroDenominators > 0)
+    Log::Warn << "Denominator of p_i is 0 for " << zeroDenominators << " points"
+        << " in batch starting at point " << begin << "!" << std::endl;
+
+  return -objective; // Negate because the optimizer is a minimizer.
+}
+
+//! The non-separable implementation, where Precalculate() is used.
+template<typename MetricType>
+void ApproxSoftmaxErrorFunction<MetricType>::Gradient(
+    const arma::mat& coordinates,
+    arma::mat& gradient)
+{
+  // Calculate the denominators and numerators, and find the non-negligible
+  // pairs, if necessary.
+  Precalculate(coordinates);
+
+  // This is the same sum as in SoftmaxErrorFunction::Gradient(), but each
+  // point i only iterates over the points k whose terms are not negligible.
+  // Because the neighbor lists are symmetric, we can handle each ordered pair
+  // (i, k) separately, adding
+  //
+  //   if class of i is the same as the class of k,
+  //     (p_i - 1) p_ik x_ik x_ik^T
+  //   otherwise
+  //     p_i p_ik x_ik x_ik^T
+  //
+  // and each point can be processed independently.
+  const size_t dims = dataset.n_rows;
+  arma::mat sum;
+  sum.zeros(dims, dims);
+
+  #pragma omp parallel
+  {
+    arma::mat threadSum;
+    threadSum.zeros(dims, dims);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    {
+      const std::vector<size_t>& pointNeighbors = neighbors[i];
+      if (pointNeighbors.size() == 0)
+        continue;
+
+      // Collect the differences x_ik (not stretched) as columns, so that the
+      // sum of outer products is a single matrix product.
+      arma::mat diffs(dims, pointNeighbors.size());
+      arma::mat weightedDiffs(dims, pointNeighbors.size());
+      for (size_t j = 0; j < pointNeighbors.size(); ++j)
+      {
+        const size_t k = pointNeighbors[j];
+        const double p_ik = std::exp(-distances[i][j]) / denominators[i];
+
+        diffs.col(j) = dataset.col(i) - dataset.col(k);
+        if (labels[i] == labels[k])
+          weightedDiffs.col(j) = ((p[i] - 1) * p_ik) * diffs.col(j);
+        else
+          weightedDiffs.col(j) = (p[i] * p_ik) * diffs.col(j);
+      }
+
+      threadSum += weightedDiffs * trans(diffs);
+    }
+
+    #pragma omp critical
+    sum += threadSum;
+  }
+
+  // Assemble the final gradient.
+  gradient = -2 * coordinates * sum;
+}
+
+//! The separable gradient for a single point.
+template<typename MetricType>
+void ApproxSoftmaxErrorFunction<MetricType>::Gradient(
+    const arma::mat& coordinates,
+    const size_t i,
+    arma::mat& gradient)
+{
+  Stretch(coordinates);
+
+  double numerator = 0;
+  double denominator = 0;
+  arma::mat firstTerm;
+  arma::mat secondTerm;
+  firstTerm.zeros(dataset.n_rows, dataset.n_rows);
+  secondTerm.zeros(dataset.n_rows, dataset.n_rows);
+
+  PointTerms(i, numerator, denominator, &firstTerm, &secondTerm);
+
+  if (denominator == 0.0)
+  {
+    Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
+    // If the denominator is zero, then all p_ik should be zero and there is
+    // no gradient contribution from this point.
+    gradient.zeros(coordinates.n_rows, coordinates.n_cols);
+    return;
+  }
+
+  // p_i * sum_k (p_ik x_ik x_ik^T) - sum_{j in class of i} (p_ij x_ij x_ij^T),
+  // negated because our optimizer is a minimizer.
+  const double p = numerator / denominator;
+  gradient = -2 * coordinates * ((p * firstTerm - secondTerm) / denominator);
+}
+
+//! The separable gradient for a batch of points.
+template<typename MetricType>
+void ApproxSoftmaxErrorFunction<MetricType>::Gradient(
+    const arma::mat& coordinates,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  StretchBatch(coordinates, batchSize);
+
+  const size_t dims = dataset.n_rows;
+  arma::mat sum;
+  sum.zeros(dims, dims);
+  size_t zeroDenominators = 0;
+
+  #pragma omp parallel
+  {
+    arma::mat threadSum;
+    threadSum.zeros(dims, dims);
+    arma::mat firstTerm(dims, dims);
+    arma::mat secondTerm(dims, dims);
+
+    #pragma omp for reduction(+:zeroDenominators)
+    for (omp_size_t i = begin; i < (omp_size_t) (begin + batchSize); ++i)
+    {
+      double numerator = 0;
+      double denominator = 0;
+      firstTerm.zeros();
+      secondTerm.zeros();
+
+      PointTerms((size_t) i, numerator, denominator, &firstTerm, &secondTerm);
+
+      // If the denominator is zero, there is no gradient contribution.
+      if (denominator == 0.0)
+      {
+        ++zeroDenominators;
+        continue;
+      }
+
+      const double p = numerator / denominator;
+      threadSum += (p * firstTerm - secondTerm) / denominator;
+    }
+
+    #pragma omp critical
+    sum += threadSum;
+  }
+
+  if (zeroDenominators > 0)
+    Log::Warn << "Denominator of p_i is 0 for " << zeroDenominators << " points"
+        << " in batch starting at point " << begin << "!" << std::endl;
+
+  gradient = -2 * coordinates * sum;
+}
+
+template<typename MetricType>
+const arma::mat ApproxSoftmaxErrorFunction<MetricType>::GetInitialPoint() const
+{
+  return arma::eye<arma::mat>(dataset.n_rows, dataset.n_rows);
+}
+
+template<typename MetricType>
+void ApproxSoftmaxErrorFunction<MetricType>::Stretch(
+    const arma::mat& coordinates)
+{
+  // Make sure the calculation is necessary.
+  if (stretched &&
+      (coordinates.n_rows == lastCoordinates.n_rows) &&
+      (coordinates.n_cols == lastCoordinates.n_cols) &&
+      (accu(coordinates == lastCoordinates) == coordinates.n_elem))
+    return;
+
+  lastCoordinates = coordinates;
+  stretchedDataset = coordinates * dataset;
+  stretched = true;
+
+  // Anything we precalculated is now invalid.
+  precalculated = false;
+}
+
+template<typename MetricType>
+void ApproxSoftmaxErrorFunction<MetricType>::StretchBatch(
+    const arma::mat& coordinates,
+    const size_t batchSize)
+{
+  // A scan over all points costs O(n) per point of the batch, whereas the
+  // range search costs roughly O(n log n) for the whole dataset.  So, if the
+  // batch is large enough, it is cheaper to find the non-negligible terms with
+  // the tree and let PointTerms() iterate over only those.
+  if ((double) batchSize > std::log2((double) dataset.n_cols))
+    Precalculate(coordinates);
+  else
+    Stretch(coordinates);
+}
+
+template<typename MetricType>
+void ApproxSoftmaxErrorFunction<MetricType>::Precalculate(
+    const arma::mat& coordinates)
+{
+  Stretch(coordinates);
+  if (precalculated)
+    return; // No need to calculate; we already have this stuff saved.
+
+  // A term exp(-d(A x_i, A x_k)) is negligible when it is smaller than the
+  // tolerance; that is, when d(A x_i, A x_k) > -log(tolerance).  So the terms
+  // we need are exactly the results of a range search on the stretched
+  // dataset, which we can do with a dual-tree algorithm.
+  const double maxDistance = std::max(-std::log(tolerance), 0.0);
+
+  Timer::Start("nca_range_search");
+  range::RangeSearch<MetricType> rangeSearch(stretchedDataset, false, false,
+      metric);
+  rangeSearch.Search(math::Range(0.0, maxDistance), neighbors, distances);
+  Timer::Stop("nca_range_search");
+
+  // Now each p_i and its denominator depend only on the neighbors of i, so we
+  // can calculate them independently.
+  p.zeros(stretchedDataset.n_cols);
+  denominators.zeros(stretchedDataset.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) stretchedDataset.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors[i].size(); ++j)
+    {
+      const double eval = std::exp(-distances[i][j]);
+
+      denominators[i] += eval;
+      if (labels[i] == labels[neighbors[i][j]])
+        p[i] += eval;
+    }
+  }
+
+  // Divide p_i by their denominators.
+  p /= denominators;
+
+  // Clean up any bad values.
+  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+  {
+    if (denominators[i] == 0.0)
+    {
+      Log::Debug << "Denominator of p_{" << i << ", j} is 0." << std::endl;
+
+      // Set to usable values.
+      denominators[i] = std::numeric_limits<double>::infinity();
+      p[i] = 0;
+    }
+  }
+
+  precalculated = true;
+}
+
+template<typename MetricType>
+void ApproxSoftmaxErrorFunction<MetricType>::PointTerms(
+    const size_t i,
+    double& numerator,
+    double& denominator,
+    arma::mat* firstTerm,
+    arma::mat* secondTerm) const
+{
+  // If the range search was done for the current coordinates, we only need to
+  // visit the non-negligible terms it found; otherwise, scan all points.
+  const size_t numTerms = precalculated ? neighbors[i].size() : dataset.n_cols;
+  for (size_t j = 0; j < numTerms; ++j)
+  {
+    const size_t k = precalculated ? neighbors[i][j] : j;
+
+    // Don't consider the case where the points are the same.
+    if (k == i)
+      continue;
+
+    // We want to evaluate exp(-D(A x_i, A x_k)), and skip it if negligible.
+    const double eval = std::exp(-(precalculated ? distances[i][j] :
+        metric.Evaluate(stretchedDataset.unsafe_col(i),
+                        stretchedDataset.unsafe_col(k))));
+    if (eval < tolerance)
+      continue;
+
+    denominator += eval;
+    if (labels[i] == labels[k])
+      numerator += eval;
+
+    if (firstTerm != NULL)
+    {
+      // For x_ik we are not using stretched points.
+      const arma::vec x_ik = dataset.col(i) - dataset.col(k);
+      const arma::mat outerProduct = eval * x_ik * trans(x_ik);
+
+      *firstTerm += outerProduct;
+      if (labels[i] == labels[k])
+        *secondTerm += outerProduct;
+    }
+  }
+}
+
+} // namespace nca
+} // namespace mlpack
+
+#endif
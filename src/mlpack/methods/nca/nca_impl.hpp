@@ -14,19 +14,25 @@ namespace mlpack {
 namespace nca {
 
 // Just set the internal matrix reference.
-template<typename MetricType, template<typename> class OptimizerType>
-NCA<MetricType, OptimizerType>::NCA(const arma::mat& dataset,
-                                    const arma::Row<size_t>& labels,
-                                    MetricType metric) :
+template<typename MetricType,
+         template<typename> class OptimizerType,
+         template<typename> class ErrorFunctionType>
+NCA<MetricType, OptimizerType, ErrorFunctionType>::NCA(
+    const arma::mat& dataset,
+    const arma::Row<size_t>& labels,
+    MetricType metric) :
     dataset(dataset),
     labels(labels),
     metric(metric),
     errorFunction(dataset, labels, metric),
-    optimizer(OptimizerType<SoftmaxErrorFunction<MetricType> >(errorFunction))
+    optimizer(OptimizerType<ErrorFunctionType<MetricType> >(errorFunction))
 { /* Nothing to do. */ }
 
-template<typename MetricType, template<typename> class OptimizerType>
-void NCA<MetricType, OptimizerType>::LearnDistance(arma::mat& outputMatrix)
+template<typename MetricType,
+         template<typename> class OptimizerType,
+         template<typename> class ErrorFunctionType>
+void NCA<MetricType, OptimizerType, ErrorFunctionType>::LearnDistance(
+    arma::mat& outputMatrix)
 {
   // See if we were passed an initialized matrix.
   if ((outputMatrix.n_rows != dataset.n_rows) ||
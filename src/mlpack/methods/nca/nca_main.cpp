@@ -68,7 +68,12 @@ PROGRAM_INFO("Neighborhood Components Analysis (NCA)",
     "documentation (in lbfgs.hpp) or the vast set of published literature on "
     "L-BFGS."
     "\n\n"
-    "By default, the SGD optimizer is used.");
+    "By default, the SGD optimizer is used."
+    "\n\n"
+    "For large datasets, the --approx_tolerance (-e) option can be used to "
+    "ignore all terms exp(-d(x_i, x_j)) of the objective that are smaller than "
+    "the given tolerance.  The remaining terms are then found with a dual-tree "
+    "range search, which can be much faster than the exact computation.");
 
 PARAM_STRING_REQ("input_file", "Input dataset to run NCA on.", "i");
 PARAM_STRING_REQ("output_file", "Output file for learned distance matrix.",
@@ -101,6 +106,9 @@ PARAM_INT("max_line_search_trials", "Maximum number of line search trials for "
 PARAM_DOUBLE("min_step", "Minimum step of line search for L-BFGS.", "m", 1e-20);
 PARAM_DOUBLE("max_step", "Maximum step of line search for L-BFGS.", "M", 1e20);
 
+PARAM_DOUBLE("approx_tolerance", "If nonzero, approximate the objective and "
+    "gradient by ignoring terms smaller than this tolerance.", "e", 0.0);
+
 PARAM_INT("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -109,6 +117,80 @@ using namespace mlpack::metric;
 using namespace mlpack::optimization;
 using namespace std;
 
+// The exact error function has no tolerance to set.
+template<typename MetricType>
+void SetApproxTolerance(SoftmaxErrorFunction<MetricType>& /* function */,
+                        const double /* tolerance */)
+{ }
+
+template<typename MetricType>
+void SetApproxTolerance(ApproxSoftmaxErrorFunction<MetricType>& function,
+                        const double tolerance)
+{
+  function.Tolerance() = tolerance;
+}
+
+// Create the NCA object with the given error function type and the optimizer
+// specified by the user, and run the optimization.
+template<template<typename> class ErrorFunctionType>
+void RunNCA(const arma::mat& data,
+            const arma::Row<size_t>& labels,
+            arma::mat& distance)
+{
+  const string optimizerType = CLI::GetParam<string>("optimizer");
+  const double stepSize = CLI::GetParam<double>("step_size");
+  const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
+  const double tolerance = CLI::GetParam<double>("tolerance");
+  const bool shuffle = !CLI::HasParam("linear_scan");
+  const int numBasis = CLI::GetParam<int>("num_basis");
+  const double armijoConstant = CLI::GetParam<double>("armijo_constant");
+  const double wolfe = CLI::GetParam<double>("wolfe");
+  const int maxLineSearchTrials = CLI::GetParam<int>("max_line_search_trials");
+  const double minStep = CLI::GetParam<double>("min_step");
+  const double maxStep = CLI::GetParam<double>("max_step");
+  const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
+  const double approxTolerance = CLI::GetParam<double>("approx_tolerance");
+
+  if (optimizerType == "sgd")
+  {
+    NCA<LMetric<2>, SGD, ErrorFunctionType> nca(data, labels);
+    SetApproxTolerance(nca.ErrorFunction(), approxTolerance);
+    nca.Optimizer().StepSize() = stepSize;
+    nca.Optimizer().MaxIterations() = maxIterations;
+    nca.Optimizer().Tolerance() = tolerance;
+    nca.Optimizer().Shuffle() = shuffle;
+
+    nca.LearnDistance(distance);
+  }
+  else if (optimizerType == "lbfgs")
+  {
+    NCA<LMetric<2>, L_BFGS, ErrorFunctionType> nca(data, labels);
+    SetApproxTolerance(nca.ErrorFunction(), approxTolerance);
+    nca.Optimizer().NumBasis() = numBasis;
+    nca.Optimizer().MaxIterations() = maxIterations;
+    nca.Optimizer().ArmijoConstant() = armijoConstant;
+    nca.Optimizer().Wolfe() = wolfe;
+    nca.Optimizer().MinGradientNorm() = tolerance;
+    nca.Optimizer().MaxLineSearchTrials() = maxLineSearchTrials;
+    nca.Optimizer().MinStep() = minStep;
+    nca.Optimizer().MaxStep() = maxStep;
+
+    nca.LearnDistance(distance);
+  }
+  else if (optimizerType == "minibatch-sgd")
+  {
+    NCA<LMetric<2>, MiniBatchSGD, ErrorFunctionType> nca(data, labels);
+    SetApproxTolerance(nca.ErrorFunction(), approxTolerance);
+    nca.Optimizer().StepSize() = stepSize;
+    nca.Optimizer().MaxIterations() = maxIterations;
+    nca.Optimizer().Tolerance() = tolerance;
+    nca.Optimizer().Shuffle() = shuffle;
+    nca.Optimizer().BatchSize() = batchSize;
+
+    nca.LearnDistance(distance);
+  }
+}
+
 int main(int argc, char* argv[])
 {
   // Parse command line.
@@ -177,18 +259,12 @@ int main(int argc, char* argv[])
           << "optimizer)." << endl;
   }
 
-  const double stepSize = CLI::GetParam<double>("step_size");
-  const size_t maxIterations = (size_t) CLI::GetParam<int>("max_iterations");
-  const double tolerance = CLI::GetParam<double>("tolerance");
   const bool normalize = CLI::HasParam("normalize");
-  const bool shuffle = !CLI::HasParam("linear_scan");
-  const int numBasis = CLI::GetParam<int>("num_basis");
-  const double armijoConstant = CLI::GetParam<double>("armijo_constant");
-  const double wolfe = CLI::GetParam<double>("wolfe");
-  const int maxLineSearchTrials = CLI::GetParam<int>("max_line_search_trials");
-  const double minStep = CLI::GetParam<double>("min_step");
-  const double maxStep = CLI::GetParam<double>("max_step");
-  const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
+
+  if (CLI::GetParam<double>("approx_tolerance") < 0.0)
+    Log::Fatal << "Invalid approximation tolerance "
+        << CLI::GetParam<double>("approx_tolerance") << "; must be "
+        << "nonnegative!" << endl;
 
   // Load data.
   arma::mat data;
@@ -241,41 +317,10 @@ int main(int argc, char* argv[])
   }
 
   // Now create the NCA object and run the optimization.
-  if (optimizerType == "sgd")
-  {
-    NCA<LMetric<2> > nca(data, labels);
-    nca.Optimizer().StepSize() = stepSize;
-    nca.Optimizer().MaxIterations() = maxIterations;
-    nca.Optimizer().Tolerance() = tolerance;
-    nca.Optimizer().Shuffle() = shuffle;
-
-    nca.LearnDistance(distance);
-  }
-  else if (optimizerType == "lbfgs")
-  {
-    NCA<LMetric<2>, L_BFGS> nca(data, labels);
-    nca.Optimizer().NumBasis() = numBasis;
-    nca.Optimizer().MaxIterations() = maxIterations;
-    nca.Optimizer().ArmijoConstant() = armijoConstant;
-    nca.Optimizer().Wolfe() = wolfe;
-    nca.Optimizer().MinGradientNorm() = tolerance;
-    nca.Optimizer().MaxLineSearchTrials() = maxLineSearchTrials;
-    nca.Optimizer().MinStep() = minStep;
-    nca.Optimizer().MaxStep() = maxStep;
-
-    nca.LearnDistance(distance);
-  }
-  else if (optimizerType == "minibatch-sgd")
-  {
-    NCA<LMetric<2>, MiniBatchSGD> nca(data, labels);
-    nca.Optimizer().StepSize() = stepSize;
-    nca.Optimizer().MaxIterations() = maxIterations;
-    nca.Optimizer().Tolerance() = tolerance;
-    nca.Optimizer().Shuffle() = shuffle;
-    nca.Optimizer().BatchSize() = batchSize;
-
-    nca.LearnDistance(distance);
-  }
+  if (CLI::GetParam<double>("approx_tolerance") > 0.0)
+    RunNCA<ApproxSoftmaxErrorFunction>(data, labels, distance);
+  else
+    RunNCA<SoftmaxErrorFunction>(data, labels, distance);
 
   // Save the output.
   data::Save(CLI::GetParam<string>("output_file"), distance, true);
@@ -31,7 +31,13 @@ namespace nca {
  * In addition to the standard Evaluate() and Gradient() functions which mlpack
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
- * stochastic gradient descent (see mlpack::optimization::SGD).
+ * stochastic gradient descent (see mlpack::optimization::SGD), and overloads
+ * which operate on a contiguous batch of points are given for mini-batch
+ * optimizers.
+ *
+ * For large datasets, where most of the terms exp(-|| A x_i - A x_j ||^2) are
+ * numerically zero, see ApproxSoftmaxErrorFunction, which avoids computing
+ * those terms.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -72,6 +78,21 @@ class SoftmaxErrorFunction
    */
   double Evaluate(const arma::mat& covariance, const size_t i);
 
+  /**
+   * Evaluate the softmax objective function for the given covariance matrix on
+   * the batch of points [begin, begin + batchSize).  This is equivalent to
+   * summing the results of the single-point Evaluate() over the batch, but the
+   * dataset is only stretched once and the points of the batch are handled in
+   * parallel.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param begin Index of first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& covariance,
+                  const size_t begin,
+                  const size_t batchSize);
+
   /**
    * Evaluate the gradient of the softmax function for the given covariance
    * matrix.  This is the non-separable implementation, where the objective
@@ -97,6 +118,22 @@ class SoftmaxErrorFunction
                 const size_t i,
                 arma::mat& gradient);
 
+  /**
+   * Evaluate the gradient of the softmax function for the given covariance
+   * matrix on the batch of points [begin, begin + batchSize).  The result is
+   * the sum of the single-point gradients over the batch; the dataset is only
+   * stretched once and the points of the batch are handled in parallel.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param begin Index of first point of the batch.
+   * @param gradient Matrix to store the calculated gradient in.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& covariance,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
   /**
    * Get the initial point.
    */
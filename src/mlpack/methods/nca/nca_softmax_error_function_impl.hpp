@@ -78,6 +78,50 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
                                      // minimizer.
 }
 
+//! The separated objective function, for a batch of points.
+template<typename MetricType>
+double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
+                                                  const size_t begin,
+                                                  const size_t batchSize)
+{
+  // Stretch the dataset only once for the whole batch.
+  stretchedDataset = coordinates * dataset;
+
+  double objective = 0;
+  size_t zeroDenominators = 0;
+  #pragma omp parallel for reduction(+:objective, zeroDenominators)
+  for (omp_size_t i = begin; i < (omp_size_t) (begin + batchSize); ++i)
+  {
+    double denominator = 0;
+    double numerator = 0;
+    for (size_t k = 0; k < dataset.n_cols; ++k)
+    {
+      // Don't consider the case where the points are the same.
+      if (k == (size_t) i)
+        continue;
+
+      const double eval = std::exp(-metric.Evaluate(
+          stretchedDataset.unsafe_col(i), stretchedDataset.unsafe_col(k)));
+
+      if (labels[i] == labels[k])
+        numerator += eval;
+
+      denominator += eval;
+    }
+
+    if (denominator == 0.0)
+      ++zeroDenominators;
+    else
+      objective += numerator / denominator;
+  }
+
+  if (zeroDenominators > 0)
+    Log::Warn << "Denominator of p_i is 0 for " << zeroDenominators << " points"
+        << " in batch starting at point " << begin << "!" << std::endl;
+
+  return -objective; // Negate because the optimizer is a minimizer.
+}
+
 //! The non-separable implementation, where Precalculate() is used.
 template<typename MetricType>
 void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
@@ -196,6 +240,82 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   gradient = -2 * coordinates * (p * firstTerm - secondTerm);
 }
 
+//! The separable implementation, for a batch of points.
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
+                                                const size_t begin,
+                                                arma::mat& gradient,
+                                                const size_t batchSize)
+{
+  // Stretch the dataset only once for the whole batch.
+  stretchedDataset = coordinates * dataset;
+
+  arma::mat sum;
+  sum.zeros(dataset.n_rows, dataset.n_rows);
+  size_t zeroDenominators = 0;
+
+  #pragma omp parallel
+  {
+    // Each thread accumulates its own part of the sum.
+    arma::mat threadSum;
+    threadSum.zeros(dataset.n_rows, dataset.n_rows);
+    arma::mat firstTerm(dataset.n_rows, dataset.n_rows);
+    arma::mat secondTerm(dataset.n_rows, dataset.n_rows);
+
+    #pragma omp for reduction(+:zeroDenominators)
+    for (omp_size_t i = begin; i < (omp_size_t) (begin + batchSize); ++i)
+    {
+      double numerator = 0;
+      double denominator = 0;
+      firstTerm.zeros();
+      secondTerm.zeros();
+
+      for (size_t k = 0; k < dataset.n_cols; ++k)
+      {
+        // Don't consider the case where the points are the same.
+        if ((size_t) i == k)
+          continue;
+
+        const double eval = std::exp(-metric.Evaluate(
+            stretchedDataset.unsafe_col(i), stretchedDataset.unsafe_col(k)));
+
+        // For x_ik we are not using stretched points.
+        const arma::vec x_ik = dataset.col(i) - dataset.col(k);
+        if (labels[i] == labels[k])
+        {
+          numerator += eval;
+          secondTerm += eval * x_ik * trans(x_ik);
+        }
+
+        denominator += eval;
+        firstTerm += eval * x_ik * trans(x_ik);
+      }
+
+      // If the denominator is zero, then all p_ik should be zero and there is
+      // no gradient contribution from this point.
+      if (denominator == 0.0)
+      {
+        ++zeroDenominators;
+        continue;
+      }
+
+      const double p = numerator / denominator;
+      threadSum += (p * firstTerm - secondTerm) / denominator;
+    }
+
+    #pragma omp critical
+    sum += threadSum;
+  }
+
+  if (zeroDenominators > 0)
+    Log::Warn << "Denominator of p_i is 0 for " << zeroDenominators << " points"
+        << " in batch starting at point " << begin << "!" << std::endl;
+
+  // Multiply all by 2 * A.  We negate it, because our optimizer is a
+  // minimizer.
+  gradient = -2 * coordinates * sum;
+}
+
 template<typename MetricType>
 const arma::mat SoftmaxErrorFunction<MetricType>::GetInitialPoint() const
 {
@@ -41,7 +41,11 @@ PROGRAM_INFO("k-Nearest-Neighbors",
     "neighbors output file corresponds to the index of the point in the "
     "reference set which is the i'th nearest neighbor from the point in the "
     "query set with index j.  Row i and column j in the distances output file "
-    "corresponds to the distance between those two points.");
+    "corresponds to the distance between those two points."
+    "\n\n"
+    "If exact results are not needed, the --epsilon (-e) option can be given to "
+    "perform faster approximate search with a bound on the relative error of "
+    "each returned distance.");
 
 // Define our input parameters that this program will take.
 PARAM_STRING("reference_file", "File containing the reference dataset.", "r",
@@ -74,6 +78,9 @@ PARAM_INT("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
     "dual-tree search).", "S");
+PARAM_DOUBLE("epsilon", "If specified, approximate search is performed: the "
+    "distance to each returned neighbor is at most (1 + epsilon) times the "
+    "distance to the true neighbor.  Must be non-negative.", "e", 0.0);
 
 // Convenience typedef.
 typedef NSModel<NearestNeighborSort> KNNModel;
@@ -142,6 +149,14 @@ int main(int argc, char *argv[])
         "than 0." << endl;
   }
 
+  // Sanity check on epsilon.
+  const double epsilon = CLI::GetParam<double>("epsilon");
+  if (epsilon < 0)
+  {
+    Log::Fatal << "Invalid epsilon: " << epsilon << ".  Must be non-negative."
+        << endl;
+  }
+
   // We either have to load the reference data, or we have to load the model.
   NSModel<NearestNeighborSort> knn;
   const bool naive = CLI::HasParam("naive");
@@ -178,7 +193,8 @@ int main(int argc, char *argv[])
         << referenceSet.n_rows << " x " << referenceSet.n_cols << ")."
         << endl;
 
-    knn.BuildModel(std::move(referenceSet), size_t(lsInt), naive, singleMode);
+    knn.BuildModel(std::move(referenceSet), size_t(lsInt), naive, singleMode,
+        epsilon);
   }
   else
   {
@@ -193,6 +209,7 @@ int main(int argc, char *argv[])
     // Adjust singleMode and naive if necessary.
     knn.SingleMode() = CLI::HasParam("single_mode");
     knn.Naive() = CLI::HasParam("naive");
+    knn.Epsilon() = epsilon;
     knn.LeafSize() = size_t(lsInt);
   }
 
@@ -226,6 +243,12 @@ int main(int argc, char *argv[])
       Log::Warn << "--single_mode ignored because --naive is present." << endl;
     }
 
+    // Naive search is always exact.
+    if (naive && epsilon > 0)
+    {
+      Log::Warn << "--epsilon ignored because --naive is present." << endl;
+    }
+
     // Now run the search.
     arma::Mat<size_t> neighbors;
     arma::mat distances;
@@ -44,6 +44,15 @@ class NSModel;
  * can be found in the NearestNeighborSort class and the kernel::ExampleKernel
  * class.
  *
+ * Approximate search is also possible: if a nonzero epsilon is given, the tree
+ * prunes nodes that cannot improve the current results by more than a factor
+ * of (1 + epsilon).  The distance to each returned neighbor is then guaranteed
+ * to be within a factor of (1 + epsilon) of the distance to the true neighbor
+ * with the same rank: for nearest neighbor search, each returned distance is at
+ * most (1 + epsilon) times the true distance, and for furthest neighbor search,
+ * it is at least the true distance divided by (1 + epsilon).  Naive search is
+ * always exact.
+ *
  * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
  * @tparam MetricType The metric to use for computation.
  * @tparam MatType The type of data matrix.
@@ -85,11 +94,13 @@ class NeighborSearch
    * @param singleMode If true, single-tree search will be used (as opposed to
    *      dual-tree search).
    * @param metric An optional instance of the MetricType class.
+   * @param epsilon Relative approximation error (0 means exact search).
    */
   NeighborSearch(const MatType& referenceSet,
                  const bool naive = false,
                  const bool singleMode = false,
-                 const MetricType metric = MetricType());
+                 const MetricType metric = MetricType(),
+                 const double epsilon = 0);
 
   /**
    * Initialize the NeighborSearch object, taking ownership of the reference
@@ -109,11 +120,13 @@ class NeighborSearch
    * @param singleMode If true, single-tree search will be used (as opposed to
    *      dual-tree search).
    * @param metric An optional instance of the MetricType class.
+   * @param epsilon Relative approximation error (0 means exact search).
    */
   NeighborSearch(MatType&& referenceSet,
                  const bool naive = false,
                  const bool singleMode = false,
-                 const MetricType metric = MetricType());
+                 const MetricType metric = MetricType(),
+                 const double epsilon = 0);
 
   /**
    * Initialize the NeighborSearch object with the given pre-constructed
@@ -139,10 +152,12 @@ class NeighborSearch
    * @param singleMode Whether single-tree computation should be used (as
    *      opposed to dual-tree computation).
    * @param metric Instantiated distance metric.
+   * @param epsilon Relative approximation error (0 means exact search).
    */
   NeighborSearch(Tree* referenceTree,
                  const bool singleMode = false,
-                 const MetricType metric = MetricType());
+                 const MetricType metric = MetricType(),
+                 const double epsilon = 0);
 
   /**
    * Create a NeighborSearch object without any reference data.  If Search() is
@@ -153,10 +168,12 @@ class NeighborSearch
    * @param singleMode Whether single-tree computation should be used (as
    *      opposed to dual-tree computation).
    * @param metric Instantiated metric.
+   * @param epsilon Relative approximation error (0 means exact search).
    */
   NeighborSearch(const bool naive = false,
                  const bool singleMode = false,
-                 const MetricType metric = MetricType());
+                 const MetricType metric = MetricType(),
+                 const double epsilon = 0);
 
 
   /**
@@ -248,6 +265,32 @@ class NeighborSearch
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Add a point to the reference set, and insert it into the reference tree,
+   * without rebuilding the tree.  This is only possible with trees that do not
+   * rearrange their dataset and that support InsertPoint() and DeletePoint(),
+   * such as the cover tree, and not in naive mode.  If the reference tree was
+   * built on a dataset that it does not own, the dataset is copied first (so
+   * ReferenceSet() may change).
+   *
+   * @param point Point to add.
+   * @return Index of the new point in the reference set.
+   */
+  template<typename VecType>
+  size_t InsertReferencePoint(const VecType& point);
+
+  /**
+   * Remove a point from the reference tree, without rebuilding the tree.  The
+   * point stays in the reference set, so the indices of the other points do not
+   * change, but it will not be returned as a neighbor by any later search.  For
+   * monochromatic search, the results for removed points should be ignored.
+   * The same restrictions as for InsertReferencePoint() apply.
+   *
+   * @param index Index of the point to remove.
+   * @return false if the point was not in the reference tree.
+   */
+  bool DeleteReferencePoint(const size_t index);
+
   //! Return the total number of base case evaluations performed during the last
   //! search.
   size_t BaseCases() const { return baseCases; }
@@ -265,6 +308,11 @@ class NeighborSearch
   //! Modify whether or not search is done in single-tree mode.
   bool& SingleMode() { return singleMode; }
 
+  //! Access the relative approximation error (0 means exact search).
+  double Epsilon() const { return epsilon; }
+  //! Modify the relative approximation error (0 means exact search).
+  double& Epsilon() { return epsilon; }
+
   //! Access the reference dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
@@ -289,6 +337,8 @@ class NeighborSearch
   bool naive;
   //! Indicates if single-tree search is being used (as opposed to dual-tree).
   bool singleMode;
+  //! Relative approximation error; 0 means exact search.
+  double epsilon;
 
   //! Instantiation of metric.
   MetricType metric;
@@ -309,6 +359,29 @@ class NeighborSearch
 } // namespace neighbor
 } // namespace mlpack
 
+namespace boost {
+namespace serialization {
+
+//! Version 1 of the NeighborSearch serialization adds epsilon; models saved
+//! with version 0 perform exact search.
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename RuleType> class TraversalType>
+struct version<mlpack::neighbor::NeighborSearch<SortPolicy, MetricType,
+    MatType, TreeType, TraversalType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "neighbor_search_impl.hpp"
 
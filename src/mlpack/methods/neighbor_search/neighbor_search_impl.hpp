@@ -75,7 +75,8 @@ NeighborSearch<SortPolicy, MetricType, MatType, TreeType, TraversalType>::
 NeighborSearch(const MatType& referenceSetIn,
                const bool naive,
                const bool singleMode,
-               const MetricType metric) :
+               const MetricType metric,
+               const double epsilon) :
     referenceTree(naive ? NULL :
         BuildTree<MatType, Tree>(referenceSetIn, oldFromNewReferences)),
     referenceSet(naive ? &referenceSetIn : &referenceTree->Dataset()),
@@ -83,6 +84,7 @@ NeighborSearch(const MatType& referenceSetIn,
     setOwner(false),
     naive(naive),
     singleMode(!naive && singleMode), // No single mode if naive.
+    epsilon(epsilon),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -103,7 +105,8 @@ NeighborSearch<SortPolicy, MetricType, MatType, TreeType, TraversalType>::
 NeighborSearch(MatType&& referenceSetIn,
                const bool naive,
                const bool singleMode,
-               const MetricType metric) :
+               const MetricType metric,
+               const double epsilon) :
     referenceTree(naive ? NULL :
         BuildTree<MatType, Tree>(std::move(referenceSetIn),
                                  oldFromNewReferences)),
@@ -113,6 +116,7 @@ NeighborSearch(MatType&& referenceSetIn,
     setOwner(naive),
     naive(naive),
     singleMode(!naive && singleMode),
+    epsilon(epsilon),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -132,13 +136,15 @@ template<typename SortPolicy,
 NeighborSearch<SortPolicy, MetricType, MatType, TreeType, TraversalType>::
 NeighborSearch(Tree* referenceTree,
                const bool singleMode,
-               const MetricType metric) :
+               const MetricType metric,
+               const double epsilon) :
     referenceTree(referenceTree),
     referenceSet(&referenceTree->Dataset()),
     treeOwner(false),
     setOwner(false),
     naive(false),
     singleMode(singleMode),
+    epsilon(epsilon),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -158,13 +164,15 @@ template<typename SortPolicy,
 NeighborSearch<SortPolicy, MetricType, MatType, TreeType, TraversalType>::
     NeighborSearch(const bool naive,
                    const bool singleMode,
-                   const MetricType metric) :
+                   const MetricType metric,
+                   const double epsilon) :
     referenceTree(NULL),
     referenceSet(new MatType()), // Empty matrix.
     treeOwner(false),
     setOwner(true),
     naive(naive),
     singleMode(singleMode),
+    epsilon(epsilon),
     metric(metric),
     baseCases(0),
     scores(0),
@@ -325,6 +333,9 @@ Search(const MatType& querySet,
     throw std::invalid_argument(ss.str());
   }
 
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+
   Timer::Start("computing_neighbors");
 
   baseCases = 0;
@@ -364,7 +375,8 @@ Search(const MatType& querySet,
   if (naive)
   {
     // Create the helper object for the tree traversal.
-    RuleType rules(*referenceSet, querySet, *neighborPtr, *distancePtr, metric);
+    RuleType rules(*referenceSet, querySet, *neighborPtr, *distancePtr, metric,
+        epsilon);
 
     // The naive brute-force traversal.
     for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -376,7 +388,8 @@ Search(const MatType& querySet,
   else if (singleMode)
   {
     // Create the helper object for the tree traversal.
-    RuleType rules(*referenceSet, querySet, *neighborPtr, *distancePtr, metric);
+    RuleType rules(*referenceSet, querySet, *neighborPtr, *distancePtr, metric,
+        epsilon);
 
     // Create the traverser.
     typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
@@ -402,7 +415,7 @@ Search(const MatType& querySet,
 
     // Create the helper object for the tree traversal.
     RuleType rules(*referenceSet, queryTree->Dataset(), *neighborPtr,
-        *distancePtr, metric);
+        *distancePtr, metric, epsilon);
 
     // Create the traverser.
     TraversalType<RuleType> traverser(rules);
@@ -501,6 +514,9 @@ Search(Tree* queryTree,
     throw std::invalid_argument(ss.str());
   }
 
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+
   // Make sure we are in dual-tree mode.
   if (singleMode || naive)
     throw std::invalid_argument("cannot call NeighborSearch::Search() with a "
@@ -527,7 +543,8 @@ Search(Tree* queryTree,
 
   // Create the helper object for the traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, querySet, *neighborPtr, distances, metric);
+  RuleType rules(*referenceSet, querySet, *neighborPtr, distances, metric,
+      epsilon);
 
   // Create the traverser.
   TraversalType<RuleType> traverser(rules);
@@ -574,6 +591,9 @@ Search(const size_t k,
     throw std::invalid_argument(ss.str());
   }
 
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+
   Timer::Start("computing_neighbors");
 
   baseCases = 0;
@@ -598,7 +618,8 @@ Search(const size_t k,
   // Create the helper object for the traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
   RuleType rules(*referenceSet, *referenceSet, *neighborPtr, *distancePtr,
-      metric, true /* don't return the same point as nearest neighbor */);
+      metric, epsilon,
+      true /* don't return the same point as nearest neighbor */);
 
   if (naive)
   {
@@ -689,6 +710,55 @@ Search(const size_t k,
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class TraversalType>
+template<typename VecType>
+size_t
+NeighborSearch<SortPolicy, MetricType, MatType, TreeType, TraversalType>::
+    InsertReferencePoint(const VecType& point)
+{
+  static_assert(!tree::TreeTraits<Tree>::RearrangesDataset,
+      "NeighborSearch::InsertReferencePoint() requires a tree type that does "
+      "not rearrange its dataset");
+
+  if (naive)
+    throw std::invalid_argument("cannot call NeighborSearch::"
+        "InsertReferencePoint() when in naive search mode");
+
+  const size_t index = referenceTree->InsertPoint(point);
+
+  // The tree may have copied its dataset.
+  referenceSet = &referenceTree->Dataset();
+
+  return index;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class TraversalType>
+bool NeighborSearch<SortPolicy, MetricType, MatType, TreeType, TraversalType>::
+    DeleteReferencePoint(const size_t index)
+{
+  static_assert(!tree::TreeTraits<Tree>::RearrangesDataset,
+      "NeighborSearch::DeleteReferencePoint() requires a tree type that does "
+      "not rearrange its dataset");
+
+  if (naive)
+    throw std::invalid_argument("cannot call NeighborSearch::"
+        "DeleteReferencePoint() when in naive search mode");
+
+  return referenceTree->DeletePoint(index);
+}
+
 //! Serialize the NeighborSearch model.
 template<typename SortPolicy,
          typename MetricType,
@@ -699,13 +769,18 @@ template<typename SortPolicy,
          template<typename> class TraversalType>
 template<typename Archive>
 void NeighborSearch<SortPolicy, MetricType, MatType, TreeType, TraversalType>::
-    Serialize(Archive& ar, const unsigned int /* version */)
+    Serialize(Archive& ar, const unsigned int version)
 {
   using data::CreateNVP;
 
-  // Serialize preferences for search.
+  // Serialize preferences for search.  Models saved before version 1 have no
+  // epsilon, and perform exact search.
   ar & CreateNVP(naive, "naive");
   ar & CreateNVP(singleMode, "singleMode");
+  if (version >= 1)
+    ar & CreateNVP(epsilon, "epsilon");
+  else if (Archive::is_loading::value)
+    epsilon = 0;
   ar & CreateNVP(treeNeedsReset, "treeNeedsReset");
 
   // If we are doing naive search, we serialize the dataset.  Otherwise we
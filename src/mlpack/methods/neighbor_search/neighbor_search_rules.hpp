@@ -17,11 +17,26 @@ template<typename SortPolicy, typename MetricType, typename TreeType>
 class NeighborSearchRules
 {
  public:
+  /**
+   * Construct the NeighborSearchRules object.  This is usually done from within
+   * the NeighborSearch class at search time.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param neighbors Matrix to store resulting neighbors in.
+   * @param distances Matrix to store resulting distances in.
+   * @param metric Instantiated metric.
+   * @param epsilon Relative approximation error; nodes are pruned if they
+   *     cannot improve any result by more than a factor of (1 + epsilon).
+   * @param sameSet If true, the query and reference set are taken to be the
+   *     same, and a query point will not return itself in the results.
+   */
   NeighborSearchRules(const typename TreeType::Mat& referenceSet,
                       const typename TreeType::Mat& querySet,
                       arma::Mat<size_t>& neighbors,
                       arma::mat& distances,
                       MetricType& metric,
+                      const double epsilon = 0,
                       const bool sameSet = false);
   /**
    * Get the distance from the query point to the reference point.
@@ -117,6 +132,9 @@ class NeighborSearchRules
   //! The instantiated metric.
   MetricType& metric;
 
+  //! Relative approximation error.
+  double epsilon;
+
   //! Denotes whether or not the reference and query sets are the same.
   bool sameSet;
 
@@ -20,12 +20,14 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances,
     MetricType& metric,
+    const double epsilon,
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
     neighbors(neighbors),
     distances(distances),
     metric(metric),
+    epsilon(epsilon),
     sameSet(sameSet),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
@@ -111,8 +113,10 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
         &referenceNode);
   }
 
-  // Compare against the best k'th distance for this query point so far.
-  const double bestDistance = distances(distances.n_rows - 1, queryIndex);
+  // Compare against the best k'th distance for this query point so far,
+  // relaxed if we are doing approximate search.
+  const double bestDistance = SortPolicy::Relax(
+      distances(distances.n_rows - 1, queryIndex), epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ? distance : DBL_MAX;
 }
@@ -127,8 +131,9 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   if (oldScore == DBL_MAX)
     return oldScore;
 
-  // Just check the score again against the distances.
-  const double bestDistance = distances(distances.n_rows - 1, queryIndex);
+  // Just check the score again against the (relaxed) distances.
+  const double bestDistance = SortPolicy::Relax(
+      distances(distances.n_rows - 1, queryIndex), epsilon);
 
   return (SortPolicy::IsBetter(oldScore, bestDistance)) ? oldScore : DBL_MAX;
 }
@@ -406,6 +411,12 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   queryNode.Stat().FirstBound() = worstDistance;
   queryNode.Stat().SecondBound() = bestDistance;
 
+  // For approximate search, the worst candidate distance can be relaxed: no
+  // point in a pruned node could improve any candidate of a descendant query
+  // point by more than a factor of (1 + epsilon).  The triangle inequality
+  // bound is not in terms of the current candidates, so it is not relaxed.
+  worstDistance = SortPolicy::Relax(worstDistance, epsilon);
+
   if (SortPolicy::IsBetter(worstDistance, bestDistance))
     return worstDistance;
   else
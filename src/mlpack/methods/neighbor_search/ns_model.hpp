@@ -100,6 +100,10 @@ class NSModel
   bool Naive() const;
   bool& Naive();
 
+  //! Expose the relative approximation error.
+  double Epsilon() const;
+  double& Epsilon();
+
   size_t LeafSize() const { return leafSize; }
   size_t& LeafSize() { return leafSize; }
 
@@ -113,7 +117,8 @@ class NSModel
   void BuildModel(arma::mat&& referenceSet,
                   const size_t leafSize,
                   const bool naive,
-                  const bool singleMode);
+                  const bool singleMode,
+                  const double epsilon = 0);
 
   //! Perform neighbor search.  The query set will be reordered.
   void Search(arma::mat&& querySet,
@@ -126,6 +131,22 @@ class NSModel
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Add a point to the reference set without rebuilding the tree, and return
+   * its index.  If a random basis is used, the point is projected first.  Only
+   * cover tree models can be updated in place; for any other tree type, a
+   * std::invalid_argument is thrown.
+   */
+  size_t Insert(const arma::vec& point);
+
+  /**
+   * Remove the point with the given index from the reference tree without
+   * rebuilding it (see NeighborSearch::DeleteReferencePoint()).  Only cover
+   * tree models can be updated in place; for any other tree type, a
+   * std::invalid_argument is thrown.
+   */
+  bool Delete(const size_t index);
+
   std::string TreeName() const;
 };
 
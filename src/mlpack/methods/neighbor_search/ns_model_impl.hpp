@@ -188,12 +188,48 @@ bool& NSModel<SortPolicy>::Naive()
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Expose the relative approximation error.
+template<typename SortPolicy>
+double NSModel<SortPolicy>::Epsilon() const
+{
+  if (kdTreeNS)
+    return kdTreeNS->Epsilon();
+  else if (coverTreeNS)
+    return coverTreeNS->Epsilon();
+  else if (rTreeNS)
+    return rTreeNS->Epsilon();
+  else if (rStarTreeNS)
+    return rStarTreeNS->Epsilon();
+  else if (ballTreeNS)
+    return ballTreeNS->Epsilon();
+
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+template<typename SortPolicy>
+double& NSModel<SortPolicy>::Epsilon()
+{
+  if (kdTreeNS)
+    return kdTreeNS->Epsilon();
+  else if (coverTreeNS)
+    return coverTreeNS->Epsilon();
+  else if (rTreeNS)
+    return rTreeNS->Epsilon();
+  else if (rStarTreeNS)
+    return rStarTreeNS->Epsilon();
+  else if (ballTreeNS)
+    return ballTreeNS->Epsilon();
+
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Build the reference tree.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
                                      const size_t leafSize,
                                      const bool naive,
-                                     const bool singleMode)
+                                     const bool singleMode,
+                                     const double epsilon)
 {
   // Initialize random basis if necessary.
   if (randomBasis)
@@ -256,7 +292,7 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
       if (naive)
       {
         kdTreeNS = new NSType<tree::KDTree>(std::move(referenceSet), naive,
-            singleMode);
+            singleMode, metric::EuclideanDistance(), epsilon);
       }
       else
       {
@@ -264,7 +300,8 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
         typename NSType<tree::KDTree>::Tree* kdTree =
             new typename NSType<tree::KDTree>::Tree(std::move(referenceSet),
             oldFromNewReferences, leafSize);
-        kdTreeNS = new NSType<tree::KDTree>(kdTree, singleMode);
+        kdTreeNS = new NSType<tree::KDTree>(kdTree, singleMode,
+            metric::EuclideanDistance(), epsilon);
 
         // Give the model ownership of the tree and the mappings.
         kdTreeNS->treeOwner = true;
@@ -275,32 +312,33 @@ void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
     case COVER_TREE:
       // If necessary, build the cover tree.
       coverTreeNS = new NSType<tree::StandardCoverTree>(std::move(referenceSet),
-          naive, singleMode);
+          naive, singleMode, metric::EuclideanDistance(), epsilon);
       break;
     case R_TREE:
       // If necessary, build the R tree.
       rTreeNS = new NSType<tree::RTree>(std::move(referenceSet), naive,
-          singleMode);
+          singleMode, metric::EuclideanDistance(), epsilon);
       break;
     case R_STAR_TREE:
       // If necessary, build the R* tree.
       rStarTreeNS = new NSType<tree::RStarTree>(std::move(referenceSet), naive,
-          singleMode);
+          singleMode, metric::EuclideanDistance(), epsilon);
       break;
     case BALL_TREE:
       // If necessary, build the ball tree.
       if (naive)
       {
         ballTreeNS = new NSType<tree::BallTree>(std::move(referenceSet), naive,
-            singleMode);
+            singleMode, metric::EuclideanDistance(), epsilon);
       }
       else
       {
         std::vector<size_t> oldFromNewReferences;
         typename NSType<tree::BallTree>::Tree* ballTree =
-            new typename NSType<tree::KDTree>::Tree(std::move(referenceSet),
+            new typename NSType<tree::BallTree>::Tree(std::move(referenceSet),
             oldFromNewReferences, leafSize);
-        ballTreeNS = new NSType<tree::BallTree>(ballTree, singleMode);
+        ballTreeNS = new NSType<tree::BallTree>(ballTree, singleMode,
+            metric::EuclideanDistance(), epsilon);
 
         // Give the model ownership of the tree and the mappings.
         ballTreeNS->treeOwner = true;
@@ -450,6 +488,32 @@ void NSModel<SortPolicy>::Search(const size_t k,
   }
 }
 
+//! Add a point to the reference set.
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::Insert(const arma::vec& point)
+{
+  if (treeType != COVER_TREE)
+    throw std::invalid_argument("NSModel::Insert(): points can only be "
+        "inserted into cover tree models, not " + TreeName() + " models");
+
+  // We may need to map the point randomly.
+  if (randomBasis)
+    return coverTreeNS->InsertReferencePoint(arma::vec(q * point));
+  else
+    return coverTreeNS->InsertReferencePoint(point);
+}
+
+//! Remove a point from the reference tree.
+template<typename SortPolicy>
+bool NSModel<SortPolicy>::Delete(const size_t index)
+{
+  if (treeType != COVER_TREE)
+    throw std::invalid_argument("NSModel::Delete(): points can only be "
+        "deleted from cover tree models, not " + TreeName() + " models");
+
+  return coverTreeNS->DeleteReferencePoint(index);
+}
+
 //! Get the name of the tree type.
 template<typename SortPolicy>
 std::string NSModel<SortPolicy>::TreeName() const
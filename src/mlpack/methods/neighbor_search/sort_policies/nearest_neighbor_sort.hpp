@@ -150,6 +150,22 @@ class NearestNeighborSort
       return DBL_MAX;
     return a + b;
   }
+
+  /**
+   * Return the given pruning bound, relaxed for approximate search with
+   * relative error epsilon.  A node whose best distance is not better than the
+   * relaxed bound cannot improve any result by more than a factor of
+   * (1 + epsilon).  In our case, this is value / (1 + epsilon).
+   *
+   * @param value Pruning bound to relax.
+   * @param epsilon Relative approximation error.
+   */
+  static inline double Relax(const double value, const double epsilon)
+  {
+    if (value == DBL_MAX)
+      return DBL_MAX;
+    return value / (1 + epsilon);
+  }
 };
 
 } // namespace neighbor
@@ -0,0 +1,146 @@
+/**
+ * @file randomized_svd_method.hpp
+ * @author agent
+ *
+ * Implementation of the randomized SVD decomposition policy for PCA.
+ */
+#ifndef __MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_RANDOMIZED_SVD_METHOD_HPP
+#define __MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_RANDOMIZED_SVD_METHOD_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the randomized SVD policy, which computes only the top
+ * principal components with a randomized range finder, as described in the
+ * following paper:
+ *
+ * @code
+ * @article{halko2011finding,
+ *   title = {Finding Structure with Randomness: Probabilistic Algorithms for
+ *       Constructing Approximate Matrix Decompositions},
+ *   author = {Halko, N. and Martinsson, P.G. and Tropp, J.A.},
+ *   journal = {SIAM Review},
+ *   volume = {53},
+ *   number = {2},
+ *   pages = {217--288},
+ *   year = {2011}
+ * }
+ * @endcode
+ *
+ * For a d x n dataset and a rank k decomposition, a random n x l test matrix
+ * (with l = k + oversampling) is used to find an orthonormal basis Q of the
+ * approximate range of the data.  The basis is refined with a few steps of
+ * power iteration, and then the (small) SVD of Q^T X gives the components.
+ * The cost is O(d n l) time and O((d + n) l) extra memory, instead of the
+ * O(d n min(d, n)) time and O(d n) memory of the exact SVD.  When only a few
+ * components of a large dataset are needed, this is much faster.
+ *
+ * Only the top k eigenvalues are returned.  If the requested rank is close to
+ * the dimensionality of the data, the exact SVD is used instead.
+ */
+class RandomizedSVDPolicy
+{
+ public:
+  /**
+   * Create the policy with the given number of power iterations and the given
+   * oversampling.
+   *
+   * @param iteratedPower Number of power iterations used to refine the basis.
+   * @param oversampling Number of extra random directions to sample.
+   */
+  RandomizedSVDPolicy(const size_t iteratedPower = 2,
+                      const size_t oversampling = 10) :
+      iteratedPower(iteratedPower),
+      oversampling(oversampling)
+  { /* nothing to do */ }
+
+  /**
+   * Apply Principal Component Analysis to the provided (already centered)
+   * data set using the randomized SVD method.
+   *
+   * @param centeredData Centered data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put the top rank eigenvalues into.
+   * @param eigvec Matrix to put the top rank eigenvectors (loadings) into.
+   * @param rank Number of components to compute.
+   */
+  void Apply(const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank) const
+  {
+    const size_t maxRank = std::min(centeredData.n_rows, centeredData.n_cols);
+    const size_t l = std::min(rank + oversampling, maxRank);
+
+    arma::mat v;
+    if (l == maxRank)
+    {
+      // The random projection would not save anything.
+      if (centeredData.n_rows < centeredData.n_cols)
+        arma::svd_econ(eigvec, eigVal, v, centeredData, 'l');
+      else
+        arma::svd(eigvec, eigVal, v, centeredData);
+    }
+    else
+    {
+      // Find an orthonormal basis of the range of X * Omega.
+      arma::mat q, r;
+      arma::qr_econ(q, r, centeredData * arma::randn<arma::mat>(
+          centeredData.n_cols, l));
+
+      // Power iterations, with re-orthonormalization after each product to
+      // keep the small singular values from being lost to rounding.
+      arma::mat z;
+      for (size_t i = 0; i < iteratedPower; ++i)
+      {
+        arma::qr_econ(z, r, arma::trans(centeredData) * q);
+        arma::qr_econ(q, r, centeredData * z);
+      }
+
+      // The SVD of the small l x n matrix Q^T X gives the approximate SVD of
+      // X.  We only need its left singular vectors.
+      arma::mat u;
+      const arma::mat b = arma::trans(q) * centeredData;
+      arma::svd_econ(u, eigVal, v, b, 'l');
+      eigvec = q * u;
+    }
+
+    // Keep only the requested components.
+    if (eigVal.n_elem > rank)
+      eigVal.shed_rows(rank, eigVal.n_elem - 1);
+    if (eigvec.n_cols > rank)
+      eigvec.shed_cols(rank, eigvec.n_cols - 1);
+
+    // Square the singular values to get the eigenvalues of the covariance
+    // matrix X * X' / (N - 1).
+    eigVal %= eigVal / (centeredData.n_cols - 1);
+
+    // Project the samples to the principals.
+    transformedData = arma::trans(eigvec) * centeredData;
+  }
+
+  //! Get the number of power iterations.
+  size_t IteratedPower() const { return iteratedPower; }
+  //! Modify the number of power iterations.
+  size_t& IteratedPower() { return iteratedPower; }
+
+  //! Get the oversampling.
+  size_t Oversampling() const { return oversampling; }
+  //! Modify the oversampling.
+  size_t& Oversampling() { return oversampling; }
+
+ private:
+  //! Number of power iterations used to refine the basis.
+  size_t iteratedPower;
+  //! Number of extra random directions to sample.
+  size_t oversampling;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file incremental_pca.cpp
+ * @author agent
+ *
+ * Implementation of the IncrementalPCA class.
+ */
+#include "incremental_pca.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::pca;
+
+IncrementalPCA::IncrementalPCA(const size_t rank) :
+    rank(rank),
+    totalSquares(0.0),
+    points(0)
+{
+  if (rank == 0)
+    Log::Fatal << "IncrementalPCA::IncrementalPCA(): rank cannot be zero!"
+        << endl;
+}
+
+void IncrementalPCA::Update(const arma::mat& block)
+{
+  if (block.n_cols == 0)
+    return;
+
+  if (points > 0 && block.n_rows != mean.n_elem)
+    Log::Fatal << "IncrementalPCA::Update(): block has dimensionality "
+        << block.n_rows << " (expected " << mean.n_elem << " dimensions)."
+        << endl;
+
+  const arma::vec blockMean = arma::mean(block, 1);
+  const double n = (double) points;
+  const double m = (double) block.n_cols;
+
+  // Assemble the matrix whose left singular vectors and singular values are
+  // those of all the centered points seen so far, up to the variance that was
+  // discarded in earlier updates.  The last column accounts for the change of
+  // the mean.
+  const size_t oldRank = components.n_cols;
+  arma::mat combined(block.n_rows, oldRank + block.n_cols + 1);
+  if (oldRank > 0)
+  {
+    combined.cols(0, oldRank - 1) = components;
+    combined.cols(0, oldRank - 1).each_row() %= arma::trans(singularValues);
+  }
+  combined.cols(oldRank, oldRank + block.n_cols - 1) = block;
+  combined.cols(oldRank, oldRank + block.n_cols - 1).each_col() -= blockMean;
+
+  const double meanWeight = (points > 0) ? std::sqrt(n * m / (n + m)) : 0.0;
+  if (points > 0)
+    combined.col(oldRank + block.n_cols) = meanWeight * (mean - blockMean);
+  else
+    combined.col(oldRank + block.n_cols).zeros();
+
+  totalSquares += arma::accu(arma::square(
+      combined.cols(oldRank, oldRank + block.n_cols)));
+
+  // Only the left singular vectors are needed.
+  arma::mat u, v;
+  arma::vec s;
+  arma::svd_econ(u, s, v, combined, 'l');
+
+  const size_t newRank = std::min(rank, (size_t) s.n_elem);
+  components = u.cols(0, newRank - 1);
+  singularValues = s.subvec(0, newRank - 1);
+
+  if (points == 0)
+    mean = blockMean;
+  else
+    mean = (n * mean + m * blockMean) / (n + m);
+  points += block.n_cols;
+}
+
+void IncrementalPCA::Transform(const arma::mat& data,
+                               arma::mat& transformedData) const
+{
+  if (points == 0)
+    Log::Fatal << "IncrementalPCA::Transform(): no points have been seen!"
+        << endl;
+
+  if (data.n_rows != mean.n_elem)
+    Log::Fatal << "IncrementalPCA::Transform(): data has dimensionality "
+        << data.n_rows << " (expected " << mean.n_elem << " dimensions)."
+        << endl;
+
+  // Project first, then subtract the projection of the mean, so the data is
+  // never centered in a copy.
+  const arma::vec projectedMean = arma::trans(components) * mean;
+  transformedData = arma::trans(components) * data;
+  transformedData.each_col() -= projectedMean;
+}
+
+arma::vec IncrementalPCA::EigenValues() const
+{
+  // The covariance matrix is X * X' / (N - 1).
+  if (points < 2)
+    return arma::zeros<arma::vec>(singularValues.n_elem);
+
+  return arma::square(singularValues) / (points - 1);
+}
+
+double IncrementalPCA::TotalVariance() const
+{
+  if (points < 2)
+    return 0.0;
+
+  return totalSquares / (points - 1);
+}
+
+double IncrementalPCA::VarianceRetained() const
+{
+  if (totalSquares == 0.0)
+    return 1.0;
+
+  return arma::accu(arma::square(singularValues)) / totalSquares;
+}
+
+void IncrementalPCA::Reset()
+{
+  mean.reset();
+  components.reset();
+  singularValues.reset();
+  totalSquares = 0.0;
+  points = 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file incremental_pca.hpp
+ * @author agent
+ *
+ * Defines the IncrementalPCA class, which computes the principal components of
+ * a dataset one block of points at a time.
+ */
+#ifndef __MLPACK_METHODS_PCA_INCREMENTAL_PCA_HPP
+#define __MLPACK_METHODS_PCA_INCREMENTAL_PCA_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * This class computes the top principal components of a dataset from blocks
+ * of points, so that the whole dataset never has to be centered (or even held
+ * in memory) at once.  After each call to Update(), the mean, the top rank
+ * components, and their eigenvalues reflect every point seen so far.
+ *
+ * Each update computes the SVD of the d x (rank + m + 1) matrix made of the
+ * current components (scaled by their singular values), the new block of m
+ * centered points, and a correction for the shift of the mean, as described
+ * in the following paper:
+ *
+ * @code
+ * @article{ross2008incremental,
+ *   title = {Incremental Learning for Robust Visual Tracking},
+ *   author = {Ross, D.A. and Lim, J. and Lin, R.S. and Yang, M.H.},
+ *   journal = {International Journal of Computer Vision},
+ *   volume = {77},
+ *   number = {1--3},
+ *   pages = {125--141},
+ *   year = {2008}
+ * }
+ * @endcode
+ *
+ * The memory used is O(d (rank + m)).  If rank is at least the dimensionality
+ * of the data, the result is exactly the same as the batch PCA (up to the
+ * signs of the components); otherwise, the variance outside of the top
+ * components of each block is discarded, so the result is an approximation,
+ * which is typically very good when the spectrum decays quickly.
+ *
+ * @code
+ * IncrementalPCA ipca(10);
+ * for (size_t i = 0; i < data.n_cols; i += 1000)
+ *   ipca.Update(data.cols(i, std::min(i + 1000, data.n_cols) - 1));
+ *
+ * arma::mat transformed;
+ * ipca.Transform(data, transformed);
+ * @endcode
+ */
+class IncrementalPCA
+{
+ public:
+  /**
+   * Create the IncrementalPCA object, which will keep the given number of
+   * components.  No points have been seen.
+   *
+   * @param rank Number of components to keep.
+   */
+  IncrementalPCA(const size_t rank);
+
+  /**
+   * Update the components with the given block of points (one per column).
+   * The dimensionality of every block must be the same.
+   *
+   * @param block Block of points.
+   */
+  void Update(const arma::mat& block);
+
+  /**
+   * Project the given points onto the components found so far.  It is safe to
+   * pass the same matrix reference for both data and transformedData.
+   *
+   * @param data Points to transform.
+   * @param transformedData Matrix to store the projected points in.
+   */
+  void Transform(const arma::mat& data, arma::mat& transformedData) const;
+
+  /**
+   * Get the eigenvalues of the covariance matrix corresponding to each
+   * component, in decreasing order.
+   */
+  arma::vec EigenValues() const;
+
+  /**
+   * Get the total variance of the points seen so far (the trace of their
+   * covariance matrix).
+   */
+  double TotalVariance() const;
+
+  /**
+   * Get the amount of the variance of the points seen so far that is retained
+   * by the components (between 0 and 1).
+   */
+  double VarianceRetained() const;
+
+  //! Forget all of the points seen so far.
+  void Reset();
+
+  //! Get the number of components that are kept.
+  size_t Rank() const { return rank; }
+  //! Get the mean of the points seen so far.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the components (eigenvectors, one per column).
+  const arma::mat& Components() const { return components; }
+  //! Get the singular values of the centered data seen so far.
+  const arma::vec& SingularValues() const { return singularValues; }
+  //! Get the number of points seen so far.
+  size_t Points() const { return points; }
+
+ private:
+  //! Number of components to keep.
+  size_t rank;
+  //! Mean of the points seen so far.
+  arma::vec mean;
+  //! Top components (one per column).
+  arma::mat components;
+  //! Singular values corresponding to each component.
+  arma::vec singularValues;
+  //! Sum of squared distances of all points seen so far to their mean.
+  double totalSquares;
+  //! Number of points seen so far.
+  size_t points;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
@@ -9,6 +9,8 @@
 #define __MLPACK_METHODS_PCA_PCA_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 
 namespace mlpack {
 namespace pca {
@@ -19,8 +21,18 @@ namespace pca {
  * or transforming data into a better basis.  Further information on PCA can be
  * found in almost any statistics or machine learning textbook, and all over the
  * internet.
+ *
+ * The decomposition of the centered data is done by the DecompositionPolicy.
+ * ExactSVDPolicy (the default) computes the full singular value decomposition;
+ * RandomizedSVDPolicy only computes the requested number of components, which
+ * is much faster when that number is small.  To compute PCA from blocks of a
+ * dataset too large to process at once, see IncrementalPCA.
+ *
+ * @tparam DecompositionPolicy Class implementing the Apply() function used to
+ *     decompose the centered data (see ExactSVDPolicy).
  */
-class PCA
+template<typename DecompositionPolicy = ExactSVDPolicy>
+class PCAType
 {
  public:
   /**
@@ -28,8 +40,10 @@ class PCA
    * dimension by standard deviation when PCA is performed.
    *
    * @param scaleData Whether or not to scale the data.
+   * @param decomposition Instantiated decomposition policy.
    */
-  PCA(const bool scaleData = false);
+  PCAType(const bool scaleData = false,
+          const DecompositionPolicy& decomposition = DecompositionPolicy());
 
   /**
    * Apply Principal Component Analysis to the provided data set.  It is safe to
@@ -64,6 +78,9 @@ class PCA
    * retained; this is a value between 0 and 1.  For instance, a value of 0.9
    * indicates that 90% of the variance present in the data was retained.
    *
+   * The data is centered in place instead of in a copy, and the decomposition
+   * policy is only asked for newDimension components.
+   *
    * @param data Data matrix.
    * @param newDimension New dimension of the data.
    * @return Amount of the variance of the data retained (between 0 and 1).
@@ -100,14 +117,33 @@ class PCA
   //! the data when PCA is performed.
   bool& ScaleData() { return scaleData; }
 
+  //! Get the decomposition policy.
+  const DecompositionPolicy& Decomposition() const { return decomposition; }
+  //! Modify the decomposition policy.
+  DecompositionPolicy& Decomposition() { return decomposition; }
+
  private:
+  /**
+   * Scale each dimension of the given centered data by its standard deviation.
+   */
+  void Scale(arma::mat& centeredData) const;
+
   //! Whether or not the data will be scaled by standard deviation when PCA is
   //! performed.
   bool scaleData;
 
-}; // class PCA
+  //! The decomposition policy.
+  DecompositionPolicy decomposition;
+
+}; // class PCAType
+
+//! PCA with the exact SVD; this is the PCA class of earlier versions.
+typedef PCAType<ExactSVDPolicy> PCA;
 
 } // namespace pca
 } // namespace mlpack
 
+// Include implementation.
+#include "pca_impl.hpp"
+
 #endif
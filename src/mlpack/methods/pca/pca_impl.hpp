@@ -1,19 +1,25 @@
 /**
- * @file pca.cpp
+ * @file pca_impl.hpp
  * @author Ajinkya Kale
  *
  * Implementation of PCA class to perform Principal Components Analysis on the
  * specified data set.
  */
+#ifndef __MLPACK_METHODS_PCA_PCA_IMPL_HPP
+#define __MLPACK_METHODS_PCA_PCA_IMPL_HPP
+
+// In case it hasn't been included yet.
 #include "pca.hpp"
-#include <mlpack/core.hpp>
 
-using namespace std;
-using namespace mlpack;
-using namespace mlpack::pca;
+namespace mlpack {
+namespace pca {
 
-PCA::PCA(const bool scaleData) :
-    scaleData(scaleData)
+template<typename DecompositionPolicy>
+PCAType<DecompositionPolicy>::PCAType(
+    const bool scaleData,
+    const DecompositionPolicy& decomposition) :
+    scaleData(scaleData),
+    decomposition(decomposition)
 { }
 
 /**
@@ -24,54 +30,24 @@ PCA::PCA(const bool scaleData) :
  * @param eigVal - contains eigen values in a column vector
  * @param coeff - PCA Loadings/Coeffs/EigenVectors
  */
-void PCA::Apply(const arma::mat& data,
-                arma::mat& transformedData,
-                arma::vec& eigVal,
-                arma::mat& coeff) const
+template<typename DecompositionPolicy>
+void PCAType<DecompositionPolicy>::Apply(const arma::mat& data,
+                                         arma::mat& transformedData,
+                                         arma::vec& eigVal,
+                                         arma::mat& coeff) const
 {
   Timer::Start("pca");
 
-  // This matrix will store the right singular values; we do not need them.
-  arma::mat v;
-
   // Center the data into a temporary matrix.
   arma::mat centeredData;
   math::Center(data, centeredData);
 
   if (scaleData)
-  {
-    // Scaling the data is when we reduce the variance of each dimension to 1.
-    // We do this by dividing each dimension by its standard deviation.
-    arma::vec stdDev = arma::stddev(centeredData, 0, 1 /* for each dimension */);
-
-    // If there are any zeroes, make them very small.
-    for (size_t i = 0; i < stdDev.n_elem; ++i)
-      if (stdDev[i] == 0)
-        stdDev[i] = 1e-50;
-
-    centeredData /= arma::repmat(stdDev, 1, centeredData.n_cols);
-  }
-
-  // Do singular value decomposition.  Use the economical singular value
-  // decomposition if the columns are much larger than the rows.
-  if (data.n_rows < data.n_cols)
-  {
-    // Do economical singular value decomposition and compute only the left
-    // singular vectors.
-    arma::svd_econ(coeff, eigVal, v, centeredData, 'l');
-  }
-  else
-  {
-    arma::svd(coeff, eigVal, v, centeredData);
-  }
+    Scale(centeredData);
 
-  // Now we must square the singular values to get the eigenvalues.
-  // In addition we must divide by the number of points, because the covariance
-  // matrix is X * X' / (N - 1).
-  eigVal %= eigVal / (data.n_cols - 1);
-
-  // Project the samples to the principals.
-  transformedData = arma::trans(coeff) * centeredData;
+  // Compute all of the components.
+  decomposition.Apply(centeredData, transformedData, eigVal, coeff,
+      data.n_rows);
 
   Timer::Stop("pca");
 }
@@ -83,9 +59,10 @@ void PCA::Apply(const arma::mat& data,
  * @param transformedData - Data with PCA applied
  * @param eigVal - contains eigen values in a column vector
  */
-void PCA::Apply(const arma::mat& data,
-                arma::mat& transformedData,
-                arma::vec& eigVal) const
+template<typename DecompositionPolicy>
+void PCAType<DecompositionPolicy>::Apply(const arma::mat& data,
+                                         arma::mat& transformedData,
+                                         arma::vec& eigVal) const
 {
   arma::mat coeffs;
   Apply(data, transformedData, eigVal, coeffs);
@@ -102,32 +79,50 @@ void PCA::Apply(const arma::mat& data,
  * @param newDimension New dimension of the data.
  * @return Amount of the variance of the data retained (between 0 and 1).
  */
-double PCA::Apply(arma::mat& data, const size_t newDimension) const
+template<typename DecompositionPolicy>
+double PCAType<DecompositionPolicy>::Apply(arma::mat& data,
+                                           const size_t newDimension) const
 {
   // Parameter validation.
   if (newDimension == 0)
     Log::Fatal << "PCA::Apply(): newDimension (" << newDimension << ") cannot "
-        << "be zero!" << endl;
+        << "be zero!" << std::endl;
   if (newDimension > data.n_rows)
     Log::Fatal << "PCA::Apply(): newDimension (" << newDimension << ") cannot "
         << "be greater than the existing dimensionality of the data ("
-        << data.n_rows << ")!" << endl;
+        << data.n_rows << ")!" << std::endl;
+
+  Timer::Start("pca");
 
+  // The data will be overwritten anyway, so we can center it in place and save
+  // a copy of the dataset.
+  data.each_col() -= arma::mean(data, 1);
+  if (scaleData)
+    Scale(data);
+
+  // The total variance is the trace of the covariance matrix; we need it
+  // because the decomposition may not return every eigenvalue.
+  const double totalVariance = arma::accu(arma::square(data)) /
+      (data.n_cols - 1);
+
+  arma::mat transformedData;
   arma::mat coeffs;
   arma::vec eigVal;
+  decomposition.Apply(data, transformedData, eigVal, coeffs, newDimension);
 
-  Apply(data, data, eigVal, coeffs);
+  // Drop unnecessary rows.
+  if (newDimension < transformedData.n_rows)
+    transformedData.shed_rows(newDimension, transformedData.n_rows - 1);
+  data = transformedData;
 
-  if (newDimension < coeffs.n_rows)
-    // Drop unnecessary rows.
-    data.shed_rows(newDimension, data.n_rows - 1);
+  Timer::Stop("pca");
 
   // The svd method returns only non-zero eigenvalues so we have to calculate
   // the right dimension before calculating the amount of variance retained.
-  double eigDim = std::min(newDimension - 1, (size_t) eigVal.n_elem - 1);
+  const size_t eigDim = std::min(newDimension, (size_t) eigVal.n_elem);
 
   // Calculate the total amount of variance retained.
-  return (sum(eigVal.subvec(0, eigDim)) / sum(eigVal));
+  return (arma::sum(eigVal.subvec(0, eigDim - 1)) / totalVariance);
 }
 
 /**
@@ -140,15 +135,17 @@ double PCA::Apply(arma::mat& data, const size_t newDimension) const
  * The method returns the actual amount of variance retained, which will
  * always be greater than or equal to the varRetained parameter.
  */
-double PCA::Apply(arma::mat& data, const double varRetained) const
+template<typename DecompositionPolicy>
+double PCAType<DecompositionPolicy>::Apply(arma::mat& data,
+                                           const double varRetained) const
 {
   // Parameter validation.
   if (varRetained < 0)
     Log::Fatal << "PCA::Apply(): varRetained (" << varRetained << ") must be "
-        << "greater than or equal to 0." << endl;
+        << "greater than or equal to 0." << std::endl;
   if (varRetained > 1)
     Log::Fatal << "PCA::Apply(): varRetained (" << varRetained << ") should be "
-        << "less than or equal to 1." << endl;
+        << "less than or equal to 1." << std::endl;
 
   arma::mat coeffs;
   arma::vec eigVal;
@@ -171,3 +168,23 @@ double PCA::Apply(arma::mat& data, const double varRetained) const
 
   return varSum;
 }
+
+template<typename DecompositionPolicy>
+void PCAType<DecompositionPolicy>::Scale(arma::mat& centeredData) const
+{
+  // Scaling the data is when we reduce the variance of each dimension to 1.
+  // We do this by dividing each dimension by its standard deviation.
+  arma::vec stdDev = arma::stddev(centeredData, 0, 1 /* for each dimension */);
+
+  // If there are any zeroes, make them very small.
+  for (size_t i = 0; i < stdDev.n_elem; ++i)
+    if (stdDev[i] == 0)
+      stdDev[i] = 1e-50;
+
+  centeredData.each_col() /= stdDev;
+}
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
@@ -7,6 +7,7 @@
 #include <mlpack/core.hpp>
 
 #include "pca.hpp"
+#include "incremental_pca.hpp"
 
 using namespace mlpack;
 using namespace mlpack::pca;
@@ -17,7 +18,16 @@ PROGRAM_INFO("Principal Components Analysis", "This program performs principal "
     "components analysis on the given dataset.  It will transform the data "
     "onto its principal components, optionally performing dimensionality "
     "reduction by ignoring the principal components with the smallest "
-    "eigenvalues.");
+    "eigenvalues."
+    "\n\n"
+    "The decomposition method can be chosen with --decomposition_method (-c). "
+    "The 'exact' method computes the full singular value decomposition.  The "
+    "'randomized' method only computes the components that are kept, which is "
+    "much faster when the new dimensionality is small.  The 'incremental' "
+    "method processes the dataset in blocks of --block_size (-b) points and "
+    "never makes a centered copy of the dataset, so it can be used for "
+    "datasets that do not fit in memory twice; its results are approximate "
+    "unless all dimensions are kept.");
 
 // Parameters for program.
 PARAM_STRING_REQ("input_file", "Input dataset to perform PCA on.", "i");
@@ -30,6 +40,93 @@ PARAM_DOUBLE("var_to_retain", "Amount of variance to retain; should be between "
 PARAM_FLAG("scale", "If set, the data will be scaled before running PCA, such "
     "that the variance of each feature is 1.", "s");
 
+PARAM_STRING("decomposition_method", "Method used to compute the principal "
+    "components: 'exact', 'randomized', or 'incremental'.", "c", "exact");
+PARAM_INT("block_size", "Number of points processed at once by the "
+    "incremental method.", "b", 10000);
+
+// Run PCA with the given decomposition policy.
+template<typename DecompositionPolicy>
+double RunPCA(arma::mat& dataset,
+              const size_t newDimension,
+              const bool scale,
+              const double varToRetain)
+{
+  PCAType<DecompositionPolicy> p(scale);
+  if (varToRetain != 0)
+    return p.Apply(dataset, varToRetain);
+  else
+    return p.Apply(dataset, newDimension);
+}
+
+// Run incremental PCA, one block of the dataset at a time.
+double RunIncrementalPCA(arma::mat& dataset,
+                         const size_t newDimension,
+                         const bool scale,
+                         const double varToRetain,
+                         const size_t blockSize)
+{
+  Timer::Start("pca");
+
+  if (scale)
+  {
+    // Scaling does not depend on centering, so it can be done in place.
+    arma::vec stdDev = arma::stddev(dataset, 0, 1 /* for each dimension */);
+    for (size_t i = 0; i < stdDev.n_elem; ++i)
+      if (stdDev[i] == 0)
+        stdDev[i] = 1e-50;
+
+    dataset.each_col() /= stdDev;
+  }
+
+  // If we need to retain a fraction of the variance, we don't know how many
+  // components are needed yet.
+  IncrementalPCA ipca((varToRetain != 0) ? dataset.n_rows : newDimension);
+  for (size_t i = 0; i < dataset.n_cols; i += blockSize)
+  {
+    const size_t end = std::min(i + blockSize, (size_t) dataset.n_cols);
+    ipca.Update(dataset.cols(i, end - 1));
+  }
+
+  ipca.Transform(dataset, dataset);
+
+  const double totalVariance = ipca.TotalVariance();
+  size_t dimension = std::min(newDimension,
+      (size_t) ipca.EigenValues().n_elem);
+  double varRetained = 0.0;
+  if (totalVariance == 0.0)
+  {
+    // The data has no variance at all (it is constant, or there is only one
+    // point), so normalizing the eigenvalues would give NaNs.  Like
+    // IncrementalPCA::VarianceRetained(), consider all of the (zero) variance
+    // retained; one dimension is then enough for any --var_to_retain.
+    varRetained = 1.0;
+    if (varToRetain != 0)
+      dimension = std::min((size_t) 1, (size_t) ipca.EigenValues().n_elem);
+  }
+  else
+  {
+    const arma::vec eigVal = ipca.EigenValues() / totalVariance;
+    if (varToRetain != 0)
+    {
+      dimension = 0;
+      while ((varRetained < varToRetain) && (dimension < eigVal.n_elem))
+        varRetained += eigVal[dimension++];
+    }
+    else
+    {
+      varRetained = arma::accu(eigVal.subvec(0, dimension - 1));
+    }
+  }
+
+  if (dimension < dataset.n_rows)
+    dataset.shed_rows(dimension, dataset.n_rows - 1);
+
+  Timer::Stop("pca");
+
+  return varRetained;
+}
+
 int main(int argc, char** argv)
 {
   // Parse commandline.
@@ -55,24 +152,33 @@ int main(int argc, char** argv)
   }
 
   // Get the options for running PCA.
-  const size_t scale = CLI::HasParam("scale");
+  const bool scale = CLI::HasParam("scale");
 
   // Perform PCA.
-  PCA p(scale);
+  const string method = CLI::GetParam<string>("decomposition_method");
+  const int blockSize = CLI::GetParam<int>("block_size");
+  if (method != "exact" && method != "randomized" && method != "incremental")
+    Log::Fatal << "Unknown decomposition method '" << method << "'; must be "
+        << "'exact', 'randomized', or 'incremental'." << endl;
+  if (method == "incremental" && blockSize <= 0)
+    Log::Fatal << "Block size (" << blockSize << ") must be positive!" << endl;
+
+  const double varToRetain = CLI::GetParam<double>("var_to_retain");
+  if (varToRetain != 0 && CLI::GetParam<int>("new_dimensionality") != 0)
+    Log::Warn << "New dimensionality (-d) ignored because -V was specified."
+        << endl;
+
   Log::Info << "Performing PCA on dataset..." << endl;
   double varRetained;
-  if (CLI::GetParam<double>("var_to_retain") != 0)
-  {
-    if (CLI::GetParam<int>("new_dimensionality") != 0)
-      Log::Warn << "New dimensionality (-d) ignored because -V was specified."
-          << endl;
-
-    varRetained = p.Apply(dataset, CLI::GetParam<double>("var_to_retain"));
-  }
+  if (method == "exact")
+    varRetained = RunPCA<ExactSVDPolicy>(dataset, newDimension, scale,
+        varToRetain);
+  else if (method == "randomized")
+    varRetained = RunPCA<RandomizedSVDPolicy>(dataset, newDimension, scale,
+        varToRetain);
   else
-  {
-    varRetained = p.Apply(dataset, newDimension);
-  }
+    varRetained = RunIncrementalPCA(dataset, newDimension, scale, varToRetain,
+        (size_t) blockSize);
 
   Log::Info << (varRetained * 100) << "% of variance retained (" <<
       dataset.n_rows << " dimensions)." << endl;
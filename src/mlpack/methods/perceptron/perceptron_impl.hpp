@@ -107,15 +107,36 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex;
+  predictedLabels.set_size(test.n_cols);
 
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; i++)
+  // Score the points in blocks, so that each block's scores are computed with
+  // one matrix multiplication and stay in cache while the labels are chosen.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (test.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel
   {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
-    predictedLabels(0, i) = maxIndex;
+    // Scratch space for the scores of one block, reused for each block.
+    arma::mat scores(weights.n_cols, blockSize);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t count = std::min(blockSize, (size_t) test.n_cols - begin);
+
+      arma::mat blockScores(scores.memptr(), weights.n_cols, count, false,
+          true);
+      blockScores = weights.t() * test.cols(begin, begin + count - 1);
+      blockScores.each_col() += biases;
+
+      arma::uword maxIndex;
+      for (size_t i = 0; i < count; ++i)
+      {
+        blockScores.unsafe_col(i).max(maxIndex);
+        predictedLabels[begin + i] = maxIndex;
+      }
+    }
   }
 }
 
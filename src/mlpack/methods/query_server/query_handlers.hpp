@@ -0,0 +1,224 @@
+/**
+ * @file query_handlers.hpp
+ * @author agent
+ *
+ * Handlers that answer query requests with a trained NSModel, RSModel, or
+ * FastMKSModel, for use with the QueryServer class.
+ */
+#ifndef __MLPACK_METHODS_QUERY_SERVER_QUERY_HANDLERS_HPP
+#define __MLPACK_METHODS_QUERY_SERVER_QUERY_HANDLERS_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/range_search/rs_model.hpp>
+#include <mlpack/methods/fastmks/fastmks_model.hpp>
+
+#include "query_protocol.hpp"
+
+namespace mlpack {
+namespace server {
+
+/**
+ * Store dense search results (k results per query, one query per column) in
+ * compressed form.
+ */
+template<typename eT>
+inline void DenseResults(const arma::Mat<size_t>& resultIndices,
+                         const arma::Mat<eT>& resultValues,
+                         std::vector<uint64_t>& offsets,
+                         std::vector<uint64_t>& indices,
+                         std::vector<double>& values)
+{
+  offsets.resize(resultIndices.n_cols + 1);
+  for (size_t i = 0; i <= resultIndices.n_cols; ++i)
+    offsets[i] = i * resultIndices.n_rows;
+
+  indices.assign(resultIndices.begin(), resultIndices.end());
+  values.assign(resultValues.begin(), resultValues.end());
+}
+
+/**
+ * Check that the queries have the same dimensionality as the reference set.
+ * Returns an error message, or an empty string if the dimensionality is right.
+ */
+inline std::string CheckDimensionality(const QueryRequest& request,
+                                       const size_t dimensionality)
+{
+  if (request.queries.n_rows == dimensionality)
+    return "";
+
+  std::ostringstream oss;
+  oss << "queries have dimensionality " << request.queries.n_rows
+      << " (expected " << dimensionality << ")";
+  return oss.str();
+}
+
+/**
+ * Answer k-nearest-neighbor (or k-furthest-neighbor) queries with an NSModel.
+ * Every handler provides the same three functions: Compatible(), to decide if
+ * two requests can be answered by a single search; Validate(), to check the
+ * parameters of a request; and Search(), to answer a set of queries.
+ */
+template<typename SortPolicy>
+class NSQueryHandler
+{
+ public:
+  //! Create the handler for the given model; the model is not copied.
+  NSQueryHandler(neighbor::NSModel<SortPolicy>& model) : model(model) { }
+
+  //! Requests can be answered together if they ask for the same k.
+  static bool Compatible(const QueryRequest& a, const QueryRequest& b)
+  {
+    return a.k == b.k;
+  }
+
+  //! Return an error message, or an empty string if the request is valid.
+  std::string Validate(const QueryRequest& request) const
+  {
+    if (request.k == 0 || request.k > model.Dataset().n_cols)
+    {
+      std::ostringstream oss;
+      oss << "invalid k " << request.k << "; must be between 1 and the number "
+          << "of reference points (" << model.Dataset().n_cols << ")";
+      return oss.str();
+    }
+
+    return CheckDimensionality(request, model.Dataset().n_rows);
+  }
+
+  //! Answer the given queries with the parameters of the given request.
+  void Search(arma::mat&& queries,
+              const QueryRequest& parameters,
+              std::vector<uint64_t>& offsets,
+              std::vector<uint64_t>& indices,
+              std::vector<double>& values)
+  {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    model.Search(std::move(queries), parameters.k, neighbors, distances);
+    DenseResults(neighbors, distances, offsets, indices, values);
+  }
+
+ private:
+  //! The model.
+  neighbor::NSModel<SortPolicy>& model;
+};
+
+/**
+ * Answer range search queries with an RSModel.
+ */
+class RSQueryHandler
+{
+ public:
+  //! Create the handler for the given model; the model is not copied.
+  RSQueryHandler(range::RSModel& model) : model(model) { }
+
+  //! Requests can be answered together if they ask for the same range.
+  static bool Compatible(const QueryRequest& a, const QueryRequest& b)
+  {
+    return (a.rangeMin == b.rangeMin) && (a.rangeMax == b.rangeMax);
+  }
+
+  //! Return an error message, or an empty string if the request is valid.
+  std::string Validate(const QueryRequest& request) const
+  {
+    if (!(request.rangeMin <= request.rangeMax))
+      return "invalid range; the minimum must not be greater than the maximum";
+
+    return CheckDimensionality(request, model.Dataset().n_rows);
+  }
+
+  //! Answer the given queries with the parameters of the given request.
+  void Search(arma::mat&& queries,
+              const QueryRequest& parameters,
+              std::vector<uint64_t>& offsets,
+              std::vector<uint64_t>& indices,
+              std::vector<double>& values)
+  {
+    std::vector<std::vector<size_t>> neighbors;
+    std::vector<std::vector<double>> distances;
+    model.Search(std::move(queries), math::Range(parameters.rangeMin,
+        parameters.rangeMax), neighbors, distances);
+
+    offsets.resize(neighbors.size() + 1);
+    offsets[0] = 0;
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      offsets[i + 1] = offsets[i] + neighbors[i].size();
+
+    indices.resize(offsets.back());
+    values.resize(offsets.back());
+    for (size_t i = 0; i < neighbors.size(); ++i)
+    {
+      std::copy(neighbors[i].begin(), neighbors[i].end(),
+          indices.begin() + offsets[i]);
+      std::copy(distances[i].begin(), distances[i].end(),
+          values.begin() + offsets[i]);
+    }
+  }
+
+ private:
+  //! The model.
+  range::RSModel& model;
+};
+
+/**
+ * Answer max-kernel search queries with a FastMKSModel.
+ */
+class FastMKSQueryHandler
+{
+ public:
+  /**
+   * Create the handler for the given model; the model is not copied.
+   *
+   * @param model Model to search with.
+   * @param base Base to use for building query cover trees.
+   */
+  FastMKSQueryHandler(fastmks::FastMKSModel& model, const double base = 2.0) :
+      model(model),
+      base(base)
+  { }
+
+  //! Requests can be answered together if they ask for the same k.
+  static bool Compatible(const QueryRequest& a, const QueryRequest& b)
+  {
+    return a.k == b.k;
+  }
+
+  //! Return an error message, or an empty string if the request is valid.
+  std::string Validate(const QueryRequest& request) const
+  {
+    if (request.k == 0 || request.k > model.ReferenceSet().n_cols)
+    {
+      std::ostringstream oss;
+      oss << "invalid k " << request.k << "; must be between 1 and the number "
+          << "of reference points (" << model.ReferenceSet().n_cols << ")";
+      return oss.str();
+    }
+
+    return CheckDimensionality(request, model.ReferenceSet().n_rows);
+  }
+
+  //! Answer the given queries with the parameters of the given request.
+  void Search(arma::mat&& queries,
+              const QueryRequest& parameters,
+              std::vector<uint64_t>& offsets,
+              std::vector<uint64_t>& indices,
+              std::vector<double>& values)
+  {
+    arma::Mat<size_t> resultIndices;
+    arma::mat kernels;
+    model.Search(queries, parameters.k, resultIndices, kernels, base);
+    DenseResults(resultIndices, kernels, offsets, indices, values);
+  }
+
+ private:
+  //! The model.
+  fastmks::FastMKSModel& model;
+  //! Base to use for building query cover trees.
+  double base;
+};
+
+} // namespace server
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,382 @@
+/**
+ * @file query_protocol.hpp
+ * @author agent
+ *
+ * The framing used by mlpack_query_server: the definition of query requests
+ * and responses, and functions to read and write them on a file descriptor
+ * (a pipe, stdin/stdout, or a Unix domain socket).
+ */
+#ifndef __MLPACK_METHODS_QUERY_SERVER_QUERY_PROTOCOL_HPP
+#define __MLPACK_METHODS_QUERY_SERVER_QUERY_PROTOCOL_HPP
+
+#include <mlpack/core.hpp>
+
+#include <cstring>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+
+namespace mlpack {
+namespace server /** Persistent query servers for trained models. */ {
+
+/**
+ * Every request starts with this magic number ("MLQ1" in native byte order).
+ * The framing uses the native byte order and double-precision layout, because
+ * the server only listens on local endpoints.
+ *
+ * A request is laid out as
+ *
+ *   uint32 magic, uint64 id, uint64 k, double rangeMin, double rangeMax,
+ *   uint64 rows, uint64 cols, double[rows * cols] queries (column-major)
+ *
+ * where k is used by kNN, kFN and FastMKS, and [rangeMin, rangeMax] by range
+ * search.
+ */
+static const uint32_t RequestMagic = 0x31514c4d;
+
+/**
+ * Every response starts with this magic number ("MLR1" in native byte order).
+ * A response is laid out as
+ *
+ *   uint32 magic, uint32 status, uint64 id, uint64 messageLength,
+ *   char[messageLength] message, uint64 queries, uint64 results,
+ *   uint64[queries + 1] offsets, uint64[results] indices,
+ *   double[results] values
+ *
+ * The results of query i are indices[offsets[i] .. offsets[i + 1] - 1] (and
+ * the corresponding values: distances for kNN, kFN, and range search, kernel
+ * values for FastMKS).  If status is not 0, the request failed, message holds
+ * the reason, and there are no results.
+ */
+static const uint32_t ResponseMagic = 0x31524c4d;
+
+/**
+ * The default limit on the number of elements (rows * cols) of a request:
+ * 2^24 doubles, so 128MB of queries.  Requests larger than the limit are
+ * rejected before their payload is allocated or buffered, so a malformed header
+ * cannot make the server allocate more than the limit allows.  The limit is
+ * configurable; see QueryServer::MaxRequestElements().
+ */
+static const uint64_t DefaultMaxRequestElements = uint64_t(1) << 24;
+
+//! The size of a request header in bytes (everything before the queries).
+static const size_t RequestHeaderSize = sizeof(uint32_t) + 4 * sizeof(uint64_t)
+    + 2 * sizeof(double);
+
+/**
+ * A batch of queries, with the search parameters for the batch.
+ */
+struct QueryRequest
+{
+  //! Identifier chosen by the client; it is returned in the response.
+  uint64_t id;
+  //! Number of results per query (kNN, kFN, FastMKS).
+  uint64_t k;
+  //! Lower end of the range (range search).
+  double rangeMin;
+  //! Upper end of the range (range search).
+  double rangeMax;
+  //! Query points, one per column.
+  arma::mat queries;
+
+  QueryRequest() : id(0), k(0), rangeMin(0.0), rangeMax(0.0) { }
+};
+
+/**
+ * The results of a batch of queries, in compressed sparse form.
+ */
+struct QueryResponse
+{
+  //! Identifier of the request.
+  uint64_t id;
+  //! 0 on success.
+  uint32_t status;
+  //! Reason of the failure, if status is not 0.
+  std::string message;
+  //! Start of the results of each query in indices and values, plus the end.
+  std::vector<uint64_t> offsets;
+  //! Indices of the result points.
+  std::vector<uint64_t> indices;
+  //! Distances or kernel values of the result points.
+  std::vector<double> values;
+
+  QueryResponse() : id(0), status(0) { }
+};
+
+//! Read exactly length bytes; return false on EOF or error.
+inline bool ReadBytes(const int fd, void* buffer, const size_t length)
+{
+  char* position = (char*) buffer;
+  size_t remaining = length;
+  while (remaining > 0)
+  {
+    const ssize_t result = ::read(fd, position, remaining);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result <= 0)
+      return false;
+
+    position += result;
+    remaining -= result;
+  }
+
+  return true;
+}
+
+//! Write exactly length bytes; return false on error.
+inline bool WriteBytes(const int fd, const void* buffer, const size_t length)
+{
+  const char* position = (const char*) buffer;
+  size_t remaining = length;
+  while (remaining > 0)
+  {
+    const ssize_t result = ::write(fd, position, remaining);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result <= 0)
+      return false;
+
+    position += result;
+    remaining -= result;
+  }
+
+  return true;
+}
+
+//! Read a single value of the given type.
+template<typename T>
+inline bool ReadValue(const int fd, T& value)
+{
+  return ReadBytes(fd, &value, sizeof(T));
+}
+
+//! Append the bytes of the given value to the buffer.
+template<typename T>
+inline void AppendValue(std::string& buffer, const T& value)
+{
+  buffer.append((const char*) &value, sizeof(T));
+}
+
+/**
+ * Check that a request of the given size is within the limit on the number of
+ * elements; if not, a warning is printed.
+ */
+inline bool CheckRequestSize(const uint64_t rows,
+                             const uint64_t cols,
+                             const uint64_t maxElements)
+{
+  if (rows > maxElements || cols > maxElements ||
+      (rows > 0 && cols > maxElements / rows))
+  {
+    Log::Warn << "Request of " << rows << " x " << cols << " queries is "
+        << "larger than the limit of " << maxElements << " elements."
+        << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Read a request from the given file descriptor.  This blocks until the whole
+ * request has been read.  Returns false if the stream ended or the request is
+ * malformed or too large; in the latter cases, a warning is printed.
+ *
+ * @param fd File descriptor to read from.
+ * @param request Request to store the result in.
+ * @param maxElements Maximum number of elements of the query set.
+ */
+inline bool ReadRequest(const int fd,
+                        QueryRequest& request,
+                        const uint64_t maxElements = DefaultMaxRequestElements)
+{
+  uint32_t magic;
+  if (!ReadValue(fd, magic))
+    return false; // The stream ended.
+
+  uint64_t rows, cols;
+  if (magic != RequestMagic || !ReadValue(fd, request.id) ||
+      !ReadValue(fd, request.k) || !ReadValue(fd, request.rangeMin) ||
+      !ReadValue(fd, request.rangeMax) || !ReadValue(fd, rows) ||
+      !ReadValue(fd, cols))
+  {
+    Log::Warn << "ReadRequest(): malformed request header." << std::endl;
+    return false;
+  }
+
+  if (!CheckRequestSize(rows, cols, maxElements))
+    return false;
+
+  request.queries.set_size(rows, cols);
+  if (!ReadBytes(fd, request.queries.memptr(), sizeof(double) * rows * cols))
+  {
+    Log::Warn << "ReadRequest(): request payload ended early." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+//! The result of ParseRequest().
+enum ParseResult
+{
+  //! The buffer does not hold a whole request yet.
+  RequestIncomplete,
+  //! A request was parsed and removed from the buffer.
+  RequestComplete,
+  //! The buffer holds a malformed or too large request.
+  RequestMalformed
+};
+
+/**
+ * Parse a request from the bytes received so far on a connection, without
+ * blocking.  If the buffer holds a whole request, it is stored in request and
+ * its bytes are removed from the front of the buffer.  A request that is too
+ * large is reported as soon as its header has arrived, so its payload is never
+ * buffered.
+ *
+ * @param buffer Bytes received so far.
+ * @param request Request to store the result in.
+ * @param maxElements Maximum number of elements of the query set.
+ */
+inline ParseResult ParseRequest(std::string& buffer,
+                                QueryRequest& request,
+                                const uint64_t maxElements =
+                                    DefaultMaxRequestElements)
+{
+  uint32_t magic;
+  if (buffer.size() < sizeof(uint32_t))
+    return RequestIncomplete;
+  std::memcpy(&magic, buffer.data(), sizeof(uint32_t));
+  if (magic != RequestMagic)
+  {
+    Log::Warn << "ParseRequest(): malformed request header." << std::endl;
+    return RequestMalformed;
+  }
+
+  if (buffer.size() < RequestHeaderSize)
+    return RequestIncomplete;
+
+  const char* position = buffer.data() + sizeof(uint32_t);
+  uint64_t id, k, rows, cols;
+  double rangeMin, rangeMax;
+  std::memcpy(&id, position, sizeof(uint64_t));
+  std::memcpy(&k, position + 8, sizeof(uint64_t));
+  std::memcpy(&rangeMin, position + 16, sizeof(double));
+  std::memcpy(&rangeMax, position + 24, sizeof(double));
+  std::memcpy(&rows, position + 32, sizeof(uint64_t));
+  std::memcpy(&cols, position + 40, sizeof(uint64_t));
+
+  if (!CheckRequestSize(rows, cols, maxElements))
+    return RequestMalformed;
+
+  const size_t payload = sizeof(double) * rows * cols;
+  if (buffer.size() < RequestHeaderSize + payload)
+    return RequestIncomplete;
+
+  request.id = id;
+  request.k = k;
+  request.rangeMin = rangeMin;
+  request.rangeMax = rangeMax;
+  request.queries.set_size(rows, cols);
+  if (payload > 0)
+    std::memcpy(request.queries.memptr(), buffer.data() + RequestHeaderSize,
+        payload);
+
+  buffer.erase(0, RequestHeaderSize + payload);
+  return RequestComplete;
+}
+
+/**
+ * Write a request to the given file descriptor.  This is the client side of
+ * the protocol.
+ */
+inline bool WriteRequest(const int fd, const QueryRequest& request)
+{
+  std::string buffer;
+  AppendValue(buffer, RequestMagic);
+  AppendValue(buffer, request.id);
+  AppendValue(buffer, request.k);
+  AppendValue(buffer, request.rangeMin);
+  AppendValue(buffer, request.rangeMax);
+  AppendValue(buffer, (uint64_t) request.queries.n_rows);
+  AppendValue(buffer, (uint64_t) request.queries.n_cols);
+
+  return WriteBytes(fd, buffer.data(), buffer.size()) &&
+      WriteBytes(fd, request.queries.memptr(),
+          sizeof(double) * request.queries.n_elem);
+}
+
+/**
+ * Append the bytes of a response to the given buffer, so that it can be
+ * written with as few system calls as possible.
+ */
+inline void AppendResponse(std::string& buffer, const QueryResponse& response)
+{
+  const uint64_t queries = (response.offsets.size() > 0) ?
+      response.offsets.size() - 1 : 0;
+
+  buffer.reserve(buffer.size() + 40 + response.message.size() +
+      8 * response.offsets.size() + 16 * response.indices.size());
+  AppendValue(buffer, ResponseMagic);
+  AppendValue(buffer, response.status);
+  AppendValue(buffer, response.id);
+  AppendValue(buffer, (uint64_t) response.message.size());
+  buffer.append(response.message);
+  AppendValue(buffer, queries);
+  AppendValue(buffer, (uint64_t) response.indices.size());
+  if (queries > 0)
+    buffer.append((const char*) response.offsets.data(),
+        sizeof(uint64_t) * response.offsets.size());
+  buffer.append((const char*) response.indices.data(),
+      sizeof(uint64_t) * response.indices.size());
+  buffer.append((const char*) response.values.data(),
+      sizeof(double) * response.values.size());
+}
+
+/**
+ * Write a response to the given file descriptor.  The response is assembled in
+ * memory first, so it is written with as few system calls as possible.
+ */
+inline bool WriteResponse(const int fd, const QueryResponse& response)
+{
+  std::string buffer;
+  AppendResponse(buffer, response);
+
+  return WriteBytes(fd, buffer.data(), buffer.size());
+}
+
+/**
+ * Read a response from the given file descriptor.  This is the client side of
+ * the protocol; responses with more than maxElements results are rejected.
+ */
+inline bool ReadResponse(const int fd,
+                         QueryResponse& response,
+                         const uint64_t maxElements = DefaultMaxRequestElements)
+{
+  uint32_t magic;
+  uint64_t messageLength, queries, results;
+  if (!ReadValue(fd, magic) || magic != ResponseMagic ||
+      !ReadValue(fd, response.status) || !ReadValue(fd, response.id) ||
+      !ReadValue(fd, messageLength) || messageLength > maxElements)
+    return false;
+
+  response.message.resize(messageLength);
+  if ((messageLength > 0 && !ReadBytes(fd, &response.message[0],
+      messageLength)) || !ReadValue(fd, queries) || !ReadValue(fd, results) ||
+      queries > maxElements || results > maxElements)
+    return false;
+
+  response.offsets.resize((queries > 0) ? queries + 1 : 0);
+  response.indices.resize(results);
+  response.values.resize(results);
+  return ReadBytes(fd, response.offsets.data(),
+          sizeof(uint64_t) * response.offsets.size()) &&
+      ReadBytes(fd, response.indices.data(), sizeof(uint64_t) * results) &&
+      ReadBytes(fd, response.values.data(), sizeof(double) * results);
+}
+
+} // namespace server
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file query_server.hpp
+ * @author agent
+ *
+ * Defines the QueryServer class, which keeps a trained model (and its tree) in
+ * memory and answers batches of queries sent over a stream or a Unix domain
+ * socket.
+ */
+#ifndef __MLPACK_METHODS_QUERY_SERVER_QUERY_SERVER_HPP
+#define __MLPACK_METHODS_QUERY_SERVER_QUERY_SERVER_HPP
+
+#include <mlpack/core.hpp>
+#include <signal.h>
+
+#include "query_protocol.hpp"
+#include "query_handlers.hpp"
+
+namespace mlpack {
+namespace server {
+
+/**
+ * The flag that makes ServeStream() and ServeSocket() return; it can be set
+ * from a signal handler.
+ */
+inline volatile sig_atomic_t& StopFlag()
+{
+  static volatile sig_atomic_t stop = 0;
+  return stop;
+}
+
+/**
+ * The QueryServer answers requests (see query_protocol.hpp) with the given
+ * handler, which wraps a trained NSModel, RSModel, or FastMKSModel (see
+ * query_handlers.hpp).  The model is loaded once and stays in memory, so the
+ * cost of deserializing the model and its tree is paid once, not for every
+ * batch of queries.
+ *
+ * Searches modify the statistics of the reference tree, so the model answers
+ * only one search at a time.  To make the best of this, every request that is
+ * pending when the server is ready is handled in one round: compatible
+ * requests (the same k, or the same range) are merged into a single query set,
+ * answered by a single (dual-tree) search, and the results are split again.
+ * Client connections are non-blocking and each has its own receive and send
+ * buffers, so a client that sends a request slowly (or reads its responses
+ * slowly) never stalls the other clients.
+ *
+ * The time taken by each search is accumulated in the "query_batch" timer, and
+ * the latency of each batch is printed to Log::Info.
+ *
+ * @tparam HandlerType Type of handler (NSQueryHandler, RSQueryHandler, or
+ *     FastMKSQueryHandler).
+ */
+template<typename HandlerType>
+class QueryServer
+{
+ public:
+  /**
+   * Create the server for the given handler; the handler is not copied.
+   *
+   * @param handler Handler that answers the queries.
+   * @param maxBatchRequests Maximum number of requests handled in one round.
+   * @param maxRequestElements Maximum number of elements (rows * cols) of the
+   *     query set of a request; larger requests are rejected before they are
+   *     buffered.
+   */
+  QueryServer(HandlerType& handler,
+              const size_t maxBatchRequests = 64,
+              const uint64_t maxRequestElements = DefaultMaxRequestElements);
+
+  /**
+   * Answer the given requests.  Compatible requests are merged and answered by
+   * a single search.  The responses are in the same order as the requests.
+   * The queries of the requests are moved out of the requests.
+   *
+   * @param requests Requests to answer.
+   * @param responses Vector to store the responses in.
+   */
+  void Process(std::vector<QueryRequest>& requests,
+               std::vector<QueryResponse>& responses);
+
+  /**
+   * Read requests from inFd and write responses to outFd until the input ends,
+   * a malformed request is read, or StopFlag() is set.  Requests that are
+   * already available when a round starts are handled together.
+   *
+   * @param inFd File descriptor to read requests from.
+   * @param outFd File descriptor to write responses to.
+   * @return Number of requests that were answered.
+   */
+  size_t ServeStream(const int inFd, const int outFd);
+
+  /**
+   * Listen on a Unix domain socket at the given path and answer the requests
+   * of every client that connects until StopFlag() is set.  Any file at the
+   * given path is replaced, and the socket is removed when the server stops.
+   *
+   * @param path Path of the socket.
+   * @return Number of requests that were answered.
+   */
+  size_t ServeSocket(const std::string& path);
+
+  //! Get the number of searches done so far.
+  size_t Batches() const { return batches; }
+  //! Get the maximum number of requests handled in one round.
+  size_t MaxBatchRequests() const { return maxBatchRequests; }
+  //! Modify the maximum number of requests handled in one round.
+  size_t& MaxBatchRequests() { return maxBatchRequests; }
+  //! Get the maximum number of elements of the query set of a request.
+  uint64_t MaxRequestElements() const { return maxRequestElements; }
+  //! Modify the maximum number of elements of the query set of a request.
+  uint64_t& MaxRequestElements() { return maxRequestElements; }
+
+ private:
+  //! The handler that answers the queries.
+  HandlerType& handler;
+  //! Maximum number of requests handled in one round.
+  size_t maxBatchRequests;
+  //! Maximum number of elements of the query set of a request.
+  uint64_t maxRequestElements;
+  //! Number of searches done so far.
+  size_t batches;
+
+  /**
+   * Answer the given requests (which are all valid and compatible) with a
+   * single search.
+   */
+  void ProcessBatch(std::vector<QueryRequest>& requests,
+                    const std::vector<size_t>& batch,
+                    std::vector<QueryResponse>& responses);
+};
+
+} // namespace server
+} // namespace mlpack
+
+// Include implementation.
+#include "query_server_impl.hpp"
+
+#endif
@@ -0,0 +1,484 @@
+/**
+ * @file query_server_impl.hpp
+ * @author agent
+ *
+ * Implementation of the QueryServer class.
+ */
+#ifndef __MLPACK_METHODS_QUERY_SERVER_QUERY_SERVER_IMPL_HPP
+#define __MLPACK_METHODS_QUERY_SERVER_QUERY_SERVER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "query_server.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace mlpack {
+namespace server {
+
+/**
+ * Wait until the given file descriptor is readable (or has been closed).
+ * Returns 1 if it is, 0 on timeout or interruption, and -1 on error.
+ */
+inline int WaitReadable(const int fd, const int timeoutMs)
+{
+  pollfd descriptor;
+  descriptor.fd = fd;
+  descriptor.events = POLLIN;
+  descriptor.revents = 0;
+
+  const int result = ::poll(&descriptor, 1, timeoutMs);
+  if (result < 0)
+    return (errno == EINTR) ? 0 : -1;
+
+  return (result > 0) ? 1 : 0;
+}
+
+//! Put the given file descriptor in non-blocking mode; return false on error.
+inline bool SetNonBlocking(const int fd)
+{
+  const int flags = ::fcntl(fd, F_GETFL, 0);
+  return (flags >= 0) && (::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0);
+}
+
+/**
+ * The state of a client connected to ServeSocket(): the bytes received that do
+ * not form a whole request yet, the next request (if it has arrived), and the
+ * bytes of the responses that have not been sent yet.
+ */
+struct ClientConnection
+{
+  //! The (non-blocking) socket of the client.
+  int fd;
+  //! Bytes received but not yet parsed.
+  std::string input;
+  //! Bytes of responses not yet written.
+  std::string output;
+  //! The next request of the client, if hasRequest is true.
+  QueryRequest request;
+  //! True if request holds a request that has not been answered.
+  bool hasRequest;
+  //! True if the connection ended or failed and must be closed.
+  bool closed;
+
+  ClientConnection(const int fd) : fd(fd), hasRequest(false), closed(false) { }
+};
+
+/**
+ * Read whatever the client has sent without blocking, until a whole request has
+ * arrived, there is nothing more to read, or the connection ends.  Requests
+ * that are malformed or too large close the connection.
+ */
+inline void ReceiveRequest(ClientConnection& client,
+                           const uint64_t maxRequestElements)
+{
+  char chunk[65536];
+  while (!client.hasRequest && !client.closed)
+  {
+    // Maybe a whole request was already received.
+    const ParseResult parsed = ParseRequest(client.input, client.request,
+        maxRequestElements);
+    if (parsed == RequestComplete)
+    {
+      client.hasRequest = true;
+      break;
+    }
+    else if (parsed == RequestMalformed)
+    {
+      client.closed = true;
+      break;
+    }
+
+    const ssize_t result = ::read(client.fd, chunk, sizeof(chunk));
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      break; // Nothing more to read for now.
+    if (result <= 0)
+      client.closed = true; // The connection ended or failed.
+    else
+      client.input.append(chunk, result);
+  }
+}
+
+/**
+ * Write as much of the pending output of the client as possible without
+ * blocking.  A failed write closes the connection.
+ */
+inline void SendResponses(ClientConnection& client)
+{
+  size_t written = 0;
+  while (written < client.output.size())
+  {
+    const ssize_t result = ::write(client.fd, client.output.data() + written,
+        client.output.size() - written);
+    if (result < 0 && errno == EINTR)
+      continue;
+    if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      break; // The socket is full; try again when it is writable.
+    if (result <= 0)
+    {
+      client.closed = true;
+      break;
+    }
+
+    written += result;
+  }
+
+  client.output.erase(0, written);
+}
+
+template<typename HandlerType>
+QueryServer<HandlerType>::QueryServer(HandlerType& handler,
+                                      const size_t maxBatchRequests,
+                                      const uint64_t maxRequestElements) :
+    handler(handler),
+    maxBatchRequests(std::max(maxBatchRequests, (size_t) 1)),
+    maxRequestElements(maxRequestElements),
+    batches(0)
+{ }
+
+template<typename HandlerType>
+void QueryServer<HandlerType>::Process(std::vector<QueryRequest>& requests,
+                                       std::vector<QueryResponse>& responses)
+{
+  responses.clear();
+  responses.resize(requests.size());
+
+  // Reject invalid requests first; they are never part of a batch.
+  std::vector<bool> handled(requests.size(), false);
+  for (size_t i = 0; i < requests.size(); ++i)
+  {
+    responses[i].id = requests[i].id;
+    responses[i].message = handler.Validate(requests[i]);
+    if (!responses[i].message.empty())
+    {
+      responses[i].status = 1;
+      handled[i] = true;
+    }
+  }
+
+  // Now group the compatible requests and answer each group with one search.
+  for (size_t i = 0; i < requests.size(); ++i)
+  {
+    if (handled[i])
+      continue;
+
+    std::vector<size_t> batch(1, i);
+    for (size_t j = i + 1; j < requests.size(); ++j)
+    {
+      if (!handled[j] && HandlerType::Compatible(requests[i], requests[j]))
+      {
+        batch.push_back(j);
+        handled[j] = true;
+      }
+    }
+
+    ProcessBatch(requests, batch, responses);
+  }
+}
+
+template<typename HandlerType>
+void QueryServer<HandlerType>::ProcessBatch(
+    std::vector<QueryRequest>& requests,
+    const std::vector<size_t>& batch,
+    std::vector<QueryResponse>& responses)
+{
+  // The number of queries of each request is needed to split the results.
+  std::vector<size_t> requestQueries(batch.size());
+  size_t totalQueries = 0;
+  for (size_t i = 0; i < batch.size(); ++i)
+  {
+    requestQueries[i] = requests[batch[i]].queries.n_cols;
+    totalQueries += requestQueries[i];
+  }
+
+  // Nothing to search for (the responses are already empty).
+  if (totalQueries == 0)
+    return;
+
+  // Merge the query sets; a single request can be moved as it is.
+  arma::mat queries;
+  if (batch.size() == 1)
+  {
+    queries = std::move(requests[batch[0]].queries);
+  }
+  else
+  {
+    queries.set_size(requests[batch[0]].queries.n_rows, totalQueries);
+    size_t column = 0;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+      arma::mat& requestSet = requests[batch[i]].queries;
+      if (requestSet.n_cols > 0)
+        queries.cols(column, column + requestSet.n_cols - 1) = requestSet;
+      column += requestSet.n_cols;
+      requestSet.reset();
+    }
+  }
+
+  std::vector<uint64_t> offsets, indices;
+  std::vector<double> values;
+  const timeval before = Timer::Get("query_batch");
+  Timer::Start("query_batch");
+  try
+  {
+    handler.Search(std::move(queries), requests[batch[0]], offsets, indices,
+        values);
+  }
+  catch (std::exception& e)
+  {
+    Timer::Stop("query_batch");
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+      responses[batch[i]].status = 1;
+      responses[batch[i]].message = e.what();
+    }
+    return;
+  }
+  Timer::Stop("query_batch");
+  const timeval after = Timer::Get("query_batch");
+
+  ++batches;
+  const double latency = (after.tv_sec - before.tv_sec) +
+      (after.tv_usec - before.tv_usec) / 1e6;
+  Log::Info << "Answered " << totalQueries << " queries from " << batch.size()
+      << " request(s) in " << latency << "s." << std::endl;
+
+  // Split the results between the requests.
+  size_t column = 0;
+  for (size_t i = 0; i < batch.size(); ++i)
+  {
+    const size_t n = requestQueries[i];
+    if (n == 0)
+      continue;
+
+    QueryResponse& response = responses[batch[i]];
+    const uint64_t start = offsets[column];
+    response.offsets.resize(n + 1);
+    for (size_t q = 0; q <= n; ++q)
+      response.offsets[q] = offsets[column + q] - start;
+
+    const uint64_t end = offsets[column + n];
+    response.indices.assign(indices.begin() + start, indices.begin() + end);
+    response.values.assign(values.begin() + start, values.begin() + end);
+    column += n;
+  }
+}
+
+template<typename HandlerType>
+size_t QueryServer<HandlerType>::ServeStream(const int inFd, const int outFd)
+{
+  size_t answered = 0;
+  bool done = false;
+  while (!done && !StopFlag())
+  {
+    // Wait with a timeout, so that StopFlag() is checked regularly.
+    const int readable = WaitReadable(inFd, 200);
+    if (readable < 0)
+      break;
+    else if (readable == 0)
+      continue;
+
+    std::vector<QueryRequest> requests(1);
+    if (!ReadRequest(inFd, requests[0], maxRequestElements))
+      break;
+
+    // Take every other request that has already arrived, so that they can be
+    // answered together.
+    while (requests.size() < maxBatchRequests && WaitReadable(inFd, 0) > 0)
+    {
+      requests.push_back(QueryRequest());
+      if (!ReadRequest(inFd, requests.back(), maxRequestElements))
+      {
+        requests.pop_back();
+        done = true;
+        break;
+      }
+    }
+
+    std::vector<QueryResponse> responses;
+    Process(requests, responses);
+    for (size_t i = 0; i < responses.size(); ++i)
+    {
+      if (!WriteResponse(outFd, responses[i]))
+      {
+        Log::Warn << "QueryServer::ServeStream(): could not write response."
+            << std::endl;
+        return answered;
+      }
+      ++answered;
+    }
+  }
+
+  return answered;
+}
+
+template<typename HandlerType>
+size_t QueryServer<HandlerType>::ServeSocket(const std::string& path)
+{
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(sockaddr_un));
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path))
+    Log::Fatal << "QueryServer::ServeSocket(): socket path '" << path << "' is "
+        << "too long." << std::endl;
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+  const int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenFd < 0)
+    Log::Fatal << "QueryServer::ServeSocket(): cannot create socket: "
+        << std::strerror(errno) << std::endl;
+
+  ::unlink(path.c_str());
+  if (::bind(listenFd, (sockaddr*) &address, sizeof(sockaddr_un)) != 0 ||
+      ::listen(listenFd, SOMAXCONN) != 0)
+  {
+    const std::string error = std::strerror(errno);
+    ::close(listenFd);
+    Log::Fatal << "QueryServer::ServeSocket(): cannot listen on '" << path
+        << "': " << error << std::endl;
+  }
+
+  if (!SetNonBlocking(listenFd))
+  {
+    const std::string error = std::strerror(errno);
+    ::close(listenFd);
+    Log::Fatal << "QueryServer::ServeSocket(): cannot make socket '" << path
+        << "' non-blocking: " << error << std::endl;
+  }
+
+  Log::Info << "Listening on '" << path << "'." << std::endl;
+
+  size_t answered = 0;
+  std::vector<ClientConnection> clients;
+  while (!StopFlag())
+  {
+    // A client is only read from when its next request has not arrived yet and
+    // its previous responses have been sent, so a client that does not read
+    // its responses cannot make the server buffer an unbounded amount.
+    bool requestsWaiting = false;
+    std::vector<pollfd> descriptors(clients.size() + 1);
+    descriptors[0].fd = listenFd;
+    descriptors[0].events = POLLIN;
+    descriptors[0].revents = 0;
+    for (size_t i = 0; i < clients.size(); ++i)
+    {
+      descriptors[i + 1].fd = clients[i].fd;
+      descriptors[i + 1].events = 0;
+      descriptors[i + 1].revents = 0;
+      if (!clients[i].output.empty())
+        descriptors[i + 1].events |= POLLOUT;
+      else if (!clients[i].hasRequest)
+        descriptors[i + 1].events |= POLLIN;
+      requestsWaiting |= clients[i].hasRequest;
+    }
+
+    // Wait with a timeout, so that StopFlag() is checked regularly; don't wait
+    // at all if there are requests left over from the last round.
+    const int result = ::poll(descriptors.data(), descriptors.size(),
+        requestsWaiting ? 0 : 200);
+    if (result < 0 && errno != EINTR)
+    {
+      Log::Warn << "QueryServer::ServeSocket(): poll() failed: "
+          << std::strerror(errno) << std::endl;
+      break;
+    }
+    else if (result < 0 || (result == 0 && !requestsWaiting))
+    {
+      continue;
+    }
+
+    // Send pending responses and receive pending requests.  Neither blocks, so
+    // a slow client only delays itself.
+    for (size_t i = 0; i < clients.size(); ++i)
+    {
+      const short revents = descriptors[i + 1].revents;
+      if (revents & POLLNVAL)
+      {
+        clients[i].closed = true;
+        continue;
+      }
+
+      if (revents & POLLOUT)
+        SendResponses(clients[i]);
+
+      // Once the responses are sent, the next request can be received (part of
+      // it may already be buffered).
+      if (clients[i].output.empty() &&
+          (revents & (POLLIN | POLLOUT | POLLHUP | POLLERR)))
+        ReceiveRequest(clients[i], maxRequestElements);
+    }
+
+    // Accept every new client; each gets a non-blocking socket.
+    if (descriptors[0].revents & POLLIN)
+    {
+      int client;
+      while ((client = ::accept(listenFd, NULL, NULL)) >= 0)
+      {
+        if (SetNonBlocking(client))
+          clients.push_back(ClientConnection(client));
+        else
+          ::close(client);
+      }
+    }
+
+    // Answer up to maxBatchRequests of the requests that have arrived.
+    std::vector<size_t> senders;
+    std::vector<QueryRequest> pending;
+    for (size_t i = 0; i < clients.size() &&
+        senders.size() < maxBatchRequests; ++i)
+    {
+      if (clients[i].hasRequest && !clients[i].closed)
+      {
+        senders.push_back(i);
+        pending.push_back(std::move(clients[i].request));
+        clients[i].hasRequest = false;
+      }
+    }
+
+    if (!pending.empty())
+    {
+      std::vector<QueryResponse> responses;
+      Process(pending, responses);
+
+      for (size_t i = 0; i < senders.size(); ++i)
+      {
+        ClientConnection& client = clients[senders[i]];
+        AppendResponse(client.output, responses[i]);
+        SendResponses(client);
+        if (!client.closed)
+          ++answered;
+
+        // The client may have sent its next request already.
+        if (client.output.empty())
+          ReceiveRequest(client, maxRequestElements);
+      }
+    }
+
+    // Disconnect the clients whose connection ended or failed.
+    for (size_t i = clients.size(); i > 0; --i)
+    {
+      if (clients[i - 1].closed)
+      {
+        ::close(clients[i - 1].fd);
+        clients.erase(clients.begin() + (i - 1));
+      }
+    }
+  }
+
+  for (size_t i = 0; i < clients.size(); ++i)
+    ::close(clients[i].fd);
+  ::close(listenFd);
+  ::unlink(path.c_str());
+
+  return answered;
+}
+
+} // namespace server
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file query_server_main.cpp
+ * @author agent
+ *
+ * Executable that loads a trained kNN, kFN, range search, or FastMKS model
+ * once and answers batches of queries until it is stopped.
+ */
+#include <mlpack/core.hpp>
+
+#include "query_server.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::server;
+using namespace mlpack::neighbor;
+using namespace mlpack::range;
+using namespace mlpack::fastmks;
+
+PROGRAM_INFO("Query Server",
+    "This program loads a model trained by the allknn, allkfn, range_search, "
+    "or fastmks programs (saved with --output_model_file) and keeps it, and its "
+    "tree, in memory, answering batches of queries until it is stopped.  This "
+    "avoids paying the cost of loading the model for every batch of queries."
+    "\n\n"
+    "The type of the model is given with --model_type (-t): 'knn', 'kfn', "
+    "'range', or 'fastmks'.  If --socket (-S) is given, the server listens on a "
+    "Unix domain socket at that path and answers the requests of any number of "
+    "clients; otherwise, requests are read from standard input and responses "
+    "are written to standard output.  The binary framing of requests and "
+    "responses is documented in query_protocol.hpp.  Requests whose query set "
+    "has more than --max_request_elements (-E) elements are rejected, and the "
+    "connection they arrived on is closed."
+    "\n\n"
+    "Requests that are pending at the same time and have the same parameters "
+    "(the same k, or the same range) are answered with a single search.  The "
+    "time taken by each search is printed with --verbose, and the total is "
+    "reported by the 'query_batch' timer."
+    "\n\n"
+    "For example, the following command serves a kNN model on a socket:"
+    "\n\n"
+    "$ mlpack_query_server -t knn -m knn_model.bin -S /tmp/knn.sock");
+
+PARAM_STRING_REQ("input_model_file", "File containing the model to serve.",
+    "m");
+PARAM_STRING_REQ("model_type", "Type of the model: 'knn', 'kfn', 'range', or "
+    "'fastmks'.", "t");
+PARAM_STRING("socket", "Path of the Unix domain socket to listen on.  If not "
+    "specified, standard input and output are used.", "S", "");
+PARAM_INT("max_batch_requests", "Maximum number of requests answered in one "
+    "round.", "B", 64);
+PARAM_INT("max_request_elements", "Maximum number of elements (rows * columns) "
+    "of the query set of a request; larger requests are rejected.", "E",
+    16777216);
+PARAM_DOUBLE("base", "Base to use for query cover trees (FastMKS only).", "b",
+    2.0);
+
+//! Set the stop flag of the server.
+void HandleSignal(int /* signal */)
+{
+  StopFlag() = 1;
+}
+
+//! Serve the given handler with the options given on the command line.
+template<typename HandlerType>
+void Serve(HandlerType& handler)
+{
+  const int maxBatchRequests = CLI::GetParam<int>("max_batch_requests");
+  if (maxBatchRequests <= 0)
+    Log::Fatal << "Invalid value for --max_batch_requests (" << maxBatchRequests
+        << "); must be positive." << endl;
+
+  const int maxRequestElements = CLI::GetParam<int>("max_request_elements");
+  if (maxRequestElements <= 0)
+    Log::Fatal << "Invalid value for --max_request_elements ("
+        << maxRequestElements << "); must be positive." << endl;
+
+  QueryServer<HandlerType> server(handler, (size_t) maxBatchRequests,
+      (uint64_t) maxRequestElements);
+
+  size_t answered;
+  const string socket = CLI::GetParam<string>("socket");
+  if (socket != "")
+    answered = server.ServeSocket(socket);
+  else
+    answered = server.ServeStream(STDIN_FILENO, STDOUT_FILENO);
+
+  Log::Info << "Answered " << answered << " requests with " << server.Batches()
+      << " searches." << endl;
+}
+
+int main(int argc, char** argv)
+{
+  CLI::ParseCommandLine(argc, argv);
+
+  // Stop cleanly on SIGINT and SIGTERM; writing to a client that went away
+  // should not kill the server.
+  struct sigaction action;
+  memset(&action, 0, sizeof(struct sigaction));
+  action.sa_handler = HandleSignal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+  signal(SIGPIPE, SIG_IGN);
+
+  const string modelFile = CLI::GetParam<string>("input_model_file");
+  const string modelType = CLI::GetParam<string>("model_type");
+
+  if (modelType != "fastmks" && CLI::HasParam("base"))
+    Log::Warn << "--base (-b) is ignored unless --model_type is 'fastmks'."
+        << endl;
+
+  if (modelType == "knn")
+  {
+    NSModel<NearestNeighborSort> model;
+    data::Load(modelFile, "knn_model", model, true); // Fatal on failure.
+    NSQueryHandler<NearestNeighborSort> handler(model);
+    Serve(handler);
+  }
+  else if (modelType == "kfn")
+  {
+    NSModel<FurthestNeighborSort> model;
+    data::Load(modelFile, "kfn_model", model, true); // Fatal on failure.
+    NSQueryHandler<FurthestNeighborSort> handler(model);
+    Serve(handler);
+  }
+  else if (modelType == "range")
+  {
+    RSModel model;
+    data::Load(modelFile, "rs_model", model, true); // Fatal on failure.
+    RSQueryHandler handler(model);
+    Serve(handler);
+  }
+  else if (modelType == "fastmks")
+  {
+    FastMKSModel model;
+    data::Load(modelFile, "fastmks_model", model, true); // Fatal on failure.
+    FastMKSQueryHandler handler(model, CLI::GetParam<double>("base"));
+    Serve(handler);
+  }
+  else
+  {
+    Log::Fatal << "Unknown model type '" << modelType << "'; must be 'knn', "
+        << "'kfn', 'range', or 'fastmks'." << endl;
+  }
+}
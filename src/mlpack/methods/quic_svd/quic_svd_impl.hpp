@@ -33,6 +33,7 @@ QUIC_SVD::QUIC_SVD(const arma::mat& dataset,
 
   // Get subspace basis by creating the cosine tree.
   ctree->GetFinalBasis(basis);
+  delete ctree;
 
   // Use the ExtractSVD algorithm mentioned in the paper to extract the SVD of
   // the original dataset in the obtained subspace.
@@ -265,6 +265,31 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Add a point to the reference set and insert it into the reference tree in
+   * place.  This needs a tree type which does not rearrange its dataset and
+   * which has InsertPoint() and DeletePoint() (such as the cover tree), and
+   * cannot be used in naive mode.  If the reference tree does not own its
+   * dataset, it will make a copy of the dataset first, so ReferenceSet() may
+   * change.
+   *
+   * @param point Point to add.
+   * @return Index of the new point in the reference set.
+   */
+  template<typename VecType>
+  size_t InsertReferencePoint(const VecType& point);
+
+  /**
+   * Remove a point from the reference tree in place.  The point is left in the
+   * reference set (so no other indices change) but will not be found by any
+   * later search; in monochromatic search, its own results should be ignored.
+   * This has the same requirements as InsertReferencePoint().
+   *
+   * @param index Index of the point to remove.
+   * @return false if the point was not in the reference tree.
+   */
+  bool DeleteReferencePoint(const size_t index);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
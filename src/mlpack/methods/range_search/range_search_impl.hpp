@@ -617,6 +617,50 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename VecType>
+size_t RangeSearch<MetricType, MatType, TreeType>::
+    InsertReferencePoint(const VecType& point)
+{
+  static_assert(!tree::TreeTraits<Tree>::RearrangesDataset,
+      "RangeSearch::InsertReferencePoint() requires a tree type that does "
+      "not rearrange its dataset");
+
+  if (naive)
+    throw std::invalid_argument("cannot call RangeSearch::"
+        "InsertReferencePoint() when in naive search mode");
+
+  const size_t index = referenceTree->InsertPoint(point);
+
+  // The tree may have copied its dataset.
+  referenceSet = &referenceTree->Dataset();
+
+  return index;
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+bool RangeSearch<MetricType, MatType, TreeType>::
+    DeleteReferencePoint(const size_t index)
+{
+  static_assert(!tree::TreeTraits<Tree>::RearrangesDataset,
+      "RangeSearch::DeleteReferencePoint() requires a tree type that does "
+      "not rearrange its dataset");
+
+  if (naive)
+    throw std::invalid_argument("cannot call RangeSearch::"
+        "DeleteReferencePoint() when in naive search mode");
+
+  return referenceTree->DeletePoint(index);
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
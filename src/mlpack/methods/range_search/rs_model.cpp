@@ -262,6 +262,30 @@ void RSModel::Search(const math::Range& range,
   }
 }
 
+// Add a point to the reference set.
+size_t RSModel::Insert(const arma::vec& point)
+{
+  if (treeType != COVER_TREE)
+    throw std::invalid_argument("RSModel::Insert(): points can only be "
+        "inserted into cover tree models, not " + TreeName() + " models");
+
+  // We may need to map the point randomly.
+  if (randomBasis)
+    return coverTreeRS->InsertReferencePoint(arma::vec(q * point));
+  else
+    return coverTreeRS->InsertReferencePoint(point);
+}
+
+// Remove a point from the reference tree.
+bool RSModel::Delete(const size_t index)
+{
+  if (treeType != COVER_TREE)
+    throw std::invalid_argument("RSModel::Delete(): points can only be "
+        "deleted from cover tree models, not " + TreeName() + " models");
+
+  return coverTreeRS->DeleteReferencePoint(index);
+}
+
 // Get the name of the tree type.
 std::string RSModel::TreeName() const
 {
@@ -149,6 +149,28 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Add a point to the reference set without rebuilding the tree.  If a random
+   * basis is used, the point is projected first.  Only cover tree models can be
+   * updated in place; for any other tree type, a std::invalid_argument is
+   * thrown.
+   *
+   * @param point Point to add.
+   * @return Index of the new point in the reference set.
+   */
+  size_t Insert(const arma::vec& point);
+
+  /**
+   * Remove a point from the reference tree without rebuilding it (see
+   * RangeSearch<>::DeleteReferencePoint()).  Only cover tree models can be
+   * updated in place; for any other tree type, a std::invalid_argument is
+   * thrown.
+   *
+   * @param index Index of the point to remove.
+   * @return false if the point was not in the reference tree.
+   */
+  bool Delete(const size_t index);
+
  private:
   /**
    * Return a string representing the name of the tree.  This is used for
@@ -25,6 +25,11 @@ namespace neighbor {
  * Every query is required to make a minimum number of samples to guarantee the
  * desired approximation error. The 'numSamplesMade' keeps track of the minimum
  * number of samples made by all queries in the node in question.
+ *
+ * When the node is in a reference tree, 'samples' holds a random sample of the
+ * node's descendants (as indices of points in the dataset), in random order,
+ * which is drawn by RASearch before each search; a node is approximated by
+ * reading a prefix of this sample.
  */
 template<typename SortPolicy>
 class RAQueryStat
@@ -55,12 +60,20 @@ class RAQueryStat
   //! Modify the number of samples made.
   size_t& NumSamplesMade() { return numSamplesMade; }
 
+  //! Get the random sample of the descendants of the node.
+  const arma::Col<size_t>& Samples() const { return samples; }
+  //! Modify the random sample of the descendants of the node.
+  arma::Col<size_t>& Samples() { return samples; }
+
   //! Serialize the statistic.
   template<typename Archive>
   void Serialize(Archive& ar, const unsigned int /* version */)
   {
     ar & data::CreateNVP(bound, "bound");
     ar & data::CreateNVP(numSamplesMade, "numSamplesMade");
+
+    // The samples are not serialized, since they are drawn again before each
+    // search.
   }
 
  private:
@@ -68,6 +81,8 @@ class RAQueryStat
   double bound;
   //! The minimum number of samples made by any query in this node.
   size_t numSamplesMade;
+  //! A random sample of the descendants of the node, in random order.
+  arma::Col<size_t> samples;
 };
 
 } // namespace neighbor
@@ -414,6 +414,20 @@ class RASearch
   void Serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Recursively draw a new random sample of the descendants of each node in the
+   * given reference tree, and store it (in random order) in the statistic of
+   * the node.  A node is approximated during the search by reading a prefix of
+   * its sample, so this is done once before each search instead of drawing new
+   * samples for every (query, node) pair.  Internal nodes can only be
+   * approximated with at most SingleSampleLimit() samples, so that many points
+   * are sampled; leaves are sampled entirely, but only if SampleAtLeaves() is
+   * true.
+   *
+   * @param referenceNode Node whose descendants should be sampled.
+   */
+  void SampleReferenceTree(Tree* referenceNode) const;
+
   //! Permutations of reference points during tree building.
   std::vector<size_t> oldFromNewReferences;
   //! Pointer to the root of the reference tree.
@@ -360,23 +360,30 @@ Search(const MatType& querySet,
 
   if (naive)
   {
+    // The sampling is done here and not by the rules.
     RuleType rules(*referenceSet, querySet, *neighborPtr, *distancePtr, metric,
-                   tau, alpha, naive, sampleAtLeaves, firstLeafExact,
+                   tau, alpha, false, sampleAtLeaves, firstLeafExact,
                    singleSampleLimit, false);
 
     // Find how many samples from the reference set we need and sample uniformly
     // from the reference set without replacement.
     const size_t numSamples = RAUtil::MinimumSamplesReqd(referenceSet->n_cols,
         k, tau, alpha);
-    arma::uvec distinctSamples;
-    RAUtil::ObtainDistinctSamples(numSamples, referenceSet->n_cols,
-        distinctSamples);
+    arma::Col<size_t> samples;
+    RAUtil::ObtainRandomSubset(numSamples, referenceSet->n_cols, samples);
 
     // Run the base case on each combination of query point and sampled
-    // reference point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        rules.BaseCase(i, (size_t) distinctSamples[j]);
+    // reference point.  The queries are independent, so they are split between
+    // threads; each thread uses its own copy of the rules, which keep counts.
+    #pragma omp parallel
+    {
+      RuleType threadRules(rules);
+
+      #pragma omp for
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+        for (size_t j = 0; j < samples.n_elem; ++j)
+          threadRules.BaseCase(i, samples[j]);
+    }
   }
   else if (singleMode)
   {
@@ -384,24 +391,30 @@ Search(const MatType& querySet,
                    tau, alpha, naive, sampleAtLeaves, firstLeafExact,
                    singleSampleLimit, false);
 
-    // If the reference root node is a leaf, then the sampling has already been
-    // done in the RASearchRules constructor.  This happens when naive = true.
-    if (!referenceTree->IsLeaf())
-    {
-      Log::Info << "Performing single-tree traversal..." << std::endl;
+    SampleReferenceTree(referenceTree);
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
+    // Each thread traverses the tree for its share of the queries, with its own
+    // copy of the rules and its own traverser.  The rules only write to the
+    // columns of the results that belong to the current query.
+    size_t numDistComputations = 0;
+    #pragma omp parallel reduction(+:numDistComputations)
+    {
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(threadRules);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
         traverser.Traverse(i, *referenceTree);
 
-      Log::Info << "Single-tree traversal complete." << std::endl;
-      Log::Info << "Average number of distance calculations per query point: "
-          << (rules.NumDistComputations() / querySet.n_cols) << "."
-          << std::endl;
+      numDistComputations += threadRules.NumDistComputations();
     }
+
+    Log::Info << "Single-tree traversal complete." << std::endl;
+    Log::Info << "Average number of distance calculations per query point: "
+        << (numDistComputations / querySet.n_cols) << "." << std::endl;
   }
   else // Dual-tree recursion.
   {
@@ -420,6 +433,8 @@ Search(const MatType& querySet,
                    firstLeafExact, singleSampleLimit, false);
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
+    SampleReferenceTree(referenceTree);
+
     Log::Info << "Query statistic pre-search: "
         << queryTree->Stat().NumSamplesMade() << std::endl;
 
@@ -535,6 +550,8 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
 
   // Create the traverser.
   typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+
+  SampleReferenceTree(referenceTree);
   traverser.Traverse(*queryTree, *referenceTree);
 
   Timer::Stop("computing_neighbors");
@@ -586,8 +603,9 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
 
   // Create the helper object for the tree traversal.
   typedef RASearchRules<SortPolicy, MetricType, Tree> RuleType;
+  // In naive mode, the sampling is done here and not by the rules.
   RuleType rules(*referenceSet, *referenceSet, *neighborPtr, *distancePtr,
-                 metric, tau, alpha, naive, sampleAtLeaves, firstLeafExact,
+                 metric, tau, alpha, false, sampleAtLeaves, firstLeafExact,
                  singleSampleLimit, true /* sets are the same */);
 
   if (naive)
@@ -596,29 +614,43 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
     // from the reference set without replacement.
     const size_t numSamples = RAUtil::MinimumSamplesReqd(referenceSet->n_cols,
         k, tau, alpha);
-    arma::uvec distinctSamples;
-    RAUtil::ObtainDistinctSamples(numSamples, referenceSet->n_cols,
-        distinctSamples);
-
-    // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    arma::Col<size_t> samples;
+    RAUtil::ObtainRandomSubset(numSamples, referenceSet->n_cols, samples);
+
+    // Run the base case on each combination of query point and sampled
+    // reference point, with the queries split between threads.
+    #pragma omp parallel
+    {
+      RuleType threadRules(rules);
+
+      #pragma omp for
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+        for (size_t j = 0; j < samples.n_elem; ++j)
+          threadRules.BaseCase(i, samples[j]);
+    }
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    SampleReferenceTree(referenceTree);
+
+    // Traverse the tree for each point in parallel, as in the bichromatic case.
+    #pragma omp parallel
+    {
+      RuleType threadRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(threadRules);
 
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = 0; i < (omp_size_t) referenceSet->n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+    }
   }
   else
   {
     // Create the traverser.
     typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
+    SampleReferenceTree(referenceTree);
     traverser.Traverse(*referenceTree, *referenceTree);
   }
 
@@ -663,6 +695,34 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::ResetQueryTree(
     ResetQueryTree(&queryNode->Child(i));
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::SampleReferenceTree(
+    Tree* referenceNode) const
+{
+  // Internal nodes are only approximated when at most singleSampleLimit
+  // samples are needed; leaves may need all of their points.
+  const size_t numDescendants = referenceNode->NumDescendants();
+  size_t numSamples;
+  if (referenceNode->IsLeaf())
+    numSamples = (sampleAtLeaves) ? numDescendants : 0;
+  else
+    numSamples = std::min(numDescendants, singleSampleLimit);
+
+  // Store the indices of the sampled points, not of the descendants.
+  arma::Col<size_t>& samples = referenceNode->Stat().Samples();
+  RAUtil::ObtainRandomSubset(numSamples, numDescendants, samples);
+  for (size_t i = 0; i < samples.n_elem; ++i)
+    samples[i] = referenceNode->Descendant(samples[i]);
+
+  for (size_t i = 0; i < referenceNode->NumChildren(); ++i)
+    SampleReferenceTree(&referenceNode->Child(i));
+}
+
 template<typename SortPolicy,
          typename MetricType,
          typename MatType,
@@ -246,6 +246,21 @@ class RASearchRules
                       const size_t neighbor,
                       const double distance);
 
+  /**
+   * Approximate the given reference node for the given query by running the
+   * base case on a uniform random sample (without replacement) of the
+   * descendants of the node.  This is a prefix of the sample held by the
+   * statistic of the node (see RAQueryStat::Samples()), which must hold at
+   * least numSamples points; RASearch::SampleReferenceTree() ensures this.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Node to sample from.
+   * @param numSamples Number of samples to take.
+   */
+  void SampleReferenceNode(const size_t queryIndex,
+                           TreeType& referenceNode,
+                           const size_t numSamples);
+
   /**
    * Perform actual scoring for single-tree case.
    */
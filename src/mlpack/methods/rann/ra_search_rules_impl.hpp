@@ -71,12 +71,12 @@ RASearchRules(const arma::mat& referenceSet,
   if (naive) // No tree traversal; just do naive sampling here.
   {
     // Sample enough points.
+    arma::Col<size_t> samples;
     for (size_t i = 0; i < querySet.n_cols; ++i)
     {
-      arma::uvec distinctSamples;
-      RAUtil::ObtainDistinctSamples(numSamplesReqd, n, distinctSamples);
-      for (size_t j = 0; j < distinctSamples.n_elem; j++)
-        BaseCase(i, (size_t) distinctSamples[j]);
+      RAUtil::ObtainRandomSubset(numSamplesReqd, n, samples);
+      for (size_t j = 0; j < samples.n_elem; j++)
+        BaseCase(i, samples[j]);
     }
   }
 }
@@ -177,14 +177,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
         {
           // Then samplesReqd <= singleSampleLimit.
           // Hence, approximate the node by sampling enough number of points.
-          arma::uvec distinctSamples;
-          RAUtil::ObtainDistinctSamples(samplesReqd,
-              referenceNode.NumDescendants(),
-                                distinctSamples);
-          for (size_t i = 0; i < distinctSamples.n_elem; i++)
-            // The counting of the samples are done in the 'BaseCase' function
-            // so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+          SampleReferenceNode(queryIndex, referenceNode, samplesReqd);
 
           // Node approximated, so we can prune it.
           return DBL_MAX;
@@ -194,15 +187,7 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           if (sampleAtLeaves) // If allowed to sample at leaves.
           {
             // Approximate node by sampling enough number of points.
-            arma::uvec distinctSamples;
-            RAUtil::ObtainDistinctSamples(samplesReqd,
-                referenceNode.NumDescendants(),
-                                  distinctSamples);
-            for (size_t i = 0; i < distinctSamples.n_elem; i++)
-              // The counting of the samples are done in the 'BaseCase' function
-              // so no book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[i]));
+            SampleReferenceNode(queryIndex, referenceNode, samplesReqd);
 
             // (Leaf) node approximated, so we can prune it.
             return DBL_MAX;
@@ -283,13 +268,7 @@ Rescore(const size_t queryIndex,
       {
         // Then, samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough number of points.
-        arma::uvec distinctSamples;
-        RAUtil::ObtainDistinctSamples(samplesReqd,
-            referenceNode.NumDescendants(), distinctSamples);
-        for (size_t i = 0; i < distinctSamples.n_elem; i++)
-          // The counting of the samples are done in the 'BaseCase' function so
-          // no book-keeping is required here.
-          BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+        SampleReferenceNode(queryIndex, referenceNode, samplesReqd);
 
         // Node approximated, so we can prune it.
         return DBL_MAX;
@@ -299,13 +278,7 @@ Rescore(const size_t queryIndex,
         if (sampleAtLeaves)
         {
           // Approximate node by sampling enough points.
-          arma::uvec distinctSamples;
-          RAUtil::ObtainDistinctSamples(samplesReqd,
-              referenceNode.NumDescendants(), distinctSamples);
-          for (size_t i = 0; i < distinctSamples.n_elem; i++)
-            // The counting of the samples are done in the 'BaseCase' function
-            // so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[i]));
+          SampleReferenceNode(queryIndex, referenceNode, samplesReqd);
 
           // (Leaf) node approximated, so we can prune it.
           return DBL_MAX;
@@ -484,17 +457,8 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
           // Then samplesReqd <= singleSampleLimit.  Hence, approximate node by
           // sampling enough number of points for every query in the query node.
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-          {
-            const size_t queryIndex = queryNode.Descendant(i);
-            arma::uvec distinctSamples;
-            RAUtil::ObtainDistinctSamples(samplesReqd,
-                referenceNode.NumDescendants(), distinctSamples);
-            for (size_t j = 0; j < distinctSamples.n_elem; j++)
-              // The counting of the samples are done in the 'BaseCase' function
-              // so no book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[j]));
-          }
+            SampleReferenceNode(queryNode.Descendant(i), referenceNode,
+                samplesReqd);
 
           // Update the number of samples made for the queryNode and also update
           // the number of sample made for the child nodes.
@@ -514,17 +478,8 @@ inline double RASearchRules<SortPolicy, MetricType, TreeType>::Score(
             // Approximate node by sampling enough number of points for every
             // query in the query node.
             for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-            {
-              const size_t queryIndex = queryNode.Descendant(i);
-              arma::uvec distinctSamples;
-              RAUtil::ObtainDistinctSamples(samplesReqd,
-                  referenceNode.NumDescendants(), distinctSamples);
-              for (size_t j = 0; j < distinctSamples.n_elem; j++)
-                // The counting of the samples are done in the 'BaseCase'
-                // function so no book-keeping is required here.
-                BaseCase(queryIndex,
-                    referenceNode.Descendant(distinctSamples[j]));
-            }
+              SampleReferenceNode(queryNode.Descendant(i), referenceNode,
+                  samplesReqd);
 
             // Update the number of samples made for the queryNode and also
             // update the number of sample made for the child nodes.
@@ -689,16 +644,8 @@ Rescore(TreeType& queryNode,
         // then samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough points for every query in the query node.
         for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-        {
-          const size_t queryIndex = queryNode.Descendant(i);
-          arma::uvec distinctSamples;
-          RAUtil::ObtainDistinctSamples(samplesReqd,
-              referenceNode.NumDescendants(), distinctSamples);
-          for (size_t j = 0; j < distinctSamples.n_elem; j++)
-            // The counting of the samples are done in the 'BaseCase'
-            // function so no book-keeping is required here.
-            BaseCase(queryIndex, referenceNode.Descendant(distinctSamples[j]));
-        }
+          SampleReferenceNode(queryNode.Descendant(i), referenceNode,
+              samplesReqd);
 
         // Update the number of samples made for the query node and also update
         // the number of samples made for the child nodes.
@@ -718,17 +665,8 @@ Rescore(TreeType& queryNode,
           // Approximate node by sampling enough points for every query in the
           // query node.
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
-          {
-            const size_t queryIndex = queryNode.Descendant(i);
-            arma::uvec distinctSamples;
-            RAUtil::ObtainDistinctSamples(samplesReqd,
-                referenceNode.NumDescendants(), distinctSamples);
-            for (size_t j = 0; j < distinctSamples.n_elem; j++)
-              // The counting of the samples are done in BaseCase() so no
-              // book-keeping is required here.
-              BaseCase(queryIndex,
-                  referenceNode.Descendant(distinctSamples[j]));
-          }
+            SampleReferenceNode(queryNode.Descendant(i), referenceNode,
+                samplesReqd);
 
           // Update the number of samples made for the query node and also
           // update the number of samples made for the child nodes.
@@ -774,6 +712,26 @@ Rescore(TreeType& queryNode,
   }
 } // Rescore(node, node, oldScore)
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void RASearchRules<SortPolicy, MetricType, TreeType>::
+SampleReferenceNode(const size_t queryIndex,
+                    TreeType& referenceNode,
+                    const size_t numSamples)
+{
+  // The samples of the node are in random order, so any prefix of them is a
+  // uniform random sample of the node without replacement.  RASearch samples
+  // the reference tree before every search, with as many points as any call
+  // here can ask for (at most singleSampleLimit for internal nodes, and all of
+  // the points of a leaf if sampleAtLeaves is set), so we never have to draw a
+  // new sample here; that would use the global RNG from inside the parallel
+  // single-tree search.  The counting of the samples is done in BaseCase(), so
+  // no book-keeping is required here.
+  const arma::Col<size_t>& samples = referenceNode.Stat().Samples();
+  Log::Assert(samples.n_elem >= numSamples);
+  for (size_t i = 0; i < numSamples; ++i)
+    BaseCase(queryIndex, samples[i]);
+}
+
 /**
  * Helper function to insert a point into the neighbors and distances matrices.
  *
@@ -7,6 +7,8 @@
  */
 #include "ra_util.hpp"
 
+#include <unordered_set>
+
 using namespace mlpack;
 using namespace mlpack::neighbor;
 
@@ -180,3 +182,48 @@ void mlpack::neighbor::RAUtil::ObtainDistinctSamples(
   distinctSamples = arma::find(sampledPoints > 0);
   return;
 }
+
+void mlpack::neighbor::RAUtil::ObtainRandomSubset(
+    const size_t numSamples,
+    const size_t rangeUpperBound,
+    arma::Col<size_t>& samples)
+{
+  Log::Assert(numSamples <= rangeUpperBound);
+  samples.set_size(numSamples);
+
+  if (2 * numSamples > rangeUpperBound)
+  {
+    // Most of the range is needed, so take the prefix of a partial
+    // Fisher-Yates shuffle of the whole range.
+    arma::Col<size_t> range(rangeUpperBound);
+    for (size_t i = 0; i < rangeUpperBound; ++i)
+      range[i] = i;
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+      const size_t j = (size_t) math::RandInt(i, rangeUpperBound);
+      std::swap(range[i], range[j]);
+      samples[i] = range[i];
+    }
+
+    return;
+  }
+
+  // Otherwise, use Floyd's algorithm to pick the subset...
+  std::unordered_set<size_t> picked;
+  for (size_t i = 0; i < numSamples; ++i)
+  {
+    const size_t j = rangeUpperBound - numSamples + i;
+    size_t sample = (size_t) math::RandInt(j + 1);
+    if (picked.count(sample))
+      sample = j;
+
+    picked.insert(sample);
+    samples[i] = sample;
+  }
+
+  // ...and then shuffle it, since Floyd's algorithm does not pick the elements
+  // in random order.
+  for (size_t i = numSamples; i > 1; --i)
+    std::swap(samples[i - 1], samples[(size_t) math::RandInt(i)]);
+}
@@ -56,6 +56,22 @@ class RAUtil
   static void ObtainDistinctSamples(const size_t numSamples,
                                     const size_t rangeUpperBound,
                                     arma::uvec& distinctSamples);
+
+  /**
+   * Pick the desired number of distinct integers uniformly at random (without
+   * replacement) from the range [0 - specified upper bound), and return them
+   * in random order, so that any prefix of the result is also a uniform random
+   * sample without replacement.  This takes O(numSamples) time and memory when
+   * numSamples is small compared to the range, instead of the
+   * O(rangeUpperBound) of ObtainDistinctSamples().
+   *
+   * @param numSamples Number of random samples (at most rangeUpperBound).
+   * @param rangeUpperBound The upper bound on the range of integers.
+   * @param samples The list of the samples, in random order.
+   */
+  static void ObtainRandomSubset(const size_t numSamples,
+                                 const size_t rangeUpperBound,
+                                 arma::Col<size_t>& samples);
 };
 
 } // namespace neighbor
@@ -0,0 +1,137 @@
+/**
+ * @file dsgd.hpp
+ * @author agent
+ *
+ * Distributed (stratified) stochastic gradient descent for matrix
+ * factorization, run in parallel with OpenMP.
+ */
+#ifndef __MLPACK_METHODS_REGULARIZED_SVD_DSGD_HPP
+#define __MLPACK_METHODS_REGULARIZED_SVD_DSGD_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * DSGD is a parallel version of stochastic gradient descent for matrix
+ * factorization problems, described in the following paper:
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *     title={{Large-Scale Matrix Factorization with Distributed Stochastic
+ *         Gradient Descent}},
+ *     author={Gemulla, R. and Nijkamp, E. and Haas, P.J. and Sismanis, Y.},
+ *     year={2011},
+ *     booktitle={Proceedings of the 17th ACM SIGKDD International Conference
+ *         on Knowledge Discovery and Data Mining (KDD '11)},
+ *     pages={69--77}
+ * }
+ * @endcode
+ *
+ * The users and the items are each split into B groups, so the ratings fall
+ * into B x B blocks.  The blocks (b, (b + s) mod B) for b = 0, ..., B - 1 share
+ * no user and no item, so for each s (a "sub-epoch"), the B blocks are
+ * processed in parallel, each by one thread, with SGD steps applied in place;
+ * no locking is needed.  Each pass over the data (an "epoch") consists of B
+ * sub-epochs, in random order if Shuffle() is true.
+ *
+ * DSGD can be used as the optimizer of RegularizedSVD:
+ *
+ * @code
+ * RegularizedSVD<DSGD> rSVD(iterations, alpha, lambda);
+ * rSVD.Apply(data, rank, u, v);
+ * @endcode
+ *
+ * The FunctionType must provide the interface of RegularizedSVDFunction:
+ * Dataset() (a coordinate list of ratings, one per column, with the user in
+ * the first row and the item in the second), NumUsers(), NumItems(),
+ * NumFunctions(), Evaluate(parameters), and Update(parameters, i, stepSize),
+ * which takes an SGD step on rating i and touches only the parameters of its
+ * user and item.
+ *
+ * @tparam FunctionType Matrix factorization objective to be minimized.
+ */
+template<typename FunctionType>
+class DSGD
+{
+ public:
+  /**
+   * Construct the DSGD optimizer with the given function and parameters.  As
+   * with the SGD optimizer, the maximum number of iterations is a number of
+   * ratings; DSGD always finishes the last epoch, so it takes
+   * ceil(maxIterations / NumFunctions()) passes over the data (at least one).
+   *
+   * @param function Function to be optimized (minimized).
+   * @param stepSize Step size for each rating.
+   * @param maxIterations Maximum number of ratings to process.
+   * @param blocks Number of groups of users and items; 0 means the number of
+   *     OpenMP threads.
+   * @param shuffle If true, the order of the sub-epochs is shuffled each
+   *     epoch.
+   */
+  DSGD(FunctionType& function,
+       const double stepSize = 0.01,
+       const size_t maxIterations = 100000,
+       const size_t blocks = 0,
+       const bool shuffle = true);
+
+  /**
+   * Optimize the function.  The given starting point will be modified to store
+   * the finishing point of the algorithm, and the final objective value is
+   * returned.
+   *
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  double Optimize(arma::mat& iterate);
+
+  //! Get the instantiated function to be optimized.
+  const FunctionType& Function() const { return function; }
+  //! Modify the instantiated function.
+  FunctionType& Function() { return function; }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of groups of users and items (0 means one per thread).
+  size_t Blocks() const { return blocks; }
+  //! Modify the number of groups of users and items (0 means one per thread).
+  size_t& Blocks() { return blocks; }
+
+  //! Get whether or not the sub-epochs are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the sub-epochs are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+ private:
+  //! The instantiated function.
+  FunctionType& function;
+
+  //! The step size for each rating.
+  double stepSize;
+
+  //! The maximum number of ratings to process.
+  size_t maxIterations;
+
+  //! The number of groups of users and items.
+  size_t blocks;
+
+  //! Whether or not to shuffle the sub-epochs.
+  bool shuffle;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+// Include implementation.
+#include "dsgd_impl.hpp"
+
+#endif
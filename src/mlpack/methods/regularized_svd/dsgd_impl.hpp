@@ -0,0 +1,103 @@
+/**
+ * @file dsgd_impl.hpp
+ * @author agent
+ *
+ * Implementation of the DSGD optimizer.
+ */
+#ifndef __MLPACK_METHODS_REGULARIZED_SVD_DSGD_IMPL_HPP
+#define __MLPACK_METHODS_REGULARIZED_SVD_DSGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "dsgd.hpp"
+
+namespace mlpack {
+namespace svd {
+
+template<typename FunctionType>
+DSGD<FunctionType>::DSGD(FunctionType& function,
+                         const double stepSize,
+                         const size_t maxIterations,
+                         const size_t blocks,
+                         const bool shuffle) :
+    function(function),
+    stepSize(stepSize),
+    maxIterations(maxIterations),
+    blocks(blocks),
+    shuffle(shuffle)
+{ /* Nothing to do. */ }
+
+template<typename FunctionType>
+double DSGD<FunctionType>::Optimize(arma::mat& iterate)
+{
+  const arma::mat& data = function.Dataset();
+  const size_t numFunctions = function.NumFunctions();
+  if (numFunctions == 0)
+    return function.Evaluate(iterate);
+
+  // Choose the number of groups; there can't be more groups than users or
+  // items.
+#ifdef _OPENMP
+  size_t groups = (blocks == 0) ? (size_t) omp_get_max_threads() : blocks;
+#else
+  size_t groups = (blocks == 0) ? 1 : blocks;
+#endif
+  groups = std::min(groups, std::min(function.NumUsers(),
+      function.NumItems()));
+  groups = std::max(groups, (size_t) 1);
+
+  // Sort the ratings by block with a counting sort, so that the ratings of
+  // block (i, j) are order[offsets[i * groups + j]] to
+  // order[offsets[i * groups + j + 1] - 1].
+  arma::Col<size_t> block(numFunctions);
+  std::vector<size_t> offsets(groups * groups + 1, 0);
+  for (size_t i = 0; i < numFunctions; ++i)
+  {
+    const size_t user = (size_t) data(0, i);
+    const size_t item = (size_t) data(1, i);
+    block[i] = (user % groups) * groups + (item % groups);
+    ++offsets[block[i] + 1];
+  }
+  for (size_t b = 0; b < groups * groups; ++b)
+    offsets[b + 1] += offsets[b];
+
+  std::vector<size_t> order(numFunctions);
+  std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < numFunctions; ++i)
+    order[next[block[i]]++] = i;
+
+  const size_t epochs = std::max((size_t) 1,
+      (maxIterations + numFunctions - 1) / numFunctions);
+  Log::Info << "DSGD: " << epochs << " epochs over " << groups << " x "
+      << groups << " blocks." << std::endl;
+
+  arma::Col<size_t> subEpochs(groups);
+  for (size_t s = 0; s < groups; ++s)
+    subEpochs[s] = s;
+
+  for (size_t epoch = 0; epoch < epochs; ++epoch)
+  {
+    if (shuffle)
+      subEpochs = arma::shuffle(subEpochs);
+
+    for (size_t s = 0; s < groups; ++s)
+    {
+      // The blocks (b, b + shift) don't share users or items.
+      const size_t shift = subEpochs[s];
+
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) groups; ++b)
+      {
+        const size_t stratum = b * groups + (b + shift) % groups;
+        for (size_t j = offsets[stratum]; j < offsets[stratum + 1]; ++j)
+          function.Update(iterate, order[j], stepSize);
+      }
+    }
+  }
+
+  return function.Evaluate(iterate);
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #include <mlpack/methods/cf/cf.hpp>
 
 #include "regularized_svd_function.hpp"
+#include "dsgd.hpp"
 
 namespace mlpack {
 namespace svd {
@@ -48,6 +49,14 @@ namespace svd {
  * // Use the Apply() method to get a factorization.
  * rSVD.Apply(data, rank, u, v);
  * @endcode
+ *
+ * For large datasets, the DSGD optimizer trains in parallel by splitting the
+ * ratings into blocks that share no users or items:
+ *
+ * @code
+ * RegularizedSVD<DSGD> parallelSVD(iterations, alpha, lambda);
+ * parallelSVD.Apply(data, rank, u, v);
+ * @endcode
  */
 
 template<
@@ -61,7 +70,8 @@ class RegularizedSVD
    * Constructor for Regularized SVD. Obtains the user and item matrices after
    * training on the passed data. The constructor initiates an object of class
    * RegularizedSVDFunction for optimization. It uses the SGD optimizer by
-   * default. The optimizer uses a template specialization of Optimize().
+   * default (which uses a template specialization of Optimize()); the DSGD
+   * optimizer can be used instead to train in parallel.
    *
    * @param iterations Number of optimization iterations.
    * @param alpha Learning rate for the SGD optimizer.
@@ -100,8 +110,8 @@ namespace mlpack {
 namespace cf {
 
 //! Factorizer traits of Regularized SVD.
-template<>
-class FactorizerTraits<mlpack::svd::RegularizedSVD<> >
+template<template<typename> class OptimizerType>
+class FactorizerTraits<mlpack::svd::RegularizedSVD<OptimizerType> >
 {
  public:
   //! Data provided to RegularizedSVD need not be cleaned.
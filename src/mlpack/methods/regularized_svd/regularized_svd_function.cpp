@@ -36,7 +36,8 @@ double RegularizedSVDFunction::Evaluate(const arma::mat& parameters) const
 
   double cost = 0.0;
 
-  for(size_t i = 0; i < data.n_cols; i++)
+  #pragma omp parallel for reduction(+:cost)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; i++)
   {
     // Indices for accessing the the correct parameter columns.
     const size_t user = data(0, i);
@@ -137,7 +138,7 @@ double SGD<mlpack::svd::RegularizedSVDFunction>::Optimize(arma::mat& parameters)
   for(size_t i = 0; i < numFunctions; i++)
     overallObjective += function.Evaluate(parameters, i);
 
-  const arma::mat data = function.Dataset();
+  const arma::mat& data = function.Dataset();
 
   // Now iterate!
   for(size_t i = 1; i != maxIterations; i++, currentFunction++)
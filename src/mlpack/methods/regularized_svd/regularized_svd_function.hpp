@@ -58,6 +58,42 @@ class RegularizedSVDFunction
   void Gradient(const arma::mat& parameters,
                 arma::mat& gradient) const;
 
+  /**
+   * Take an SGD step of the given size on the given training example, in
+   * place.  Only the parameter columns of the example's user and item are
+   * touched, so steps on examples that share neither a user nor an item may
+   * be taken at the same time.
+   *
+   * @param parameters Parameters(user/item matrices) of the decomposition.
+   * @param i Index of the training example to be used.
+   * @param stepSize Step size of the update.
+   */
+  void Update(arma::mat& parameters,
+              const size_t i,
+              const double stepSize) const
+  {
+    // Indices for accessing the the correct parameter columns.
+    const size_t user = data(0, i);
+    const size_t item = data(1, i) + numUsers;
+
+    double* u = parameters.colptr(user);
+    double* v = parameters.colptr(item);
+
+    // Prediction error for the example.
+    double prediction = 0.0;
+    for (size_t k = 0; k < rank; ++k)
+      prediction += u[k] * v[k];
+    const double ratingError = data(2, i) - prediction;
+
+    // Both columns are updated from their old values.
+    for (size_t k = 0; k < rank; ++k)
+    {
+      const double uk = u[k];
+      u[k] -= stepSize * (lambda * uk - ratingError * v[k]);
+      v[k] -= stepSize * (lambda * v[k] - ratingError * uk);
+    }
+  }
+
   //! Return the initial point for the optimization.
   const arma::mat& GetInitialPoint() const { return initialPoint; }
 
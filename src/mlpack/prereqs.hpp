@@ -46,6 +46,18 @@
   #define force_inline __forceinline
 #endif
 
+// Include OpenMP if the compiler was invoked with OpenMP support.  Visual
+// Studio's OpenMP implementation does not support unsigned loop indices, so
+// parallel loops should use omp_size_t as their index type.
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+#ifdef _WIN32
+  #define omp_size_t intmax_t
+#else
+  #define omp_size_t size_t
+#endif
+
 // We'll need the necessary boost::serialization features, as well as what we
 // use with mlpack.  In Boost 1.59 and newer, the BOOST_PFTO code is no longer
 // defined, but we still need to define it (as nothing) so that the mlpack
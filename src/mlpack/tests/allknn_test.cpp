@@ -1093,6 +1093,142 @@ BOOST_AUTO_TEST_CASE(KNNModelMonochromaticTest)
   }
 }
 
+/**
+ * Make sure that tree-based search on float data gives the same results as a
+ * naive search on the same float data, for both kd-trees and cover trees.
+ */
+BOOST_AUTO_TEST_CASE(FloatDataTest)
+{
+  arma::fmat dataset = arma::randu<arma::fmat>(20, 1000);
+
+  NeighborSearch<NearestNeighborSort, metric::EuclideanDistance, arma::fmat>
+      naive(dataset, true);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(10, naiveNeighbors, naiveDistances);
+
+  NeighborSearch<NearestNeighborSort, metric::EuclideanDistance, arma::fmat>
+      kdtree(dataset);
+  arma::Mat<size_t> kdNeighbors;
+  arma::mat kdDistances;
+  kdtree.Search(10, kdNeighbors, kdDistances);
+
+  NeighborSearch<NearestNeighborSort, metric::EuclideanDistance, arma::fmat,
+      tree::StandardCoverTree> covertree(dataset);
+  arma::Mat<size_t> coverNeighbors;
+  arma::mat coverDistances;
+  covertree.Search(10, coverNeighbors, coverDistances);
+
+  for (size_t i = 0; i < naiveNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(kdNeighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(kdDistances[i], naiveDistances[i], 1e-5);
+    BOOST_REQUIRE_EQUAL(coverNeighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(coverDistances[i], naiveDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Approximate search with a relative error epsilon should return distances that
+ * are within a factor of (1 + epsilon) of the true distances, for each of the
+ * search modes and a few tree types.
+ */
+BOOST_AUTO_TEST_CASE(ApproximateSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(5, 300);
+
+  AllkNN naive(dataset, true);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  const double epsilons[] = { 0.0, 0.05, 0.2, 1.0 };
+  for (size_t e = 0; e < 4; ++e)
+  {
+    const double epsilon = epsilons[e];
+
+    AllkNN kdDual(dataset, false, false, EuclideanDistance(), epsilon);
+    AllkNN kdSingle(dataset, false, true, EuclideanDistance(), epsilon);
+    NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+        StandardCoverTree> coverDual(dataset, false, false,
+        EuclideanDistance(), epsilon);
+
+    arma::Mat<size_t> neighbors[3];
+    arma::mat distances[3];
+    kdDual.Search(querySet, 5, neighbors[0], distances[0]);
+    kdSingle.Search(querySet, 5, neighbors[1], distances[1]);
+    coverDual.Search(querySet, 5, neighbors[2], distances[2]);
+
+    for (size_t m = 0; m < 3; ++m)
+    {
+      for (size_t i = 0; i < naiveDistances.n_elem; ++i)
+      {
+        // The distance must be correct for the returned neighbor...
+        const size_t query = i / naiveDistances.n_rows;
+        BOOST_REQUIRE_CLOSE(distances[m][i], arma::norm(querySet.col(query) -
+            dataset.col(neighbors[m][i]), 2), 1e-5);
+
+        // ...and within the error bound of the true distance.
+        BOOST_REQUIRE_GE(distances[m][i], naiveDistances[i] * (1 - 1e-10));
+        BOOST_REQUIRE_LE(distances[m][i],
+            (1 + epsilon) * naiveDistances[i] * (1 + 1e-10));
+      }
+    }
+  }
+}
+
+/**
+ * Negative values of epsilon should be rejected.
+ */
+BOOST_AUTO_TEST_CASE(NegativeEpsilonTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 100);
+  AllkNN knn(dataset, false, false, EuclideanDistance(), -0.5);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  BOOST_REQUIRE_THROW(knn.Search(3, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that searches with flattened kd-trees give the same results as the
+ * naive method, in both single-tree and dual-tree mode.
+ */
+BOOST_AUTO_TEST_CASE(FlattenedTreeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 2000);
+
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  TreeType bfsTree(dataset);
+  bfsTree.Flatten(BREADTH_FIRST_LAYOUT);
+  TreeType vebTree(dataset);
+  vebTree.Flatten(VAN_EMDE_BOAS_LAYOUT);
+
+  // The trees are identical, so the data is in the same order in each.
+  AllkNN naive(bfsTree.Dataset(), true);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  AllkNN bfsSearch(&bfsTree);
+  AllkNN vebSearch(&vebTree, true);
+  arma::Mat<size_t> bfsNeighbors, vebNeighbors;
+  arma::mat bfsDistances, vebDistances;
+  bfsSearch.Search(5, bfsNeighbors, bfsDistances);
+  vebSearch.Search(5, vebNeighbors, vebDistances);
+
+  for (size_t i = 0; i < naiveNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(bfsNeighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(bfsDistances[i], naiveDistances[i], 1e-5);
+    BOOST_REQUIRE_EQUAL(vebNeighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(vebDistances[i], naiveDistances[i], 1e-5);
+  }
+}
+
 /**
  * If we search twice with the same reference tree, the bounds need to be reset
  * before the second search.  This test ensures that that happens, by making
@@ -1142,4 +1278,105 @@ BOOST_AUTO_TEST_CASE(NeighborPtrDeleteTest)
   BOOST_REQUIRE_EQUAL(distances.n_rows, 3);
 }
 
+/**
+ * Insert points into and remove points from the reference tree of a cover tree
+ * search, and make sure the results are the same as naive search on the
+ * remaining points.
+ */
+BOOST_AUTO_TEST_CASE(DynamicReferenceSetTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 600);
+  arma::mat newPoints = arma::randu<arma::mat>(4, 100);
+  arma::mat querySet = arma::randu<arma::mat>(4, 200);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> CoverTreeSearch;
+  CoverTreeSearch dualSearch(dataset);
+  CoverTreeSearch singleSearch(dataset, false, true);
+  CoverTreeSearch* searches[2] = { &dualSearch, &singleSearch };
+
+  for (size_t s = 0; s < 2; ++s)
+  {
+    for (size_t i = 0; i < 100; ++i)
+      BOOST_REQUIRE_EQUAL(searches[s]->InsertReferencePoint(newPoints.col(i)),
+          600 + i);
+
+    // This includes the root point.
+    for (size_t i = 0; i < 150; ++i)
+      BOOST_REQUIRE_EQUAL(searches[s]->DeleteReferencePoint(i), true);
+
+    BOOST_REQUIRE_EQUAL(searches[s]->DeleteReferencePoint(0), false);
+    BOOST_REQUIRE_EQUAL(searches[s]->ReferenceSet().n_cols, 700);
+  }
+
+  // The points that are left are 150 through 699.
+  arma::mat remaining = arma::join_rows(dataset.cols(150, 599), newPoints);
+  AllkNN naive(remaining, true);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  for (size_t s = 0; s < 2; ++s)
+  {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    searches[s]->Search(querySet, 5, neighbors, distances);
+
+    for (size_t i = 0; i < naiveNeighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i] + 150);
+      BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+    }
+  }
+
+  // The reference set can't be changed in naive mode.
+  CoverTreeSearch naiveSearch(dataset, true);
+  BOOST_REQUIRE_THROW(naiveSearch.InsertReferencePoint(newPoints.col(0)),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(naiveSearch.DeleteReferencePoint(0),
+      std::invalid_argument);
+}
+
+/**
+ * Insert points into and remove points from a cover tree NSModel with a random
+ * basis, and make sure the results match naive search; models with other tree
+ * types can't be updated in place.
+ */
+BOOST_AUTO_TEST_CASE(NSModelInsertDeleteTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 300);
+  arma::mat newPoints = arma::randu<arma::mat>(3, 20);
+  arma::mat querySet = arma::randu<arma::mat>(3, 50);
+
+  NSModel<NearestNeighborSort> model(NSModel<NearestNeighborSort>::COVER_TREE,
+      true);
+  model.BuildModel(arma::mat(dataset), 20, false, false);
+
+  for (size_t i = 0; i < 20; ++i)
+    BOOST_REQUIRE_EQUAL(model.Insert(newPoints.col(i)), 300 + i);
+  for (size_t i = 0; i < 10; ++i)
+    BOOST_REQUIRE_EQUAL(model.Delete(i), true);
+
+  // The points that are left are 10 through 319.
+  arma::mat remaining = arma::join_rows(dataset.cols(10, 299), newPoints);
+  AllkNN naive(remaining, true);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 3, naiveNeighbors, naiveDistances);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  model.Search(arma::mat(querySet), 3, neighbors, distances);
+  for (size_t i = 0; i < naiveNeighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i] + 10);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+
+  NSModel<NearestNeighborSort> kdModel;
+  kdModel.BuildModel(arma::mat(dataset), 20, false, false);
+  BOOST_REQUIRE_THROW(kdModel.Insert(newPoints.col(0)), std::invalid_argument);
+  BOOST_REQUIRE_THROW(kdModel.Delete(0), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
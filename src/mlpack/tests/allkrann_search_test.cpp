@@ -698,4 +698,48 @@ BOOST_AUTO_TEST_CASE(RAModelTest)
   }
 }
 
+// Make sure RAUtil::ObtainRandomSubset() returns distinct points from the range,
+// in random order, both when few and when most of the points are sampled.
+BOOST_AUTO_TEST_CASE(RandomSubsetTest)
+{
+  const size_t range = 50;
+  const size_t trials = 10000;
+  const size_t sizes[] = { 3, 40 };
+
+  for (size_t s = 0; s < 2; ++s)
+  {
+    // Count how often each point is sampled, and how often it is first.
+    arma::vec counts(range, arma::fill::zeros);
+    arma::vec firstCounts(range, arma::fill::zeros);
+
+    arma::Col<size_t> samples;
+    for (size_t t = 0; t < trials; ++t)
+    {
+      RAUtil::ObtainRandomSubset(sizes[s], range, samples);
+      BOOST_REQUIRE_EQUAL(samples.n_elem, sizes[s]);
+
+      arma::Col<size_t> sorted = arma::sort(samples);
+      for (size_t i = 0; i < sorted.n_elem; ++i)
+      {
+        BOOST_REQUIRE_LT(sorted[i], range);
+        if (i > 0)
+          BOOST_REQUIRE_NE(sorted[i], sorted[i - 1]);
+
+        counts[sorted[i]]++;
+      }
+
+      firstCounts[samples[0]]++;
+    }
+
+    // Every point should be sampled (and be first) about equally often.
+    const double expected = (double) trials * sizes[s] / range;
+    const double expectedFirst = (double) trials / range;
+    for (size_t i = 0; i < range; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(counts[i], expected, 20.0);
+      BOOST_REQUIRE_CLOSE(firstCounts[i], expectedFirst, 50.0);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
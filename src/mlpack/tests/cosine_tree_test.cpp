@@ -177,4 +177,43 @@ BOOST_AUTO_TEST_CASE(CosineTreeModifiedGramSchmidt)
   }
 }
 
+/**
+ * The basis built by the CosineTree should be orthonormal, and should capture
+ * most of a low-rank matrix.
+ */
+BOOST_AUTO_TEST_CASE(CosineTreeOrthonormalBasis)
+{
+  // Make a random dataset of rank 10, plus a little noise.
+  const size_t numRows = 100;
+  const size_t numCols = 200;
+  arma::mat data = arma::randu(numRows, 10) * arma::randu(10, numCols) +
+      0.001 * arma::randu(numRows, numCols);
+
+  CosineTree ctree(data, 0.01, 0.1);
+  arma::mat basis;
+  ctree.GetFinalBasis(basis);
+
+  BOOST_REQUIRE_EQUAL(basis.n_rows, numRows);
+  BOOST_REQUIRE_GT(basis.n_cols, 1);
+
+  // Each basis vector is either normalized, or zero if its centroid was
+  // already in the span of the others.
+  const arma::mat gram = basis.t() * basis;
+  for (size_t i = 0; i < gram.n_rows; ++i)
+  {
+    for (size_t j = 0; j < gram.n_cols; ++j)
+    {
+      if (i == j && gram(i, i) > 0.5)
+        BOOST_REQUIRE_CLOSE(gram(i, j), 1.0, 1e-5);
+      else
+        BOOST_REQUIRE_SMALL(gram(i, j), 1e-8);
+    }
+  }
+
+  // The projection onto the basis should keep almost all of the matrix.
+  const arma::mat projected = basis * (basis.t() * data);
+  BOOST_REQUIRE_LT(arma::norm(data - projected, "fro"),
+      0.2 * arma::norm(data, "fro"));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
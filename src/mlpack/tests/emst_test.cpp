@@ -275,4 +275,51 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
 
 }
 
+/**
+ * Compute the MST of a dataset large enough that the statistics are reset in
+ * parallel (if OpenMP is available), with a kd-tree and a cover tree, and make
+ * sure the results are the same as the results with a single thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelVsSerialTest)
+{
+  arma::mat dataset(3, 15000);
+  dataset.randu();
+
+  DualTreeBoruvka<> kd(dataset);
+  DualTreeBoruvka<EuclideanDistance, arma::mat, StandardCoverTree>
+      ct(dataset);
+
+  arma::mat kdResults;
+  arma::mat coverResults;
+  kd.ComputeMST(kdResults);
+  ct.ComputeMST(coverResults);
+
+  // Now compute the MST with one thread.
+#ifdef _OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  DualTreeBoruvka<> serial(dataset);
+  arma::mat serialResults;
+  serial.ComputeMST(serialResults);
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  BOOST_REQUIRE_EQUAL(kdResults.n_cols, dataset.n_cols - 1);
+  BOOST_REQUIRE_EQUAL(coverResults.n_cols, dataset.n_cols - 1);
+  BOOST_REQUIRE_EQUAL(serialResults.n_cols, dataset.n_cols - 1);
+
+  for (size_t i = 0; i < serialResults.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(kdResults(0, i), serialResults(0, i));
+    BOOST_REQUIRE_EQUAL(kdResults(1, i), serialResults(1, i));
+    BOOST_REQUIRE_CLOSE(kdResults(2, i), serialResults(2, i), 1e-5);
+
+    BOOST_REQUIRE_EQUAL(coverResults(0, i), serialResults(0, i));
+    BOOST_REQUIRE_EQUAL(coverResults(1, i), serialResults(1, i));
+    BOOST_REQUIRE_CLOSE(coverResults(2, i), serialResults(2, i), 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
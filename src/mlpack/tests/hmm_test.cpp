@@ -5,6 +5,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/hmm/hmm.hpp>
+#include <mlpack/methods/hmm/online_filter.hpp>
 #include <mlpack/methods/gmm/gmm.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -1154,5 +1155,195 @@ BOOST_AUTO_TEST_CASE(DiscreteHMMLoadSaveTest)
           hmm2.Emission()[j].Probabilities()[i], 1e-3);
 }
 
+/**
+ * GaussianDistribution evaluates the emission probabilities of a whole sequence
+ * at once, while GMM evaluates them one observation at a time.  Make sure that
+ * a Gaussian HMM and the equivalent HMM with one-component GMMs give the same
+ * results.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMBatchEmissionTest)
+{
+  std::vector<GaussianDistribution> gaussians;
+  gaussians.push_back(GaussianDistribution("0.0 1.0", "1.0 0.3; 0.3 1.2"));
+  gaussians.push_back(GaussianDistribution("3.0 -1.0", "0.8 0.0; 0.0 0.6"));
+  gaussians.push_back(GaussianDistribution("-2.0 4.0", "1.5 -0.2; -0.2 1.0"));
+
+  std::vector<GMM> gmms(3, GMM(1, 2));
+  for (size_t i = 0; i < 3; ++i)
+  {
+    gmms[i].Weights() = arma::vec("1.0");
+    gmms[i].Component(0) = gaussians[i];
+  }
+
+  arma::vec initial("0.5 0.3 0.2");
+  arma::mat transition("0.6 0.2 0.3;"
+                       "0.3 0.7 0.1;"
+                       "0.1 0.1 0.6");
+
+  HMM<GaussianDistribution> gaussianHMM(initial, transition, gaussians);
+  HMM<GMM> gmmHMM(initial, transition, gmms);
+
+  arma::mat dataSeq;
+  arma::Row<size_t> stateSeq;
+  gaussianHMM.Generate(500, dataSeq, stateSeq);
+
+  arma::mat gaussianStateProb, gmmStateProb;
+  const double gaussianLoglik = gaussianHMM.Estimate(dataSeq,
+      gaussianStateProb);
+  const double gmmLoglik = gmmHMM.Estimate(dataSeq, gmmStateProb);
+
+  BOOST_REQUIRE_CLOSE(gaussianLoglik, gmmLoglik, 1e-5);
+  BOOST_REQUIRE_CLOSE(gaussianHMM.LogLikelihood(dataSeq),
+      gmmHMM.LogLikelihood(dataSeq), 1e-5);
+  for (size_t i = 0; i < gaussianStateProb.n_elem; ++i)
+  {
+    if (std::abs(gmmStateProb[i]) < 1e-10)
+      BOOST_REQUIRE_SMALL(gaussianStateProb[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(gaussianStateProb[i], gmmStateProb[i], 1e-5);
+  }
+
+  arma::Row<size_t> gaussianPrediction, gmmPrediction;
+  gaussianHMM.Predict(dataSeq, gaussianPrediction);
+  gmmHMM.Predict(dataSeq, gmmPrediction);
+  for (size_t t = 0; t < dataSeq.n_cols; ++t)
+    BOOST_REQUIRE_EQUAL(gaussianPrediction[t], gmmPrediction[t]);
+}
+
+/**
+ * Make sure the checkpointed two-argument Estimate() gives the same results as
+ * the full forward-backward algorithm, and that observations far from every
+ * state do not make the log-likelihood underflow.
+ */
+BOOST_AUTO_TEST_CASE(CheckpointedEstimateTest)
+{
+  std::vector<GaussianDistribution> gaussians;
+  gaussians.push_back(GaussianDistribution("0.0 1.0", "1.0 0.3; 0.3 1.2"));
+  gaussians.push_back(GaussianDistribution("3.0 -1.0", "0.8 0.0; 0.0 0.6"));
+  gaussians.push_back(GaussianDistribution("-2.0 4.0", "1.5 -0.2; -0.2 1.0"));
+
+  arma::vec initial("0.5 0.3 0.2");
+  arma::mat transition("0.6 0.2 0.3;"
+                       "0.3 0.7 0.1;"
+                       "0.1 0.1 0.6");
+  HMM<GaussianDistribution> hmm(initial, transition, gaussians);
+
+  arma::mat dataSeq;
+  arma::Row<size_t> stateSeq;
+  hmm.Generate(1000, dataSeq, stateSeq);
+
+  arma::mat stateProb, fullStateProb, forwardProb, backwardProb;
+  arma::vec scales;
+  const double loglik = hmm.Estimate(dataSeq, stateProb);
+  const double fullLoglik = hmm.Estimate(dataSeq, fullStateProb, forwardProb,
+      backwardProb, scales);
+
+  BOOST_REQUIRE_CLOSE(loglik, fullLoglik, 1e-5);
+  BOOST_REQUIRE_CLOSE(hmm.LogLikelihood(dataSeq), fullLoglik, 1e-5);
+  BOOST_REQUIRE_CLOSE(accu(log(scales)), fullLoglik, 1e-5);
+  BOOST_REQUIRE_EQUAL(stateProb.n_rows, fullStateProb.n_rows);
+  BOOST_REQUIRE_EQUAL(stateProb.n_cols, fullStateProb.n_cols);
+  for (size_t i = 0; i < stateProb.n_elem; ++i)
+  {
+    if (std::abs(fullStateProb[i]) < 1e-10)
+      BOOST_REQUIRE_SMALL(stateProb[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(stateProb[i], fullStateProb[i], 1e-5);
+  }
+
+  // An observation very far from every state has an emission probability of
+  // zero in double precision, but its log-likelihood is still finite.
+  dataSeq(0, 500) = 1000.0;
+  const double farLoglik = hmm.LogLikelihood(dataSeq);
+  BOOST_REQUIRE(std::isfinite(farLoglik));
+  BOOST_REQUIRE_CLOSE(hmm.Estimate(dataSeq, stateProb), farLoglik, 1e-5);
+  BOOST_REQUIRE(stateProb.is_finite());
+
+  arma::Row<size_t> prediction;
+  BOOST_REQUIRE(std::isfinite(hmm.Predict(dataSeq, prediction)));
+}
+
+/**
+ * Make sure the OnlineFilter gives the same results as the forward algorithm,
+ * no matter how the observations are split into blocks.
+ */
+BOOST_AUTO_TEST_CASE(OnlineFilterTest)
+{
+  std::vector<GaussianDistribution> gaussians;
+  gaussians.push_back(GaussianDistribution("0.0 1.0", "1.0 0.3; 0.3 1.2"));
+  gaussians.push_back(GaussianDistribution("3.0 -1.0", "0.8 0.0; 0.0 0.6"));
+  gaussians.push_back(GaussianDistribution("-2.0 4.0", "1.5 -0.2; -0.2 1.0"));
+
+  arma::vec initial("0.5 0.3 0.2");
+  arma::mat transition("0.6 0.2 0.3;"
+                       "0.3 0.7 0.1;"
+                       "0.1 0.1 0.6");
+  HMM<GaussianDistribution> hmm(initial, transition, gaussians);
+
+  arma::mat dataSeq;
+  arma::Row<size_t> stateSeq;
+  hmm.Generate(300, dataSeq, stateSeq);
+
+  arma::mat stateProb, forwardProb, backwardProb;
+  arma::vec scales;
+  hmm.Estimate(dataSeq, stateProb, forwardProb, backwardProb, scales);
+
+  arma::mat filterSeq;
+  hmm.Filter(dataSeq, filterSeq);
+
+  OnlineFilter<GaussianDistribution> filter(hmm);
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    filter.Reset();
+    BOOST_REQUIRE_EQUAL(filter.Steps(), 0);
+
+    // Feed the observations one at a time in the first trial, and in blocks of
+    // increasing size in the second.
+    size_t t = 0;
+    size_t blockSize = 1;
+    while (t < dataSeq.n_cols)
+    {
+      const size_t end = std::min(t + blockSize, (size_t) dataSeq.n_cols);
+      const double blockLoglik = filter.Update(dataSeq.cols(t, end - 1));
+      BOOST_REQUIRE_CLOSE(blockLoglik, accu(log(scales.subvec(t, end - 1))),
+          1e-5);
+      t = end;
+
+      BOOST_REQUIRE_EQUAL(filter.Steps(), t);
+      BOOST_REQUIRE_CLOSE(filter.LogLikelihood(),
+          accu(log(scales.subvec(0, t - 1))), 1e-5);
+      for (size_t i = 0; i < forwardProb.n_rows; ++i)
+      {
+        if (forwardProb(i, t - 1) < 1e-10)
+          BOOST_REQUIRE_SMALL(filter.StateProbabilities()[i], 1e-10);
+        else
+          BOOST_REQUIRE_CLOSE(filter.StateProbabilities()[i],
+              forwardProb(i, t - 1), 1e-5);
+      }
+
+      arma::vec expectedEmission;
+      filter.ExpectedEmission(0, expectedEmission);
+      for (size_t i = 0; i < expectedEmission.n_elem; ++i)
+      {
+        if (std::abs(filterSeq(i, t - 1)) < 1e-5)
+          BOOST_REQUIRE_SMALL(expectedEmission[i], 1e-5);
+        else
+          BOOST_REQUIRE_CLOSE(expectedEmission[i], filterSeq(i, t - 1), 1e-5);
+      }
+
+      if (trial == 1)
+        ++blockSize;
+    }
+
+    BOOST_REQUIRE_CLOSE(filter.LogLikelihood(), hmm.LogLikelihood(dataSeq),
+        1e-5);
+
+    // The predicted state distribution must still sum to one.
+    arma::vec predictedProb;
+    filter.Predict(3, predictedProb);
+    BOOST_REQUIRE_CLOSE(accu(predictedProb), 1.0, 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
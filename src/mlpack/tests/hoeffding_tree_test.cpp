@@ -8,6 +8,7 @@
 #include <mlpack/methods/hoeffding_trees/gini_impurity.hpp>
 #include <mlpack/methods/hoeffding_trees/information_gain.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
+#include <mlpack/methods/hoeffding_trees/hoeffding_forest.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_categorical_split.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
 
@@ -1152,4 +1153,157 @@ BOOST_AUTO_TEST_CASE(MultipleSerializationTest)
   }
 }
 
+/**
+ * Generate the dataset used by the HoeffdingForest tests: three classes, three
+ * numeric features, and one categorical feature.
+ */
+void ForestDataset(arma::mat& dataset,
+                   arma::Row<size_t>& labels,
+                   data::DatasetInfo& info)
+{
+  dataset.set_size(4, 9000);
+  labels.set_size(9000);
+  info = data::DatasetInfo(4);
+  info.MapString("0", 3);
+  info.MapString("1", 3);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    dataset(3, i) = 0.0;
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    dataset(3, i + 1) = 1.0;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    dataset(3, i + 2) = 0.0;
+    labels[i + 2] = 1;
+  }
+}
+
+/**
+ * Make sure a HoeffdingForest learns an easy dataset, and that training on a
+ * batch gives the same ensemble as training on one point at a time (the
+ * Poisson weights of each tree come from its own generator, so the order in
+ * which the trees are trained doesn't matter).
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  data::DatasetInfo info;
+  ForestDataset(dataset, labels, info);
+
+  typedef HoeffdingForest<GiniImpurity, BinaryDoubleNumericSplit> ForestType;
+  mlpack::math::RandomSeed(12);
+  ForestType batchForest(dataset, info, labels, 3, 5);
+  mlpack::math::RandomSeed(12);
+  ForestType streamForest(info, 3, 5);
+  for (size_t i = 0; i < 9000; ++i)
+    streamForest.Train(dataset.col(i), labels[i]);
+
+  BOOST_REQUIRE_EQUAL(batchForest.NumTrees(), 5);
+  BOOST_REQUIRE_EQUAL(streamForest.NumTrees(), 5);
+
+  arma::Row<size_t> batchPredictions, streamPredictions;
+  arma::rowvec probabilities;
+  batchForest.Classify(dataset, batchPredictions, probabilities);
+  streamForest.Classify(dataset, streamPredictions);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(batchPredictions[i], streamPredictions[i]);
+    BOOST_REQUIRE_EQUAL(batchPredictions[i],
+        batchForest.Classify(dataset.col(i)));
+    BOOST_REQUIRE_GT(probabilities[i], 0.0);
+    BOOST_REQUIRE_LE(probabilities[i], 1.0 + 1e-5);
+    if (batchPredictions[i] == labels[i])
+      ++correct;
+  }
+
+  // Each tree splits, so the ensemble should do much better than chance.
+  for (size_t t = 0; t < batchForest.NumTrees(); ++t)
+    BOOST_REQUIRE_GT(batchForest.Tree(t).NumChildren(), 0);
+  BOOST_REQUIRE_GT(correct, 6000);
+}
+
+/**
+ * Make sure a serialized HoeffdingForest gives the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestSerializationTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  data::DatasetInfo info;
+  ForestDataset(dataset, labels, info);
+
+  HoeffdingForest<> forest(dataset, info, labels, 3, 4);
+  HoeffdingForest<> xmlForest(info, 2, 1);
+  HoeffdingForest<> textForest(info, 2, 1);
+  HoeffdingForest<> binaryForest(info, 2, 1);
+
+  SerializeObjectAll(forest, xmlForest, textForest, binaryForest);
+
+  BOOST_REQUIRE_EQUAL(xmlForest.NumTrees(), 4);
+  BOOST_REQUIRE_EQUAL(textForest.NumTrees(), 4);
+  BOOST_REQUIRE_EQUAL(binaryForest.NumTrees(), 4);
+
+  arma::Row<size_t> predictions, xmlPredictions, textPredictions,
+      binaryPredictions;
+  forest.Classify(dataset, predictions);
+  xmlForest.Classify(dataset, xmlPredictions);
+  textForest.Classify(dataset, textPredictions);
+  binaryForest.Classify(dataset, binaryPredictions);
+
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], xmlPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], textPredictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], binaryPredictions[i]);
+  }
+}
+
+/**
+ * Make sure copy and move assignment of a HoeffdingForest give an ensemble with
+ * the same predictions, and that the copy owns its own trees.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestAssignmentTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  data::DatasetInfo info;
+  ForestDataset(dataset, labels, info);
+
+  HoeffdingForest<> forest(dataset, info, labels, 3, 4);
+  arma::Row<size_t> predictions;
+  forest.Classify(dataset, predictions);
+
+  HoeffdingForest<> copiedForest(info, 2, 1);
+  copiedForest = forest;
+  BOOST_REQUIRE_EQUAL(copiedForest.NumTrees(), 4);
+  BOOST_REQUIRE_EQUAL(copiedForest.NumClasses(), 3);
+  BOOST_REQUIRE_NE(&copiedForest.Tree(0), &forest.Tree(0));
+
+  HoeffdingForest<> movedForest(info, 2, 1);
+  movedForest = std::move(copiedForest);
+  BOOST_REQUIRE_EQUAL(movedForest.NumTrees(), 4);
+
+  // Self-assignment must not lose the trees.
+  movedForest = movedForest;
+  BOOST_REQUIRE_EQUAL(movedForest.NumTrees(), 4);
+
+  arma::Row<size_t> movedPredictions;
+  movedForest.Classify(dataset, movedPredictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], movedPredictions[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
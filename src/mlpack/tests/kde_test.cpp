@@ -0,0 +1,166 @@
+/**
+ * @file kde_test.cpp
+ * @author agent
+ *
+ * Tests for the KDE class.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+#include <boost/test/unit_test.hpp>
+#include "old_boost_test_definitions.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kde;
+using namespace mlpack::kernel;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(KDETest);
+
+// Compute the exact densities by brute force.
+template<typename KernelType>
+void ExactDensities(const arma::mat& referenceSet,
+                    const arma::mat& querySet,
+                    KernelType& kernel,
+                    arma::vec& densities)
+{
+  densities.zeros(querySet.n_cols);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+      densities[i] += kernel.Evaluate(EuclideanDistance::Evaluate(
+          querySet.col(i), referenceSet.col(j)));
+
+  densities /= (referenceSet.n_cols * kernel.Normalizer(referenceSet.n_rows));
+}
+
+/**
+ * Make sure that the naive computation gives exactly the brute-force result.
+ */
+BOOST_AUTO_TEST_CASE(NaiveExactTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(2, 100);
+  arma::mat querySet = arma::randu<arma::mat>(2, 30);
+
+  GaussianKernel kernel(0.3);
+  arma::vec exact;
+  ExactDensities(referenceSet, querySet, kernel, exact);
+
+  KDE<> kde(0.0, 0.0, kernel, true);
+  kde.Train(referenceSet);
+
+  arma::vec estimations;
+  kde.Evaluate(querySet, estimations);
+
+  BOOST_REQUIRE_EQUAL(estimations.n_elem, 30);
+  for (size_t i = 0; i < 30; ++i)
+    BOOST_REQUIRE_CLOSE(estimations[i], exact[i], 1e-5);
+}
+
+/**
+ * Make sure that dual-tree and single-tree estimates are within the relative
+ * error tolerance of the exact densities, and that the trees are doing some
+ * pruning.
+ */
+BOOST_AUTO_TEST_CASE(TreeVsNaiveGaussianTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  GaussianKernel kernel(0.2);
+  arma::vec exact;
+  ExactDensities(referenceSet, querySet, kernel, exact);
+
+  const double relError = 0.05;
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    KDE<> kde(relError, 0.0, kernel, false, (mode == 1));
+    kde.Train(referenceSet);
+
+    arma::vec estimations;
+    kde.Evaluate(querySet, estimations);
+
+    BOOST_REQUIRE_EQUAL(estimations.n_elem, 200);
+    for (size_t i = 0; i < 200; ++i)
+      BOOST_REQUIRE_LE(std::abs(estimations[i] - exact[i]),
+          relError * exact[i] + 1e-10);
+
+    BOOST_REQUIRE_LT(kde.BaseCases(), 1000 * 200);
+  }
+}
+
+/**
+ * Test the monochromatic evaluation with the Epanechnikov kernel and a ball
+ * tree, which must return the estimates in the original order of the points.
+ * BallTree is a BinarySpaceTree with an HRectBound and a midpoint split, so this
+ * also checks that KDE does not depend on the kd-tree's split rule.
+ */
+BOOST_AUTO_TEST_CASE(MonochromaticEpanechnikovBallTreeTest)
+{
+  arma::mat referenceSet = arma::randu<arma::mat>(2, 500);
+
+  EpanechnikovKernel kernel(0.3);
+  arma::vec exact;
+  ExactDensities(referenceSet, referenceSet, kernel, exact);
+
+  const double relError = 0.02;
+  const double absError = 1e-3;
+  KDE<EpanechnikovKernel, EuclideanDistance, arma::mat, BallTree>
+      kde(relError, absError, kernel);
+  kde.Train(referenceSet);
+
+  arma::vec estimations;
+  kde.Evaluate(estimations);
+
+  BOOST_REQUIRE_EQUAL(estimations.n_elem, 500);
+  for (size_t i = 0; i < 500; ++i)
+    BOOST_REQUIRE_LE(std::abs(estimations[i] - exact[i]),
+        relError * exact[i] + absError + 1e-10);
+}
+
+/**
+ * With Monte Carlo approximations on a large, dense dataset, the estimates
+ * should still be reasonable.  The guarantee is only probabilistic, so we check
+ * a looser tolerance on the average error.
+ */
+BOOST_AUTO_TEST_CASE(MonteCarloTest)
+{
+  arma::mat referenceSet = arma::randn<arma::mat>(2, 5000);
+  arma::mat querySet = arma::randn<arma::mat>(2, 100);
+
+  GaussianKernel kernel(1.0);
+  arma::vec exact;
+  ExactDensities(referenceSet, querySet, kernel, exact);
+
+  KDE<> kde(0.05, 0.0, kernel);
+  kde.MonteCarlo() = true;
+  kde.MCProbability() = 0.95;
+  kde.MCInitialSampleSize() = 50;
+  kde.Train(referenceSet);
+
+  arma::vec estimations;
+  kde.Evaluate(querySet, estimations);
+
+  BOOST_REQUIRE_EQUAL(estimations.n_elem, 100);
+  const double meanRelError = arma::mean(arma::abs(estimations - exact) /
+      exact);
+  BOOST_REQUIRE_LT(meanRelError, 0.1);
+}
+
+/**
+ * Make sure mismatched dimensions and an untrained model are reported.
+ */
+BOOST_AUTO_TEST_CASE(InvalidEvaluateTest)
+{
+  KDE<> kde;
+  arma::vec estimations;
+  BOOST_REQUIRE_THROW(kde.Evaluate(estimations), std::invalid_argument);
+
+  arma::mat referenceSet = arma::randu<arma::mat>(3, 50);
+  arma::mat querySet = arma::randu<arma::mat>(2, 10);
+  kde.Train(referenceSet);
+  BOOST_REQUIRE_THROW(kde.Evaluate(querySet, estimations),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -590,4 +590,45 @@ BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateTest)
   BOOST_REQUIRE_CLOSE(p.Evaluate(b, a), 11.0, 1e-5);
 }
 
+// Make sure the batch evaluation of the p-spectrum kernel gives the same
+// results as evaluating each pair of strings, even across datasets.
+BOOST_AUTO_TEST_CASE(PSpectrumStringBatchEvaluateTest)
+{
+  std::vector<std::vector<std::string> > datasets(2);
+  datasets[0].push_back("hello");
+  datasets[0].push_back("jello");
+  datasets[0].push_back("mellow");
+  datasets[1].push_back("mellow jello");
+  datasets[1].push_back("yellow fellow");
+  datasets[1].push_back("xyz");
+
+  PSpectrumStringKernel p(datasets, 3);
+
+  // The distinct substrings are ell, fel, hel, jel, llo, low, mel, xyz, yel.
+  BOOST_REQUIRE_EQUAL(p.NumSubstrings(), 9);
+
+  arma::mat b("0 0 0 1 1 1;"
+              "0 1 2 0 1 2");
+
+  for (size_t i = 0; i < b.n_cols; ++i)
+  {
+    arma::vec a = b.col(i);
+    arma::vec results;
+    p.Evaluate(a, b, results);
+
+    BOOST_REQUIRE_EQUAL(results.n_elem, b.n_cols);
+    for (size_t j = 0; j < b.n_cols; ++j)
+    {
+      arma::vec bCol = b.col(j);
+      BOOST_REQUIRE_CLOSE(results[j] + 1.0, p.Evaluate(a, bCol) + 1.0, 1e-5);
+    }
+  }
+
+  // "mellow jello" against "yellow fellow": ell and llo appear twice in each,
+  // and low appears once in the first and twice in the second.
+  arma::vec a("1 0");
+  arma::vec c("1 1");
+  BOOST_REQUIRE_CLOSE(p.Evaluate(a, c), 10.0, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
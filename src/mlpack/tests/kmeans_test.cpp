@@ -662,4 +662,64 @@ BOOST_AUTO_TEST_CASE(DTNNCoverTreeTest)
   }
 }
 
+/**
+ * Make sure that all of the Lloyd step types work with float data, and that
+ * they give the same results as the naive algorithm on the same data.
+ */
+BOOST_AUTO_TEST_CASE(FloatDataTest)
+{
+  arma::fmat dataset = arma::randu<arma::fmat>(10, 1000);
+
+  const size_t k = 10;
+  arma::mat centroids(10, k);
+  centroids.randu();
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      NaiveKMeans, arma::fmat> naive;
+  arma::Row<size_t> assignments;
+  arma::mat naiveCentroids(centroids);
+  naive.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      ElkanKMeans, arma::fmat> elkan;
+  arma::Row<size_t> elkanAssignments;
+  arma::mat elkanCentroids(centroids);
+  elkan.Cluster(dataset, k, elkanAssignments, elkanCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      HamerlyKMeans, arma::fmat> hamerly;
+  arma::Row<size_t> hamerlyAssignments;
+  arma::mat hamerlyCentroids(centroids);
+  hamerly.Cluster(dataset, k, hamerlyAssignments, hamerlyCentroids, false,
+      true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      PellegMooreKMeans, arma::fmat> pellegMoore;
+  arma::Row<size_t> pmAssignments;
+  arma::mat pmCentroids(centroids);
+  pellegMoore.Cluster(dataset, k, pmAssignments, pmCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      DefaultDualTreeKMeans, arma::fmat> dtnn;
+  arma::Row<size_t> dtnnAssignments;
+  arma::mat dtnnCentroids(centroids);
+  dtnn.Cluster(dataset, k, dtnnAssignments, dtnnCentroids, false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(assignments[i], elkanAssignments[i]);
+    BOOST_REQUIRE_EQUAL(assignments[i], hamerlyAssignments[i]);
+    BOOST_REQUIRE_EQUAL(assignments[i], pmAssignments[i]);
+    BOOST_REQUIRE_EQUAL(assignments[i], dtnnAssignments[i]);
+  }
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], elkanCentroids[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], hamerlyCentroids[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], pmCentroids[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], dtnnCentroids[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
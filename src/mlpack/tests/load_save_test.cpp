@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/chunk_reader.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "old_boost_test_definitions.hpp"
@@ -1286,4 +1287,112 @@ BOOST_AUTO_TEST_CASE(BadDatasetInfoARFFTest)
   remove("test.arff");
 }
 
+/**
+ * Reading a CSV file in blocks should give the same points as loading it all
+ * at once.
+ */
+BOOST_AUTO_TEST_CASE(ChunkReaderCSVTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 23);
+  data::Save("test.csv", dataset);
+
+  arma::mat loaded;
+  data::Load("test.csv", loaded);
+
+  DatasetInfo info;
+  ChunkReader reader("test.csv", info, 5);
+  BOOST_REQUIRE_EQUAL(reader.Dimensionality(), 4);
+
+  // Take two passes to make sure Rewind() works.
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    reader.Rewind();
+    arma::mat chunk;
+    size_t blocks = 0;
+    while (reader.Next(chunk))
+    {
+      const size_t start = blocks * 5;
+      BOOST_REQUIRE_EQUAL(chunk.n_rows, 4);
+      BOOST_REQUIRE_EQUAL(chunk.n_cols, std::min((size_t) 5, 23 - start));
+      for (size_t i = 0; i < chunk.n_elem; ++i)
+        BOOST_REQUIRE_CLOSE(chunk[i], loaded[start * 4 + i], 1e-5);
+      ++blocks;
+    }
+
+    BOOST_REQUIRE_EQUAL(blocks, 5);
+    BOOST_REQUIRE_EQUAL(reader.PointsRead(), 23);
+    BOOST_REQUIRE_EQUAL(chunk.n_elem, 0);
+  }
+
+  remove("test.csv");
+}
+
+/**
+ * After MapCategories(), every category of an ARFF file should be mapped before
+ * the first block is read, and the blocks should match data::Load().
+ */
+BOOST_AUTO_TEST_CASE(ChunkReaderARFFCategoricalTest)
+{
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one STRING" << endl;
+  f << "@attribute two REAL" << endl;
+  f << "@attribute three STRING" << endl;
+  f << "@data" << endl;
+  f << "hello, 1, moo" << endl;
+  f << "cheese, 2.34, goodbye" << endl;
+  f << "\% a comment line " << endl;
+  f << "seven, 1.03e+5, moo" << endl;
+  f << "hello, -1.3, goodbye" << endl;
+  f << "eight, 4, cow" << endl;
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo loadInfo;
+  data::Load("test.arff", dataset, loadInfo);
+
+  DatasetInfo info;
+  ChunkReader reader("test.arff", info, 2);
+  BOOST_REQUIRE_EQUAL(info.Dimensionality(), 3);
+  BOOST_REQUIRE(info.Type(0) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(1) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+
+  reader.MapCategories();
+  BOOST_REQUIRE_EQUAL(info.NumMappings(0), 4);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 3);
+
+  arma::mat chunk;
+  size_t points = 0;
+  while (reader.Next(chunk))
+  {
+    for (size_t i = 0; i < chunk.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(chunk[i] + 1.0, dataset[points * 3 + i] + 1.0, 1e-5);
+    points += chunk.n_cols;
+  }
+  BOOST_REQUIRE_EQUAL(points, 5);
+
+  remove("test.arff");
+}
+
+/**
+ * A CSV file with non-numeric values can't be read in blocks.
+ */
+BOOST_AUTO_TEST_CASE(ChunkReaderBadCSVTest)
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  f << "1, 2, 3" << endl;
+  f << "4, five, 6" << endl;
+  f.close();
+
+  DatasetInfo info;
+  ChunkReader reader("test.csv", info, 10);
+  arma::mat chunk;
+  BOOST_REQUIRE_THROW(reader.Next(chunk), std::runtime_error);
+
+  remove("test.csv");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -309,4 +309,74 @@ BOOST_AUTO_TEST_CASE(Keller4LovaszThetaSDP)
   }
 }*/
 
+/**
+ * Entry constraints should give the same augmented Lagrangian objective,
+ * gradient, and constraint values as the equivalent sparse constraints.
+ */
+BOOST_AUTO_TEST_CASE(EntryConstraintTest)
+{
+  const size_t n = 20;
+  const size_t p = 50;
+
+  // Random constraints, some on the diagonal.
+  arma::umat indices(2, p);
+  arma::vec values = arma::randn<arma::vec>(p);
+  arma::vec b = arma::randn<arma::vec>(p);
+  for (size_t i = 0; i < p; ++i)
+  {
+    indices(0, i) = math::RandInt(n);
+    indices(1, i) = (i % 5 == 0) ? indices(0, i) : math::RandInt(n);
+  }
+
+  const arma::mat coordinates = arma::randn<arma::mat>(n, 4);
+  const arma::vec lambda = arma::randn<arma::vec>(p);
+
+  LRSDP<SDP<arma::sp_mat>> sparse(p, 0, coordinates);
+  sparse.SDP().C().eye(n, n);
+  sparse.SDP().SparseB() = b;
+  for (size_t i = 0; i < p; ++i)
+  {
+    sparse.SDP().SparseA()[i].zeros(n, n);
+    sparse.SDP().SparseA()[i](indices(0, i), indices(1, i)) = values[i];
+    sparse.SDP().SparseA()[i](indices(1, i), indices(0, i)) = values[i];
+  }
+
+  LRSDP<SDP<arma::sp_mat>> entry(0, 0, coordinates);
+  entry.SDP().C().eye(n, n);
+  entry.SDP().EntryIndices() = indices;
+  entry.SDP().EntryValues() = values;
+  entry.SDP().EntryB() = b;
+
+  BOOST_REQUIRE_EQUAL(entry.SDP().NumConstraints(), p);
+  BOOST_REQUIRE_EQUAL(entry.SDP().NumEntryConstraints(), p);
+
+  for (size_t i = 0; i < p; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(entry.Function().EvaluateConstraint(i, coordinates),
+        sparse.Function().EvaluateConstraint(i, coordinates), 1e-5);
+  }
+
+  AugLagrangianFunction<LRSDPFunction<SDP<arma::sp_mat>>> sparseAugLag(
+      sparse.Function(), lambda, 3.0);
+  AugLagrangianFunction<LRSDPFunction<SDP<arma::sp_mat>>> entryAugLag(
+      entry.Function(), lambda, 3.0);
+
+  BOOST_REQUIRE_CLOSE(entryAugLag.Evaluate(coordinates),
+      sparseAugLag.Evaluate(coordinates), 1e-5);
+
+  arma::mat sparseGradient, entryGradient;
+  sparseAugLag.Gradient(coordinates, sparseGradient);
+  entryAugLag.Gradient(coordinates, entryGradient);
+
+  BOOST_REQUIRE_EQUAL(entryGradient.n_rows, n);
+  BOOST_REQUIRE_EQUAL(entryGradient.n_cols, 4);
+  for (size_t i = 0; i < entryGradient.n_elem; ++i)
+  {
+    if (std::abs(sparseGradient[i]) < 1e-8)
+      BOOST_REQUIRE_SMALL(entryGradient[i], 1e-8);
+    else
+      BOOST_REQUIRE_CLOSE(entryGradient[i], sparseGradient[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
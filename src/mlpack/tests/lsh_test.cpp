@@ -155,4 +155,41 @@ BOOST_AUTO_TEST_CASE(EmptyConstructorTest)
   BOOST_REQUIRE_EQUAL(distances.n_rows, 3);
 }
 
+/**
+ * Queries are hashed all at once; make sure that the results do not depend on
+ * which other queries are in the same batch, or on the order of the candidate
+ * buckets.
+ */
+BOOST_AUTO_TEST_CASE(LSHBatchQueryTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(4, 1000);
+  arma::mat qdata = arma::randu<arma::mat>(4, 50);
+
+  LSHSearch<> lsh(rdata, 5, 8, 0.0, 99901, 500);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lsh.Search(qdata, 3, neighbors, distances);
+  const size_t evaluations = lsh.DistanceEvaluations();
+
+  size_t singleEvaluations = 0;
+  for (size_t i = 0; i < qdata.n_cols; ++i)
+  {
+    arma::Mat<size_t> singleNeighbors;
+    arma::mat singleDistances;
+    lsh.DistanceEvaluations() = 0;
+    lsh.Search(qdata.col(i), 3, singleNeighbors, singleDistances);
+    singleEvaluations += lsh.DistanceEvaluations();
+
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(singleNeighbors(j, 0), neighbors(j, i));
+      BOOST_REQUIRE_CLOSE(singleDistances(j, 0), distances(j, i), 1e-5);
+    }
+  }
+
+  // Each candidate is evaluated once per query, however it is found.
+  BOOST_REQUIRE_EQUAL(singleEvaluations, evaluations);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
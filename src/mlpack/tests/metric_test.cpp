@@ -82,4 +82,73 @@ BOOST_AUTO_TEST_CASE(LINFMetricTest)
                       lMetric.Evaluate(a2, b2), 1e-5);
 }
 
+/**
+ * Make sure that the vectorized kernels give the same results as the Armadillo
+ * expressions for float and double vectors of many sizes, including sizes that
+ * are not multiples of the vector width, and for vectors of mixed types.
+ */
+BOOST_AUTO_TEST_CASE(VectorizedMetricTest)
+{
+  const size_t sizes[] = { 1, 7, 15, 16, 17, 31, 64, 100, 1003 };
+
+  ManhattanDistance l1;
+  SquaredEuclideanDistance squaredL2;
+  EuclideanDistance l2;
+  ChebyshevDistance lInf;
+
+  for (size_t s = 0; s < 9; ++s)
+  {
+    arma::vec a = arma::randn<arma::vec>(sizes[s]);
+    arma::vec b = arma::randn<arma::vec>(sizes[s]);
+
+    BOOST_REQUIRE_CLOSE(l1.Evaluate(a, b), arma::accu(arma::abs(a - b)),
+        1e-5);
+    BOOST_REQUIRE_CLOSE(squaredL2.Evaluate(a, b),
+        arma::accu(arma::square(a - b)), 1e-5);
+    BOOST_REQUIRE_CLOSE(l2.Evaluate(a, b),
+        sqrt(arma::accu(arma::square(a - b))), 1e-5);
+    BOOST_REQUIRE_CLOSE(lInf.Evaluate(a, b),
+        arma::as_scalar(arma::max(arma::abs(a - b))), 1e-5);
+
+    // Now the same with float data.  The reference results are calculated in
+    // double precision, so the tolerance is larger.
+    arma::fvec af = arma::conv_to<arma::fvec>::from(a);
+    arma::fvec bf = arma::conv_to<arma::fvec>::from(b);
+    arma::vec ad = arma::conv_to<arma::vec>::from(af);
+    arma::vec bd = arma::conv_to<arma::vec>::from(bf);
+
+    BOOST_REQUIRE_CLOSE(l1.Evaluate(af, bf), arma::accu(arma::abs(ad - bd)),
+        1e-3);
+    BOOST_REQUIRE_CLOSE(squaredL2.Evaluate(af, bf),
+        arma::accu(arma::square(ad - bd)), 1e-3);
+    BOOST_REQUIRE_CLOSE(lInf.Evaluate(af, bf),
+        arma::as_scalar(arma::max(arma::abs(ad - bd))), 1e-3);
+
+    // Mixed float and double vectors.
+    BOOST_REQUIRE_CLOSE(l1.Evaluate(af, bd), arma::accu(arma::abs(ad - bd)),
+        1e-3);
+    BOOST_REQUIRE_CLOSE(squaredL2.Evaluate(ad, bf),
+        arma::accu(arma::square(ad - bd)), 1e-3);
+    BOOST_REQUIRE_CLOSE(lInf.Evaluate(af, bd),
+        arma::as_scalar(arma::max(arma::abs(ad - bd))), 1e-3);
+
+    // Mixed types where one argument is an Armadillo expression.
+    BOOST_REQUIRE_CLOSE(squaredL2.Evaluate(2 * af, bd),
+        arma::accu(arma::square(2 * ad - bd)), 1e-3);
+    BOOST_REQUIRE_CLOSE(l1.Evaluate(ad, af + bf),
+        arma::accu(arma::abs(ad - (ad + bd))), 1e-3);
+    BOOST_REQUIRE_CLOSE(lInf.Evaluate(af - bf, bd),
+        arma::as_scalar(arma::max(arma::abs(ad - bd - bd))), 1e-3);
+
+    // Column views of matrices should give the same results as vectors.
+    arma::fmat m(sizes[s], 2);
+    m.col(0) = af;
+    m.col(1) = bf;
+    BOOST_REQUIRE_CLOSE(squaredL2.Evaluate(m.col(0), m.col(1)),
+        squaredL2.Evaluate(af, bf), 1e-5);
+    BOOST_REQUIRE_CLOSE(l1.Evaluate(m.unsafe_col(0), m.unsafe_col(1)),
+        l1.Evaluate(af, bf), 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
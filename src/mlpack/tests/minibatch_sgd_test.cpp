@@ -131,4 +131,92 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionTest)
   }
 }
 
+/**
+ * A decomposable function, f(x) = sum_i (x - i)^2 for i in [0, 10), that also
+ * has batch Evaluate() and Gradient() overloads.  It counts the calls to each
+ * overload, so we can see which ones the optimizer uses.
+ */
+class BatchCountingFunction
+{
+ public:
+  BatchCountingFunction() :
+      pointEvaluations(0),
+      pointGradients(0),
+      batchEvaluations(0),
+      batchGradients(0)
+  { }
+
+  size_t NumFunctions() const { return 10; }
+
+  arma::mat GetInitialPoint() const { return arma::mat("20.0"); }
+
+  double Evaluate(const arma::mat& coordinates, const size_t i)
+  {
+    ++pointEvaluations;
+    return std::pow(coordinates[0] - i, 2.0);
+  }
+
+  void Gradient(const arma::mat& coordinates,
+                const size_t i,
+                arma::mat& gradient)
+  {
+    ++pointGradients;
+    gradient.set_size(1, 1);
+    gradient[0] = 2 * (coordinates[0] - i);
+  }
+
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t begin,
+                  const size_t batchSize)
+  {
+    ++batchEvaluations;
+    double objective = 0;
+    for (size_t i = begin; i < begin + batchSize; ++i)
+      objective += std::pow(coordinates[0] - i, 2.0);
+    return objective;
+  }
+
+  void Gradient(const arma::mat& coordinates,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize)
+  {
+    ++batchGradients;
+    gradient.zeros(1, 1);
+    for (size_t i = begin; i < begin + batchSize; ++i)
+      gradient[0] += 2 * (coordinates[0] - i);
+  }
+
+  size_t pointEvaluations;
+  size_t pointGradients;
+  size_t batchEvaluations;
+  size_t batchGradients;
+};
+
+/**
+ * Make sure that mini-batch SGD uses the batch Evaluate() and Gradient()
+ * overloads when they are available, and that it still finds the minimum
+ * (x = 4.5).
+ */
+BOOST_AUTO_TEST_CASE(BatchOverloadTest)
+{
+  for (size_t shuffle = 0; shuffle < 2; ++shuffle)
+  {
+    BatchCountingFunction f;
+    MiniBatchSGD<BatchCountingFunction> s(f, 5, 0.01, 10000, 1e-10,
+        (shuffle == 1));
+
+    arma::mat coordinates = f.GetInitialPoint();
+    const double result = s.Optimize(coordinates);
+
+    BOOST_REQUIRE_EQUAL(f.pointEvaluations, 0);
+    BOOST_REQUIRE_EQUAL(f.pointGradients, 0);
+    BOOST_REQUIRE_GT(f.batchEvaluations, 0);
+    BOOST_REQUIRE_GT(f.batchGradients, 0);
+
+    BOOST_REQUIRE_CLOSE(coordinates[0], 4.5, 1.0);
+    BOOST_REQUIRE_CLOSE(result, 82.5, 1.0);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -285,4 +285,43 @@ BOOST_AUTO_TEST_CASE(SeparateTrainIndividualIncrementalTest)
   }
 }
 
+/**
+ * Make sure that classifying many points at once (in several blocks, the last
+ * of which is partial) gives the class with the highest log-likelihood for
+ * each point.
+ */
+BOOST_AUTO_TEST_CASE(BatchClassifyTest)
+{
+  NaiveBayesClassifier<> nbc(4, 3);
+  nbc.Means().randn();
+  nbc.Variances().randu();
+  nbc.Variances() += 0.1;
+  nbc.Probabilities() = arma::vec("0.2 0.3 0.5");
+
+  arma::mat testData = arma::randn<arma::mat>(4, 3000);
+  arma::Row<size_t> results;
+  nbc.Classify(testData, results);
+
+  BOOST_REQUIRE_EQUAL(results.n_elem, 3000);
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    arma::vec logLikelihoods(3);
+    for (size_t c = 0; c < 3; ++c)
+    {
+      logLikelihoods[c] = std::log(nbc.Probabilities()[c]);
+      for (size_t d = 0; d < 4; ++d)
+      {
+        const double variance = nbc.Variances()(d, c);
+        const double diff = testData(d, i) - nbc.Means()(d, c);
+        logLikelihoods[c] -= 0.5 * (std::log(2 * M_PI * variance) +
+            diff * diff / variance);
+      }
+    }
+
+    arma::uword maxIndex;
+    logLikelihoods.max(maxIndex);
+    BOOST_REQUIRE_EQUAL(results[i], maxIndex);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -244,6 +244,107 @@ BOOST_AUTO_TEST_CASE(SoftmaxSeparableGradient)
   BOOST_REQUIRE_CLOSE(gradient(1, 1), -2.0 * -0.1435886, 0.01);
 }
 
+/**
+ * Ensure the batch separable objective and gradient are the sums of the
+ * single-point objectives and gradients.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxBatchSeparable)
+{
+  arma::mat data;
+  data.randu(3, 50);
+  arma::Row<size_t> labels(50);
+  for (size_t i = 0; i < 50; ++i)
+    labels[i] = i % 3;
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+
+  arma::mat coordinates;
+  coordinates.randu(3, 3);
+
+  double objective = 0.0;
+  arma::mat gradient;
+  gradient.zeros(3, 3);
+  for (size_t i = 10; i < 30; ++i)
+  {
+    objective += sef.Evaluate(coordinates, i);
+
+    arma::mat pointGradient;
+    sef.Gradient(coordinates, i, pointGradient);
+    gradient += pointGradient;
+  }
+
+  arma::mat batchGradient;
+  BOOST_REQUIRE_CLOSE(sef.Evaluate(coordinates, 10, 20), objective, 1e-5);
+  sef.Gradient(coordinates, 10, batchGradient, 20);
+
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    if (std::abs(gradient[i]) < 1e-8)
+      BOOST_REQUIRE_SMALL(batchGradient[i], 1e-8);
+    else
+      BOOST_REQUIRE_CLOSE(batchGradient[i], gradient[i], 1e-5);
+  }
+}
+
+/**
+ * With a tiny tolerance, the approximate softmax error function should give
+ * the same results as the exact one, for both the tree-based non-separable
+ * implementation and the separable implementation.
+ */
+BOOST_AUTO_TEST_CASE(ApproxSoftmaxMatchesExact)
+{
+  arma::mat data;
+  data.randu(3, 200);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = (data(0, i) > 0.5) ? 1 : 0;
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  ApproxSoftmaxErrorFunction<SquaredEuclideanDistance> asef(data, labels,
+      SquaredEuclideanDistance(), 1e-300);
+
+  arma::mat coordinates = 2.0 * arma::eye<arma::mat>(3, 3);
+
+  BOOST_REQUIRE_CLOSE(asef.Evaluate(coordinates), sef.Evaluate(coordinates),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(asef.Evaluate(coordinates, 7),
+      sef.Evaluate(coordinates, 7), 1e-5);
+
+  arma::mat gradient, approxGradient;
+  sef.Gradient(coordinates, gradient);
+  asef.Gradient(coordinates, approxGradient);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(approxGradient[i], gradient[i], 1e-5);
+
+  sef.Gradient(coordinates, 7, gradient);
+  asef.Gradient(coordinates, 7, approxGradient);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(approxGradient[i], gradient[i], 1e-5);
+}
+
+/**
+ * On a dataset with two far-apart clusters, the approximate softmax error
+ * function with a reasonable tolerance should still be very close to the exact
+ * result.
+ */
+BOOST_AUTO_TEST_CASE(ApproxSoftmaxClusters)
+{
+  arma::mat data;
+  data.randn(2, 300);
+  data.cols(150, 299) += 20.0;
+  arma::Row<size_t> labels(300);
+  for (size_t i = 0; i < 300; ++i)
+    labels[i] = (i % 2);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  ApproxSoftmaxErrorFunction<SquaredEuclideanDistance> asef(data, labels,
+      SquaredEuclideanDistance(), 1e-12);
+
+  arma::mat coordinates = arma::eye<arma::mat>(2, 2);
+  BOOST_REQUIRE_CLOSE(asef.Evaluate(coordinates), sef.Evaluate(coordinates),
+      1e-3);
+}
+
 //
 // Tests for the NCA algorithm.
 //
@@ -318,4 +419,33 @@ BOOST_AUTO_TEST_CASE(NCALBFGSSimpleDataset)
 
 }
 
+/**
+ * NCA with the approximate error function should also fully separate the points
+ * of our simple dataset.
+ */
+BOOST_AUTO_TEST_CASE(NCAApproxLBFGSSimpleDataset)
+{
+  // Useful but simple dataset with six points and two classes.
+  arma::mat data           = "-0.1 -0.1 -0.1  0.1  0.1  0.1;"
+                             " 1.0  0.0 -1.0  1.0  0.0 -1.0 ";
+  arma::Row<size_t> labels = " 0    0    0    1    1    1   ";
+
+  NCA<SquaredEuclideanDistance, L_BFGS, ApproxSoftmaxErrorFunction>
+      nca(data, labels);
+  nca.ErrorFunction().Tolerance() = 1e-15;
+  nca.Optimizer().NumBasis() = 5;
+
+  arma::mat outputMatrix;
+  nca.LearnDistance(outputMatrix);
+
+  // Check the result with the exact error function.
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+
+  double initObj = sef.Evaluate(arma::eye<arma::mat>(2, 2));
+  double finalObj = sef.Evaluate(outputMatrix);
+
+  BOOST_REQUIRE_LT(finalObj, initObj);
+  BOOST_REQUIRE_CLOSE(finalObj, -6.0, 1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -211,4 +211,103 @@ BOOST_AUTO_TEST_CASE(SparseNMFALSTest)
       1e-5);
 }
 
+/**
+ * Make sure that a single step of the ALS update rule gives the same result for
+ * sparse and dense matrices, and that it agrees with the least squares solution
+ * computed with the pseudoinverse.
+ */
+BOOST_AUTO_TEST_CASE(NMFALSSparseUpdateTest)
+{
+  sp_mat v;
+  v.sprandu(300, 200, 0.05);
+  mat dv(v);
+  const size_t r = 8;
+
+  mat w = randu<mat>(300, r);
+  mat h = randu<mat>(r, 200);
+
+  NMFALSUpdate sparseUpdate;
+  NMFALSUpdate denseUpdate;
+  sparseUpdate.Initialize(v, r);
+  denseUpdate.Initialize(dv, r);
+
+  // Update W.
+  mat sparseW(w), denseW(w);
+  sparseUpdate.WUpdate(v, sparseW, h);
+  denseUpdate.WUpdate(dv, denseW, h);
+
+  mat expectedW = dv * h.t() * pinv(h * h.t());
+  expectedW.elem(find(expectedW < 0)).zeros();
+
+  BOOST_REQUIRE_SMALL(norm(sparseW - denseW, "fro") / norm(denseW, "fro"),
+      1e-8);
+  BOOST_REQUIRE_SMALL(norm(denseW - expectedW, "fro") / norm(expectedW, "fro"),
+      1e-6);
+
+  // Update H with the new W.
+  mat sparseH(h), denseH(h);
+  sparseUpdate.HUpdate(v, denseW, sparseH);
+  denseUpdate.HUpdate(dv, denseW, denseH);
+
+  mat expectedH = pinv(denseW.t() * denseW) * denseW.t() * dv;
+  expectedH.elem(find(expectedH < 0)).zeros();
+
+  BOOST_REQUIRE_SMALL(norm(sparseH - denseH, "fro") / norm(denseH, "fro"),
+      1e-8);
+  BOOST_REQUIRE_SMALL(norm(denseH - expectedH, "fro") / norm(expectedH, "fro"),
+      1e-6);
+}
+
+/**
+ * Make sure that SimpleResidueTermination computes the same residue as the
+ * explicit calculation with W * H, and that with a check interval the residue
+ * is only computed every few iterations.
+ */
+BOOST_AUTO_TEST_CASE(SimpleResidueTerminationTest)
+{
+  mat v = randu<mat>(30, 40);
+  mat w1 = randu<mat>(30, 5);
+  mat h1 = randu<mat>(5, 40);
+  mat w2 = randu<mat>(30, 5);
+  mat h2 = randu<mat>(5, 40);
+
+  // Calculate the norms by hand.
+  const mat wh1 = w1 * h1;
+  const mat wh2 = w2 * h2;
+  double norm1 = 0.0;
+  double norm2 = 0.0;
+  for (size_t j = 0; j < v.n_cols; ++j)
+  {
+    norm1 += arma::norm(wh1.col(j), 2);
+    norm2 += arma::norm(wh2.col(j), 2);
+  }
+
+  SimpleResidueTermination srt(1e-20, 100);
+  srt.Initialize(v);
+  BOOST_REQUIRE(!srt.IsConverged(w1, h1));
+  BOOST_REQUIRE(!srt.IsConverged(w2, h2));
+  BOOST_REQUIRE_CLOSE(srt.Index(), std::fabs(norm1 - norm2) / norm1, 1e-7);
+  BOOST_REQUIRE_EQUAL(srt.Iteration(), 3);
+
+  // Now only check every third iteration.  The second and third calls should
+  // not change the residue.
+  SimpleResidueTermination interval(1e-20, 100, 3);
+  interval.Initialize(v);
+  BOOST_REQUIRE(!interval.IsConverged(w1, h1));
+  const double firstResidue = interval.Index();
+  BOOST_REQUIRE(!interval.IsConverged(w2, h2));
+  BOOST_REQUIRE(!interval.IsConverged(w2, h2));
+  BOOST_REQUIRE_EQUAL(interval.Index(), firstResidue);
+  BOOST_REQUIRE(!interval.IsConverged(w2, h2));
+  BOOST_REQUIRE_CLOSE(interval.Index(), std::fabs(norm1 - norm2) / norm1,
+      1e-7);
+  BOOST_REQUIRE_EQUAL(interval.Iteration(), 5);
+
+  // The last iteration must be checked and must terminate.
+  SimpleResidueTermination last(1e-20, 2, 10);
+  last.Initialize(v);
+  BOOST_REQUIRE(!last.IsConverged(w1, h1));
+  BOOST_REQUIRE(last.IsConverged(w2, h2));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
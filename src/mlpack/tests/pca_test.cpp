@@ -6,6 +6,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
+#include <mlpack/methods/pca/incremental_pca.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "old_boost_test_definitions.hpp"
@@ -197,5 +198,106 @@ BOOST_AUTO_TEST_CASE(PCAScalingTest)
   BOOST_REQUIRE_CLOSE(accu(eigval), 3.0, 0.1); // 10% tolerance.
 }
 
+/**
+ * Make sure that the randomized SVD policy finds the same top components as the
+ * exact SVD policy on a dataset with a quickly decaying spectrum.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedPCATest)
+{
+  // Low-rank data with a little bit of noise.
+  mat data = randn<mat>(40, 5) * diagmat(vec("10 8 6 4 2")) *
+      randn<mat>(5, 1000) + 0.01 * randn<mat>(40, 1000);
+  mat exactData = data;
+  mat randomizedData = data;
+
+  PCA exact;
+  PCAType<RandomizedSVDPolicy> randomized;
+  const double exactVar = exact.Apply(exactData, 3);
+  const double randomizedVar = randomized.Apply(randomizedData, 3);
+
+  BOOST_REQUIRE_EQUAL(randomizedData.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(randomizedData.n_cols, 1000);
+  BOOST_REQUIRE_CLOSE(randomizedVar, exactVar, 1e-3);
+
+  // The components may point in opposite directions.
+  for (size_t i = 0; i < 3; ++i)
+  {
+    if (dot(exactData.row(i), randomizedData.row(i)) < 0)
+      randomizedData.row(i) *= -1;
+
+    for (size_t j = 0; j < 1000; ++j)
+      BOOST_REQUIRE_SMALL(randomizedData(i, j) - exactData(i, j), 1e-3 *
+          (1 + std::abs(exactData(i, j))));
+  }
+
+  // When all components are requested, the results are exact.
+  mat coeff, coeff1, score, score1;
+  vec eigVal, eigVal1;
+  exact.Apply(data, score, eigVal, coeff);
+  randomized.Apply(data, score1, eigVal1, coeff1);
+  BOOST_REQUIRE_EQUAL(eigVal.n_elem, eigVal1.n_elem);
+  for (size_t i = 0; i < eigVal.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(eigVal[i], eigVal1[i], 1e-5);
+}
+
+/**
+ * Make sure that IncrementalPCA gives the same results as PCA when all
+ * components are kept, no matter how the data is split into blocks, and a
+ * good approximation when only the top components are kept.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCATest)
+{
+  mat data = randn<mat>(10, 10) * randn<mat>(10, 500);
+  data.each_col() += linspace<vec>(1, 10, 10);
+
+  mat coeff, score;
+  vec eigVal;
+  PCA p;
+  p.Apply(data, score, eigVal, coeff);
+
+  IncrementalPCA ipca(10);
+  for (size_t i = 0; i < data.n_cols; i += 37)
+    ipca.Update(data.cols(i, std::min(i + 37, (size_t) data.n_cols) - 1));
+
+  BOOST_REQUIRE_EQUAL(ipca.Points(), 500);
+  for (size_t i = 0; i < 10; ++i)
+    BOOST_REQUIRE_CLOSE(ipca.Mean()[i], mean(data.row(i)), 1e-5);
+
+  const vec ipcaEigVal = ipca.EigenValues();
+  BOOST_REQUIRE_EQUAL(ipcaEigVal.n_elem, eigVal.n_elem);
+  for (size_t i = 0; i < eigVal.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(ipcaEigVal[i], eigVal[i], 1e-5);
+  BOOST_REQUIRE_CLOSE(ipca.TotalVariance(), accu(eigVal), 1e-5);
+  BOOST_REQUIRE_CLOSE(ipca.VarianceRetained(), 1.0, 1e-5);
+
+  mat transformed;
+  ipca.Transform(data, transformed);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    if (dot(transformed.row(i), score.row(i)) < 0)
+      transformed.row(i) *= -1;
+
+    for (size_t j = 0; j < data.n_cols; ++j)
+      BOOST_REQUIRE_SMALL(transformed(i, j) - score(i, j), 1e-5 *
+          (1 + std::abs(score(i, j))));
+  }
+
+  // Now keep only the top two components of data whose spectrum decays
+  // quickly.
+  data = randn<mat>(10, 2) * diagmat(vec("10 5")) * randn<mat>(2, 500) +
+      0.01 * randn<mat>(10, 500);
+  p.Apply(data, score, eigVal, coeff);
+
+  IncrementalPCA topPCA(2);
+  for (size_t i = 0; i < data.n_cols; i += 50)
+    topPCA.Update(data.cols(i, i + 49));
+
+  BOOST_REQUIRE_EQUAL(topPCA.Components().n_cols, 2);
+  BOOST_REQUIRE_CLOSE(topPCA.EigenValues()[0], eigVal[0], 0.1);
+  BOOST_REQUIRE_CLOSE(topPCA.EigenValues()[1], eigVal[1], 0.1);
+  BOOST_REQUIRE_CLOSE(std::abs(dot(topPCA.Components().col(0), coeff.col(0))),
+      1.0, 1e-3);
+}
+
 
 BOOST_AUTO_TEST_SUITE_END();
@@ -166,4 +166,29 @@ BOOST_AUTO_TEST_CASE(SecondaryConstructor)
   Perceptron<> p2(p1);
 }
 
+/**
+ * Make sure that classifying many points at once (in several blocks, the last
+ * of which is partial) gives the same labels as classifying each point by
+ * itself.
+ */
+BOOST_AUTO_TEST_CASE(BatchClassifyTest)
+{
+  Perceptron<> p(4, 5);
+  p.Weights().randn();
+  p.Biases().randn();
+
+  mat testData = randn<mat>(5, 3000);
+  Row<size_t> predictedLabels;
+  p.Classify(testData, predictedLabels);
+
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, 3000);
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    vec scores = p.Weights().t() * testData.col(i) + p.Biases();
+    uword maxIndex;
+    scores.max(maxIndex);
+    BOOST_REQUIRE_EQUAL(predictedLabels[i], maxIndex);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,191 @@
+/**
+ * @file query_server_test.cpp
+ * @author agent
+ *
+ * Tests for the QueryServer class and its framing.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/query_server/query_server.hpp>
+#include <boost/test/unit_test.hpp>
+#include "old_boost_test_definitions.hpp"
+
+using namespace mlpack;
+using namespace mlpack::server;
+using namespace mlpack::neighbor;
+using namespace mlpack::range;
+
+BOOST_AUTO_TEST_SUITE(QueryServerTest);
+
+/**
+ * Make sure that compatible requests are answered with a single search, that
+ * the results are the same as those of a direct search, and that invalid
+ * requests are rejected without affecting the others.
+ */
+BOOST_AUTO_TEST_CASE(KNNProcessTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 200);
+  NSModel<NearestNeighborSort> model;
+  model.BuildModel(arma::mat(referenceData), 10, false, false);
+
+  std::vector<QueryRequest> requests(4);
+  requests[0].id = 10;
+  requests[0].k = 3;
+  requests[0].queries = arma::randu<arma::mat>(3, 15);
+  requests[1].id = 11;
+  requests[1].k = 0; // Invalid.
+  requests[1].queries = arma::randu<arma::mat>(3, 5);
+  requests[2].id = 12;
+  requests[2].k = 3;
+  requests[2].queries = arma::randu<arma::mat>(3, 7);
+  requests[3].id = 13;
+  requests[3].k = 3;
+  requests[3].queries = arma::randu<arma::mat>(4, 5); // Wrong dimensionality.
+
+  const arma::mat queries0 = requests[0].queries;
+  const arma::mat queries2 = requests[2].queries;
+
+  NSQueryHandler<NearestNeighborSort> handler(model);
+  QueryServer<NSQueryHandler<NearestNeighborSort>> server(handler);
+  std::vector<QueryResponse> responses;
+  server.Process(requests, responses);
+
+  BOOST_REQUIRE_EQUAL(responses.size(), 4);
+  BOOST_REQUIRE_EQUAL(server.Batches(), 1);
+  BOOST_REQUIRE_EQUAL(responses[1].status, 1);
+  BOOST_REQUIRE_EQUAL(responses[3].status, 1);
+  BOOST_REQUIRE_GT(responses[1].message.size(), 0);
+
+  const size_t checked[] = { 0, 2 };
+  const arma::mat* checkedQueries[] = { &queries0, &queries2 };
+  for (size_t r = 0; r < 2; ++r)
+  {
+    const QueryResponse& response = responses[checked[r]];
+    BOOST_REQUIRE_EQUAL(response.status, 0);
+    BOOST_REQUIRE_EQUAL(response.id, 10 + checked[r]);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    NeighborSearch<NearestNeighborSort> naive(referenceData, true);
+    naive.Search(*checkedQueries[r], 3, neighbors, distances);
+
+    BOOST_REQUIRE_EQUAL(response.offsets.size(), neighbors.n_cols + 1);
+    for (size_t i = 0; i < neighbors.n_cols; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(response.offsets[i + 1] - response.offsets[i], 3);
+      for (size_t j = 0; j < 3; ++j)
+      {
+        BOOST_REQUIRE_EQUAL(response.indices[response.offsets[i] + j],
+            neighbors(j, i));
+        BOOST_REQUIRE_CLOSE(response.values[response.offsets[i] + j],
+            distances(j, i), 1e-5);
+      }
+    }
+  }
+}
+
+/**
+ * Send range search requests through a pipe with the binary framing, and make
+ * sure the responses that come back are correct.
+ */
+BOOST_AUTO_TEST_CASE(RangeStreamTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(2, 100);
+  RSModel model;
+  model.BuildModel(arma::mat(referenceData), 10, false, false);
+
+  int requestPipe[2], responsePipe[2];
+  BOOST_REQUIRE_EQUAL(pipe(requestPipe), 0);
+  BOOST_REQUIRE_EQUAL(pipe(responsePipe), 0);
+
+  std::vector<QueryRequest> requests(3);
+  for (size_t i = 0; i < requests.size(); ++i)
+  {
+    requests[i].id = i;
+    requests[i].rangeMin = 0.0;
+    requests[i].rangeMax = (i == 2) ? 0.3 : 0.2;
+    requests[i].queries = arma::randu<arma::mat>(2, 8);
+    BOOST_REQUIRE(WriteRequest(requestPipe[1], requests[i]));
+  }
+  close(requestPipe[1]);
+
+  RSQueryHandler handler(model);
+  QueryServer<RSQueryHandler> server(handler);
+  BOOST_REQUIRE_EQUAL(server.ServeStream(requestPipe[0], responsePipe[1]), 3);
+  close(requestPipe[0]);
+  close(responsePipe[1]);
+
+  RangeSearch<> naive(referenceData, true);
+  for (size_t r = 0; r < requests.size(); ++r)
+  {
+    QueryResponse response;
+    BOOST_REQUIRE(ReadResponse(responsePipe[0], response));
+    BOOST_REQUIRE_EQUAL(response.status, 0);
+    BOOST_REQUIRE_EQUAL(response.id, r);
+
+    std::vector<std::vector<size_t>> neighbors;
+    std::vector<std::vector<double>> distances;
+    naive.Search(requests[r].queries, math::Range(requests[r].rangeMin,
+        requests[r].rangeMax), neighbors, distances);
+
+    BOOST_REQUIRE_EQUAL(response.offsets.size(), neighbors.size() + 1);
+    for (size_t i = 0; i < neighbors.size(); ++i)
+    {
+      std::vector<size_t> expected(neighbors[i]);
+      std::vector<size_t> found(response.indices.begin() + response.offsets[i],
+          response.indices.begin() + response.offsets[i + 1]);
+      std::sort(expected.begin(), expected.end());
+      std::sort(found.begin(), found.end());
+      BOOST_REQUIRE(expected == found);
+    }
+  }
+
+  // There are no more responses.
+  QueryResponse response;
+  BOOST_REQUIRE(!ReadResponse(responsePipe[0], response));
+  close(responsePipe[0]);
+}
+
+/**
+ * Feed a request to ParseRequest() in pieces, as a non-blocking connection
+ * would receive it, and make sure it is only parsed once it is complete; also
+ * make sure a request that is too large is rejected from its header alone.
+ */
+BOOST_AUTO_TEST_CASE(ParseRequestTest)
+{
+  QueryRequest request;
+  request.id = 7;
+  request.k = 3;
+  request.queries = arma::randu<arma::mat>(4, 5);
+
+  int requestPipe[2];
+  BOOST_REQUIRE_EQUAL(pipe(requestPipe), 0);
+  BOOST_REQUIRE(WriteRequest(requestPipe[1], request));
+  close(requestPipe[1]);
+
+  std::string bytes(RequestHeaderSize + sizeof(double) * 20, '\0');
+  BOOST_REQUIRE(ReadBytes(requestPipe[0], &bytes[0], bytes.size()));
+  close(requestPipe[0]);
+
+  // Receive the request in two pieces, with a second request's first byte.
+  std::string buffer(bytes.substr(0, RequestHeaderSize + 10));
+  QueryRequest parsed;
+  BOOST_REQUIRE_EQUAL(ParseRequest(buffer, parsed), RequestIncomplete);
+  buffer.append(bytes.substr(RequestHeaderSize + 10));
+  buffer.append(bytes.substr(0, 1));
+  BOOST_REQUIRE_EQUAL(ParseRequest(buffer, parsed), RequestComplete);
+  BOOST_REQUIRE_EQUAL(buffer.size(), 1);
+  BOOST_REQUIRE_EQUAL(ParseRequest(buffer, parsed), RequestIncomplete);
+
+  BOOST_REQUIRE_EQUAL(parsed.id, 7);
+  BOOST_REQUIRE_EQUAL(parsed.k, 3);
+  BOOST_REQUIRE_EQUAL(parsed.queries.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(parsed.queries.n_cols, 5);
+  for (size_t i = 0; i < 20; ++i)
+    BOOST_REQUIRE_EQUAL(parsed.queries[i], request.queries[i]);
+
+  // With a limit of 19 elements, the header alone is enough to reject it.
+  buffer = bytes.substr(0, RequestHeaderSize);
+  BOOST_REQUIRE_EQUAL(ParseRequest(buffer, parsed, 19), RequestMalformed);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
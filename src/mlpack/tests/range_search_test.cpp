@@ -1404,4 +1404,44 @@ BOOST_AUTO_TEST_CASE(NeighborPtrDeleteTest)
 }
 
 
+/**
+ * Make sure that tree-based range search on float data gives the same results
+ * as a naive search on the same float data.
+ */
+BOOST_AUTO_TEST_CASE(FloatDataTest)
+{
+  arma::fmat dataset = arma::randu<arma::fmat>(8, 1000);
+
+  RangeSearch<EuclideanDistance, arma::fmat> naive(dataset, true);
+  vector<vector<size_t>> naiveNeighbors;
+  vector<vector<double>> naiveDistances;
+  naive.Search(Range(0.3, 0.6), naiveNeighbors, naiveDistances);
+
+  RangeSearch<EuclideanDistance, arma::fmat> kdtree(dataset);
+  vector<vector<size_t>> kdNeighbors;
+  vector<vector<double>> kdDistances;
+  kdtree.Search(Range(0.3, 0.6), kdNeighbors, kdDistances);
+
+  BOOST_REQUIRE_EQUAL(kdNeighbors.size(), naiveNeighbors.size());
+  for (size_t i = 0; i < naiveNeighbors.size(); ++i)
+  {
+    // The results are not necessarily in the same order.
+    vector<pair<size_t, double>> naiveResults, kdResults;
+    for (size_t j = 0; j < naiveNeighbors[i].size(); ++j)
+      naiveResults.push_back(make_pair(naiveNeighbors[i][j],
+          naiveDistances[i][j]));
+    for (size_t j = 0; j < kdNeighbors[i].size(); ++j)
+      kdResults.push_back(make_pair(kdNeighbors[i][j], kdDistances[i][j]));
+    sort(naiveResults.begin(), naiveResults.end());
+    sort(kdResults.begin(), kdResults.end());
+
+    BOOST_REQUIRE_EQUAL(kdResults.size(), naiveResults.size());
+    for (size_t j = 0; j < naiveResults.size(); ++j)
+    {
+      BOOST_REQUIRE_EQUAL(kdResults[j].first, naiveResults[j].first);
+      BOOST_REQUIRE_CLOSE(kdResults[j].second, naiveResults[j].second, 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -835,4 +835,130 @@ BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Count the number of leaves in the tree.
+ */
+template<typename TreeType>
+size_t CountLeaves(const TreeType& tree)
+{
+  if (tree.IsLeaf())
+    return 1;
+
+  size_t leaves = 0;
+  for (size_t i = 0; i < tree.NumChildren(); i++)
+    leaves += CountLeaves(tree.Child(i));
+
+  return leaves;
+}
+
+// Make sure that a tree built with STR bulk loading is a valid tree, with
+// every point held exactly once, and with packed leaves.
+template<typename TreeType>
+void CheckBulkLoadedTree(const size_t dimensionality, const size_t numPoints)
+{
+  arma::mat dataset;
+  dataset.randu(dimensionality, numPoints);
+
+  TreeType tree(dataset, STR_BULK_LOAD, 20, 6, 5, 2);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), numPoints);
+  arma::Col<size_t> counts(numPoints, arma::fill::zeros);
+  for (size_t i = 0; i < tree.NumDescendants(); i++)
+    ++counts[tree.Descendant(i)];
+  for (size_t i = 0; i < numPoints; i++)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckSync(tree);
+  CheckFills(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+  BOOST_REQUIRE_EQUAL(tree.TreeDepth(), GetMinLevel(tree));
+
+  // Every leaf but the last two should be full.
+  BOOST_REQUIRE_EQUAL(CountLeaves(tree), (numPoints + 19) / 20);
+}
+
+BOOST_AUTO_TEST_CASE(BulkLoadedTreeTest)
+{
+  typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> RTreeType;
+  typedef RStarTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> RStarTreeType;
+
+  CheckBulkLoadedTree<RTreeType>(8, 1000);
+  CheckBulkLoadedTree<RTreeType>(3, 2011);
+  CheckBulkLoadedTree<RTreeType>(1, 437);
+  CheckBulkLoadedTree<RTreeType>(5, 15); // A single leaf.
+  CheckBulkLoadedTree<RStarTreeType>(8, 1000);
+  CheckBulkLoadedTree<RStarTreeType>(2, 3333);
+}
+
+// Make sure nearest neighbor search with a bulk-loaded tree gives the same
+// results as naive search, and that points can still be inserted into and
+// deleted from the tree.
+BOOST_AUTO_TEST_CASE(BulkLoadedTreeDynamicTest)
+{
+  const int numIter = 50;
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef RTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  TreeType tree(dataset, STR_BULK_LOAD, 20, 6, 5, 2);
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      RTree> allknn1(&tree);
+  allknn1.Search(5, neighbors1, distances1);
+
+  AllkNN allknn2(dataset, true, true);
+  allknn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_CLOSE(distances1[i], distances2[i], 1e-5);
+  }
+
+  // Delete some points and insert some others.
+  for (int i = 0; i < numIter; i++)
+    tree.DeletePoint(999 - i);
+
+  arma::mat tmpData;
+  tmpData.randu(8, numIter);
+  for (int i = 0; i < numIter; i++)
+  {
+    tree.Dataset().col(999 - i) = tmpData.col(i);
+    dataset.col(999 - i) = tmpData.col(i);
+    tree.InsertPoint(999 - i);
+  }
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckSync(tree);
+  CheckFills(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      RTree> allknn3(&tree, true);
+  allknn3.Search(5, neighbors1, distances1);
+
+  AllkNN allknn4(dataset, true, true);
+  allknn4.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_CLOSE(distances1[i], distances2[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
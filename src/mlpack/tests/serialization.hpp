@@ -15,6 +15,7 @@
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/block_archive.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "old_boost_test_definitions.hpp"
@@ -93,6 +94,8 @@ void TestAllArmadilloSerialization(arma::Cube<CubeType>& x)
       boost::archive::text_oarchive>(x);
   TestArmadilloSerialization<CubeType, boost::archive::binary_iarchive,
       boost::archive::binary_oarchive>(x);
+  TestArmadilloSerialization<CubeType, data::BlockIArchive,
+      data::BlockOArchive>(x);
 }
 
 // Test function for loading and saving Armadillo objects.
@@ -159,6 +162,8 @@ void TestAllArmadilloSerialization(MatType& x)
       boost::archive::text_oarchive>(x);
   TestArmadilloSerialization<MatType, boost::archive::binary_iarchive,
       boost::archive::binary_oarchive>(x);
+  TestArmadilloSerialization<MatType, data::BlockIArchive,
+      data::BlockOArchive>(x);
 }
 
 // Save and load an mlpack object.
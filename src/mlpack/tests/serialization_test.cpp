@@ -532,6 +532,43 @@ BOOST_AUTO_TEST_CASE(BinarySpaceTreeOverwriteTest)
   CheckTrees(tree, xmlTree, textTree, binaryTree);
 }
 
+BOOST_AUTO_TEST_CASE(FlattenedBinarySpaceTreeTest)
+{
+  arma::mat data;
+  data.randu(3, 1000);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(data);
+  tree.Flatten(VAN_EMDE_BOAS_LAYOUT);
+
+  TreeType* xmlTree;
+  TreeType* textTree;
+  TreeType* binaryTree;
+
+  SerializePointerObjectAll(&tree, xmlTree, textTree, binaryTree);
+
+  BOOST_REQUIRE(xmlTree->IsFlat());
+  BOOST_REQUIRE(textTree->IsFlat());
+  BOOST_REQUIRE(binaryTree->IsFlat());
+  CheckTrees(tree, *xmlTree, *textTree, *binaryTree);
+
+  delete xmlTree;
+  delete textTree;
+  delete binaryTree;
+
+  // Loading a flattened tree over another flattened tree should also work.
+  arma::mat otherData;
+  otherData.randu(5, 50);
+  TreeType xmlOverwriteTree(otherData);
+  xmlOverwriteTree.Flatten(BREADTH_FIRST_LAYOUT);
+  TreeType textOverwriteTree(otherData);
+  TreeType binaryOverwriteTree(otherData);
+
+  SerializeObjectAll(tree, xmlOverwriteTree, textOverwriteTree,
+      binaryOverwriteTree);
+
+  CheckTrees(tree, xmlOverwriteTree, textOverwriteTree, binaryOverwriteTree);
+}
+
 BOOST_AUTO_TEST_CASE(CoverTreeTest)
 {
   arma::mat data;
@@ -827,6 +864,43 @@ BOOST_AUTO_TEST_CASE(AllkNNTest)
   CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
 }
 
+/**
+ * Save a kNN model with data::Save() in the block format, load it with
+ * data::Load() (which maps the file), and make sure the results are the same.
+ */
+BOOST_AUTO_TEST_CASE(AllkNNBlockFormatTest)
+{
+  using neighbor::AllkNN;
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+
+  AllkNN allknn(dataset, false, false);
+  BOOST_REQUIRE(data::Save("test_knn.blk", "knn", allknn));
+
+  AllkNN knnBlock;
+  BOOST_REQUIRE(data::Load("test_knn.blk", "knn", knnBlock));
+  remove("test_knn.blk");
+
+  BOOST_REQUIRE_EQUAL(knnBlock.ReferenceSet().n_rows, 5);
+  BOOST_REQUIRE_EQUAL(knnBlock.ReferenceSet().n_cols, 2000);
+  for (size_t i = 0; i < dataset.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(knnBlock.ReferenceSet()[i],
+        allknn.ReferenceSet()[i]);
+
+  arma::mat querySet = arma::randu<arma::mat>(5, 1000);
+
+  arma::mat distances, blockDistances;
+  arma::Mat<size_t> neighbors, blockNeighbors;
+
+  allknn.Search(querySet, 5, neighbors, distances);
+  knnBlock.Search(querySet, 5, blockNeighbors, blockDistances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], blockNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], blockDistances[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(SoftmaxRegressionTest)
 {
   using regression::SoftmaxRegression;
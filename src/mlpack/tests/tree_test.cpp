@@ -1358,6 +1358,134 @@ BOOST_AUTO_TEST_CASE(KdTreeTest)
   TreeType root(dataset);
 }
 
+// Recursively checks that two binary space trees have the same structure and
+// bounds.
+template<typename TreeType>
+void CheckSameTree(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  for (size_t d = 0; d < a.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_EQUAL(a.Bound()[d].Lo(), b.Bound()[d].Lo());
+    BOOST_REQUIRE_EQUAL(a.Bound()[d].Hi(), b.Bound()[d].Hi());
+  }
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Build a kd-tree large enough that it is built in parallel (if OpenMP is
+ * available), and make sure that it is valid and the same as the tree that a
+ * single thread builds.
+ */
+BOOST_AUTO_TEST_CASE(ParallelKdTreeBuildTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset(4, 50000);
+  dataset.randu();
+
+  std::vector<size_t> oldFromNew;
+  TreeType root(dataset, oldFromNew);
+
+  BOOST_REQUIRE_EQUAL(root.NumDescendants(), dataset.n_cols);
+  BOOST_REQUIRE(CheckPointBounds(root));
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    for (size_t j = 0; j < dataset.n_rows; ++j)
+      BOOST_REQUIRE_EQUAL(root.Dataset()(j, i), dataset(j, oldFromNew[i]));
+
+  // Now build the same tree with one thread.
+#ifdef _OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  std::vector<size_t> serialOldFromNew;
+  TreeType serialRoot(dataset, serialOldFromNew);
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(oldFromNew[i], serialOldFromNew[i]);
+
+  CheckSameTree(root, serialRoot);
+}
+
+// Recursively check that the parent links of each node are correct.
+template<typename TreeType>
+void CheckParentLinks(const TreeType& node)
+{
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(node.Child(i).Parent(), &node);
+    BOOST_REQUIRE_EQUAL(&node.Child(i).Dataset(), &node.Dataset());
+    CheckParentLinks(node.Child(i));
+  }
+}
+
+/**
+ * Flatten a kd-tree in both layouts, and make sure that it is still the same
+ * tree.
+ */
+BOOST_AUTO_TEST_CASE(FlattenedKdTreeTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset(5, 3000);
+  dataset.randu();
+
+  TreeType root(dataset);
+  TreeType copy(root);
+  BOOST_REQUIRE(!root.IsFlat());
+
+  root.Flatten(BREADTH_FIRST_LAYOUT);
+  BOOST_REQUIRE(root.IsFlat());
+  CheckSameTree(root, copy);
+  CheckParentLinks(root);
+  BOOST_REQUIRE(CheckPointBounds(root));
+
+  // Flatten it again, in the other layout.
+  root.Flatten(VAN_EMDE_BOAS_LAYOUT);
+  BOOST_REQUIRE(root.IsFlat());
+  CheckSameTree(root, copy);
+  CheckParentLinks(root);
+  BOOST_REQUIRE(CheckPointBounds(root));
+
+  // A copy of a flattened tree is not flattened, but is the same tree.
+  TreeType flatCopy(root);
+  BOOST_REQUIRE(!flatCopy.IsFlat());
+  CheckSameTree(flatCopy, copy);
+  CheckParentLinks(flatCopy);
+
+  // Moving the tree moves the flattened storage.
+  TreeType moved(std::move(root));
+  BOOST_REQUIRE(moved.IsFlat());
+  BOOST_REQUIRE(!root.IsFlat());
+  CheckSameTree(moved, copy);
+}
+
+/**
+ * Make sure a tree with a single node can be flattened.
+ */
+BOOST_AUTO_TEST_CASE(FlattenedSingleNodeTreeTest)
+{
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::mat dataset(3, 10);
+  dataset.randu();
+
+  TreeType root(dataset);
+  TreeType copy(root);
+  BOOST_REQUIRE(root.IsLeaf());
+
+  root.Flatten();
+  BOOST_REQUIRE(root.IsFlat());
+  CheckSameTree(root, copy);
+}
+
 // Recursively checks that each node contains all points that it claims to have.
 template<typename TreeType>
 bool CheckPointBounds(TreeType& node)
@@ -2093,4 +2221,118 @@ BOOST_AUTO_TEST_CASE(CoverTreeDescendantTest)
   CheckDescendants(&tree);
 }
 
+/**
+ * Check the parts of the structure of a cover tree that the traversers depend
+ * on: explicit nodes only, decreasing scales, correct parent links and
+ * descendant counts, and valid furthest descendant distances.
+ */
+template<typename TreeType>
+void CheckCoverTreeStructure(const TreeType& node)
+{
+  if (node.NumChildren() == 0)
+  {
+    BOOST_REQUIRE_EQUAL(node.NumDescendants(), 1);
+    return;
+  }
+
+  BOOST_REQUIRE_GE(node.NumChildren(), 2);
+
+  size_t descendants = 0;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_LT(node.Child(i).Scale(), node.Scale());
+    BOOST_REQUIRE(node.Child(i).Parent() == &node);
+    descendants += node.Child(i).NumDescendants();
+    CheckCoverTreeStructure(node.Child(i));
+  }
+  BOOST_REQUIRE_EQUAL(descendants, node.NumDescendants());
+
+  for (size_t i = 0; i < node.NumDescendants(); ++i)
+  {
+    const double distance = EuclideanDistance::Evaluate(
+        node.Dataset().col(node.Point()),
+        node.Dataset().col(node.Descendant(i)));
+    BOOST_REQUIRE_LE(distance, node.FurthestDescendantDistance());
+  }
+}
+
+/**
+ * Insert points into a cover tree one by one, and make sure it stays valid.
+ */
+BOOST_AUTO_TEST_CASE(CoverTreeInsertTest)
+{
+  arma::mat dataset;
+  dataset.randu(5, 1000);
+  arma::mat initialDataset = dataset.cols(0, 499);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+  TreeType tree(initialDataset);
+
+  for (size_t i = 500; i < 1000; ++i)
+    BOOST_REQUIRE_EQUAL(tree.InsertPoint(dataset.col(i)), i);
+
+  // The original dataset must not be modified.
+  BOOST_REQUIRE_EQUAL(initialDataset.n_cols, 500);
+  BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000);
+
+  arma::vec counts;
+  counts.zeros(1000);
+  RecurseTreeCountLeaves(tree, counts);
+  for (size_t i = 0; i < 1000; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  CheckSelfChild<TreeType>(tree);
+  CheckCovering<TreeType, LMetric<2, true>>(tree);
+  CheckCoverTreeStructure(tree);
+  CheckDescendants(&tree);
+}
+
+/**
+ * Delete points from a cover tree (including the root), then insert them again,
+ * and make sure it stays valid.
+ */
+BOOST_AUTO_TEST_CASE(CoverTreeDeleteTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 1000);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+  TreeType tree(dataset);
+
+  // Delete the root point and every third point.
+  for (size_t i = 0; i < 1000; i += 3)
+    BOOST_REQUIRE_EQUAL(tree.DeletePoint(i), true);
+  BOOST_REQUIRE_EQUAL(tree.DeletePoint(0), false);
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 666);
+
+  arma::vec counts;
+  counts.zeros(1000);
+  RecurseTreeCountLeaves(tree, counts);
+  for (size_t i = 0; i < 1000; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], (i % 3 == 0) ? 0 : 1);
+
+  CheckSelfChild<TreeType>(tree);
+  CheckCovering<TreeType, LMetric<2, true>>(tree);
+  CheckCoverTreeStructure(tree);
+  CheckDescendants(&tree);
+
+  // Now put the points back.
+  for (size_t i = 0; i < 1000; i += 3)
+    tree.InsertPoint(i);
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000);
+
+  counts.zeros();
+  RecurseTreeCountLeaves(tree, counts);
+  for (size_t i = 0; i < 1000; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  CheckSelfChild<TreeType>(tree);
+  CheckCovering<TreeType, LMetric<2, true>>(tree);
+  CheckCoverTreeStructure(tree);
+  CheckDescendants(&tree);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
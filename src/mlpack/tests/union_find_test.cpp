@@ -46,4 +46,33 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind_.Find(6) == testUnionFind_.Find(3));
 }
 
+/**
+ * Make sure Root() gives the same components as Find(), before and after the
+ * structure is flattened.
+ */
+BOOST_AUTO_TEST_CASE(TestRootAndFlatten)
+{
+  static const size_t testSize_ = 10;
+  UnionFind testUnionFind_(testSize_);
+
+  testUnionFind_.Union(0, 1);
+  testUnionFind_.Union(2, 3);
+  testUnionFind_.Union(0, 2);
+  testUnionFind_.Union(5, 0);
+  testUnionFind_.Union(7, 8);
+
+  for (size_t i = 0; i < testSize_; i++)
+    BOOST_REQUIRE_EQUAL(testUnionFind_.Root(i), testUnionFind_.Find(i));
+
+  testUnionFind_.Flatten();
+
+  for (size_t i = 0; i < testSize_; i++)
+    BOOST_REQUIRE_EQUAL(testUnionFind_.Root(i), testUnionFind_.Find(i));
+
+  BOOST_REQUIRE_EQUAL(testUnionFind_.Root(3), testUnionFind_.Root(5));
+  BOOST_REQUIRE_EQUAL(testUnionFind_.Root(7), testUnionFind_.Root(8));
+  BOOST_REQUIRE(testUnionFind_.Root(4) != testUnionFind_.Root(5));
+  BOOST_REQUIRE(testUnionFind_.Root(6) != testUnionFind_.Root(7));
+}
+
 BOOST_AUTO_TEST_SUITE_END();